@@ -55,6 +55,8 @@ namespace profiling {
 enum EventCategory {
   SESSION_EVENT = 0,
   NODE_EVENT,
+  THREAD_POOL_EVENT,
+  MEMORY_EVENT,  // written as counter events, with numeric args
   EVENT_CATEGORY_MAX
 };
 
@@ -63,7 +65,9 @@ Event descriptions for the above session events.
 */
 static constexpr const char* event_categor_names_[EVENT_CATEGORY_MAX] = {
     "Session",
-    "Node"};
+    "Node",
+    "ThreadPool",
+    "Memory"};
 
 /*
 Timing record for all events.
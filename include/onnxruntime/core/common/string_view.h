@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace onnxruntime {
+
+/**
+ * A non-owning view of a range of chars, e.g. a string element of a Tensor.
+ * A minimal stand-in for std::string_view, which is not available in C++14.
+ */
+class StringView {
+ public:
+  StringView() noexcept : data_(nullptr), size_(0) {}
+  StringView(const char* data, size_t size) noexcept : data_(data), size_(size) {}
+  StringView(const char* s) : data_(s), size_(std::strlen(s)) {}
+  StringView(const std::string& s) noexcept : data_(s.data()), size_(s.size()) {}
+
+  const char* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+  size_t length() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  const char* begin() const noexcept { return data_; }
+  const char* end() const noexcept { return data_ + size_; }
+
+  char operator[](size_t i) const noexcept { return data_[i]; }
+
+  StringView substr(size_t pos, size_t count) const noexcept {
+    return StringView(data_ + pos, count < size_ - pos ? count : size_ - pos);
+  }
+
+  std::string ToString() const { return std::string(data_, size_); }
+
+  int compare(StringView other) const noexcept {
+    const size_t n = size_ < other.size_ ? size_ : other.size_;
+    const int result = n == 0 ? 0 : std::memcmp(data_, other.data_, n);
+    if (result != 0) return result;
+    return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+inline bool operator==(StringView lhs, StringView rhs) noexcept {
+  return lhs.size() == rhs.size() && (lhs.size() == 0 || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+
+inline bool operator!=(StringView lhs, StringView rhs) noexcept { return !(lhs == rhs); }
+
+inline bool operator<(StringView lhs, StringView rhs) noexcept { return lhs.compare(rhs) < 0; }
+
+inline std::ostream& operator<<(std::ostream& out, StringView s) {
+  return out.write(s.data(), s.size());
+}
+
+// FNV-1a, so unordered containers can be keyed by StringView.
+struct StringViewHash {
+  size_t operator()(StringView s) const noexcept {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : s) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+}  // namespace onnxruntime
@@ -5,11 +5,14 @@
 
 #include <stddef.h>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "gsl/gsl"
 #include "core/common/common.h"
+#include "core/common/string_view.h"
 #include "core/framework/allocator.h"
 #include "core/framework/tensor_shape.h"
 #include "onnxruntime_config.h"
@@ -129,6 +132,7 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    if (strings_) ReleaseContiguousStrings();
     return reinterpret_cast<T*>(static_cast<char*>(p_data_) + byte_offset_);
   }
 
@@ -140,6 +144,7 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    if (strings_) ReleaseContiguousStrings();
     T* data = reinterpret_cast<T*>(static_cast<char*>(p_data_) + byte_offset_);
     return gsl::make_span(data, static_cast<size_t>(shape_.Size()));
   }
@@ -149,6 +154,7 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    if (strings_) MaterializeStrings();
     return reinterpret_cast<const T*>(static_cast<char*>(p_data_) + byte_offset_);
   }
 
@@ -157,25 +163,30 @@ class Tensor final {
     // Type check
     ORT_ENFORCE(utils::IsPrimitiveDataType<T>(dtype_), "Tensor type mismatch. ",
                 "T ", "!=", dtype_);
+    if (strings_) MaterializeStrings();
     const T* data = reinterpret_cast<const T*>(static_cast<char*>(p_data_) + byte_offset_);
     return gsl::make_span(data, static_cast<typename gsl::span<T>::index_type>(shape_.Size()));
   }
 
   void* MutableDataRaw(MLDataType type) {
     ORT_ENFORCE(type == dtype_, "Tensor type mismatch.", type, "!=", dtype_);
+    if (strings_) ReleaseContiguousStrings();
     return static_cast<char*>(p_data_) + byte_offset_;
   }
 
   const void* DataRaw(MLDataType type) const {
     ORT_ENFORCE(type == dtype_, "Tensor type mismatch.", type, "!=", dtype_);
+    if (strings_) MaterializeStrings();
     return static_cast<char*>(p_data_) + byte_offset_;
   }
 
-  void* MutableDataRaw() noexcept {
+  void* MutableDataRaw() {
+    if (strings_) ReleaseContiguousStrings();
     return static_cast<char*>(p_data_) + byte_offset_;
   }
 
-  const void* DataRaw() const noexcept {
+  const void* DataRaw() const {
+    if (strings_) MaterializeStrings();
     return static_cast<char*>(p_data_) + byte_offset_;
   }
 
@@ -183,6 +194,45 @@ class Tensor final {
     return buffer_deleter_ != nullptr;
   }
 
+  /**
+   * Set the elements of a string tensor from one contiguous buffer of chars.
+   * Element i is chars[offsets[i], offsets[i + 1]), so offsets has Shape().Size() + 1 entries and starts at 0.
+   * The chars and offsets are copied into a single allocation, and the std::string elements are only created
+   * when they are accessed through Data<std::string>(), DataRaw() or the mutable accessors.
+   */
+  void SetStrings(gsl::span<const char> chars, gsl::span<const size_t> offsets);
+
+  /**
+   * True if the string elements are held in the contiguous buffer set by SetStrings.
+   */
+  bool HasContiguousStrings() const noexcept {
+    return strings_ != nullptr;
+  }
+
+  /**
+   * The chars and the Shape().Size() + 1 offsets of the contiguous string elements.
+   * Only valid if HasContiguousStrings() and until the tensor is modified.
+   */
+  const char* ContiguousStringChars() const noexcept {
+    return strings_->chars;
+  }
+
+  const size_t* ContiguousStringOffsets() const noexcept {
+    return strings_->offsets;
+  }
+
+  /**
+   * Returns a view of string element i, without creating a std::string for it.
+   * The tensor must contain strings.
+   */
+  StringView StringAt(size_t i) const {
+    if (strings_) {
+      const size_t* offsets = strings_->offsets;
+      return StringView(strings_->chars + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return StringView(reinterpret_cast<const std::string*>(static_cast<char*>(p_data_) + byte_offset_)[i]);
+  }
+
   /**
    * Resizes the tensor without touching underlying storage.
    * This requires the total size of the tensor to remains constant.
@@ -227,6 +277,19 @@ class Tensor final {
 
   void ReleaseBuffer();
 
+  // Create the std::string elements from the contiguous buffer, once.
+  void MaterializeStrings() const;
+
+  // Create the std::string elements and release the contiguous buffer, as they are about to be modified.
+  void ReleaseContiguousStrings();
+
+  struct ContiguousStrings {
+    BufferUniquePtr buffer;
+    const size_t* offsets;
+    const char* chars;
+    std::once_flag materialized;
+  };
+
   void* p_data_;
   /**
      if buffer_deleter_ is null, it means tensor does not own the buffer.
@@ -239,6 +302,9 @@ class Tensor final {
   const PrimitiveDataTypeBase* dtype_;
   OrtMemoryInfo alloc_info_;
   ptrdiff_t byte_offset_;
+
+  // string elements set by SetStrings, if any. takes precedence over the std::string elements in p_data_.
+  std::unique_ptr<ContiguousStrings> strings_;
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
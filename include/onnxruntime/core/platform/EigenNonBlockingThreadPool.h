@@ -9,6 +9,7 @@
 
 /* Modifications Copyright (c) Microsoft. */
 
+#include <chrono>
 #include <type_traits>
 
 #pragma once
@@ -33,10 +34,12 @@
 #pragma warning(pop)
 #endif
 #include "core/common/denormal.h"
+#include "core/common/logging/logging.h"
 #include "core/common/make_unique.h"
 #include "core/common/spin_pause.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
 
 // ORT thread pool overview
 // ------------------------
@@ -581,6 +584,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
+        collect_stats_(thread_options.collect_stats),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
         blocked_(0),
@@ -835,7 +839,11 @@ void SummonWorkers(PerThread &pt,
   // value.  However, the costs of creating distinct lambda for each
   // iteration appeared more costly than the cost of synchronization
   // on a shared counter.
-  auto call_worker_fn = [&ps, worker_fn]() {
+  const auto push_time = collect_stats_ ? Clock::now() : Clock::time_point();
+  auto call_worker_fn = [this, &ps, worker_fn, push_time]() {
+    if (collect_stats_) {
+      RecordSectionJoin(push_time);
+    }
     unsigned my_idx = ++ps.worker_idx;
     worker_fn(my_idx);
     // After the assignment to ps.tasks_finished, the stack-allocated
@@ -991,6 +999,32 @@ int CurrentThreadId() const EIGEN_FINAL {
   return -1;
 }
 
+// Number of tasks waiting in the queues of the workers.
+unsigned QueuedTasks() const {
+  unsigned queued = 0;
+  for (size_t i = 0; i < worker_data_.size(); i++) {
+    queued += worker_data_[i].queue.Size();
+  }
+  return queued;
+}
+
+// Copy the counters of the workers, which are only maintained when
+// the pool was created with ThreadOptions::collect_stats.
+void GetWorkerStats(std::vector<ThreadPoolStats::Worker>& workers) const {
+  workers.resize(worker_data_.size());
+  for (size_t i = 0; i < worker_data_.size(); i++) {
+    const WorkerStats& ws = worker_data_[i].stats;
+    ThreadPoolStats::Worker& w = workers[i];
+    w.os_thread_id = ws.os_thread_id.load(std::memory_order_relaxed);
+    w.tasks = ws.tasks.load(std::memory_order_relaxed);
+    w.steals = ws.steals.load(std::memory_order_relaxed);
+    w.spin_us = ws.spin_ns.load(std::memory_order_relaxed) / 1000;
+    w.blocked_us = ws.blocked_ns.load(std::memory_order_relaxed) / 1000;
+    w.section_joins = ws.section_joins.load(std::memory_order_relaxed);
+    w.section_entry_us = ws.section_entry_ns.load(std::memory_order_relaxed) / 1000;
+  }
+}
+
  private:
 
 #ifdef NDEBUG
@@ -1048,11 +1082,35 @@ int CurrentThreadId() const EIGEN_FINAL {
   static_assert(std::is_trivially_destructible<PerThread>::value,
                 "Per-thread state should be trivially destructible");
 
+  using Clock = std::chrono::steady_clock;
+
+  // Utilization counters of a worker, maintained if collect_stats_ is set.  Only
+  // the worker itself updates them, so the updates are plain relaxed
+  // loads and stores rather than read-modify-write operations.
+  struct WorkerStats {
+    std::atomic<unsigned> os_thread_id{0};
+    std::atomic<uint64_t> tasks{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> spin_ns{0};
+    std::atomic<uint64_t> blocked_ns{0};
+    std::atomic<uint64_t> section_joins{0};
+    std::atomic<uint64_t> section_entry_ns{0};
+
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static uint64_t ElapsedNs(Clock::time_point start) {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+  };
+
   struct WorkerData {
     constexpr WorkerData() : thread(), queue() {
     }
     std::unique_ptr<Thread> thread;
     Queue queue;
+    WorkerStats stats;
 
     // Each thread has a status, available read-only without locking, and protected
     // by the mutex field below for updates.  The status is used for three
@@ -1144,6 +1202,7 @@ int CurrentThreadId() const EIGEN_FINAL {
   const int num_threads_;
   const bool allow_spinning_;
   const bool set_denormal_as_zero_;
+  const bool collect_stats_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
@@ -1191,28 +1250,45 @@ int CurrentThreadId() const EIGEN_FINAL {
 
     SetDenormalAsZero(set_denormal_as_zero_);
 
+    WorkerStats& stats = td.stats;
+    if (collect_stats_) {
+      stats.os_thread_id.store(onnxruntime::logging::GetThreadId(), std::memory_order_relaxed);
+    }
+
     while (!cancelled_ && !should_exit) {
         Task t = q.PopFront();
+        bool stolen = false;
         if (!t) {
           // Spin waiting for work.  We indicate, via SetGOodWorkerHint that we are
           // spinning.  This will bias other threads toward pushing work to our queue.
           // In addition, priodically make a best-effort attempt to steal from other
           // threads which are not themselves spinning.
 
+          const auto spin_start = collect_stats_ ? Clock::now() : Clock::time_point();
           SetGoodWorkerHint(thread_id, true);
           for (int i = 0; i < spin_count && !t && !cancelled_ && !done_; i++) {
-            t = ((i+1)%steal_count == 0) ? TrySteal() : q.PopFront();
+            if ((i+1)%steal_count == 0) {
+              t = TrySteal();
+              stolen = static_cast<bool>(t);
+            } else {
+              t = q.PopFront();
+            }
             onnxruntime::concurrency::SpinPause();
           }
           SetGoodWorkerHint(thread_id, false);
+          if (collect_stats_) {
+            WorkerStats::Add(stats.spin_ns, WorkerStats::ElapsedNs(spin_start));
+          }
 
           if (!t) {
             // No work passed to us while spinning; make a further full attempt to
             // steal work from other threads prior to blocking.
             if (num_threads_ != 1) {
               t = Steal(true /* true => check all queues */);
+              stolen = static_cast<bool>(t);
             }
             if (!t) {
+              const auto block_start = collect_stats_ ? Clock::now() : Clock::time_point();
               td.SetBlocked(
                   // Pre-block test
                   [&]() -> bool {
@@ -1224,6 +1300,7 @@ int CurrentThreadId() const EIGEN_FINAL {
                       should_block = false;
                       if (!cancelled_) {
                         t = worker_data_[victim].queue.PopBack();
+                        stolen = static_cast<bool>(t) && victim != thread_id;
                       }
                     }
                     // Number of blocked threads is used as termination condition.
@@ -1256,11 +1333,20 @@ int CurrentThreadId() const EIGEN_FINAL {
                   // Post-block update (executed only if we blocked)
                   [&]() {
                     blocked_--;
+                    if (collect_stats_) {
+                      WorkerStats::Add(stats.blocked_ns, WorkerStats::ElapsedNs(block_start));
+                    }
                   });
             }
           }
         }
         if (t) {
+          if (collect_stats_) {
+            WorkerStats::Add(stats.tasks, 1);
+            if (stolen) {
+              WorkerStats::Add(stats.steals, 1);
+            }
+          }
           td.SetActive();
           t();
           td.SetSpinning();
@@ -1321,6 +1407,17 @@ int CurrentThreadId() const EIGEN_FINAL {
     return Steal(false);
   }
 
+  // Account for a worker joining a parallel loop or section whose work was
+  // pushed to it at push_time.
+  void RecordSectionJoin(Clock::time_point push_time) {
+    PerThread* pt = GetPerThread();
+    if (pt->pool == this) {
+      WorkerStats& stats = worker_data_[pt->thread_id].stats;
+      WorkerStats::Add(stats.section_joins, 1);
+      WorkerStats::Add(stats.section_entry_ns, WorkerStats::ElapsedNs(push_time));
+    }
+  }
+
   int NonEmptyQueueIndex() {
     PerThread* pt = GetPerThread();
     const unsigned size = static_cast<unsigned>(worker_data_.size());
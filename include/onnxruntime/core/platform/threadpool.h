@@ -16,6 +16,8 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <atomic>
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <functional>
@@ -135,8 +137,53 @@ class ThreadPoolTempl;
 
 class ExtendedThreadPoolInterface;
 class LoopCounter;
+class SharedLoopScope;
+class LoopCostModel;
+struct LoopCost;
 class ThreadPoolParallelSection;
 
+// Utilization counters of a thread pool created with ThreadOptions::collect_stats.  The
+// counters are cumulative since the pool was created, and times are in microseconds.
+struct ThreadPoolStats {
+  struct Worker {
+    unsigned os_thread_id{0};       // Id of the worker's OS thread, as used for the tid of profiler events
+    uint64_t tasks{0};              // Tasks run by the worker
+    uint64_t steals{0};             // Tasks the worker took from the queues of other workers
+    uint64_t spin_us{0};            // Time spent spinning while waiting for work
+    uint64_t blocked_us{0};         // Time spent blocked while waiting for work
+    uint64_t section_joins{0};      // Parallel loops and sections the worker joined
+    uint64_t section_entry_us{0};   // Total time between work being pushed to the worker and the worker joining
+  };
+  std::vector<Worker> workers;
+
+  // Parallel loops run by the pool.  The imbalance of a loop is the longest time a thread spent
+  // running iterations divided by the average over the threads the loop was offered to, so 1 is
+  // perfectly balanced and the degree of parallelism means one thread did all the work.
+  uint64_t loops{0};
+  double total_loop_imbalance{0};
+  double max_loop_imbalance{0};
+};
+
+// Options of a pool that runs its work on the threads of another pool, see
+// the corresponding ThreadPool constructor.
+struct ThreadPoolShareOptions {
+  // Weight of the pool when its parallel loops run at the same time as loops
+  // of other pools sharing the threads.  Must be positive.
+  unsigned share{1};
+
+  // Upper limit on the degree of parallelism of the pool, 0 for no limit.
+  int max_degree_of_parallelism{0};
+};
+
+// Load of the threads of a pool, which may be shared with other pools.
+struct ThreadPoolLoad {
+  unsigned queued_tasks{0};      // Tasks waiting in the queues of the threads
+  unsigned active_loops{0};      // Parallel loops of the sharing pools running now
+  uint64_t active_shares{0};     // Sum of the shares of the pools of those loops
+  uint64_t shared_loops{0};      // Parallel loops the pool ran on shared threads
+  uint64_t throttled_loops{0};   // Those of them that got fewer threads because of other pools' loops
+};
+
 class ThreadPool {
  public:
 #ifdef _WIN32
@@ -159,6 +206,15 @@ class ThreadPool {
              int degree_of_parallelism,
              bool low_latency_hint);
 
+  // Constructs a pool that runs its work on the threads of "shared_pool"
+  // instead of creating threads, so that several sessions can share one set
+  // of threads without oversubscribing the machine.  When parallel loops of
+  // pools sharing the threads run at the same time, each loop is offered the
+  // threads in proportion to the share of its pool, so that a latency
+  // critical session can be given most of the threads while batch sessions
+  // keep making progress.  "shared_pool" must outlive this pool.
+  ThreadPool(ThreadPool* shared_pool, const ThreadPoolShareOptions& share_options);
+
   // Waits until all scheduled work has finished and then destroy the
   // set of threads.
   ~ThreadPool();
@@ -222,6 +278,35 @@ class ThreadPool {
                   "Per-thread state should be trivially destructible");
   };
 
+  // Loop scopes name the operator for which the calling thread runs parallel
+  // loops.  In pools created with ThreadOptions::adaptive_loop_costs a loop
+  // started inside a scope is measured separately for every operator type and
+  // node name, in addition to its call site, so that helpers shared by several
+  // kernels, such as the element-wise broadcasting loops, don't mix the costs
+  // of different operators.  The executors open a scope around the Compute
+  // call of every kernel.  The strings must outlive the scope.  Scopes may be
+  // nested, the innermost one applies.
+
+  class LoopScope {
+  public:
+    LoopScope(const std::string& op_type, const std::string& node_name);
+    ~LoopScope();
+
+  private:
+    friend class ThreadPool;
+
+    const std::string& op_type_;
+    const std::string& node_name_;
+    LoopScope* previous_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LoopScope);
+
+    // Non-owning reference to the current thread's innermost loop scope
+    // (or nullptr outside loop scopes).
+    static thread_local LoopScope* current_loop_scope;
+    static_assert(std::is_trivially_destructible<decltype(current_loop_scope)>::value,
+                  "Per-thread state should be trivially destructible");
+  };
+
   // Schedules fn() for execution in the pool of threads.  The function may run
   // synchronously if it cannot be enqueued.  This will occur if the thread pool's
   // degree-of-parallelism is 1, but it may also occur for implementation-dependent
@@ -246,14 +331,24 @@ class ThreadPool {
   // Context creation. Underestimating may not fully make use of the specified
   // parallelism, and may also cause inefficiencies due to load balancing
   // issues and stragglers.
+  //
+  // If the pool was created with ThreadOptions::adaptive_loop_costs then
+  // "cost_per_unit" is only used until the pool has measured the loop, see
+  // LoadLoopCosts.  The loop is identified by the type of "fn", which is
+  // distinct for every lambda expression, or by "loop_tag" if it is given,
+  // and by the operator of the enclosing LoopScope.
+  // Builds without RTTI only learn the costs of tagged loops.  A tag must be
+  // a string that outlives the pool, such as a string literal.
 
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
-    TryParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                             const char* loop_tag = nullptr) {
+    TryParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn, loop_tag);
   }
 
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                             const char* loop_tag = nullptr);
 
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
@@ -369,19 +464,45 @@ class ThreadPool {
 
   static bool ShouldParallelize(const ThreadPool* tp);
 
+  // Copy the utilization counters of the thread pool into stats.  Returns false,
+  // leaving stats unchanged, if tp is nullptr or was not created with
+  // ThreadOptions::collect_stats.
+  static bool GetStats(const ThreadPool* tp, ThreadPoolStats& stats);
+
+  // Copy the load of the threads of the pool into load.  Returns false if tp is nullptr.
+  static bool GetLoad(const ThreadPool* tp, ThreadPoolLoad& load);
+
+  // Save the per-iteration costs measured by a pool created with
+  // ThreadOptions::adaptive_loop_costs, one loop per line as the time per
+  // iteration in nanoseconds followed by the name of the loop.  Loading them
+  // into a new pool lets it pick the block size and degree of parallelism of
+  // those loops from their first run.  Loop names come from the compiler's
+  // type names, so saved costs only match the build that saved them.
+  static Status SaveLoopCosts(const ThreadPool* tp, std::ostream& out);
+  static Status LoadLoopCosts(ThreadPool* tp, std::istream& in);
+
   // Return the degree of parallelism that code should assume when using the thread pool.
   // It decouples the degree of parallelism for use with the thread pool from
   // the implementation choice of whether this matches the number of threads created in
   // the pool.
   //
   // Currently, a loop with degree-of-parallelism N is supported by a pool of N-1 threads
-  // working in combination with the thread initiating the loop.
+  // working in combination with the thread initiating the loop.  A pool sharing
+  // the threads of another pool is also limited by its max_degree_of_parallelism.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Return the shard of a parallel loop's iteration space from which the
+  // thread at position (0 for the thread entering the loop, i+1 for worker
+  // thread i) starts claiming iterations.  Positions map to the num_shards
+  // shards in proportion, so the result only depends on the position and
+  // not on the order in which threads join the loop.
+  static unsigned GetHomeShard(unsigned position, unsigned num_positions, unsigned num_shards);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
  private:
   friend class LoopCounter;
+  friend class SharedLoopScope;
 
   // Returns the number of threads created in the pool.  This may be different from the
   // value returned by DegreeOfParallelism to code using the pool.
@@ -404,8 +525,11 @@ class ThreadPool {
   // the number of threads available in the pool.
   // When (i+1)*block_size > total, fn(i*block_size, total) is called instead.
   // Requires 0 < block_size <= total.
+  // At most max_d_of_p threads take part if it is positive.  If measured_loop
+  // is given, the time spent running iterations is added to its cost.
   void ParallelForFixedBlockSizeScheduling(std::ptrdiff_t total, std::ptrdiff_t block_size,
-                                           const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn);
+                                           const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn,
+                                           int max_d_of_p = 0, LoopCost* measured_loop = nullptr);
 
   // Return whether or not the calling thread should run a loop of
   // num_iterations divided in chunks of block_size in parallel.  If not,
@@ -416,17 +540,43 @@ class ThreadPool {
   // Internal (non-static) parallel loop methods.  Unlike the public static methods,
   // these will not handle the cases of OpenMP builds. or builds without a threadpool.
   void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
-                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                   const char* loop_tag = nullptr);
 
   void ParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn);
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn,
+                   const char* loop_tag = nullptr);
 
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
 
   void Schedule(std::function<void()> fn);
 
+  // Add the imbalance of a parallel loop to the statistics.
+  void RecordLoop(uint64_t max_busy_ns, uint64_t total_busy_ns, unsigned num_work_items);
+
   ThreadOptions thread_options_;
 
+  // Pool whose threads this pool uses, or nullptr if the pool owns its threads.
+  ThreadPool* shared_pool_ = nullptr;
+  ThreadPoolShareOptions share_options_;
+
+  // Parallel loops running on the threads of this pool on behalf of the pools sharing them.
+  std::atomic<unsigned> active_loops_{0};
+  std::atomic<uint64_t> active_shares_{0};
+
+  // Parallel loops this pool ran on the threads of shared_pool_.
+  std::atomic<uint64_t> shared_loops_{0};
+  std::atomic<uint64_t> throttled_loops_{0};
+
+  // Statistics of the parallel loops, updated only if thread_options_.collect_stats is set.
+  // Imbalances are kept in thousandths so they can be accumulated atomically.
+  std::atomic<uint64_t> loops_{0};
+  std::atomic<uint64_t> total_loop_imbalance_{0};
+  std::atomic<uint64_t> max_loop_imbalance_{0};
+
+  // Measured loop costs, only created if thread_options_.adaptive_loop_costs is set.
+  std::unique_ptr<LoopCostModel> loop_cost_model_;
+
   // If a thread pool is created with degree_of_parallelism != 1 then an underlying
   // EigenThreadPool is used to create OS threads and handle work distribution to them.
   // If degree_of_parallelism == 1 then underlying_threadpool_ is left as nullptr
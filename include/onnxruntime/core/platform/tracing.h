@@ -3,7 +3,37 @@
 
 #pragma once
 
+#ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
 #include <windows.h>
 #include <TraceLoggingProvider.h>
 
 TRACELOGGING_DECLARE_PROVIDER(telemetry_provider_handle);
+#endif
+
+// Statically defined tracepoints for system profilers.
+//
+// When built with onnxruntime_ENABLE_USDT on Linux the probes are USDT probes from <sys/sdt.h> in the
+// "onnxruntime" provider. A probe that no tool is attached to is a single nop, so they can stay in production
+// builds and be attached to on demand, e.g.
+//   bpftrace -e 'usdt:/path/to/libonnxruntime.so:onnxruntime:node_end { @[str(arg1)] = count(); }'
+//   perf buildid-cache --add /path/to/libonnxruntime.so && perf record -e sdt_onnxruntime:node_begin ...
+// In other builds the probes compile to nothing.
+//
+// Probes and their arguments:
+//   run_begin(session_id, run_tag)                  InferenceSession::Run validated its feeds and fetches
+//   run_end(session_id, status_code)                InferenceSession::Run finished executing
+//   node_begin(node_index, op_type, node_name)      a kernel starts computing
+//   node_end(node_index, op_type, status_code)      a kernel finished computing
+//   arena_extend(arena_name, bytes, total_bytes)    a BFCArena allocated a new region from its device allocator
+//   parallel_for_begin(total, block_size, d_of_p)   a thread pool parallel loop starts
+//   parallel_for_end(total, d_of_p)                 a thread pool parallel loop ends
+// Strings are passed as const char*, status codes as the int value of common::StatusCode.
+#ifdef ORT_USE_USDT
+#include <sys/sdt.h>
+
+#define ORT_TRACE_PROBE2(name, a1, a2) DTRACE_PROBE2(onnxruntime, name, a1, a2)
+#define ORT_TRACE_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(onnxruntime, name, a1, a2, a3)
+#else
+#define ORT_TRACE_PROBE2(name, a1, a2)
+#define ORT_TRACE_PROBE3(name, a1, a2, a3)
+#endif
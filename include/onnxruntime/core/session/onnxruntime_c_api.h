@@ -1102,6 +1102,61 @@ struct OrtApi {
    * and that's recommended because turning this option on may hurt model accuracy.
    */
   ORT_API2_STATUS(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* tp_options);
+
+  /**
+   * Get the utilization counters of the session's thread pools as a JSON object, with an "intra_op" and an
+   * "inter_op" member for each pool that collects them. The counters are collected by per session thread pools
+   * when the "session.thread_pool_stats" session config entry is "1".
+   * The "intra_op_load" and "inter_op_load" members have the current queue depth and concurrent parallel loops of
+   * each pool, and the loops the session ran on threads shared with other sessions (see "session.thread_pool_share").
+   * \param out is allocated with the allocator and should be freed by it after use
+   */
+  ORT_API2_STATUS(SessionGetThreadPoolStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Get the latency statistics of the session's nodes as a JSON object with a "nodes" array. Each entry has the
+   * name and op_type of a node that ran, its number of calls, total and maximum latency in nanoseconds, the bytes
+   * of its output tensors and a histogram of the latencies. The statistics are kept when the "session.node_stats"
+   * session config entry is "1", and can be read at any time, including while the session is running.
+   * \param out is allocated with the allocator and should be freed by it after use
+   */
+  ORT_API2_STATUS(SessionGetNodeStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Get the memory usage of the session as a JSON object. The "arenas" array has, for each arena of the session's
+   * execution providers, the bytes in use, the peak bytes in use, the bytes allocated from the device, the number of
+   * allocations and extensions, the largest free block and the fragmentation, the share of the free bytes that are
+   * not in the largest free block. When the "session.memory_profile" session config entry is "1" the object also
+   * has the number of "runs" and a "peaks" array with the highest peak of the live tensor bytes of each memory
+   * location over all runs and the largest tensors at that peak, with the nodes that produced them.
+   * \param out is allocated with the allocator and should be freed by it after use
+   */
+  ORT_API2_STATUS(SessionGetMemoryStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /**
+   * Fill a string tensor from one buffer with the strings of all its elements, in the layout returned by
+   * GetStringTensorContent. The strings are copied into a single allocation instead of one per element.
+   * \param value A tensor created from OrtCreateTensor... function.
+   * \param s string contents. Each string is NOT null-terminated.
+   * \param s_len total data length
+   * \param offsets the offset of each string in s, starting at 0
+   * \param offsets_len the number of elements of the tensor
+   */
+  ORT_API2_STATUS(FillStringTensorContent, _Inout_ OrtValue* value, _In_reads_(s_len) const char* s,
+                  size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len);
+
+  /**
+   * Get the strings of a tensor without copying them. Element i is [s + offsets[i], s + offsets[i + 1]), so offsets
+   * has one more entry than the tensor has elements. The strings are not null-terminated.
+   * This requires a tensor that stores its strings contiguously, e.g. an output of a string kernel or a tensor filled
+   * with FillStringTensorContent, and fails otherwise; GetStringTensorContent works for every string tensor.
+   * The pointers are valid until the tensor is modified or released.
+   */
+  ORT_API2_STATUS(GetStringTensorContentView, _In_ const OrtValue* value, _Outptr_ const char** s,
+                  _Outptr_ const size_t** offsets);
 };
 
 /*
@@ -360,6 +360,9 @@ struct Session : Base<OrtSession> {
   char* GetOutputName(size_t index, OrtAllocator* allocator) const;
   char* GetOverridableInitializerName(size_t index, OrtAllocator* allocator) const;
   char* EndProfiling(OrtAllocator* allocator) const;
+  char* GetThreadPoolStats(OrtAllocator* allocator) const;
+  char* GetNodeStats(OrtAllocator* allocator) const;
+  char* GetMemoryStats(OrtAllocator* allocator) const;
   uint64_t GetProfilingStartTimeNs() const;
   ModelMetadata GetModelMetadata() const;
 
@@ -437,6 +440,7 @@ struct Value : Base<OrtValue> {
 
   size_t GetStringTensorDataLength() const;
   void GetStringTensorContent(void* buffer, size_t buffer_length, size_t* offsets, size_t offsets_count) const;
+  void GetStringTensorContentView(const char** buffer, const size_t** offsets) const;
 
   template <typename T>
   T* GetTensorMutableData();
@@ -454,6 +458,7 @@ struct Value : Base<OrtValue> {
   void GetStringTensorElement(size_t buffer_length, size_t element_index, void* buffer) const;
 
   void FillStringTensor(const char* const* s, size_t s_len);
+  void FillStringTensorContent(const char* s, size_t s_len, const size_t* offsets, size_t offsets_count);
   void FillStringTensorElement(const char* s, size_t index);
 };
 
@@ -557,6 +557,24 @@ inline char* Session::EndProfiling(OrtAllocator* allocator) const {
   return out;
 }
 
+inline char* Session::GetThreadPoolStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetThreadPoolStats(p_, allocator, &out));
+  return out;
+}
+
+inline char* Session::GetNodeStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetNodeStats(p_, allocator, &out));
+  return out;
+}
+
+inline char* Session::GetMemoryStats(OrtAllocator* allocator) const {
+  char* out;
+  ThrowOnError(GetApi().SessionGetMemoryStats(p_, allocator, &out));
+  return out;
+}
+
 inline uint64_t Session::GetProfilingStartTimeNs() const {
   uint64_t out;
   ThrowOnError(GetApi().SessionGetProfilingStartTimeNs(p_, &out));
@@ -786,6 +804,10 @@ inline void Value::GetStringTensorContent(void* buffer, size_t buffer_length, si
   ThrowOnError(GetApi().GetStringTensorContent(p_, buffer, buffer_length, offsets, offsets_count));
 }
 
+inline void Value::GetStringTensorContentView(const char** buffer, const size_t** offsets) const {
+  ThrowOnError(GetApi().GetStringTensorContentView(p_, buffer, offsets));
+}
+
 inline void Value::GetStringTensorElement(size_t buffer_length, size_t element_index, void* buffer) const {
   ThrowOnError(GetApi().GetStringTensorElement(p_, buffer_length, element_index, buffer));
 }
@@ -794,6 +816,10 @@ inline void Value::FillStringTensor(const char* const* s, size_t s_len) {
   ThrowOnError(GetApi().FillStringTensor(p_, s, s_len));
 }
 
+inline void Value::FillStringTensorContent(const char* s, size_t s_len, const size_t* offsets, size_t offsets_count) {
+  ThrowOnError(GetApi().FillStringTensorContent(p_, s, s_len, offsets, offsets_count));
+}
+
 inline void Value::FillStringTensorElement(const char* s, size_t index) {
   ThrowOnError(GetApi().FillStringTensorElement(p_, s, index));
 }
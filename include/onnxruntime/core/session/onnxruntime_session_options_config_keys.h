@@ -40,3 +40,76 @@ static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save
 // Note that an alternative way not using this option at runtime is to train and export a model without denormals
 // and that's recommended because turning this option on may hurt model accuracy.
 static const char* const kOrtSessionOptionsConfigSetDenormalAsZero = "session.set_denormal_as_zero";
+
+// Number of streams the graph is partitioned into at session initialization when the execution mode is ORT_PARALLEL.
+// Each stream runs its nodes in a fixed order on the inter-op thread pool and only synchronizes with the other
+// streams on the edges between them, which avoids the per node scheduling of the parallel executor.
+// The partition balances the estimated cost of the nodes. The number of streams is limited to the degree of
+// parallelism of the inter-op thread pool, and streams are only used if all nodes are assigned to the CPU EP.
+// The default is "0", which uses the parallel executor.
+static const char* const kOrtSessionOptionsConfigInterOpNumStreams = "session.inter_op_num_streams";
+
+// Logical processors the threads of the per session intra-op thread pool are bound to, one set per thread.
+// Sets are separated by ';' and each is a ',' separated list of processor IDs or ranges, e.g. "0-3;4-7" binds the
+// first thread to processors 0 to 3 and the second to 4 to 7. Sets are reused when there are more threads than sets.
+// Parallel loops keep each range of iterations on the same thread from one loop to the next and neighboring threads
+// take neighboring ranges, so the sets of a NUMA node should be listed next to each other.
+// The default is "", which doesn't bind the threads to processors.
+static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
+
+// Index of the NUMA node whose logical processors run the threads of the per session thread pools.
+// If the number of threads of a pool is 0, the pool uses all the processors of the node. Running one session per
+// NUMA node keeps the threads of each session, and the memory they touch first, on one node.
+// Supported on Linux and Windows. The default is "-1", which doesn't restrict the threads to a node.
+static const char* const kOrtSessionOptionsConfigNumaNode = "session.numa_node";
+
+// If the value is "1", the per session thread pools count the tasks, steals, spinning and blocked time of each
+// thread, the latency of threads joining parallel sections, and the imbalance of parallel loops.
+// The counters can be read with SessionGetThreadPoolStats, and when profiling is enabled each run adds an event per
+// thread with the counters of the run on the thread's track. The default is "0".
+static const char* const kOrtSessionOptionsConfigThreadPoolStats = "session.thread_pool_stats";
+
+// If the value is "1", the per session intra-op thread pool measures the time per iteration of each parallel loop
+// of each node and uses it in place of the cost estimated by the kernel to choose the block size and number of
+// threads of the following runs of the loop. Small loops that the estimate sends to several threads then run on fewer
+// threads, or on the calling thread alone. The default is "0".
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveLoopCosts = "session.intra_op_adaptive_loop_costs";
+
+// Path of a file with the loop costs measured by the per session intra-op thread pool. If it is set, adaptive loop
+// costs are enabled, the costs in the file are loaded when the session is created if the file exists, and the costs
+// measured by the session are written to it when the session is destroyed. This lets new sessions of a model start
+// with costs learned by earlier ones. The costs are only valid for the build of onnxruntime that wrote them.
+// The default is "", which keeps the costs in memory only.
+static const char* const kOrtSessionOptionsConfigIntraOpLoopCostsFile = "session.intra_op_loop_costs_file";
+
+// Share of the global intra-op thread pool given to the session, for sessions that use the thread pools of an env
+// created with CreateEnvWithGlobalThreadPools. When parallel loops of several such sessions run at the same time,
+// each loop is offered the threads in proportion to the share of its session, e.g. a latency critical session with
+// share "8" running next to a batch session with share "1" gets 8/9 of the threads. Sessions that set neither this
+// nor kOrtSessionOptionsConfigThreadPoolMaxParallelism use the global pool directly and don't take part.
+// The default is "1".
+static const char* const kOrtSessionOptionsConfigThreadPoolShare = "session.thread_pool_share";
+
+// Maximum degree of parallelism of the parallel loops of a session that uses the global intra-op thread pool,
+// see kOrtSessionOptionsConfigThreadPoolShare. The default is "0", which allows all the threads of the pool.
+static const char* const kOrtSessionOptionsConfigThreadPoolMaxParallelism = "session.thread_pool_max_parallelism";
+
+// If the value is "1", the session keeps latency statistics of every node: the number of calls, the total and
+// longest latency, a histogram of the latencies in power of two buckets and the bytes of the output tensors.
+// Unlike profiling, updating them neither allocates nor takes locks, so they can be left on in production and read
+// at any time with SessionGetNodeStats. The default is "0".
+static const char* const kOrtSessionOptionsConfigNodeStats = "session.node_stats";
+
+// If the value is "1", every run of the session records the allocations and frees of the tensors of the main graph,
+// with whether they were placed in the memory pattern or allocated dynamically. The highest peak of the live tensor
+// bytes of every memory location and the largest tensors at that peak are returned by SessionGetMemoryStats, and
+// when profiling is enabled the timeline is added to the profile as counter events. The default is "0".
+static const char* const kOrtSessionOptionsConfigMemoryProfile = "session.memory_profile";
+
+// If the value is "1", runs of a model that only uses the CPU execution provider and whose node outputs all have
+// static tensor shapes replay the kernels of the execution plan directly. The first run that can be replayed keeps
+// its execution frame, so the intermediate tensors stay allocated between runs, and later runs with the same input
+// shapes and outputs only rebind the inputs and call Compute on each kernel. Runs with other input shapes,
+// concurrent runs, and runs with profiling, only_execute_path_to_fetches or parallel execution are executed
+// normally. The default is "0".
+static const char* const kOrtSessionOptionsConfigKernelReplay = "session.kernel_replay";
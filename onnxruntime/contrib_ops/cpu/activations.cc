@@ -5,6 +5,20 @@
 #include "activations.h"
 
 namespace onnxruntime {
+namespace functors {
+
+template <>
+void ParametricSoftplus<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  ConstEigenVectorArrayMap<float> xm(input + first, len);
+  EigenVectorArrayMap<float> ym(output_ptr, len);
+  ym = xm * beta;
+  MlasComputeSoftplus(output_ptr, output_ptr, static_cast<size_t>(len));
+  ym *= alpha;
+}
+}  // namespace functors
+
 namespace contrib {
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -46,6 +46,9 @@ struct ParametricSoftplus : public ElementWiseRangedTransform<T> {
              .select(xm * (T)beta + ((-xm * (T)beta).exp() + 1.0f).log(), ((xm * (T)beta).exp() + 1.0f).log());
   }
 };
+
+template <>
+void ParametricSoftplus<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
 }  // namespace functors
 
 namespace contrib {
@@ -77,16 +80,7 @@ class Gelu : public OpKernel {
           T* p_output = output_data + start;
           int64_t count = std::min(length_per_task, elem_count - start);
 
-          for (int64_t i = 0; i < count; i++) {
-            T value = p_input[i];
-            p_output[i] = value * static_cast<T>(M_SQRT1_2);
-          }
-
-          MlasComputeErf(p_output, p_output, count);
-
-          for (int64_t i = 0; i < count; i++) {
-            p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
-          }
+          MlasComputeGelu(p_input, nullptr, p_output, static_cast<size_t>(count), MlasComputeModeAccurate);
         },
         0);
     return Status::OK();
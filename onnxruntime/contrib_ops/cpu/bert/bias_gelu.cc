@@ -23,9 +23,11 @@ ONNX_OPERATOR_KERNEL_EX(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     BiasGelu<float, false>);
 
-// FastGelu uses approximation for Gelu. The formula is 0.5 * (1 + Tanh(x * (C * x * x + B))) * x.
-static constexpr float B = 0.7978845608028654f;    // sqrt(2.0 / M_PI)
-static constexpr float C = 0.035677408136300125f;  // 0.044715 * sqrt(2.0 / M_PI)
+// FastGelu uses approximation for Gelu. The formula is 0.5 * (1 + Tanh(x * (C * x * x + B))) * x,
+// which is implemented by the fast compute mode of MlasComputeGelu.
+static constexpr MLAS_COMPUTE_MODE kGeluComputeMode(bool use_approximation) {
+  return use_approximation ? MlasComputeModeFast : MlasComputeModeAccurate;
+}
 
 template <typename T, bool use_approximation>
 Status BiasGelu<T, use_approximation>::Compute(OpKernelContext* context) const {
@@ -55,16 +57,8 @@ Status BiasGelu<T, use_approximation>::Compute(OpKernelContext* context) const {
             T* p_output = output_data + start;
             int64_t count = std::min(length_per_task, elem_count - start);
 
-            for (int64_t i = 0; i < count; i++) {
-              T value = p_input[i];
-              p_output[i] = value * (static_cast<T>(C) * value * value + static_cast<T>(B));
-            }
-
-            MlasComputeTanh(p_output, p_output, count);
-
-            for (int64_t i = 0; i < count; i++) {
-              p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
-            }
+            MlasComputeGelu(p_input, nullptr, p_output, static_cast<size_t>(count),
+                            kGeluComputeMode(use_approximation));
           },
           0);
     }
@@ -74,12 +68,6 @@ Status BiasGelu<T, use_approximation>::Compute(OpKernelContext* context) const {
   const T* bias_data = bias->template Data<T>();
   int64_t bias_len = bias->Shape().Size();
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-  BufferUniquePtr buffer = BufferUniquePtr(alloc->Alloc(SafeInt<size_t>(sizeof(T)) * elem_count),
-                                           BufferDeleter(alloc));
-  T* tmp_data = static_cast<T*>(buffer.get());
-
   int64_t task_count = elem_count / bias_len;
 
   concurrency::ThreadPool::TryBatchParallelFor(
@@ -87,45 +75,15 @@ Status BiasGelu<T, use_approximation>::Compute(OpKernelContext* context) const {
       [&](ptrdiff_t task_idx) {
         const T* p_input = input_data + task_idx * bias_len;
         T* p_output = output_data + task_idx * bias_len;
-        T* p_tmp = tmp_data + task_idx * bias_len;
 
-        AddBiasGelu(p_input, bias_data, p_tmp, p_output, bias_len);
+        MlasComputeGelu(p_input, bias_data, p_output, static_cast<size_t>(bias_len),
+                        kGeluComputeMode(use_approximation));
       },
       0);
 
   return Status::OK();
 }
 
-template <typename T, bool use_approximation>
-void BiasGelu<T, use_approximation>::AddBiasGelu(
-    const T* input, const T* bias, T* temp, T* output, int64_t count) const {
-  if (use_approximation) {
-    for (int64_t i = 0; i < count; i++) {
-      T value = input[i] + bias[i];
-      output[i] = value * (static_cast<T>(C) * value * value + static_cast<T>(B));
-      temp[i] = value * 0.5f;
-    }
-
-    MlasComputeTanh(output, output, count);
-
-    for (int64_t i = 0; i < count; i++) {
-      output[i] = temp[i] * (output[i] + 1.0f);
-    }
-  } else {  // BiasGelu
-    for (int64_t i = 0; i < count; i++) {
-      T value = input[i] + bias[i];
-      output[i] = value * static_cast<T>(M_SQRT1_2);
-      temp[i] = value * 0.5f;
-    }
-
-    MlasComputeErf(output, output, count);
-
-    for (int64_t i = 0; i < count; i++) {
-      output[i] = temp[i] * (output[i] + 1.0f);
-    }
-  }
-}
-
 // Instantiation for BiasGelu
 template class BiasGelu<float, false>;
 
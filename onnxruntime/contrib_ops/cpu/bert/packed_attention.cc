@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention_base.h"
+#include "attention_helper.h"
+#include "core/util/math.h"
+#include "core/util/math_cpuonly.h"
+#include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class PackedAttention : public OpKernel, public AttentionBase {
+ public:
+  explicit PackedAttention(const OpKernelInfo& info) : OpKernel(info), AttentionBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+ private:
+  Status CheckInputs(const TensorShape& input_shape,
+                     const TensorShape& weights_shape,
+                     const TensorShape& bias_shape,
+                     const Tensor* cumulative_sequence_length) const;
+
+  BufferUniquePtr packed_weights_;
+  size_t packed_weights_size_;
+  TensorShape weight_shape_;
+};
+
+// These ops are internal-only, so register outside of onnx
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    PackedAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
+    PackedAttention<float>);
+
+template <typename T>
+Status PackedAttention<T>::CheckInputs(const TensorShape& input_shape,
+                                       const TensorShape& weights_shape,
+                                       const TensorShape& bias_shape,
+                                       const Tensor* cumulative_sequence_length) const {
+  // Input shapes:
+  //   input                      : (1, total_token_count, hidden_size)
+  //   weights                    : (hidden_size, 3 * hidden_size)
+  //   bias                       : (3 * hidden_size)
+  //   cumulative_sequence_length : (batch_size + 1)
+
+  const auto& dims = input_shape.GetDims();
+  if (dims.size() != 3 || dims[0] != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'input' is expected to have shape (1, total_token_count, hidden_size), got ",
+                           input_shape);
+  }
+  if (dims[2] % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 dimension 2 should be divisiable by value of the num_heads attribute.");
+  }
+
+  const auto& weights_dims = weights_shape.GetDims();
+  if (weights_dims.size() != 2 || weights_dims[0] != dims[2] || weights_dims[1] != 3 * weights_dims[0]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'weights' is expected to have shape (hidden_size, 3 * hidden_size), got ",
+                           weights_shape);
+  }
+
+  const auto& bias_dims = bias_shape.GetDims();
+  if (bias_dims.size() != 1 || bias_dims[0] != weights_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' is expected to have shape (3 * hidden_size), got ", bias_shape);
+  }
+
+  const auto& cumulative_dims = cumulative_sequence_length->Shape().GetDims();
+  if (cumulative_dims.size() != 1 || cumulative_dims[0] < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' is expected to have shape (batch_size + 1), got ",
+                           cumulative_sequence_length->Shape());
+  }
+
+  const int32_t* cumulative_data = cumulative_sequence_length->template Data<int32_t>();
+  const int64_t batch_size = cumulative_dims[0] - 1;
+  if (cumulative_data[0] != 0 || cumulative_data[batch_size] != dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' shall start at 0 and end at total_token_count");
+  }
+  for (int64_t b = 0; b < batch_size; b++) {
+    if (cumulative_data[b + 1] < cumulative_data[b]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'cumulative_sequence_length' shall not be decreasing");
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+Status PackedAttention<T>::PrePack(const Tensor& weights, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (1 != input_idx) {
+    return Status::OK();
+  }
+
+  weight_shape_ = weights.Shape();
+  const auto& weights_dims = weight_shape_.GetDims();
+  if (weights_dims.size() != 2) {
+    return Status::OK();
+  }
+
+  const size_t hidden_size = static_cast<size_t>(weights_dims[0]);
+  const size_t hidden_size_x3 = static_cast<size_t>(weights_dims[1]);
+  const size_t head_size = hidden_size / num_heads_;
+
+  // Bail out if the weights shape has an expected shape.
+  if ((hidden_size == 0) || ((hidden_size % num_heads_) != 0) || (hidden_size_x3 != 3 * hidden_size)) {
+    return Status::OK();
+  }
+
+  const auto* weights_data = weights.Data<T>();
+
+  packed_weights_size_ = MlasGemmPackBSize(head_size, hidden_size);
+  if (packed_weights_size_ == 0) {
+    return Status::OK();
+  }
+
+  const size_t loop_len = 3 * num_heads_;
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_weights_data = static_cast<uint8_t*>(alloc->Alloc(packed_weights_size_ * loop_len));
+  packed_weights_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
+
+  for (size_t i = 0; i < loop_len; i++) {
+    MlasGemmPackB(CblasNoTrans, head_size, hidden_size, weights_data, hidden_size_x3, packed_weights_data);
+    packed_weights_data += packed_weights_size_;
+    weights_data += head_size;
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+template <typename T>
+Status PackedAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = packed_weights_ ? nullptr : context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(3);
+
+  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
+                                  packed_weights_ ? weight_shape_ : weights->Shape(),
+                                  bias->Shape(),
+                                  cumulative_sequence_length));
+
+  const auto& shape = input->Shape().GetDims();
+  const int token_count = static_cast<int>(shape[1]);
+  const int hidden_size = static_cast<int>(shape[2]);
+  const int head_size = hidden_size / num_heads_;
+  const int batch_size = static_cast<int>(cumulative_sequence_length->Shape()[0]) - 1;
+  const int32_t* cumulative_data = cumulative_sequence_length->template Data<int32_t>();
+
+  Tensor* output = context->Output(0, shape);
+  if (token_count == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  // Compute Q, K, V for the real tokens only. Each head is stored as a TxH block so that the rows of a sequence
+  // are contiguous within the block.
+  // gemm_data(3, N, T, H) = input(T, NH) x weights(NH, 3NH) + bias(3NH)
+  const size_t qkv_size = SafeInt<size_t>(token_count) * hidden_size;
+  auto gemm_data = allocator->Alloc(SafeInt<size_t>(qkv_size) * 3 * sizeof(T));
+  BufferUniquePtr gemm_buffer(gemm_data, BufferDeleter(allocator));
+
+  auto Q = reinterpret_cast<T*>(gemm_data);
+  auto K = Q + qkv_size;
+  auto V = K + qkv_size;
+  T* QKV[3] = {Q, K, V};
+
+  {
+    const int loop_len = 3 * num_heads_;
+    const auto* input_data = input->template Data<T>();
+    const auto* weights_data = packed_weights_ ? nullptr : weights->template Data<T>();
+    const auto* bias_data = bias->template Data<T>();
+
+    const double cost =
+        static_cast<double>(token_count) * static_cast<double>(head_size) * static_cast<double>(hidden_size);
+    ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int head_index = static_cast<int>(i / 3);
+        const int qkv_index = static_cast<int>(i % 3);
+
+        int weights_offset = qkv_index * hidden_size + head_index * head_size;
+        T* qkv_dest = QKV[qkv_index] + static_cast<size_t>(head_index) * token_count * head_size;
+
+        // broadcast 3NH -> (3.N.)T.H
+        const T* broadcast_data_src = bias_data + weights_offset;
+        T* broadcast_data_dest = qkv_dest;
+        for (int token_index = 0; token_index < token_count; token_index++) {
+          memcpy(broadcast_data_dest, broadcast_data_src, head_size * sizeof(T));
+          broadcast_data_dest += head_size;
+        }
+
+        if (packed_weights_) {
+          const auto* packed_weight =
+              static_cast<const uint8_t*>(packed_weights_.get()) + packed_weights_size_ * (weights_offset / head_size);
+          MlasGemm(
+              CblasNoTrans,   // TransA = no
+              token_count,    // M      = T
+              head_size,      // N      = H
+              hidden_size,    // K      = NH
+              1.0f,           // alpha
+              input_data,     // A
+              hidden_size,    // lda    = NH
+              packed_weight,  // B
+              1.0f,           // beta
+              qkv_dest,       // C
+              head_size,      // ldc
+              nullptr);       // use single-thread
+        } else {
+          math::GemmEx<float, ThreadPool>(CblasNoTrans,                   // TransA = no
+                                          CblasNoTrans,                   // TransB = no
+                                          token_count,                    // M      = T
+                                          head_size,                      // N      = H
+                                          hidden_size,                    // K      = NH
+                                          1.0f,                           // alpha
+                                          input_data,                     // A
+                                          hidden_size,                    // lda    = NH
+                                          weights_data + weights_offset,  // B
+                                          3 * hidden_size,                // ldb    = 3NH
+                                          1.0f,                           // beta
+                                          qkv_dest,                       // C
+                                          head_size,                      // ldc
+                                          nullptr                         // use single-thread
+          );
+        }
+      }
+    });
+  }
+
+  // Compute the attention of each sequence and head with its own LxL block of attention probs.
+  std::vector<size_t> probs_offsets(batch_size + 1);
+  int max_sequence_length = 0;
+  probs_offsets[0] = 0;
+  for (int b = 0; b < batch_size; b++) {
+    const int sequence_length = cumulative_data[b + 1] - cumulative_data[b];
+    max_sequence_length = std::max(max_sequence_length, sequence_length);
+    probs_offsets[b + 1] = probs_offsets[b] + SafeInt<size_t>(sequence_length) * sequence_length * num_heads_;
+  }
+
+  auto attention_probs = allocator->Alloc(SafeInt<size_t>(probs_offsets[batch_size]) * sizeof(T));
+  BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
+  {
+    const int loop_len = batch_size * num_heads_;
+    const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+    T* output_data = output->template MutableData<T>();
+
+    const double cost = static_cast<double>(max_sequence_length) * static_cast<double>(max_sequence_length) *
+                        static_cast<double>(head_size) * 2.0;
+
+    ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        const int sequence_start = cumulative_data[batch_index];
+        const int sequence_length = cumulative_data[batch_index + 1] - sequence_start;
+        if (sequence_length == 0) {
+          continue;
+        }
+
+        const size_t head_offset = (static_cast<size_t>(head_index) * token_count + sequence_start) * head_size;
+        T* probs = reinterpret_cast<T*>(attention_probs) + probs_offsets[batch_index] +
+                   static_cast<size_t>(head_index) * sequence_length * sequence_length;
+
+        // attention_probs(L, L) = 1/sqrt(H) x Q(L, H) x K'(H, L)
+        math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, sequence_length, head_size, alpha,
+                                  Q + head_offset, K + head_offset, 0.0f, probs, nullptr);
+
+        // Apply the same additive mask as the dense Attention so that the results of both match.
+        if (is_unidirectional_) {
+          for (int s_i = 0; s_i < sequence_length - 1; s_i++) {
+            for (int m_i = s_i + 1; m_i < sequence_length; m_i++) {
+              probs[s_i * sequence_length + m_i] += static_cast<T>(-10000.0f);
+            }
+          }
+        }
+
+        ComputeAttentionSoftmaxInplace(probs, sequence_length, sequence_length, nullptr);
+
+        // output(L, N.H) = attention_probs(L, L) x V(L, H)
+        math::GemmEx<float, ThreadPool>(CblasNoTrans,                                        // TransA = no
+                                        CblasNoTrans,                                        // TransB = no
+                                        sequence_length,                                     // M      = L
+                                        head_size,                                           // N      = H
+                                        sequence_length,                                     // K      = L
+                                        1.0f,                                                // alpha
+                                        probs,                                               // A
+                                        sequence_length,                                     // lda    = L
+                                        V + head_offset,                                     // B
+                                        head_size,                                           // ldb    = H
+                                        0.0f,                                                // beta
+                                        output_data + static_cast<size_t>(sequence_start) * hidden_size +
+                                            head_index * head_size,                          // C
+                                        hidden_size,                                         // ldc    = NH
+                                        nullptr                                              // use single-thread
+        );
+      }
+    });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
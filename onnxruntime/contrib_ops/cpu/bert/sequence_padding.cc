@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/common.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class RemovePadding : public OpKernel {
+ public:
+  explicit RemovePadding(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+template <typename T>
+class RestorePadding : public OpKernel {
+ public:
+  explicit RestorePadding(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+// These ops are internal-only, so register outside of onnx
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    RemovePadding,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
+    RemovePadding<float>);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    RestorePadding,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
+    RestorePadding<float>);
+
+template <typename T>
+Status RemovePadding<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* mask_index = context->Input<Tensor>(1);
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' is expected to have 3 dimensions, got ",
+                           input_dims.size());
+  }
+
+  const int64_t batch_size = input_dims[0];
+  const int64_t sequence_length = input_dims[1];
+  const int64_t hidden_size = input_dims[2];
+
+  const auto& mask_dims = mask_index->Shape().GetDims();
+  const bool is_raw_mask = mask_dims.size() == 2;
+  if (!(mask_dims.size() == 1 && mask_dims[0] == batch_size) &&
+      !(is_raw_mask && mask_dims[0] == batch_size && mask_dims[1] == sequence_length)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'mask_index' is expected to have shape (batch_size) or (batch_size, sequence_length), got ",
+                           mask_index->Shape());
+  }
+
+  const int32_t* mask_index_data = mask_index->template Data<int32_t>();
+
+  Tensor* token_offset = context->Output(1, {batch_size, sequence_length});
+  Tensor* cumulative_sequence_length = context->Output(2, {batch_size + 1});
+
+  int32_t* token_offset_data = token_offset->template MutableData<int32_t>();
+
+  // A token is real when its raw mask value is not zero, which matches the masking of Attention. For a 1D mask
+  // index, the real tokens are the leading tokens, and the counts are clamped to the sequence length.
+  std::vector<int32_t> cumulative(static_cast<size_t>(batch_size) + 1);
+  int32_t total_token_count = 0;
+  for (int64_t b = 0; b < batch_size; b++) {
+    cumulative[b] = total_token_count;
+    int32_t* offsets = token_offset_data + b * sequence_length;
+    if (is_raw_mask) {
+      const int32_t* mask = mask_index_data + b * sequence_length;
+      for (int64_t s = 0; s < sequence_length; s++) {
+        offsets[s] = mask[s] != 0 ? total_token_count++ : -1;
+      }
+    } else {
+      const int64_t token_count = std::min<int64_t>(std::max<int32_t>(mask_index_data[b], 0), sequence_length);
+      for (int64_t s = 0; s < token_count; s++) {
+        offsets[s] = total_token_count++;
+      }
+      std::fill(offsets + token_count, offsets + sequence_length, -1);
+    }
+  }
+  cumulative[batch_size] = total_token_count;
+
+  Tensor* output = context->Output(0, {1, total_token_count, hidden_size});
+
+  const T* input_data = input->template Data<T>();
+  T* output_data = output->template MutableData<T>();
+
+  const int64_t token_count = batch_size * sequence_length;
+  for (int64_t i = 0; i < token_count; i++) {
+    const int32_t offset = token_offset_data[i];
+    if (offset >= 0) {
+      memcpy(output_data + SafeInt<size_t>(offset) * hidden_size,
+             input_data + SafeInt<size_t>(i) * hidden_size,
+             SafeInt<size_t>(hidden_size) * sizeof(T));
+    }
+  }
+
+  if (cumulative_sequence_length != nullptr) {
+    memcpy(cumulative_sequence_length->template MutableData<int32_t>(), cumulative.data(),
+           cumulative.size() * sizeof(int32_t));
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+Status RestorePadding<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* token_offset = context->Input<Tensor>(1);
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 3 || input_dims[0] != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'input' is expected to have shape (1, total_token_count, hidden_size), got ",
+                           input->Shape());
+  }
+
+  const auto& token_offset_dims = token_offset->Shape().GetDims();
+  if (token_offset_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'token_offset' is expected to have 2 dimensions, got ", token_offset_dims.size());
+  }
+
+  const int64_t total_token_count = input_dims[1];
+  const int64_t hidden_size = input_dims[2];
+
+  Tensor* output = context->Output(0, {token_offset_dims[0], token_offset_dims[1], hidden_size});
+
+  const T* input_data = input->template Data<T>();
+  const int32_t* token_offset_data = token_offset->template Data<int32_t>();
+  T* output_data = output->template MutableData<T>();
+
+  const std::ptrdiff_t token_count = static_cast<std::ptrdiff_t>(token_offset_dims[0] * token_offset_dims[1]);
+  std::atomic_bool failed{false};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), token_count, static_cast<double>(hidden_size),
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          T* y = output_data + i * hidden_size;
+          const int32_t offset = token_offset_data[i];
+          if (offset < 0) {
+            std::fill_n(y, hidden_size, static_cast<T>(0));
+          } else if (offset < total_token_count) {
+            memcpy(y, input_data + static_cast<size_t>(offset) * hidden_size, hidden_size * sizeof(T));
+          } else {
+            failed.store(true, std::memory_order_release);
+          }
+        }
+      });
+
+  if (failed.load(std::memory_order_acquire)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'token_offset' has an offset out of range");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -5,8 +5,10 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -31,9 +33,106 @@ namespace contrib {
       KernelDefBuilder()                                          \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       LayerNorm<T, true>);
-  
+
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+// The mean and inverse standard deviation outputs are float for half inputs.
+template <typename T>
+struct LayerNormStatisticsType {
+  using type = T;
+};
+
+template <>
+struct LayerNormStatisticsType<MLFloat16> {
+  using type = float;
+};
+
+template <bool simplified>
+void ComputeLayerNorm(const double* X_data, const double* scale_data, const double* bias_data, double* Y_data,
+                      double* mean_data, double* inv_std_var_data, int64_t norm_count, int64_t norm_size,
+                      float epsilon, concurrency::ThreadPool* thread_pool, AllocatorPtr /*alloc*/) {
+  concurrency::ThreadPool::TryBatchParallelFor(thread_pool, static_cast<int32_t>(norm_count),
+                                               [&](ptrdiff_t task_idx) {
+                                                 const double* p_input = X_data + task_idx * norm_size;
+                                                 double* p_output = Y_data + task_idx * norm_size;
+
+                                                 double mean = 0;
+                                                 double mean_square = 0;
+
+                                                 for (int64_t h = 0; h < norm_size; h++) {
+                                                   mean += p_input[h];
+                                                   mean_square += p_input[h] * p_input[h];
+                                                 }
+
+                                                 mean = mean / norm_size;
+                                                 if (simplified) {
+                                                   mean_square = sqrt(mean_square / norm_size + epsilon);
+                                                 } else {
+                                                   mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+                                                 }
+
+                                                 for (int64_t h = 0; h < norm_size; h++) {
+                                                   if (simplified) {
+                                                     p_output[h] = p_input[h] / mean_square * scale_data[h];
+                                                   } else {
+                                                     p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+                                                   }
+                                                 }
+
+                                                 if (mean_data != nullptr) {
+                                                   mean_data[task_idx] = mean;
+                                                 }
+                                                 inv_std_var_data[task_idx] = 1 / mean_square;
+                                               }, 0);
+}
+
+template <bool simplified>
+void ComputeLayerNorm(const float* X_data, const float* scale_data, const float* bias_data, float* Y_data,
+                      float* mean_data, float* inv_std_var_data, int64_t norm_count, int64_t norm_size,
+                      float epsilon, concurrency::ThreadPool* thread_pool, AllocatorPtr /*alloc*/) {
+  MlasComputeLayerNormalization(X_data, nullptr, nullptr, scale_data, bias_data, Y_data, mean_data, inv_std_var_data,
+                                static_cast<size_t>(norm_count), static_cast<size_t>(norm_size), epsilon, simplified,
+                                thread_pool);
+}
+
+template <bool simplified>
+void ComputeLayerNorm(const MLFloat16* X_data, const MLFloat16* scale_data, const MLFloat16* bias_data,
+                      MLFloat16* Y_data, float* mean_data, float* inv_std_var_data, int64_t norm_count,
+                      int64_t norm_size, float epsilon, concurrency::ThreadPool* thread_pool, AllocatorPtr alloc) {
+  // Convert the input and parameters to float and normalize in place in the float buffer.
+  const size_t element_count = SafeInt<size_t>(norm_count) * norm_size;
+  const size_t param_count = (simplified ? 1 : 2) * static_cast<size_t>(norm_size);
+
+  auto float_data_buf = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * (element_count + param_count));
+  BufferUniquePtr float_data_buf_ptr(float_data_buf, BufferDeleter(alloc));
+  float* float_data = static_cast<float*>(float_data_buf_ptr.get());
+  float* float_scale = float_data + element_count;
+  float* float_bias = simplified ? nullptr : float_scale + norm_size;
+
+  for (size_t i = 0; i < element_count; i++) {
+    float_data[i] = math::halfToFloat(X_data[i].val);
+  }
+  for (int64_t h = 0; h < norm_size; h++) {
+    float_scale[h] = math::halfToFloat(scale_data[h].val);
+    if (!simplified) {
+      float_bias[h] = math::halfToFloat(bias_data[h].val);
+    }
+  }
+
+  MlasComputeLayerNormalization(float_data, nullptr, nullptr, float_scale, float_bias, float_data, mean_data,
+                                inv_std_var_data, static_cast<size_t>(norm_count), static_cast<size_t>(norm_size),
+                                epsilon, simplified, thread_pool);
+
+  for (size_t i = 0; i < element_count; i++) {
+    Y_data[i] = MLFloat16(math::floatToHalf(float_data[i]));
+  }
+}
+
+}  // namespace
 
 template <typename T, bool simplified>
 LayerNorm<T, simplified>::LayerNorm(const OpKernelInfo& op_kernel_info)
@@ -73,67 +172,33 @@ Status LayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
 
-  T* mean_data = nullptr;
-  BufferUniquePtr mean_data_buf_ptr;
+  using U = typename LayerNormStatisticsType<T>::type;
+
+  U* mean_data = nullptr;
 
   int output_index = 1;
 
   if (!simplified) {
     Tensor* mean = p_ctx->Output(output_index++, TensorShape(mean_inv_std_var_dim));
     if (mean != nullptr) {
-      mean_data = mean->template MutableData<T>();
-    } else {
-      auto mean_data_buf = alloc->Alloc(SafeInt<size_t>(sizeof(T)) * norm_count);
-      mean_data_buf_ptr = BufferUniquePtr(mean_data_buf, BufferDeleter(alloc));
-      mean_data = static_cast<T*>(mean_data_buf_ptr.get());
+      mean_data = mean->template MutableData<U>();
     }
   }
 
-  T* inv_std_var_data = nullptr;
+  U* inv_std_var_data = nullptr;
   BufferUniquePtr inv_std_var_data_buf_ptr;
 
   Tensor* inv_std_var = p_ctx->Output(output_index, TensorShape(mean_inv_std_var_dim));
   if (inv_std_var != nullptr) {
-    inv_std_var_data = inv_std_var->template MutableData<T>();
+    inv_std_var_data = inv_std_var->template MutableData<U>();
   } else {
-    auto inv_std_var_data_buf = alloc->Alloc(SafeInt<size_t>(sizeof(T)) * norm_count);
+    auto inv_std_var_data_buf = alloc->Alloc(SafeInt<size_t>(sizeof(U)) * norm_count);
     inv_std_var_data_buf_ptr = BufferUniquePtr(inv_std_var_data_buf, BufferDeleter(alloc));
-    inv_std_var_data = static_cast<T*>(inv_std_var_data_buf_ptr.get());
+    inv_std_var_data = static_cast<U*>(inv_std_var_data_buf_ptr.get());
   }
 
-  concurrency::ThreadPool::TryBatchParallelFor(p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
-                                               [&](ptrdiff_t task_idx) {
-                                                 const T* p_input = X_data + task_idx * norm_size;
-                                                 T* p_output = Y_data + task_idx * norm_size;
-
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   mean += p_input[h];
-                                                   mean_square += p_input[h] * p_input[h];
-                                                 }
-
-                                                 mean = mean / norm_size;
-                                                 if (simplified) {
-                                                   mean_square = sqrt(mean_square / norm_size + epsilon_);
-                                                 } else {
-                                                   mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon_);
-                                                 }
-
-                                                 for (int64_t h = 0; h < norm_size; h++) {
-                                                   if (simplified) {
-                                                     p_output[h] = p_input[h] / mean_square * scale_data[h];
-                                                   } else {
-                                                     p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-                                                   }
-                                                 }
-
-                                                 if (mean_data != nullptr) {
-                                                   mean_data[task_idx] = mean;
-                                                 }
-                                                 inv_std_var_data[task_idx] = 1 / mean_square;
-                                               }, 0);
+  ComputeLayerNorm<simplified>(X_data, scale_data, bias_data, Y_data, mean_data, inv_std_var_data,
+                               norm_count, norm_size, epsilon_, p_ctx->GetOperatorThreadPool(), alloc);
 
   return Status::OK();
 }
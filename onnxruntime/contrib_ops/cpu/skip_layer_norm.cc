@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -23,6 +26,89 @@ namespace contrib {
 
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+void ComputeSkipLayerNorm(const double* input_data, const double* skip_data, const double* gamma_data,
+                          const double* beta_data, const double* bias_data, double* output_data,
+                          int64_t task_count, int64_t hidden_size, float epsilon,
+                          concurrency::ThreadPool* thread_pool, AllocatorPtr /*alloc*/) {
+  concurrency::ThreadPool::TryBatchParallelFor(thread_pool, static_cast<int32_t>(task_count),
+                                               [&](ptrdiff_t task_idx) {
+                                                 const double* p_input = input_data + task_idx * hidden_size;
+                                                 const double* p_skip = skip_data + task_idx * hidden_size;
+                                                 double* p_output = output_data + task_idx * hidden_size;
+
+                                                 double mean = 0;
+                                                 double mean_square = 0;
+
+                                                 for (int64_t h = 0; h < hidden_size; h++) {
+                                                   double value = p_input[h] + p_skip[h];
+                                                   if (nullptr != bias_data) {
+                                                     value += bias_data[h];
+                                                   }
+                                                   p_output[h] = value;
+                                                   mean += value;
+                                                   mean_square += value * value;
+                                                 }
+
+                                                 mean = mean / hidden_size;
+                                                 mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon);
+
+                                                 for (int64_t h = 0; h < hidden_size; h++) {
+                                                   p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+                                                 }
+                                               }, 0);
+}
+
+void ComputeSkipLayerNorm(const float* input_data, const float* skip_data, const float* gamma_data,
+                          const float* beta_data, const float* bias_data, float* output_data,
+                          int64_t task_count, int64_t hidden_size, float epsilon,
+                          concurrency::ThreadPool* thread_pool, AllocatorPtr /*alloc*/) {
+  MlasComputeLayerNormalization(input_data, skip_data, bias_data, gamma_data, beta_data, output_data,
+                                nullptr, nullptr, static_cast<size_t>(task_count), static_cast<size_t>(hidden_size),
+                                epsilon, false, thread_pool);
+}
+
+void ComputeSkipLayerNorm(const MLFloat16* input_data, const MLFloat16* skip_data, const MLFloat16* gamma_data,
+                          const MLFloat16* beta_data, const MLFloat16* bias_data, MLFloat16* output_data,
+                          int64_t task_count, int64_t hidden_size, float epsilon,
+                          concurrency::ThreadPool* thread_pool, AllocatorPtr alloc) {
+  // Convert the inputs to float. The input buffer is reused to receive the normalized output.
+  const size_t element_count = SafeInt<size_t>(task_count) * hidden_size;
+  const size_t param_count = 3 * static_cast<size_t>(hidden_size);
+
+  auto float_data_buf = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * (2 * element_count + param_count));
+  BufferUniquePtr float_data_buf_ptr(float_data_buf, BufferDeleter(alloc));
+  float* float_input = static_cast<float*>(float_data_buf_ptr.get());
+  float* float_skip = float_input + element_count;
+  float* float_gamma = float_skip + element_count;
+  float* float_beta = float_gamma + hidden_size;
+  float* float_bias = (bias_data != nullptr) ? float_beta + hidden_size : nullptr;
+
+  for (size_t i = 0; i < element_count; i++) {
+    float_input[i] = math::halfToFloat(input_data[i].val);
+    float_skip[i] = math::halfToFloat(skip_data[i].val);
+  }
+  for (int64_t h = 0; h < hidden_size; h++) {
+    float_gamma[h] = math::halfToFloat(gamma_data[h].val);
+    float_beta[h] = math::halfToFloat(beta_data[h].val);
+    if (float_bias != nullptr) {
+      float_bias[h] = math::halfToFloat(bias_data[h].val);
+    }
+  }
+
+  MlasComputeLayerNormalization(float_input, float_skip, float_bias, float_gamma, float_beta, float_input,
+                                nullptr, nullptr, static_cast<size_t>(task_count), static_cast<size_t>(hidden_size),
+                                epsilon, false, thread_pool);
+
+  for (size_t i = 0; i < element_count; i++) {
+    output_data[i] = MLFloat16(math::floatToHalf(float_input[i]));
+  }
+}
+
+}  // namespace
 
 template <typename T>
 SkipLayerNorm<T>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
@@ -96,32 +182,11 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
 
   T* output_data = output->MutableData<T>();
 
-  concurrency::ThreadPool::TryBatchParallelFor(p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
-                                               [&](ptrdiff_t task_idx) {
-                                                 const T* p_input = input_data + task_idx * hidden_size;
-                                                 const T* p_skip = skip_data + task_idx * hidden_size;
-                                                 T* p_output = output_data + task_idx * hidden_size;
-
-                                                 T mean = 0;
-                                                 T mean_square = 0;
-
-                                                 for (int64_t h = 0; h < hidden_size; h++) {
-                                                   T value = p_input[h] + p_skip[h];
-                                                   if (nullptr != bias_data) {
-                                                     value += bias_data[h];
-                                                   }
-                                                   p_output[h] = value;
-                                                   mean += value;
-                                                   mean_square += value * value;
-                                                 }
-
-                                                 mean = mean / hidden_size;
-                                                 mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
 
-                                                 for (int64_t h = 0; h < hidden_size; h++) {
-                                                   p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-                                                 }
-                                               }, 0);
+  ComputeSkipLayerNorm(input_data, skip_data, gamma_data, beta_data, bias_data, output_data,
+                       task_count, hidden_size, epsilon_, p_ctx->GetOperatorThreadPool(), alloc);
 
   return Status::OK();
 }
@@ -5,6 +5,7 @@
 #include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/string_tensor_builder.h"
 #include "re2/re2.h"
 
 namespace onnxruntime {
@@ -120,19 +121,16 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   // add padding and add start/end test separators if necessary
   size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  const size_t num_strings = N * C;
+  for (size_t i = 0; i < num_strings; ++i) {
+    const StringView s = X->StringAt(i);
     size_t tokens = 0;  // length in utf8 chars
     if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
                        tokens)) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+                    "Input string contains invalid utf8 chars: " + s.ToString());
     }
     max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -151,14 +149,11 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   output_dims.push_back(max_tokens);
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  StringTensorBuilder output(num_strings * max_tokens);
+  for (size_t i = 0; i < num_strings; ++i) {
+    const StringView s = X->StringAt(i);
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      output.Append(start_text);
     }
     size_t tokens = 0;
     const size_t str_len = s.size();
@@ -168,24 +163,21 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
       assert(result);
       (void)result;
       assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
+      output.Append(StringView(s.data() + token_idx, tlen));
       token_idx += tlen;
       ++tokens;
     }
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      output.Append(end_text);
     }
     // Padding strings
     assert(tokens + (mark_ * 2) <= max_tokens);
     const size_t pads = max_tokens - (mark_ * 2) - tokens;
     for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+      output.Append(pad_value_);
     }
-    ++curr_input;
   }
+  output.Build(*output_tensor);
   return Status::OK();
 }
 
@@ -193,8 +185,16 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                                                size_t N, size_t C,
                                                const std::vector<int64_t>& input_dims) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
+  // The tokens of all the rows are stored contiguously. The tokens of row r are
+  // in [row_offsets[r], row_offsets[r + 1]) so there is no allocation per row.
+  std::vector<StringPiece> all_tokens;
+  std::vector<size_t> row_offsets;
+  row_offsets.reserve(N * C + 1);
+  row_offsets.push_back(0);
+
+  // Tokens of the current row, re-used for every row and separator
+  std::vector<StringPiece> row;
+  std::vector<StringPiece> tokens;
 
   // We do not constraint the search to match
   // on the beginning or end of the string
@@ -204,22 +204,20 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   // collect all the output tokens here
   size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  const size_t num_strings = N * C;
+  for (size_t i = 0; i < num_strings; ++i) {
+    const StringView s = X->StringAt(i);
     size_t utf8_chars = 0;  // length in utf8 chars
     if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
                        utf8_chars)) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+                    "Input string contains invalid utf8 chars: " + s.ToString());
     }
 
-    std::vector<StringPiece> row{s};
+    row.assign(1, StringPiece(s.data(), s.size()));
 
     for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
+      tokens.clear();
       for (const auto& text : row) {
         const auto end_pos = text.length();
         size_t start_pos = 0;
@@ -270,8 +268,8 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
       row.swap(tokens);
     }  // separators_
     max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
+    all_tokens.insert(all_tokens.end(), row.cbegin(), row.cend());
+    row_offsets.push_back(all_tokens.size());
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -292,41 +290,27 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   TensorShape output_shape(output_dims);
 
   auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
+  StringTensorBuilder output(num_strings * max_tokens);
+  for (size_t r = 0; r + 1 < row_offsets.size(); ++r) {
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      output.Append(start_text);
     }
     // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
+    const size_t row_size = row_offsets[r + 1] - row_offsets[r];
+    for (size_t t = row_offsets[r]; t < row_offsets[r + 1]; ++t) {
+      const auto& token = all_tokens[t];
+      output.Append(StringView(token.data(), token.size()));
     }
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      output.Append(end_text);
     }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
+    const size_t pads = max_tokens - (mark_ * 2) - row_size;
     for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+      output.Append(pad_value_);
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
+    assert(output.NumStrings() == (r + 1) * max_tokens);
   }
+  output.Build(*output_tensor);
   return Status::OK();
 }
 
@@ -334,35 +318,32 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                                   size_t N, size_t C,
                                   const std::vector<int64_t>& input_dims) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
+  // The tokens of all the rows are stored contiguously. The tokens of row r are
+  // in [row_offsets[r], row_offsets[r + 1]) so there is no allocation per row.
+  std::vector<StringPiece> tokens;
+  std::vector<size_t> row_offsets;
+  row_offsets.reserve(N * C + 1);
+  row_offsets.push_back(0);
 
   size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
+  const size_t num_strings = N * C;
 
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  for (size_t i = 0; i < num_strings; ++i) {
+    const StringView s = X->StringAt(i);
 
     size_t utf8_chars = 0;
     if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
                        utf8_chars)) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+                    "Input string contains invalid utf8 chars: " + s.ToString());
     }
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
+    StringPiece text(s.data(), s.size());
     const auto end_pos = s.length();
     size_t start_pos = 0;
     StringPiece submatch;
@@ -384,7 +365,7 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                         "Match contains invalid utf8 chars: " + submatch.as_string());
         }
         if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
+          tokens.push_back(submatch);
           start_pos = match_pos + token_len;
         } else {
           size_t bytes = 0;
@@ -393,8 +374,8 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
         }
       }
     } while (match);
-    max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
+    max_tokens = std::max(max_tokens, tokens.size() - row_offsets.back());
+    row_offsets.push_back(tokens.size());
   }
 
   // Check for empty output
@@ -416,42 +397,27 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
   TensorShape output_shape(output_dims);
 
   auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
+  StringTensorBuilder output(num_strings * max_tokens);
+  for (size_t r = 0; r + 1 < row_offsets.size(); ++r) {
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      output.Append(start_text);
     }
     // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
+    const size_t row_size = row_offsets[r + 1] - row_offsets[r];
+    for (size_t t = row_offsets[r]; t < row_offsets[r + 1]; ++t) {
+      const auto& token = tokens[t];
+      output.Append(StringView(token.data(), token.length()));
     }
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      output.Append(end_text);
     }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
+    const size_t pads = max_tokens - (mark_ * 2) - row_size;
     for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+      output.Append(pad_value_);
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
+    assert(output.NumStrings() == (r + 1) * max_tokens);
   }
+  output.Build(*output_tensor);
 
   return Status::OK();
 }
@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/beam_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    BeamSearch,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    transformers::BeamSearch);
+
+namespace transformers {
+
+// Input indices of BeamSearch.
+static constexpr int kMinLengthInput = 2;
+static constexpr int kNumBeamsInput = 3;
+static constexpr int kNumReturnSequencesInput = 4;
+static constexpr int kTemperatureInput = 5;
+static constexpr int kLengthPenaltyInput = 6;
+static constexpr int kRepetitionPenaltyInput = 7;
+
+// Score of a running beam that has not started yet, so that only the first beam of each batch entry is expanded
+// after the prompt.
+static constexpr float kInactiveBeamScore = -1e9f;
+
+float BeamHypotheses::Score(float sum_logprobs, int length) const {
+  return sum_logprobs / std::pow(static_cast<float>(length), length_penalty_);
+}
+
+void BeamHypotheses::Add(std::vector<int32_t> sequence, int length, float sum_logprobs) {
+  const float score = Score(sum_logprobs, length);
+  if (static_cast<int>(beams_.size()) == num_beams_) {
+    auto worst = std::min_element(beams_.begin(), beams_.end(),
+                                  [](const std::pair<float, std::vector<int32_t>>& a,
+                                     const std::pair<float, std::vector<int32_t>>& b) { return a.first < b.first; });
+    if (score <= worst->first) {
+      return;
+    }
+    beams_.erase(worst);
+  }
+  beams_.emplace_back(score, std::move(sequence));
+}
+
+bool BeamHypotheses::IsDone(float best_sum_logprobs, int current_length) const {
+  if (static_cast<int>(beams_.size()) < num_beams_) {
+    return false;
+  }
+  if (early_stopping_) {
+    return true;
+  }
+
+  float worst_score = beams_.front().first;
+  for (const auto& beam : beams_) {
+    worst_score = std::min(worst_score, beam.first);
+  }
+  return worst_score >= Score(best_sum_logprobs, current_length);
+}
+
+std::vector<std::pair<float, std::vector<int32_t>>> BeamHypotheses::Sorted() const {
+  auto sorted = beams_;
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const std::pair<float, std::vector<int32_t>>& a,
+                      const std::pair<float, std::vector<int32_t>>& b) { return a.first > b.first; });
+  return sorted;
+}
+
+BeamSearch::BeamSearch(const OpKernelInfo& info) : GenerationBase(info) {
+  early_stopping_ = info.GetAttrOrDefault<int64_t>("early_stopping", 0) != 0;
+}
+
+Status BeamSearch::Compute(OpKernelContext* context) const {
+  int max_length;
+  ORT_RETURN_IF_ERROR(CheckInputs(context, max_length));
+
+  LogitsProcessorOptions options;
+  options.eos_token_id = eos_token_id_;
+  options.no_repeat_ngram_size = no_repeat_ngram_size_;
+  ORT_RETURN_IF_ERROR(options.Initialize(context, kMinLengthInput, kTemperatureInput, kRepetitionPenaltyInput));
+
+  int32_t num_beams = 0;
+  int32_t num_return_sequences = 1;
+  float length_penalty = 1.0f;
+  ORT_RETURN_IF_ERROR(ReadScalarInput<int32_t>(context, kNumBeamsInput, num_beams));
+  ORT_RETURN_IF_ERROR(ReadScalarInput<int32_t>(context, kNumReturnSequencesInput, num_return_sequences));
+  ORT_RETURN_IF_ERROR(ReadScalarInput<float>(context, kLengthPenaltyInput, length_penalty));
+  if (num_beams < 1 || num_return_sequences < 1 || num_return_sequences > num_beams) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "num_beams should be positive and num_return_sequences should be in [1, num_beams]. Got ",
+                           num_beams, " and ", num_return_sequences);
+  }
+
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const int64_t batch_size = input_ids->Shape()[0];
+  const int sequence_length = static_cast<int>(input_ids->Shape()[1]);
+  const int64_t row_count = batch_size * num_beams;
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  // The running beams, with max_length tokens per row. All the beams of a batch entry start with its prompt.
+  std::vector<int32_t> sequences(static_cast<size_t>(row_count * max_length), pad_token_id_);
+  std::vector<int32_t> next_sequences(sequences.size(), pad_token_id_);
+  const int32_t* input_ids_data = input_ids->Data<int32_t>();
+  for (int64_t r = 0; r < row_count; r++) {
+    std::copy_n(input_ids_data + (r / num_beams) * sequence_length, sequence_length, sequences.data() + r * max_length);
+  }
+
+  std::vector<float> beam_scores(static_cast<size_t>(row_count));
+  for (int64_t r = 0; r < row_count; r++) {
+    beam_scores[r] = r % num_beams == 0 ? 0.0f : kInactiveBeamScore;
+  }
+
+  std::vector<BeamHypotheses> hypotheses(static_cast<size_t>(batch_size),
+                                         BeamHypotheses(num_beams, length_penalty, early_stopping_));
+  std::vector<bool> done(static_cast<size_t>(batch_size), false);
+
+  // The prompt is only run once for each batch entry, and its past state is expanded to the beams after the first
+  // step.
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  std::vector<OrtValue> feeds;
+  std::vector<OrtValue> fetches;
+  std::vector<int32_t> next_positions;
+  ORT_RETURN_IF_ERROR(gpt_subgraph_->CreateInitialFeeds(*input_ids, pad_token_id_, ctx_internal->GetImplicitInputs(),
+                                                        allocator, feeds, next_positions));
+
+  std::vector<float> next_scores;
+  std::vector<int32_t> next_tokens(static_cast<size_t>(row_count));
+  std::vector<float> next_beam_scores(static_cast<size_t>(row_count));
+  std::vector<int32_t> source_rows(static_cast<size_t>(row_count));
+  std::vector<int32_t> candidates;
+  auto* tp = context->GetOperatorThreadPool();
+
+  bool first_step = true;
+  int current_length = sequence_length;
+  while (current_length < max_length) {
+    int64_t vocab_size;
+    ORT_RETURN_IF_ERROR(RunDecoder(context, feeds, fetches, first_step ? batch_size : row_count, vocab_size));
+
+    // The scores of the beams extended by each token are the log probabilities of the sequences.
+    next_scores.resize(static_cast<size_t>(row_count * vocab_size));
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(row_count), static_cast<double>(vocab_size * 8),
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          std::vector<float> logits(static_cast<size_t>(vocab_size));
+          for (std::ptrdiff_t r = begin; r != end; ++r) {
+            std::copy_n(GetNextTokenLogits(fetches, first_step ? r / num_beams : r), vocab_size, logits.data());
+            ProcessLogits(options,
+                          gsl::make_span(sequences.data() + r * max_length, static_cast<size_t>(current_length)),
+                          gsl::make_span(logits));
+
+            float* scores = next_scores.data() + r * vocab_size;
+            MlasComputeSoftmax(logits.data(), scores, 1, static_cast<size_t>(vocab_size), true, nullptr);
+            for (int64_t v = 0; v < vocab_size; v++) {
+              scores[v] += beam_scores[r];
+            }
+          }
+        });
+
+    const int64_t batch_vocab_size = num_beams * vocab_size;
+    const int64_t candidate_count = std::min<int64_t>(2 * num_beams, batch_vocab_size);
+    candidates.resize(static_cast<size_t>(batch_vocab_size));
+
+    bool all_done = true;
+    for (int64_t b = 0; b < batch_size; b++) {
+      const int64_t first_row = b * num_beams;
+
+      if (done[b]) {
+        for (int64_t k = 0; k < num_beams; k++) {
+          next_tokens[first_row + k] = pad_token_id_;
+          next_beam_scores[first_row + k] = 0.0f;
+          source_rows[first_row + k] = static_cast<int32_t>(first_row);
+        }
+        continue;
+      }
+
+      // Twice as many candidates as beams are enough to find num_beams candidates that do not end the sequence.
+      const float* batch_scores = next_scores.data() + first_row * vocab_size;
+      std::iota(candidates.begin(), candidates.end(), 0);
+      auto by_score = [batch_scores](int32_t a, int32_t b) { return batch_scores[a] > batch_scores[b]; };
+      std::nth_element(candidates.begin(), candidates.begin() + (candidate_count - 1), candidates.end(), by_score);
+      std::sort(candidates.begin(), candidates.begin() + candidate_count, by_score);
+
+      int64_t beam = 0;
+      for (int64_t rank = 0; rank < candidate_count && beam < num_beams; rank++) {
+        const int32_t candidate = candidates[rank];
+        const int64_t row = first_row + candidate / vocab_size;
+        const int32_t token = static_cast<int32_t>(candidate % vocab_size);
+        const float score = batch_scores[candidate];
+
+        if (token == eos_token_id_) {
+          // A sequence only ends when its score is among the num_beams best scores.
+          if (rank < num_beams) {
+            const int32_t* sequence = sequences.data() + row * max_length;
+            std::vector<int32_t> hypothesis(sequence, sequence + current_length);
+            hypothesis.push_back(token);
+            hypotheses[b].Add(std::move(hypothesis), current_length, score);
+          }
+        } else {
+          next_tokens[first_row + beam] = token;
+          next_beam_scores[first_row + beam] = score;
+          source_rows[first_row + beam] = static_cast<int32_t>(row);
+          beam++;
+        }
+      }
+
+      // With a vocabulary of a single token there are fewer candidates than beams, and none of them continues when
+      // it is the end of sequence token. The remaining rows repeat the last continued beam, or start from the first
+      // row of the batch entry, with a score of -inf so that they are never preferred to a continued beam.
+      for (; beam < num_beams; beam++) {
+        const int64_t row = first_row + beam;
+        next_tokens[row] = beam > 0 ? next_tokens[row - 1] : pad_token_id_;
+        next_beam_scores[row] = -std::numeric_limits<float>::infinity();
+        source_rows[row] = beam > 0 ? source_rows[row - 1] : static_cast<int32_t>(first_row);
+      }
+
+      done[b] = hypotheses[b].IsDone(batch_scores[candidates[0]], current_length);
+      all_done = all_done && done[b];
+    }
+
+    // Reorder the running beams and append the next tokens.
+    bool reordered = false;
+    for (int64_t r = 0; r < row_count; r++) {
+      reordered = reordered || source_rows[r] != r;
+      std::copy_n(sequences.data() + source_rows[r] * max_length, current_length,
+                  next_sequences.data() + r * max_length);
+      next_sequences[r * max_length + current_length] = next_tokens[r];
+    }
+    sequences.swap(next_sequences);
+    beam_scores.swap(next_beam_scores);
+
+    ++current_length;
+    if (all_done || current_length == max_length) {
+      break;
+    }
+
+    // The past state of the first step has one row per batch entry. The present states are only gathered when the
+    // beams are reordered.
+    const std::vector<int32_t>* feed_source_rows = nullptr;
+    if (first_step) {
+      for (auto& row : source_rows) {
+        row /= num_beams;
+      }
+      feed_source_rows = &source_rows;
+    } else if (reordered) {
+      feed_source_rows = &source_rows;
+    }
+
+    ORT_RETURN_IF_ERROR(gpt_subgraph_->UpdateFeeds(fetches, next_tokens, sequences, max_length, current_length,
+                                                   feed_source_rows, allocator, feeds, next_positions));
+    first_step = false;
+  }
+
+  // The running beams of the batch entries that are not done compete with the finished sequences.
+  for (int64_t b = 0; b < batch_size; b++) {
+    if (!done[b]) {
+      for (int64_t k = 0; k < num_beams; k++) {
+        const int32_t* sequence = sequences.data() + (b * num_beams + k) * max_length;
+        hypotheses[b].Add(std::vector<int32_t>(sequence, sequence + current_length), current_length,
+                          beam_scores[b * num_beams + k]);
+      }
+    }
+  }
+
+  Tensor* output = context->Output(0, {batch_size, num_return_sequences, max_length});
+  Tensor* output_scores = context->Output(1, {batch_size, num_return_sequences});
+
+  int32_t* output_data = output->MutableData<int32_t>();
+  std::fill_n(output_data, output->Shape().Size(), pad_token_id_);
+  for (int64_t b = 0; b < batch_size; b++) {
+    const auto best = hypotheses[b].Sorted();
+    for (int64_t i = 0; i < num_return_sequences; i++) {
+      const auto& hypothesis = best[i];
+      std::copy(hypothesis.second.begin(), hypothesis.second.end(),
+                output_data + (b * num_return_sequences + i) * max_length);
+      if (output_scores != nullptr) {
+        output_scores->MutableData<float>()[b * num_return_sequences + i] = hypothesis.first;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "contrib_ops/cpu/transformers/generation_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// The best finished sequences of one batch entry.
+class BeamHypotheses {
+ public:
+  BeamHypotheses(int num_beams, float length_penalty, bool early_stopping)
+      : num_beams_(num_beams), length_penalty_(length_penalty), early_stopping_(early_stopping) {}
+
+  // Adds a finished sequence with the sum of the log probabilities of its tokens. The length penalty is applied with
+  // the given length, which does not count the end of sequence token.
+  void Add(std::vector<int32_t> sequence, int length, float sum_logprobs);
+
+  // Returns whether none of the running beams can become better than the worst finished sequence.
+  bool IsDone(float best_sum_logprobs, int current_length) const;
+
+  // Returns the finished sequences with their scores, best first.
+  std::vector<std::pair<float, std::vector<int32_t>>> Sorted() const;
+
+ private:
+  float Score(float sum_logprobs, int length) const;
+
+  int num_beams_;
+  float length_penalty_;
+  bool early_stopping_;
+  std::vector<std::pair<float, std::vector<int32_t>>> beams_;
+};
+
+class BeamSearch final : public GenerationBase {
+ public:
+  explicit BeamSearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool early_stopping_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
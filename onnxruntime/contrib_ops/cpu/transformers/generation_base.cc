@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/generation_base.h"
+
+#include "core/framework/framework_common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+GenerationBase::GenerationBase(const OpKernelInfo& info) : IControlFlowKernel(info) {
+  // The GraphProto is loaded as a Graph instance by main Graph::Resolve, and a SessionState instance for executing
+  // the subgraph is created by InferenceSession.
+  ONNX_NAMESPACE::GraphProto proto;
+  ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+  ORT_IGNORE_RETURN_VALUE(proto);
+
+  int64_t eos_token_id;
+  int64_t pad_token_id;
+  ORT_ENFORCE(info.GetAttr<int64_t>("eos_token_id", &eos_token_id).IsOK());
+  ORT_ENFORCE(info.GetAttr<int64_t>("pad_token_id", &pad_token_id).IsOK());
+  eos_token_id_ = static_cast<int>(eos_token_id);
+  pad_token_id_ = static_cast<int>(pad_token_id);
+  no_repeat_ngram_size_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("no_repeat_ngram_size", 0));
+}
+
+common::Status GenerationBase::SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                                          const std::string& attribute_name,
+                                                          const SessionState& subgraph_session_state) {
+  ORT_ENFORCE(gpt_subgraph_ == nullptr, "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+  ORT_UNUSED_PARAMETER(attribute_name);
+
+  gpt_subgraph_ = onnxruntime::make_unique<GptSubgraph>(Node(), subgraph_session_state.GetGraphViewer());
+  return gpt_subgraph_->Setup(session_state, subgraph_session_state);
+}
+
+Status GenerationBase::CheckInputs(OpKernelContext* context, int& max_length) const {
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const auto& input_ids_dims = input_ids->Shape().GetDims();
+  if (input_ids_dims.size() != 2 || input_ids_dims[0] <= 0 || input_ids_dims[1] <= 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'input_ids' is expected to have shape (batch_size, sequence_length), got ",
+                           input_ids->Shape());
+  }
+
+  max_length = 0;
+  ORT_RETURN_IF_ERROR(ReadScalarInput<int32_t>(context, 1, max_length));
+  if (max_length <= input_ids_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "max_length should be larger than the sequence length of input_ids (", input_ids_dims[1],
+                           "). Got ", max_length);
+  }
+
+  return Status::OK();
+}
+
+Status GenerationBase::RunDecoder(OpKernelContext* context,
+                                  const std::vector<OrtValue>& feeds,
+                                  std::vector<OrtValue>& fetches,
+                                  int64_t row_count,
+                                  int64_t& vocab_size) const {
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  auto* session_state = ctx_internal->SubgraphSessionState("decoder");
+  ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'decoder' attribute.");
+  ORT_ENFORCE(gpt_subgraph_, "SetupSubgraphExecutionInfo must be called prior to execution of graph.");
+
+  fetches.clear();
+  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(*session_state, gpt_subgraph_->GetFeedsFetchesManager(), feeds, fetches,
+                                             {}, ExecutionMode::ORT_SEQUENTIAL, ctx_internal->GetTerminateFlag(),
+                                             context->Logger()));
+
+  const auto& logits_shape = fetches[0].Get<Tensor>().Shape();
+  if (logits_shape.NumDimensions() != 3 || logits_shape[0] != row_count || logits_shape[1] <= 0 ||
+      logits_shape[2] <= 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The logits output of the decoder subgraph is expected to have shape (",
+                           row_count, ", sequence_length, vocab_size). Got ", logits_shape);
+  }
+
+  vocab_size = logits_shape[2];
+  return Status::OK();
+}
+
+const float* GenerationBase::GetNextTokenLogits(const std::vector<OrtValue>& fetches, int64_t row) {
+  const Tensor& logits = fetches[0].Get<Tensor>();
+  const auto& logits_dims = logits.Shape().GetDims();
+  return logits.Data<float>() + ((row + 1) * logits_dims[1] - 1) * logits_dims[2];
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
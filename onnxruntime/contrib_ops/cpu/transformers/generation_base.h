@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/controlflow/utils.h"
+#include "contrib_ops/cpu/transformers/gpt_subgraph.h"
+#include "contrib_ops/cpu/transformers/logits_processor.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Base class of the ops that generate tokens by running the decoder subgraph in the 'decoder' attribute once per
+// token. The subgraph is run in a loop inside of Compute, so the past state stays in the buffers produced by the
+// subgraph instead of going through the caller for each token.
+class GenerationBase : public controlflow::IControlFlowKernel {
+ public:
+  explicit GenerationBase(const OpKernelInfo& info);
+
+  common::Status SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                            const std::string& attribute_name,
+                                            const SessionState& subgraph_session_state) override;
+
+ protected:
+  // Validates input_ids with shape (batch_size, sequence_length) and reads the max_length input.
+  Status CheckInputs(OpKernelContext* context, int& max_length) const;
+
+  // Runs one step of the decoder subgraph, and validates the logits with shape (row_count, sequence_length,
+  // vocab_size) in fetches[0].
+  Status RunDecoder(OpKernelContext* context,
+                    const std::vector<OrtValue>& feeds,
+                    std::vector<OrtValue>& fetches,
+                    int64_t row_count,
+                    int64_t& vocab_size) const;
+
+  // Returns the logits of the last token of a row.
+  static const float* GetNextTokenLogits(const std::vector<OrtValue>& fetches, int64_t row);
+
+  int eos_token_id_;
+  int pad_token_id_;
+  int no_repeat_ngram_size_;
+
+  std::unique_ptr<GptSubgraph> gpt_subgraph_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,296 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/gpt_subgraph.h"
+
+#include "core/framework/framework_common.h"
+#include "core/framework/session_state.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/framework/utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/providers/cpu/controlflow/utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+namespace {
+
+OrtValue AllocateTensorValue(MLDataType data_type, const TensorShape& shape, const AllocatorPtr& allocator) {
+  auto p_tensor = onnxruntime::make_unique<Tensor>(data_type, shape, allocator);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  return OrtValue{p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc()};
+}
+
+bool IsTensorOfType(const NodeArg& arg, int32_t elem_type) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() && type->tensor_type().elem_type() == elem_type;
+}
+
+// Sets the positions of the tokens from the attention mask, so that left side padding does not shift the positions
+// of the real tokens. Returns the position of the next token.
+int32_t ComputePositions(const int32_t* mask, int32_t* positions, int64_t length) {
+  int32_t position = 0;
+  for (int64_t i = 0; i < length; i++) {
+    positions[i] = mask[i] != 0 ? position++ : 0;
+  }
+  return position;
+}
+
+}  // namespace
+
+GptSubgraph::GptSubgraph(const onnxruntime::Node& node, const GraphViewer& subgraph)
+    : num_layers(0), num_heads(0), head_size(0), subgraph_(subgraph) {
+  for (const auto* input : subgraph_.GetInputs()) {
+    subgraph_input_names_.push_back(input->Name());
+  }
+  for (const auto* output : subgraph_.GetOutputs()) {
+    subgraph_output_names_.push_back(output->Name());
+  }
+  for (const auto* entry : node.ImplicitInputDefs()) {
+    implicit_input_names_.push_back(entry->Name());
+  }
+}
+
+Status GptSubgraph::Setup(const SessionState& session_state, const SessionState& subgraph_session_state) {
+  const auto& subgraph_inputs = subgraph_.GetInputs();
+  const auto& subgraph_outputs = subgraph_.GetOutputs();
+
+  if (subgraph_inputs.size() < 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The decoder subgraph should have input_ids, position_ids and attention_mask inputs "
+                           "followed by past state inputs. Found ", subgraph_inputs.size(), " inputs.");
+  }
+
+  num_layers = static_cast<int>(subgraph_inputs.size()) - 3;
+  if (subgraph_outputs.size() != static_cast<size_t>(num_layers) + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The decoder subgraph has ", num_layers, " past state inputs so it should have ",
+                           num_layers + 1, " outputs (logits and present states). Found ", subgraph_outputs.size());
+  }
+
+  for (int i = 0; i < 3; i++) {
+    if (!IsTensorOfType(*subgraph_inputs[i], TensorProto_DataType_INT32)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The decoder subgraph input ", subgraph_inputs[i]->Name(), " should be an int32 tensor.");
+    }
+  }
+
+  for (const auto* output : subgraph_outputs) {
+    if (!IsTensorOfType(*output, TensorProto_DataType_FLOAT)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The decoder subgraph output ", output->Name(), " should be a float tensor.");
+    }
+  }
+
+  // The past state of the first step is empty, so its shape has to be known from the subgraph.
+  for (int i = 0; i < num_layers; i++) {
+    const auto* past = subgraph_inputs[3 + i];
+    const auto* past_shape = past->Shape();
+    if (!IsTensorOfType(*past, TensorProto_DataType_FLOAT) || past_shape == nullptr ||
+        past_shape->dim_size() != 5 ||
+        !utils::HasDimValue(past_shape->dim(2)) || !utils::HasDimValue(past_shape->dim(4))) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The decoder subgraph input ", past->Name(), " should be a float tensor with shape "
+                             "(2, batch_size, num_heads, past_sequence_length, head_size) where num_heads and "
+                             "head_size are known.");
+    }
+
+    if (i == 0) {
+      num_heads = static_cast<int>(past_shape->dim(2).dim_value());
+      head_size = static_cast<int>(past_shape->dim(4).dim_value());
+    } else if (num_heads != past_shape->dim(2).dim_value() || head_size != past_shape->dim(4).dim_value()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The past state inputs of the decoder subgraph should have the same shape.");
+    }
+  }
+
+  // The subgraph inputs are created on CPU, and the implicit inputs are fed from the outer scope.
+  std::vector<std::string> feed_names{subgraph_input_names_};
+  feed_names.insert(feed_names.end(), implicit_input_names_.begin(), implicit_input_names_.end());
+
+  std::vector<OrtDevice> feed_locations;
+  ORT_RETURN_IF_ERROR(controlflow::detail::FindDevicesForValues(session_state, feed_names, feed_locations,
+                                                                subgraph_input_names_.size()));
+
+  std::unique_ptr<FeedsFetchesManager> ffm;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, subgraph_output_names_,
+                                                  subgraph_session_state.GetOrtValueNameIdxMap(), ffm));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(subgraph_session_state, *ffm));
+
+  // The logits and the present states are processed on CPU after each step.
+  const auto& cpu_allocator_info = session_state.GetExecutionProviders()
+                                       .Get(onnxruntime::kCpuExecutionProvider)
+                                       ->GetAllocator(0, OrtMemTypeDefault)
+                                       ->Info();
+  std::vector<const OrtMemoryInfo*> fetch_locations(subgraph_output_names_.size(), &cpu_allocator_info);
+
+  utils::FinalizeFeedFetchCopyInfo(*ffm, feed_locations, fetch_locations);
+
+  feeds_fetches_manager_ = std::move(ffm);
+
+  return Status::OK();
+}
+
+Status GptSubgraph::CreateInitialFeeds(const Tensor& input_ids,
+                                       int pad_token_id,
+                                       const std::vector<const OrtValue*>& implicit_inputs,
+                                       AllocatorPtr allocator,
+                                       std::vector<OrtValue>& feeds,
+                                       std::vector<int32_t>& next_positions) const {
+  const auto& dims = input_ids.Shape().GetDims();
+  const int64_t batch_size = dims[0];
+  const int64_t sequence_length = dims[1];
+
+  auto* int32_type = DataTypeImpl::GetType<int32_t>();
+  OrtValue input_ids_value = AllocateTensorValue(int32_type, input_ids.Shape(), allocator);
+  OrtValue position_ids_value = AllocateTensorValue(int32_type, input_ids.Shape(), allocator);
+  OrtValue attention_mask_value = AllocateTensorValue(int32_type, input_ids.Shape(), allocator);
+
+  const int32_t* input_ids_data = input_ids.Data<int32_t>();
+  int32_t* mask_data = attention_mask_value.GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* position_data = position_ids_value.GetMutable<Tensor>()->MutableData<int32_t>();
+
+  memcpy(input_ids_value.GetMutable<Tensor>()->MutableData<int32_t>(), input_ids_data,
+         input_ids.SizeInBytes());
+
+  next_positions.resize(static_cast<size_t>(batch_size));
+  for (int64_t b = 0; b < batch_size; b++) {
+    const int64_t offset = b * sequence_length;
+    for (int64_t s = 0; s < sequence_length; s++) {
+      mask_data[offset + s] = input_ids_data[offset + s] != pad_token_id ? 1 : 0;
+    }
+    next_positions[b] = ComputePositions(mask_data + offset, position_data + offset, sequence_length);
+  }
+
+  feeds.clear();
+  feeds.reserve(subgraph_input_names_.size() + implicit_inputs.size());
+  feeds.push_back(std::move(input_ids_value));
+  feeds.push_back(std::move(position_ids_value));
+  feeds.push_back(std::move(attention_mask_value));
+
+  // The past state of the first step is empty.
+  TensorShape past_shape{2, batch_size, num_heads, 0, head_size};
+  for (int i = 0; i < num_layers; i++) {
+    feeds.push_back(AllocateTensorValue(DataTypeImpl::GetType<float>(), past_shape, allocator));
+  }
+
+  for (const auto* entry : implicit_inputs) {
+    feeds.push_back(*entry);
+  }
+
+  return Status::OK();
+}
+
+Status GptSubgraph::UpdateFeeds(const std::vector<OrtValue>& last_outputs,
+                                const std::vector<int32_t>& next_tokens,
+                                const std::vector<int32_t>& sequences,
+                                int sequence_stride,
+                                int sequence_length,
+                                const std::vector<int32_t>* source_rows,
+                                AllocatorPtr allocator,
+                                std::vector<OrtValue>& feeds,
+                                std::vector<int32_t>& next_positions) const {
+  const int64_t row_count = static_cast<int64_t>(next_tokens.size());
+  auto source_row = [source_rows](int64_t row) {
+    return source_rows != nullptr ? static_cast<int64_t>((*source_rows)[row]) : row;
+  };
+
+  // The attention mask of a row continues the mask of its source row.
+  const Tensor& last_mask = feeds[2].Get<Tensor>();
+  const int64_t last_mask_length = last_mask.Shape()[1];
+  const int32_t* last_mask_data = last_mask.Data<int32_t>();
+
+  auto* int32_type = DataTypeImpl::GetType<int32_t>();
+  OrtValue attention_mask_value = AllocateTensorValue(int32_type, {row_count, last_mask_length + 1}, allocator);
+  int32_t* mask_data = attention_mask_value.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t r = 0; r < row_count; r++) {
+    int32_t* mask = mask_data + r * (last_mask_length + 1);
+    memcpy(mask, last_mask_data + source_row(r) * last_mask_length, last_mask_length * sizeof(int32_t));
+    mask[last_mask_length] = 1;
+  }
+
+  std::vector<int32_t> positions(static_cast<size_t>(row_count));
+  for (int64_t r = 0; r < row_count; r++) {
+    positions[r] = next_positions[source_row(r)];
+  }
+  next_positions.resize(static_cast<size_t>(row_count));
+
+  OrtValue input_ids_value;
+  OrtValue position_ids_value;
+  if (num_layers > 0) {
+    // Only the new tokens are run, and the past state has the keys and values of the previous tokens.
+    input_ids_value = AllocateTensorValue(int32_type, {row_count, 1}, allocator);
+    position_ids_value = AllocateTensorValue(int32_type, {row_count, 1}, allocator);
+    memcpy(input_ids_value.GetMutable<Tensor>()->MutableData<int32_t>(), next_tokens.data(),
+           row_count * sizeof(int32_t));
+    memcpy(position_ids_value.GetMutable<Tensor>()->MutableData<int32_t>(), positions.data(),
+           row_count * sizeof(int32_t));
+    for (int64_t r = 0; r < row_count; r++) {
+      next_positions[r] = positions[r] + 1;
+    }
+  } else {
+    // Without past state, the whole sequences are run again.
+    if (sequence_length != last_mask_length + 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The sequence length ", sequence_length,
+                             " does not match the attention mask length ", last_mask_length + 1);
+    }
+
+    input_ids_value = AllocateTensorValue(int32_type, {row_count, sequence_length}, allocator);
+    position_ids_value = AllocateTensorValue(int32_type, {row_count, sequence_length}, allocator);
+    int32_t* input_ids_data = input_ids_value.GetMutable<Tensor>()->MutableData<int32_t>();
+    int32_t* position_data = position_ids_value.GetMutable<Tensor>()->MutableData<int32_t>();
+    for (int64_t r = 0; r < row_count; r++) {
+      memcpy(input_ids_data + r * sequence_length, sequences.data() + r * sequence_stride,
+             sequence_length * sizeof(int32_t));
+      next_positions[r] = ComputePositions(mask_data + r * sequence_length, position_data + r * sequence_length,
+                                           sequence_length);
+    }
+  }
+
+  feeds[0] = std::move(input_ids_value);
+  feeds[1] = std::move(position_ids_value);
+  feeds[2] = std::move(attention_mask_value);
+
+  // The present states become the past states of the next step. They are only copied when beam search changes
+  // the rows; otherwise the buffers produced by the subgraph are fed back directly.
+  for (int i = 0; i < num_layers; i++) {
+    const OrtValue& present_value = last_outputs[1 + i];
+    if (source_rows == nullptr) {
+      feeds[3 + i] = present_value;
+      continue;
+    }
+
+    const Tensor& present = present_value.Get<Tensor>();
+    const auto& present_dims = present.Shape().GetDims();
+    if (present_dims.size() != 5 || present_dims[0] != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The present state output ", i, " should have shape "
+                             "(2, batch_size, num_heads, total_sequence_length, head_size). Got ", present.Shape());
+    }
+
+    const int64_t last_row_count = present_dims[1];
+    const size_t row_size = static_cast<size_t>(present_dims[2] * present_dims[3] * present_dims[4]);
+
+    OrtValue past_value = AllocateTensorValue(DataTypeImpl::GetType<float>(),
+                                              {2, row_count, present_dims[2], present_dims[3], present_dims[4]},
+                                              allocator);
+    const float* src = present.Data<float>();
+    float* dst = past_value.GetMutable<Tensor>()->MutableData<float>();
+    for (int64_t kv = 0; kv < 2; kv++) {
+      for (int64_t r = 0; r < row_count; r++) {
+        memcpy(dst + (kv * row_count + r) * row_size,
+               src + (kv * last_row_count + source_row(r)) * row_size,
+               row_size * sizeof(float));
+      }
+    }
+    feeds[3 + i] = std::move(past_value);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
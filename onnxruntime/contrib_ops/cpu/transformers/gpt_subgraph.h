@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class SessionState;
+
+namespace contrib {
+namespace transformers {
+
+/**
+Information about a GPT style decoder subgraph that is run once per generated token.
+
+The subgraph has 3 + N inputs: input_ids (batch_size, sequence_length) int32, position_ids (batch_size,
+sequence_length) int32, attention_mask (batch_size, past_sequence_length + sequence_length) int32, and N past
+states with shape (2, batch_size, num_heads, past_sequence_length, head_size). It has 1 + N outputs: logits
+(batch_size, sequence_length, vocab_size) and N present states with shape (2, batch_size, num_heads,
+past_sequence_length + sequence_length, head_size). A subgraph without past state is run on the whole sequence
+in each step.
+*/
+class GptSubgraph {
+ public:
+  GptSubgraph(const onnxruntime::Node& node, const GraphViewer& subgraph);
+
+  // Validates the subgraph inputs and outputs, and creates the FeedsFetchesManager for the subgraph execution.
+  Status Setup(const SessionState& session_state, const SessionState& subgraph_session_state);
+
+  const FeedsFetchesManager& GetFeedsFetchesManager() const { return *feeds_fetches_manager_; }
+
+  // Creates the feeds for the first step from the prompt in input_ids. Left side padding is supported: the
+  // attention mask is 0 and the position is 0 for the padding tokens. The implicit inputs of the node are appended.
+  Status CreateInitialFeeds(const Tensor& input_ids,
+                            int pad_token_id,
+                            const std::vector<const OrtValue*>& implicit_inputs,
+                            AllocatorPtr allocator,
+                            std::vector<OrtValue>& feeds,
+                            std::vector<int32_t>& next_positions) const;
+
+  // Updates the feeds for the next step.
+  // next_tokens has the tokens generated for each row of the next step, and sequences has the whole sequences
+  // of sequence_length tokens, with sequence_stride tokens per row. When beam search reorders or expands the rows,
+  // source_rows has the row of the last step that each row of the next step continues. The past states are
+  // gathered from the present states in last_outputs, or passed through when the rows are not reordered.
+  Status UpdateFeeds(const std::vector<OrtValue>& last_outputs,
+                     const std::vector<int32_t>& next_tokens,
+                     const std::vector<int32_t>& sequences,
+                     int sequence_stride,
+                     int sequence_length,
+                     const std::vector<int32_t>* source_rows,
+                     AllocatorPtr allocator,
+                     std::vector<OrtValue>& feeds,
+                     std::vector<int32_t>& next_positions) const;
+
+  int num_layers;
+  int num_heads;
+  int head_size;
+
+ private:
+  const GraphViewer& subgraph_;
+
+  std::vector<std::string> implicit_input_names_;
+  std::vector<std::string> subgraph_input_names_;
+  std::vector<std::string> subgraph_output_names_;
+
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/greedy_search.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    GreedySearch,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    transformers::GreedySearch);
+
+namespace transformers {
+
+// Input indices of GreedySearch.
+static constexpr int kMinLengthInput = 2;
+static constexpr int kRepetitionPenaltyInput = 3;
+static constexpr int kTemperatureInput = 4;
+static constexpr int kTopKInput = 5;
+static constexpr int kTopPInput = 6;
+
+GreedySearch::GreedySearch(const OpKernelInfo& info) : GenerationBase(info) {
+  do_sample_ = info.GetAttrOrDefault<int64_t>("do_sample", 0) != 0;
+
+  // read optional seed attribute and generate if not provided
+  float seed = 0.f;
+  if (info.GetAttr<float>("seed", &seed).IsOK()) {
+    generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
+  } else {
+    generator_ = std::default_random_engine{
+        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())};
+  }
+}
+
+Status GreedySearch::Compute(OpKernelContext* context) const {
+  int max_length;
+  ORT_RETURN_IF_ERROR(CheckInputs(context, max_length));
+
+  LogitsProcessorOptions options;
+  options.eos_token_id = eos_token_id_;
+  options.no_repeat_ngram_size = no_repeat_ngram_size_;
+  ORT_RETURN_IF_ERROR(options.Initialize(context, kMinLengthInput, kTemperatureInput, kRepetitionPenaltyInput));
+
+  int32_t top_k = 0;
+  float top_p = 1.0f;
+  ORT_RETURN_IF_ERROR(ReadScalarInput<int32_t>(context, kTopKInput, top_k));
+  ORT_RETURN_IF_ERROR(ReadScalarInput<float>(context, kTopPInput, top_p));
+  if (top_k < 0 || !(top_p > 0.0f && top_p <= 1.0f)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "top_k should not be negative and top_p should be in (0, 1]. Got ", top_k, " and ", top_p);
+  }
+
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const int64_t batch_size = input_ids->Shape()[0];
+  const int sequence_length = static_cast<int>(input_ids->Shape()[1]);
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  // The generated sequences, with max_length tokens per row.
+  std::vector<int32_t> sequences(static_cast<size_t>(batch_size * max_length), pad_token_id_);
+  const int32_t* input_ids_data = input_ids->Data<int32_t>();
+  for (int64_t b = 0; b < batch_size; b++) {
+    std::copy_n(input_ids_data + b * sequence_length, sequence_length, sequences.data() + b * max_length);
+  }
+
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  std::vector<OrtValue> feeds;
+  std::vector<OrtValue> fetches;
+  std::vector<int32_t> next_positions;
+  ORT_RETURN_IF_ERROR(gpt_subgraph_->CreateInitialFeeds(*input_ids, pad_token_id_, ctx_internal->GetImplicitInputs(),
+                                                        allocator, feeds, next_positions));
+
+  std::vector<int32_t> next_tokens(static_cast<size_t>(batch_size));
+  std::vector<bool> finished(static_cast<size_t>(batch_size), false);
+  std::vector<float> next_logits;
+  auto* tp = context->GetOperatorThreadPool();
+
+  for (int current_length = sequence_length; current_length < max_length;) {
+    int64_t vocab_size;
+    ORT_RETURN_IF_ERROR(RunDecoder(context, feeds, fetches, batch_size, vocab_size));
+
+    next_logits.resize(static_cast<size_t>(batch_size * vocab_size));
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(batch_size), static_cast<double>(vocab_size * 4),
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t b = begin; b != end; ++b) {
+            const float* logits = GetNextTokenLogits(fetches, b);
+            gsl::span<float> row = gsl::make_span(next_logits.data() + b * vocab_size,
+                                                  static_cast<size_t>(vocab_size));
+            std::copy_n(logits, vocab_size, row.data());
+            ProcessLogits(options,
+                          gsl::make_span(sequences.data() + b * max_length, static_cast<size_t>(current_length)),
+                          row);
+            if (!do_sample_) {
+              next_tokens[b] = static_cast<int32_t>(std::max_element(row.begin(), row.end()) - row.begin());
+            }
+          }
+        });
+
+    if (do_sample_) {
+      std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
+      for (int64_t b = 0; b < batch_size; b++) {
+        next_tokens[b] = SampleToken(gsl::make_span(next_logits.data() + b * vocab_size,
+                                                    static_cast<size_t>(vocab_size)),
+                                     top_k, top_p, generator_);
+      }
+    }
+
+    // Finished sequences are padded.
+    bool all_finished = true;
+    for (int64_t b = 0; b < batch_size; b++) {
+      if (finished[b]) {
+        next_tokens[b] = pad_token_id_;
+      } else if (next_tokens[b] == eos_token_id_) {
+        finished[b] = true;
+      }
+      all_finished = all_finished && finished[b];
+      sequences[b * max_length + current_length] = next_tokens[b];
+    }
+
+    ++current_length;
+    if (all_finished || current_length == max_length) {
+      break;
+    }
+
+    ORT_RETURN_IF_ERROR(gpt_subgraph_->UpdateFeeds(fetches, next_tokens, sequences, max_length, current_length,
+                                                   nullptr, allocator, feeds, next_positions));
+  }
+
+  Tensor* output = context->Output(0, {batch_size, max_length});
+  std::copy(sequences.begin(), sequences.end(), output->MutableData<int32_t>());
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
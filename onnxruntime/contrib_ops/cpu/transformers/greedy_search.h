@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <random>
+
+#include "core/platform/ort_mutex.h"
+#include "contrib_ops/cpu/transformers/generation_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+class GreedySearch final : public GenerationBase {
+ public:
+  explicit GreedySearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool do_sample_;
+
+  // generator_ is updated with every call to Compute(). use generator_mutex_ to ensure Compute() can be called
+  // concurrently.
+  mutable std::default_random_engine generator_;
+  mutable OrtMutex generator_mutex_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/logits_processor.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+Status LogitsProcessorOptions::Initialize(OpKernelContext* context, int min_length_index, int temperature_index,
+                                          int repetition_penalty_index) {
+  ORT_RETURN_IF_ERROR(ReadScalarInput<int32_t>(context, min_length_index, min_length));
+  ORT_RETURN_IF_ERROR(ReadScalarInput<float>(context, temperature_index, temperature));
+  ORT_RETURN_IF_ERROR(ReadScalarInput<float>(context, repetition_penalty_index, repetition_penalty));
+
+  if (!(temperature > 0.0f)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "temperature should be positive. Got ", temperature);
+  }
+  if (!(repetition_penalty > 0.0f)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "repetition_penalty should be positive. Got ",
+                           repetition_penalty);
+  }
+
+  return Status::OK();
+}
+
+void ProcessLogits(const LogitsProcessorOptions& options,
+                   gsl::span<const int32_t> sequence,
+                   gsl::span<float> logits) {
+  const int64_t vocab_size = static_cast<int64_t>(logits.size());
+
+  if (options.temperature != 1.0f) {
+    const float scale = 1.0f / options.temperature;
+    for (auto& logit : logits) {
+      logit *= scale;
+    }
+  }
+
+  // Each token of the sequence is penalized once, however often it occurs.
+  if (options.repetition_penalty != 1.0f) {
+    std::vector<int32_t> tokens(sequence.begin(), sequence.end());
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    for (int32_t token : tokens) {
+      if (token >= 0 && token < vocab_size) {
+        float& logit = logits[token];
+        logit = logit < 0.0f ? logit * options.repetition_penalty : logit / options.repetition_penalty;
+      }
+    }
+  }
+
+  // Block the tokens that would repeat an n-gram of the sequence.
+  const int ngram_size = options.no_repeat_ngram_size;
+  const int64_t sequence_length = static_cast<int64_t>(sequence.size());
+  if (ngram_size > 0 && sequence_length >= ngram_size) {
+    const int32_t* prefix = sequence.data() + sequence_length - (ngram_size - 1);
+    for (int64_t i = 0; i + ngram_size <= sequence_length; i++) {
+      if (std::equal(prefix, prefix + ngram_size - 1, sequence.data() + i)) {
+        const int32_t token = sequence[i + ngram_size - 1];
+        if (token >= 0 && token < vocab_size) {
+          logits[token] = -std::numeric_limits<float>::infinity();
+        }
+      }
+    }
+  }
+
+  if (sequence_length < options.min_length && options.eos_token_id >= 0 && options.eos_token_id < vocab_size) {
+    logits[options.eos_token_id] = -std::numeric_limits<float>::infinity();
+  }
+}
+
+int32_t SampleToken(gsl::span<float> logits, int top_k, float top_p, std::default_random_engine& generator) {
+  const size_t vocab_size = logits.size();
+  constexpr float lowest = -std::numeric_limits<float>::infinity();
+
+  if (top_k > 0 && static_cast<size_t>(top_k) < vocab_size) {
+    std::vector<float> sorted(logits.begin(), logits.end());
+    std::nth_element(sorted.begin(), sorted.begin() + (top_k - 1), sorted.end(), std::greater<float>());
+    const float threshold = sorted[top_k - 1];
+    for (auto& logit : logits) {
+      if (logit < threshold) {
+        logit = lowest;
+      }
+    }
+  }
+
+  std::vector<float> probs(vocab_size);
+  MlasComputeSoftmax(logits.data(), probs.data(), 1, vocab_size, false, nullptr);
+
+  if (top_p < 1.0f) {
+    std::vector<int32_t> order(vocab_size);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&probs](int32_t a, int32_t b) { return probs[a] > probs[b]; });
+
+    // Keep the smallest set of tokens whose probabilities reach top_p, which has at least one token.
+    float cumulative = 0.0f;
+    size_t keep = 0;
+    while (keep < vocab_size && (keep == 0 || cumulative < top_p)) {
+      cumulative += probs[order[keep++]];
+    }
+    for (size_t i = keep; i < vocab_size; i++) {
+      probs[order[i]] = 0.0f;
+    }
+  }
+
+  const float total = std::accumulate(probs.begin(), probs.end(), 0.0f);
+  std::uniform_real_distribution<float> distribution(0.0f, total);
+  const float sample = distribution(generator);
+
+  float cumulative = 0.0f;
+  int32_t last_candidate = 0;
+  for (size_t i = 0; i < vocab_size; i++) {
+    if (probs[i] > 0.0f) {
+      cumulative += probs[i];
+      last_candidate = static_cast<int32_t>(i);
+      if (sample < cumulative) {
+        return last_candidate;
+      }
+    }
+  }
+
+  return last_candidate;
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <random>
+#include "gsl/gsl"
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Reads an optional scalar input. Inputs with an index of -1 are not present in the op, and value is unchanged
+// for a missing input.
+template <typename T>
+Status ReadScalarInput(OpKernelContext* context, int index, T& value) {
+  const Tensor* tensor = index >= 0 ? context->Input<Tensor>(index) : nullptr;
+  if (tensor == nullptr) {
+    return Status::OK();
+  }
+
+  if (tensor->Shape().Size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", index, " should be a scalar. Got shape of ",
+                           tensor->Shape());
+  }
+
+  value = *tensor->Data<T>();
+  return Status::OK();
+}
+
+struct LogitsProcessorOptions {
+  int min_length = 0;
+  int eos_token_id = -1;
+  int no_repeat_ngram_size = 0;
+  float temperature = 1.0f;
+  float repetition_penalty = 1.0f;
+
+  // Reads the optional scalar inputs of a generation op.
+  Status Initialize(OpKernelContext* context, int min_length_index, int temperature_index,
+                    int repetition_penalty_index);
+};
+
+// Applies the temperature, the repetition penalty, the n-gram blocking and the minimal length to the next token
+// logits of a sequence.
+void ProcessLogits(const LogitsProcessorOptions& options,
+                   gsl::span<const int32_t> sequence,
+                   gsl::span<float> logits);
+
+// Keeps the top_k tokens with the highest logits, then the most likely tokens whose probabilities add up to top_p,
+// and samples the next token from them. top_k of 0 and top_p of 1 disable the filters.
+int32_t SampleToken(gsl::span<float> logits, int top_k, float top_p, std::default_random_engine& generator);
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
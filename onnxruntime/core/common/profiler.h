@@ -78,6 +78,16 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a single event on the track of another thread, such as a thread pool worker.
+  Time is measured till the call of this function from the start_time.
+  */
+  void EndTimeAndRecordEvent(EventCategory category,
+                             const std::string& event_name,
+                             const TimePoint& start_time,
+                             unsigned thread_id,
+                             std::unordered_map<std::string, std::string>&& event_args);
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -111,6 +121,8 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  void RecordEvent(EventRecord&& event);
+
   /**
    * The maximum number of profiler records to collect.
    * This value is used to initialize the per-profiler maximum.
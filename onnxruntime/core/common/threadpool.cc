@@ -13,13 +13,21 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <chrono>
+#include <istream>
 #include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 #include "core/common/eigen_common_wrapper.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
+#include "core/platform/tracing.h"
 
 namespace onnxruntime {
 
@@ -75,14 +83,22 @@ public:
  // Allocate each thread to a home shard, from which it starts
  // claiming iterations.
  //
- // We use the worker ID provided by the thread pool as the basis of
- // this allocation.  Doing so promotes locality between successive
+ // We use the position of the thread in the pool as the basis of
+ // this allocation: 0 for the thread entering the loop, and i+1 for
+ // worker thread i.  Unlike the order in which workers join a loop,
+ // positions are stable, which promotes locality between successive
  // loops: the worker that runs a given iteration in one loop will
  // tend to run the same iterations in the next loop.  This helps
  // operators with a series of short loops, such as GRU.
-
- unsigned GetHomeShard(unsigned idx) const {
-   return idx % _num_shards;
+ //
+ // Positions map to shards in proportion, so that neighboring
+ // threads get neighboring shards, and ClaimIterations steals from
+ // the following shards first.  When the workers are bound to NUMA
+ // nodes in order (ThreadOptions::cpu_sets), a contiguous part of
+ // the iteration space stays on the same node across loops.
+
+ unsigned GetHomeShard(unsigned position, unsigned num_positions) const {
+   return ThreadPool::GetHomeShard(position, num_positions, _num_shards);
  }
 
   // Attempt to claim iterations from the sharded counter.  The function either
@@ -136,6 +152,150 @@ private:
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+// The cost model works in CPU cycles, measured times are converted assuming a 3GHz clock.
+static constexpr double CYCLES_PER_NS = 3.0;
+
+// A loop is measured on each of its first LOOP_WARMUP_RUNS runs, and then once every
+// LOOP_SAMPLE_PERIOD runs so that the cost follows changes in the loop's inputs.
+static constexpr uint64_t LOOP_WARMUP_RUNS = 8;
+static constexpr uint64_t LOOP_SAMPLE_PERIOD = 64;
+
+// Measured cost of one parallel loop.  Runs of the loop may update it concurrently, and an update
+// lost to a race only delays the adaptation.
+struct LoopCost {
+  // Moving average of the time per iteration in nanoseconds, 0 until the loop is measured.
+  std::atomic<double> ns_per_iteration{0};
+  std::atomic<uint64_t> runs{0};
+
+  bool ShouldMeasure() {
+    const uint64_t run = runs.fetch_add(1, std::memory_order_relaxed);
+    return run < LOOP_WARMUP_RUNS || run % LOOP_SAMPLE_PERIOD == 0;
+  }
+
+  void Record(std::ptrdiff_t iterations, uint64_t busy_ns) {
+    if (iterations <= 0) {
+      return;
+    }
+    const double sample = static_cast<double>(busy_ns) / static_cast<double>(iterations);
+    const double current = ns_per_iteration.load(std::memory_order_relaxed);
+    ns_per_iteration.store(current == 0 ? sample : 0.75 * current + 0.25 * sample, std::memory_order_relaxed);
+  }
+};
+
+// Costs of the loops run by a thread pool created with ThreadOptions::adaptive_loop_costs.  A loop
+// is identified by the type of its body, which is distinct for every lambda expression and so for
+// every call site, or by the tag given by the caller.  The address of the type_info or tag is used
+// for lookups, and the name is used to match loops with costs loaded from a file.
+class LoopCostModel {
+ public:
+  // Returns the cost of the loop, or nullptr if the loop cannot be identified.  op_type and node_name are those
+  // of the enclosing loop scope, or nullptr outside of a scope.
+  LoopCost* GetLoop(const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn, const char* tag,
+                    const std::string* op_type, const std::string* node_name) {
+    const void* site = tag;
+    if (tag == nullptr) {
+#ifdef ORT_NO_RTTI
+      ORT_UNUSED_PARAMETER(fn);
+      return nullptr;
+#else
+      site = &fn.target_type();
+#endif
+    }
+
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto& entry = loops_by_id_[LoopId{site, op_type, node_name}];
+    // The strings of a scope belong to a session, and may be freed and their addresses reused by another session
+    // that shares the pool, so the entry is only valid while they still have the same contents.
+    if (entry.loop != nullptr && (op_type == nullptr || (entry.op_type == *op_type && entry.node_name == *node_name))) {
+      return entry.loop;
+    }
+#ifdef ORT_NO_RTTI
+    std::string name(tag);
+#else
+    std::string name(tag != nullptr ? tag : fn.target_type().name());
+#endif
+    if (op_type != nullptr) {
+      entry.op_type = *op_type;
+      entry.node_name = *node_name;
+      name = *op_type + '(' + *node_name + ") " + name;
+    }
+    auto& loop = loops_[name];
+    if (!loop) {
+      loop = onnxruntime::make_unique<LoopCost>();
+    }
+    entry.loop = loop.get();
+    return entry.loop;
+  }
+
+  void Save(std::ostream& out) const {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (const auto& loop : loops_) {
+      const double ns_per_iteration = loop.second->ns_per_iteration.load(std::memory_order_relaxed);
+      if (ns_per_iteration > 0) {
+        out << ns_per_iteration << ' ' << loop.first << '\n';
+      }
+    }
+  }
+
+  Status Load(std::istream& in) {
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+      ++line_number;
+      if (line.empty()) {
+        continue;
+      }
+      std::istringstream fields(line);
+      double ns_per_iteration = 0;
+      std::string name;
+      fields >> ns_per_iteration >> std::ws;
+      std::getline(fields, name);
+      if (fields.fail() || ns_per_iteration <= 0 || name.empty()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid loop cost on line ", line_number, ": ", line);
+      }
+
+      std::lock_guard<OrtMutex> lock(mutex_);
+      auto& loop = loops_[name];
+      if (!loop) {
+        loop = onnxruntime::make_unique<LoopCost>();
+      }
+      loop->ns_per_iteration.store(ns_per_iteration, std::memory_order_relaxed);
+      // Loaded costs are trusted like warmed up ones and only sampled from now on.
+      loop->runs.store(LOOP_WARMUP_RUNS, std::memory_order_relaxed);
+    }
+    return Status::OK();
+  }
+
+ private:
+  // A loop is identified by its call site and the addresses of the strings of its loop scope.
+  struct LoopId {
+    const void* site;
+    const std::string* op_type;
+    const std::string* node_name;
+
+    bool operator==(const LoopId& other) const {
+      return site == other.site && op_type == other.op_type && node_name == other.node_name;
+    }
+  };
+
+  struct LoopIdHash {
+    size_t operator()(const LoopId& id) const {
+      const std::hash<const void*> hash;
+      return (hash(id.site) * 31 + hash(id.op_type)) * 31 + hash(id.node_name);
+    }
+  };
+
+  struct LoopEntry {
+    LoopCost* loop{nullptr};
+    std::string op_type;
+    std::string node_name;
+  };
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<LoopId, LoopEntry, LoopIdHash> loops_by_id_;
+  std::unordered_map<std::string, std::unique_ptr<LoopCost>> loops_;
+};
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
@@ -156,46 +316,146 @@ ThreadPool::ThreadPool(Env* env,
                                                        thread_options_);
     underlying_threadpool_ = extended_eigen_threadpool_.get();
   }
+  if (thread_options_.adaptive_loop_costs) {
+    loop_cost_model_ = onnxruntime::make_unique<LoopCostModel>();
+  }
+}
+
+ThreadPool::ThreadPool(ThreadPool* shared_pool, const ThreadPoolShareOptions& share_options)
+    : share_options_(share_options) {
+  ORT_ENFORCE(shared_pool != nullptr, "A pool to share threads with is required");
+  ORT_ENFORCE(share_options.share > 0, "The share of a thread pool must be positive");
+  ORT_ENFORCE(share_options.max_degree_of_parallelism >= 0, "Invalid max_degree_of_parallelism: ",
+              share_options.max_degree_of_parallelism);
+  shared_pool_ = shared_pool->shared_pool_ ? shared_pool->shared_pool_ : shared_pool;
+  thread_options_ = shared_pool_->thread_options_;
+  underlying_threadpool_ = shared_pool_->underlying_threadpool_;
+  if (thread_options_.adaptive_loop_costs) {
+    loop_cost_model_ = onnxruntime::make_unique<LoopCostModel>();
+  }
 }
 
 ThreadPool::~ThreadPool() = default;
 
+// Registers a parallel loop of a pool sharing the threads of another pool for as long as it runs, and
+// reduces its degree of parallelism to the part of the threads given by its share of the loops running.
+// Has no effect for pools that own their threads.
+class SharedLoopScope {
+ public:
+  SharedLoopScope(ThreadPool& tp, int& d_of_p) : tp_(tp) {
+    if (tp_.shared_pool_ == nullptr) {
+      return;
+    }
+    ThreadPool& shared_pool = *tp_.shared_pool_;
+    const uint64_t share = tp_.share_options_.share;
+    shared_pool.active_loops_.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t active_shares = shared_pool.active_shares_.fetch_add(share, std::memory_order_relaxed) + share;
+    tp_.shared_loops_.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t threads = static_cast<uint64_t>(ThreadPool::DegreeOfParallelism(&shared_pool));
+    const int fair_d_of_p = static_cast<int>(std::max<uint64_t>(1, threads * share / active_shares));
+    if (fair_d_of_p < d_of_p) {
+      d_of_p = fair_d_of_p;
+      tp_.throttled_loops_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  ~SharedLoopScope() {
+    if (tp_.shared_pool_ == nullptr) {
+      return;
+    }
+    ThreadPool& shared_pool = *tp_.shared_pool_;
+    shared_pool.active_shares_.fetch_sub(tp_.share_options_.share, std::memory_order_relaxed);
+    shared_pool.active_loops_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+ private:
+  ThreadPool& tp_;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedLoopScope);
+};
+
 // Base case for parallel loops, running iterations 0..total, divided into blocks
 // of block_size iterations, and calling into a function that takes a start..end
 // range of indices to run.
 void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
                                                      const std::ptrdiff_t block_size,
-                                                     const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+                                                     const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn,
+                                                     int max_d_of_p, LoopCost* measured_loop) {
   if (total <= 0)
     return;
 
   if (total <= block_size) {
+    const auto start = measured_loop ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
     fn(0, total);
+    if (measured_loop) {
+      measured_loop->Record(total, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                             std::chrono::steady_clock::now() - start)
+                                                             .count()));
+    }
     return;
   }
 
   // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
   // hence we need at most one for each thread, even if the numberof blocks of iterations is larger.
   auto d_of_p = DegreeOfParallelism(this);
+  if (max_d_of_p > 0 && max_d_of_p < d_of_p) {
+    d_of_p = max_d_of_p;
+  }
+  SharedLoopScope shared_loop(*this, d_of_p);
   auto num_blocks = total / block_size;
   int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(d_of_p), num_blocks));
   assert(num_work_items > 0);
+  ORT_TRACE_PROBE3(parallel_for_begin, total, block_size, num_work_items);
 
   LoopCounter lc(total, block_size);
-  std::function<void(unsigned)> run_work = [&](unsigned idx) {
-    unsigned my_home_shard = lc.GetHomeShard(idx);
+  const unsigned num_positions = static_cast<unsigned>(NumThreads()) + 1;
+  const bool collect_stats = thread_options_.collect_stats;
+  const bool measure = collect_stats || measured_loop != nullptr;
+  std::atomic<uint64_t> max_busy_ns{0};
+  std::atomic<uint64_t> total_busy_ns{0};
+  std::function<void(unsigned)> run_work = [&](unsigned) {
+    const auto start = measure ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    unsigned my_home_shard = lc.GetHomeShard(static_cast<unsigned>(CurrentThreadId() + 1), num_positions);
     unsigned my_shard = my_home_shard;
     uint64_t my_iter_start, my_iter_end;
     while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end)) {
       fn(static_cast<std::ptrdiff_t>(my_iter_start),
          static_cast<std::ptrdiff_t>(my_iter_end));
     }
+    if (measure) {
+      const auto busy_ns = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+      total_busy_ns += busy_ns;
+      uint64_t seen = max_busy_ns.load(std::memory_order_relaxed);
+      while (busy_ns > seen && !max_busy_ns.compare_exchange_weak(seen, busy_ns, std::memory_order_relaxed)) {
+      }
+    }
   };
 
   // Run the work in the thread pool (and in the current thread).  Synchronization with helping
   // threads is handled within RunInParallel, hence we can deallocate lc and other state captured by
   // run_work.
   RunInParallel(run_work, num_work_items);
+  ORT_TRACE_PROBE2(parallel_for_end, total, num_work_items);
+
+  if (collect_stats) {
+    RecordLoop(max_busy_ns, total_busy_ns, static_cast<unsigned>(num_work_items));
+  }
+  if (measured_loop) {
+    measured_loop->Record(total, total_busy_ns);
+  }
+}
+
+void ThreadPool::RecordLoop(uint64_t max_busy_ns, uint64_t total_busy_ns, unsigned num_work_items) {
+  if (total_busy_ns == 0) {
+    return;
+  }
+  const uint64_t imbalance = max_busy_ns * 1000 * num_work_items / total_busy_ns;
+  loops_.fetch_add(1, std::memory_order_relaxed);
+  total_loop_imbalance_.fetch_add(imbalance, std::memory_order_relaxed);
+  uint64_t seen = max_loop_imbalance_.load(std::memory_order_relaxed);
+  while (imbalance > seen && !max_loop_imbalance_.compare_exchange_weak(seen, imbalance, std::memory_order_relaxed)) {
+  }
 }
 
 void ThreadPool::SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn) {
@@ -216,6 +476,17 @@ void ThreadPool::Schedule(std::function<void()> fn) {
 
 thread_local ThreadPool::ParallelSection *ThreadPool::ParallelSection::current_parallel_section{nullptr};
 
+thread_local ThreadPool::LoopScope* ThreadPool::LoopScope::current_loop_scope{nullptr};
+
+ThreadPool::LoopScope::LoopScope(const std::string& op_type, const std::string& node_name)
+    : op_type_(op_type), node_name_(node_name), previous_(current_loop_scope) {
+  current_loop_scope = this;
+}
+
+ThreadPool::LoopScope::~LoopScope() {
+  current_loop_scope = previous_;
+}
+
 ThreadPool::ParallelSection::ParallelSection(ThreadPool *tp) {
 #ifdef _OPENMP
   // Nothing
@@ -340,30 +611,113 @@ static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::Tenso
 }
 
 void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f,
+                             const char* loop_tag) {
   ORT_ENFORCE(n >= 0);
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
   auto d_of_p = DegreeOfParallelism(this);
+
+  // With adaptive loop costs, replace the caller's estimate with the measured cost once there is one,
+  // and limit the threads to those the cost model finds worthwhile rather than offering the loop to all.
+  LoopCost* loop = nullptr;
+  if (loop_cost_model_) {
+    const LoopScope* scope = LoopScope::current_loop_scope;
+    loop = loop_cost_model_->GetLoop(f, loop_tag, scope ? &scope->op_type_ : nullptr,
+                                     scope ? &scope->node_name_ : nullptr);
+  }
+  LoopCost* measured_loop = nullptr;
+  int max_d_of_p = 0;
+  if (loop) {
+    const double ns_per_iteration = loop->ns_per_iteration.load(std::memory_order_relaxed);
+    if (ns_per_iteration > 0) {
+      cost = Eigen::TensorOpCost(0, 0, ns_per_iteration * CYCLES_PER_NS);
+    }
+    if (loop->ShouldMeasure()) {
+      measured_loop = loop;
+    }
+  }
+
   // Compute small problems directly in the caller thread.
-  if ((!ShouldParallelizeLoop(n)) ||
-      CostModel::numThreads(static_cast<double>(n), cost, d_of_p) == 1) {
-    f(0, n);
+  const int num_threads = ShouldParallelizeLoop(n) ? CostModel::numThreads(static_cast<double>(n), cost, d_of_p) : 1;
+  if (num_threads == 1) {
+    if (measured_loop) {
+      const auto start = std::chrono::steady_clock::now();
+      f(0, n);
+      measured_loop->Record(n, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                         std::chrono::steady_clock::now() - start)
+                                                         .count()));
+    } else {
+      f(0, n);
+    }
     return;
   }
 
-  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
-  ParallelForFixedBlockSizeScheduling(n, block, f);
+  if (loop) {
+    max_d_of_p = num_threads;
+  }
+  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, loop ? num_threads : d_of_p);
+  ParallelForFixedBlockSizeScheduling(n, block, f, max_d_of_p, measured_loop);
 }
 
 void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn) {
-  ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn,
+                             const char* loop_tag) {
+  ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn, loop_tag);
 }
 
 bool ThreadPool::ShouldParallelize(const concurrency::ThreadPool* tp) {
   return (DegreeOfParallelism(tp) != 1);
 }
 
+bool ThreadPool::GetStats(const ThreadPool* tp, ThreadPoolStats& stats) {
+  if (tp == nullptr || !tp->thread_options_.collect_stats) {
+    return false;
+  }
+
+  stats = ThreadPoolStats();
+  const ThreadPool* owner = tp->shared_pool_ ? tp->shared_pool_ : tp;
+  if (owner->extended_eigen_threadpool_) {
+    owner->extended_eigen_threadpool_->GetWorkerStats(stats.workers);
+  }
+  stats.loops = tp->loops_.load(std::memory_order_relaxed);
+  stats.total_loop_imbalance = static_cast<double>(tp->total_loop_imbalance_.load(std::memory_order_relaxed)) / 1000;
+  stats.max_loop_imbalance = static_cast<double>(tp->max_loop_imbalance_.load(std::memory_order_relaxed)) / 1000;
+  return true;
+}
+
+bool ThreadPool::GetLoad(const ThreadPool* tp, ThreadPoolLoad& load) {
+  if (tp == nullptr) {
+    return false;
+  }
+
+  load = ThreadPoolLoad();
+  const ThreadPool* owner = tp->shared_pool_ ? tp->shared_pool_ : tp;
+  if (owner->extended_eigen_threadpool_) {
+    load.queued_tasks = owner->extended_eigen_threadpool_->QueuedTasks();
+  }
+  load.active_loops = owner->active_loops_.load(std::memory_order_relaxed);
+  load.active_shares = owner->active_shares_.load(std::memory_order_relaxed);
+  load.shared_loops = tp->shared_loops_.load(std::memory_order_relaxed);
+  load.throttled_loops = tp->throttled_loops_.load(std::memory_order_relaxed);
+  return true;
+}
+
+Status ThreadPool::SaveLoopCosts(const ThreadPool* tp, std::ostream& out) {
+  ORT_RETURN_IF_NOT(tp != nullptr && tp->loop_cost_model_, "Thread pool was not created with adaptive loop costs");
+  tp->loop_cost_model_->Save(out);
+  ORT_RETURN_IF_NOT(out.good(), "Failed to write the loop costs");
+  return Status::OK();
+}
+
+Status ThreadPool::LoadLoopCosts(ThreadPool* tp, std::istream& in) {
+  ORT_RETURN_IF_NOT(tp != nullptr && tp->loop_cost_model_, "Thread pool was not created with adaptive loop costs");
+  return tp->loop_cost_model_->Load(in);
+}
+
+unsigned ThreadPool::GetHomeShard(unsigned position, unsigned num_positions, unsigned num_shards) {
+  return static_cast<unsigned>(static_cast<uint64_t>(position) * num_shards / num_positions);
+}
+
 int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
 #ifdef _OPENMP
   // When using OpenMP, omp_get_num_threads() returns the number of threads in the
@@ -375,7 +729,12 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
 #else
   // When not using OpenMP, we parallelise over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
-  return tp ? (tp->NumThreads()+1) : 1;
+  if (!tp) {
+    return 1;
+  }
+  const int d_of_p = tp->NumThreads() + 1;
+  const int max_d_of_p = tp->share_options_.max_degree_of_parallelism;
+  return (max_d_of_p > 0 && max_d_of_p < d_of_p) ? max_d_of_p : d_of_p;
 #endif
 }
 
@@ -399,8 +758,11 @@ int ThreadPool::CurrentThreadId() const {
 }
 
 void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                           const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+                           const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                           const char* loop_tag) {
 #ifdef _OPENMP
+    // Loop costs are not measured with OpenMP.
+    ORT_UNUSED_PARAMETER(loop_tag);
     ORT_ENFORCE(total >= 0);
     if (total == 0) {
       return;
@@ -442,7 +804,7 @@ void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t tota
       fn(0, total);
       return;
     }
-    tp->ParallelFor(total, cost_per_unit, fn);
+    tp->ParallelFor(total, cost_per_unit, fn, loop_tag);
 #endif
   }
 
@@ -9,6 +9,8 @@
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+struct AllocatorStats;
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -27,6 +29,8 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Runtime statistics. The default only reports Used() and Max().
+  virtual void GetStats(AllocatorStats* stats);
   // allocate host pinned memory?
 };
 
@@ -43,6 +47,8 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_arena_extensions;      // Number of regions the arena allocated from the device allocator.
+  int64_t largest_free_block_bytes;  // The largest allocation possible without extending the arena.
 
   AllocatorStats() { Clear(); }
 
@@ -53,6 +59,8 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_arena_extensions = 0;
+    this->largest_free_block_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -62,8 +70,16 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "NumExtensions:  " << this->num_arena_extensions << "\n"
+       << "LargestFree:    " << this->largest_free_block_bytes << "\n";
     return ss.str();
   }
 };
+
+inline void IArenaAllocator::GetStats(AllocatorStats* stats) {
+  stats->Clear();
+  stats->bytes_in_use = static_cast<int64_t>(Used());
+  stats->bytes_limit = static_cast<int64_t>(Max());
+}
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/bfc_arena.h"
 #include <type_traits>
+#include "core/platform/tracing.h"
 
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
@@ -158,8 +159,10 @@ Status BFCArena::Extend(size_t rounded_bytes) {
   LOGS_DEFAULT(INFO) << "Extended allocation by " << bytes << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
+  ++stats_.num_arena_extensions;
   LOGS_DEFAULT(INFO) << "Total allocated bytes: "
                      << stats_.total_allocated_bytes;
+  ORT_TRACE_PROBE3(arena_extend, Info().name, bytes, stats_.total_allocated_bytes);
 
   LOGS_DEFAULT(INFO) << "Allocated memory at " << mem_addr << " to "
                      << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
@@ -301,6 +304,15 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+
+  // The free chunks of a bin are sorted by size and are smaller than those of the next bin.
+  for (BinNum b = kNumBins - 1; b >= 0; --b) {
+    const auto& free_chunks = BinFromIndex(b)->free_chunks;
+    if (!free_chunks.empty()) {
+      stats->largest_free_block_bytes = static_cast<int64_t>(ChunkFromHandle(*free_chunks.rbegin())->size);
+      break;
+    }
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
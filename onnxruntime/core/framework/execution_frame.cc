@@ -176,6 +176,22 @@ void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std:
   }
 }
 
+void IExecutionFrame::UpdateFeeds(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds) {
+  ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
+
+  for (size_t idx = 0, end = feed_mlvalue_idxs.size(); idx < end; ++idx) {
+    all_values_[feed_mlvalue_idxs[idx]] = feeds[idx];
+  }
+}
+
+void IExecutionFrame::UpdateFetches(const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(fetches.size() == fetch_mlvalue_idxs_.size());
+
+  for (size_t idx = 0, end = fetch_mlvalue_idxs_.size(); idx < end; ++idx) {
+    all_values_[fetch_mlvalue_idxs_[idx]] = fetches[idx];
+  }
+}
+
 Status IExecutionFrame::GetOutputs(std::vector<OrtValue>& fetches) {
   auto num_fetches = fetch_mlvalue_idxs_.size();
 
@@ -211,6 +227,10 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
       planner_(nullptr) {
   Init(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetches);
 
+  if (session_state.GetMemoryProfiler()) {
+    memory_timeline_ = session_state.GetMemoryProfiler()->StartRun();
+  }
+
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
     for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
@@ -300,7 +320,11 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  if (memory_timeline_) {
+    session_state_.GetMemoryProfiler()->AddRun(*memory_timeline_);
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -364,6 +388,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
                 shape);
+            if (memory_timeline_ && status.IsOK()) {
+              memory_timeline_->Allocate(ort_value_index, size, location, true);
+            }
             return status;
           } else {
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
@@ -397,6 +424,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     TraceAllocate(ort_value_index, size);
   }
 
+  if (memory_timeline_) {
+    memory_timeline_->Allocate(ort_value_index, size, location, false);
+  }
+
   {
     // This code block is not thread-safe.
     // Dynamic activation size would be accessed by multiple threads
@@ -591,6 +622,9 @@ Status ExecutionFrame::CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
   TraceFree(ort_value_idx);
+  if (memory_timeline_) {
+    memory_timeline_->Free(ort_value_idx);
+  }
   return Status::OK();
 }
 
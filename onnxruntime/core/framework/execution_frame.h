@@ -11,6 +11,7 @@
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/memory_profiler.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/sequential_execution_plan.h"
@@ -69,6 +70,11 @@ class IExecutionFrame {
 
   Status ReleaseMLValue(int ort_value_idx);
 
+  // Replace the values of the feeds and of the pre-allocated fetches of a frame that is kept between runs.
+  // An empty entry in fetches clears the value so it is allocated again.
+  void UpdateFeeds(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds);
+  void UpdateFetches(const std::vector<OrtValue>& fetches);
+
  protected:
   // get the ort_value_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
@@ -196,6 +202,9 @@ class ExecutionFrame final : public IExecutionFrame {
   // use this planner_ to trace the memory allocation in current executor.
   std::unique_ptr<OrtValuePatternPlanner> planner_;
 
+  // Allocations and frees of this run if the session has a MemoryProfiler.
+  std::unique_ptr<MemoryProfiler::RunTimeline> memory_timeline_;
+
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
 
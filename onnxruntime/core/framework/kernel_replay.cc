@@ -0,0 +1,275 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_replay.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
+#include "core/platform/tracing.h"
+
+namespace onnxruntime {
+
+static bool HasStaticTensorShape(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !utils::HasTensorType(*type)) {
+    return false;
+  }
+
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+KernelReplay::KernelReplay() = default;
+
+KernelReplay::~KernelReplay() = default;
+
+Status KernelReplay::TryRun(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                            const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                            const bool& terminate_flag, const logging::Logger& logger, bool& replayed) {
+  replayed = false;
+
+  // the frame is in use by another run
+  std::unique_lock<OrtMutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return Status::OK();
+  }
+
+  if (graph_check_ == GraphCheck::kNotChecked) {
+    graph_check_ = CanReplayGraph(session_state, logger) ? GraphCheck::kReplayable : GraphCheck::kNotReplayable;
+  }
+
+  // profiling needs the events of the executors
+  if (graph_check_ != GraphCheck::kReplayable || session_state.Profiler().IsEnabled()) {
+    return Status::OK();
+  }
+
+  if (!frame_) {
+    if (!Capture(session_state, feeds_fetches_manager, feeds, fetches)) {
+      return Status::OK();
+    }
+  } else if (MatchesCapture(feeds_fetches_manager, feeds)) {
+    // values of a run that failed with an exception may still be bound
+    ReleaseRunValues();
+    frame_->UpdateFeeds(feed_mlvalue_idxs_, feeds);
+    if (!fetches.empty()) {
+      frame_->UpdateFetches(fetches);
+    }
+  } else {
+    return Status::OK();
+  }
+
+  replayed = true;
+
+  Status status = Replay(session_state, terminate_flag, logger);
+  if (status.IsOK()) {
+    status = frame_->GetOutputs(fetches);
+  }
+
+  if (status.IsOK()) {
+    ReleaseRunValues();
+    ++num_replays_;
+  } else {
+    // capture again in the next run rather than replaying a frame in an unknown state
+    frame_.reset();
+  }
+
+  return status;
+}
+
+bool KernelReplay::CanReplayGraph(const SessionState& session_state, const logging::Logger& logger) {
+  if (session_state.GetMemoryProfiler()) {
+    LOGS(logger, INFO) << "Kernel replay is disabled as the memory profile records the allocations of every run.";
+    return false;
+  }
+
+  const auto& execution_plan = session_state.GetExecutionPlan()->execution_plan;
+  kernels_.reserve(execution_plan.size());
+
+  for (const auto& node_exec_plan : execution_plan) {
+    const auto* p_op_kernel = session_state.GetKernel(node_exec_plan.node_index);
+    if (p_op_kernel == nullptr) {
+      kernels_.clear();
+      return false;
+    }
+
+    const auto& node = p_op_kernel->Node();
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider || node.ContainsSubgraph()) {
+      LOGS(logger, INFO) << "Kernel replay is disabled as node " << node.Name() << " (" << node.OpType()
+                         << ") doesn't run on the CPU execution provider or has a subgraph.";
+      kernels_.clear();
+      return false;
+    }
+
+    for (const auto* output : node.OutputDefs()) {
+      if (output->Exists() && !HasStaticTensorShape(*output)) {
+        LOGS(logger, INFO) << "Kernel replay is disabled as output " << output->Name() << " of node " << node.Name()
+                           << " is not a tensor with a static shape.";
+        kernels_.clear();
+        return false;
+      }
+    }
+
+    kernels_.push_back(p_op_kernel);
+  }
+
+  return true;
+}
+
+bool KernelReplay::Capture(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                           const std::vector<OrtValue>& feeds, const std::vector<OrtValue>& fetches) {
+  const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  const auto& initializers = session_state.GetInitializedTensors();
+
+  // the run values are released after every run, which would lose an overridden initializer, or a fetch that is
+  // provided by an initializer or an input instead of being allocated by the node that produces it.
+  for (int idx : feeds_fetches_info.feeds_mlvalue_idxs) {
+    if (initializers.find(idx) != initializers.cend()) {
+      return false;
+    }
+  }
+
+  for (int idx : feeds_fetches_info.fetches_mlvalue_idxs) {
+    if (allocation_plan[idx].alloc_kind != AllocKind::kAllocateOutput) {
+      return false;
+    }
+  }
+
+  std::vector<TensorShape> feed_shapes;
+  feed_shapes.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+    feed_shapes.push_back(feed.Get<Tensor>().Shape());
+  }
+
+  feed_mlvalue_idxs_ = feeds_fetches_info.feeds_mlvalue_idxs;
+  fetch_mlvalue_idxs_ = feeds_fetches_info.fetches_mlvalue_idxs;
+  feed_shapes_ = std::move(feed_shapes);
+
+  // values created on the buffer of a feed or fetch, e.g. by a Reshape of an input, have to be created again for
+  // the buffers of every run.
+  run_value_idxs_ = feed_mlvalue_idxs_;
+  run_value_idxs_.insert(run_value_idxs_.end(), fetch_mlvalue_idxs_.cbegin(), fetch_mlvalue_idxs_.cend());
+  const size_t num_feeds_and_fetches = run_value_idxs_.size();
+  for (size_t idx = 0, end = allocation_plan.size(); idx < end; ++idx) {
+    const auto& per_alloc_plan = allocation_plan[idx];
+    if ((per_alloc_plan.alloc_kind == AllocKind::kReuse || per_alloc_plan.alloc_kind == AllocKind::kShare) &&
+        std::find(run_value_idxs_.cbegin(), run_value_idxs_.cbegin() + num_feeds_and_fetches,
+                  per_alloc_plan.reused_buffer) != run_value_idxs_.cbegin() + num_feeds_and_fetches) {
+      run_value_idxs_.push_back(static_cast<int>(idx));
+    }
+  }
+
+  auto frame = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs_, feeds, fetch_mlvalue_idxs_, fetches,
+                                                        std::unordered_map<size_t, IExecutor::CustomAllocator>{},
+                                                        session_state);
+
+  // without a memory pattern for these shapes the frame traces its allocations to create one. let a normal run
+  // create and cache it, so the intermediate tensors of the kept frame are placed in a single buffer.
+  if (frame->HasMemoryPatternPlanner()) {
+    if (capture_deferred_) {
+      graph_check_ = GraphCheck::kNotReplayable;
+    }
+    capture_deferred_ = true;
+    return false;
+  }
+
+  frame_ = std::move(frame);
+  return true;
+}
+
+bool KernelReplay::MatchesCapture(const FeedsFetchesManager& feeds_fetches_manager,
+                                  const std::vector<OrtValue>& feeds) const {
+  const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  if (feeds_fetches_info.feeds_mlvalue_idxs != feed_mlvalue_idxs_ ||
+      feeds_fetches_info.fetches_mlvalue_idxs != fetch_mlvalue_idxs_) {
+    return false;
+  }
+
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (!feeds[i].IsTensor() || feeds[i].Get<Tensor>().Shape() != feed_shapes_[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status KernelReplay::Replay(const SessionState& session_state, const bool& terminate_flag,
+                            const logging::Logger& logger) {
+  NodeStats* const node_stats = session_state.GetNodeStats();
+
+  for (const auto* p_op_kernel : kernels_) {
+    if (terminate_flag) {
+      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    }
+
+    const auto& node = p_op_kernel->Node();
+    const NodeIndex node_index = node.Index();
+
+    // outputs that are still allocated from the previous run are returned as is by OpKernelContext::Output
+    OpKernelContextInternal op_kernel_context(session_state, *frame_, *p_op_kernel, logger, terminate_flag);
+
+    ORT_TRACE_PROBE3(node_begin, node_index, node.OpType().c_str(), node.Name().c_str());
+    const uint64_t node_stats_begin = node_stats ? NodeStats::Now() : 0;
+    Status status;
+    ORT_TRY {
+      if (p_op_kernel->KernelDef().AllocateInputsContiguously())
+        utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context);
+
+      concurrency::ThreadPool::LoopScope loop_scope(node.OpType(), node.Name());
+      status = p_op_kernel->Compute(&op_kernel_context);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    ORT_TRACE_PROBE3(node_end, node_index, node.OpType().c_str(), static_cast<int>(status.Code()));
+
+    if (!status.IsOK()) {
+      std::ostringstream ss;
+      ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+         << "' Status Message: " << status.ErrorMessage();
+      const auto msg_string = ss.str();
+      LOGS(logger, ERROR) << msg_string;
+      return Status(status.Category(), status.Code(), msg_string);
+    }
+
+    if (node_stats) {
+      node_stats->Record(node_index, node_stats_begin, NodeStats::Now(), NodeStats::OutputBytes(op_kernel_context));
+    }
+  }
+
+  return Status::OK();
+}
+
+void KernelReplay::ReleaseRunValues() {
+  for (int idx : run_value_idxs_) {
+    ORT_THROW_IF_ERROR(frame_->ReleaseMLValue(idx));
+  }
+}
+
+}  // namespace onnxruntime
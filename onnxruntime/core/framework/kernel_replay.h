@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/status.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+class FeedsFetchesManager;
+class OpKernel;
+class SessionState;
+
+// Replay of the kernels of a graph with static shapes, enabled with the session.kernel_replay session config entry.
+// The first run that can be replayed keeps its ExecutionFrame, so the intermediate tensors stay allocated in their
+// planned buffers. When memory patterns are enabled that is the first run after the one that created the pattern for
+// the input shapes, so the tensors are placed in the single buffer of the pattern. Later runs with the same feeds,
+// fetches and input shapes rebind the inputs and outputs in that frame and call Compute on the kernels of the
+// execution plan directly, without creating a frame, allocating the intermediate tensors or releasing them.
+// Only one run replays at a time. Runs that can't be replayed, e.g. because another run holds the frame or an input
+// shape differs from the captured one, return without executing and are executed normally by the caller.
+class KernelReplay {
+ public:
+  KernelReplay();
+  ~KernelReplay();
+
+  // Execute the graph by replaying its kernels if possible. replayed is false when the run was not executed.
+  Status TryRun(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                const bool& terminate_flag, const logging::Logger& logger, bool& replayed);
+
+  // Number of runs that were replayed.
+  size_t NumReplays() const noexcept { return num_replays_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelReplay);
+
+  // Check once whether the graph has only CPU kernels without subgraphs and static tensor outputs.
+  bool CanReplayGraph(const SessionState& session_state, const logging::Logger& logger);
+
+  // Keep a new frame for the feeds and fetches of this run if their values can be rebound in later runs.
+  bool Capture(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+               const std::vector<OrtValue>& feeds, const std::vector<OrtValue>& fetches);
+
+  bool MatchesCapture(const FeedsFetchesManager& feeds_fetches_manager, const std::vector<OrtValue>& feeds) const;
+
+  Status Replay(const SessionState& session_state, const bool& terminate_flag, const logging::Logger& logger);
+
+  // Release the values of the frame that belong to a single run, so the frame doesn't hold on to the inputs
+  // and outputs of the caller.
+  void ReleaseRunValues();
+
+  enum class GraphCheck { kNotChecked,
+                          kReplayable,
+                          kNotReplayable };
+
+  OrtMutex mutex_;
+  GraphCheck graph_check_{GraphCheck::kNotChecked};
+
+  // A capture waited for a normal run to cache the memory pattern.
+  bool capture_deferred_{false};
+
+  // Kernels in the order of the execution plan.
+  std::vector<const OpKernel*> kernels_;
+
+  std::unique_ptr<ExecutionFrame> frame_;
+  std::vector<int> feed_mlvalue_idxs_;
+  std::vector<int> fetch_mlvalue_idxs_;
+  std::vector<TensorShape> feed_shapes_;
+
+  // Values that are rebound on every run: the feeds, the fetches, and the values that share or reuse their buffers.
+  std::vector<int> run_value_idxs_;
+
+  std::atomic<size_t> num_replays_{0};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace onnxruntime {
+
+MemoryProfiler::RunTimeline::RunTimeline(size_t num_values) {
+  events_.reserve(2 * num_values);
+}
+
+void MemoryProfiler::RunTimeline::Allocate(int ort_value_idx, size_t bytes, const OrtMemoryInfo& location,
+                                           bool planned) {
+  const auto now = std::chrono::high_resolution_clock::now();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  events_.push_back({now, ort_value_idx, false, planned, bytes, location.name});
+}
+
+void MemoryProfiler::RunTimeline::Free(int ort_value_idx) {
+  const auto now = std::chrono::high_resolution_clock::now();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  events_.push_back({now, ort_value_idx, true, false, 0, nullptr});
+}
+
+MemoryProfiler::MemoryProfiler(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                               profiling::Profiler& profiler)
+    : profiler_(profiler) {
+  const size_t num_values = static_cast<size_t>(ort_value_name_idx_map.MaxIdx()) + 1;
+  value_names_.resize(num_values);
+  producers_.resize(num_values, nullptr);
+
+  for (const auto& entry : ort_value_name_idx_map) {
+    value_names_[entry.second] = entry.first;
+  }
+
+  for (const auto& node : graph_viewer.Nodes()) {
+    for (const auto* output : node.OutputDefs()) {
+      int idx;
+      if (output->Exists() && ort_value_name_idx_map.GetIdx(output->Name(), idx).IsOK()) {
+        producers_[idx] = &node;
+      }
+    }
+  }
+}
+
+std::unique_ptr<MemoryProfiler::RunTimeline> MemoryProfiler::StartRun() const {
+  return onnxruntime::make_unique<RunTimeline>(value_names_.size());
+}
+
+void MemoryProfiler::AddRun(const RunTimeline& run) {
+  const auto end_time = std::chrono::high_resolution_clock::now();
+  const auto& events = run.events_;
+
+  // Bytes of the live tensors of every location while replaying the events, and the number of
+  // events up to the highest peak.
+  struct LocationState {
+    const char* name;
+    size_t planned_bytes;
+    size_t dynamic_bytes;
+    size_t peak_bytes;
+    size_t peak_planned_bytes;
+    size_t peak_num_events;
+  };
+  std::vector<LocationState> locations;
+  std::unordered_map<int, size_t> live;  // OrtValue index to the index of its allocation event
+
+  const bool trace = profiler_.IsEnabled();
+  auto trace_location = [this](const LocationState& state, const TimePoint& time) {
+    profiler_.EndTimeAndRecordEvent(profiling::MEMORY_EVENT, std::string(state.name) + "_memory", time,
+                                    logging::GetThreadId(),
+                                    {{"planned", std::to_string(state.planned_bytes)},
+                                     {"dynamic", std::to_string(state.dynamic_bytes)}});
+  };
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    const RunTimeline::Event* allocation = &event;
+    if (event.is_free) {
+      auto it = live.find(event.ort_value_idx);
+      if (it == live.end()) {
+        continue;
+      }
+      allocation = &events[it->second];
+      live.erase(it);
+    } else {
+      live[event.ort_value_idx] = i;
+    }
+
+    auto state = std::find_if(locations.begin(), locations.end(), [allocation](const LocationState& s) {
+      return std::strcmp(s.name, allocation->location) == 0;
+    });
+    if (state == locations.end()) {
+      locations.push_back({allocation->location, 0, 0, 0, 0, 0});
+      state = locations.end() - 1;
+    }
+
+    size_t& bytes = allocation->planned ? state->planned_bytes : state->dynamic_bytes;
+    if (event.is_free) {
+      bytes -= allocation->bytes;
+    } else {
+      bytes += allocation->bytes;
+      if (state->planned_bytes + state->dynamic_bytes > state->peak_bytes) {
+        state->peak_bytes = state->planned_bytes + state->dynamic_bytes;
+        state->peak_planned_bytes = state->planned_bytes;
+        state->peak_num_events = i + 1;
+      }
+    }
+
+    if (trace) {
+      trace_location(*state, event.time);
+    }
+  }
+
+  if (trace) {
+    for (auto& state : locations) {
+      state.planned_bytes = 0;
+      state.dynamic_bytes = 0;
+      trace_location(state, end_time);
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ++num_runs_;
+  for (const auto& state : locations) {
+    auto peak = std::find_if(peaks_.begin(), peaks_.end(), [&state](const Peak& p) {
+      return p.location == state.name;
+    });
+    if (peak == peaks_.end()) {
+      peaks_.push_back(Peak());
+      peak = peaks_.end() - 1;
+      peak->location = state.name;
+    } else if (state.peak_bytes <= peak->bytes) {
+      continue;
+    }
+
+    peak->bytes = state.peak_bytes;
+    peak->planned_bytes = state.peak_planned_bytes;
+    peak->contributors = GetContributors(run, state.name, state.peak_num_events);
+  }
+}
+
+std::vector<MemoryProfiler::PeakContributor> MemoryProfiler::GetContributors(const RunTimeline& run,
+                                                                             const char* location,
+                                                                             size_t num_events) const {
+  const auto& events = run.events_;
+
+  // Replay the events up to the peak to find the tensors of the location that were live.
+  std::unordered_map<int, const RunTimeline::Event*> live;
+  for (size_t i = 0; i < num_events; ++i) {
+    const auto& event = events[i];
+    if (event.is_free) {
+      live.erase(event.ort_value_idx);
+    } else if (std::strcmp(event.location, location) == 0) {
+      live[event.ort_value_idx] = &event;
+    }
+  }
+
+  std::vector<const RunTimeline::Event*> allocations;
+  allocations.reserve(live.size());
+  for (const auto& entry : live) {
+    allocations.push_back(entry.second);
+  }
+  const size_t num_contributors = allocations.size() < kMaxPeakContributors ? allocations.size()
+                                                                           : kMaxPeakContributors;
+  std::partial_sort(allocations.begin(), allocations.begin() + num_contributors, allocations.end(),
+                    [](const RunTimeline::Event* a, const RunTimeline::Event* b) {
+                      return a->bytes > b->bytes || (a->bytes == b->bytes && a->ort_value_idx < b->ort_value_idx);
+                    });
+
+  std::vector<PeakContributor> contributors;
+  contributors.reserve(num_contributors);
+  for (size_t i = 0; i < num_contributors; ++i) {
+    const auto& allocation = *allocations[i];
+    const auto idx = static_cast<size_t>(allocation.ort_value_idx);
+    const Node* producer = idx < producers_.size() ? producers_[idx] : nullptr;
+    contributors.push_back({idx < value_names_.size() ? value_names_[idx] : std::string(),
+                            producer ? producer->Name() : std::string(),
+                            producer ? producer->OpType() : std::string(),
+                            allocation.bytes,
+                            allocation.planned});
+  }
+  return contributors;
+}
+
+void MemoryProfiler::GetPeaks(std::vector<Peak>& peaks, size_t& num_runs) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  peaks = peaks_;
+  num_runs = num_runs_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/profiler.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Memory timeline of the runs of a graph, enabled with the session.memory_profile session config entry.
+// Every ExecutionFrame records the allocations and frees of its tensors in a RunTimeline, which is added to the
+// MemoryProfiler when the run finishes. The profiler keeps, for every memory location, the highest peak of the
+// bytes of live tensors over all runs and the tensors that made it up. When the session Profiler is enabled the
+// timeline is also written to its Chrome trace as counter events.
+class MemoryProfiler {
+ public:
+  // Maximum number of tensors kept for a peak, the largest ones.
+  static constexpr size_t kMaxPeakContributors = 32;
+
+  class RunTimeline {
+   public:
+    explicit RunTimeline(size_t num_values);
+
+    // A tensor was allocated. planned is true when it was placed in a buffer of the memory pattern,
+    // false when it was allocated from the allocator of its location.
+    void Allocate(int ort_value_idx, size_t bytes, const OrtMemoryInfo& location, bool planned);
+
+    // A value was released. Values that were not allocated in this run are ignored.
+    void Free(int ort_value_idx);
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunTimeline);
+    friend class MemoryProfiler;
+
+    struct Event {
+      TimePoint time;
+      int ort_value_idx;
+      bool is_free;
+      bool planned;
+      size_t bytes;
+      const char* location;
+    };
+
+    OrtMutex mutex_;
+    std::vector<Event> events_;
+  };
+
+  struct PeakContributor {
+    std::string value_name;
+    // Node that produced the value, empty for graph inputs.
+    std::string node_name;
+    std::string op_type;
+    size_t bytes;
+    bool planned;
+  };
+
+  struct Peak {
+    std::string location;
+    size_t bytes{0};
+    size_t planned_bytes{0};
+    // Largest tensors that were live at the peak, largest first.
+    std::vector<PeakContributor> contributors;
+  };
+
+  MemoryProfiler(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                 profiling::Profiler& profiler);
+
+  std::unique_ptr<RunTimeline> StartRun() const;
+
+  // Add the timeline of a finished run. Tensors that are still live, such as the outputs, are freed at the end.
+  void AddRun(const RunTimeline& run);
+
+  // Highest peak of every location over all runs and the number of runs.
+  void GetPeaks(std::vector<Peak>& peaks, size_t& num_runs) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryProfiler);
+
+  std::vector<PeakContributor> GetContributors(const RunTimeline& run, const char* location,
+                                               size_t num_events) const;
+
+  // Indexed by OrtValue index.
+  std::vector<std::string> value_names_;
+  std::vector<const Node*> producers_;
+
+  profiling::Profiler& profiler_;
+
+  mutable OrtMutex mutex_;
+  std::vector<Peak> peaks_;
+  size_t num_runs_{0};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define NODE_STATS_TSC
+#elif defined(__clang__) || defined(__GNUC__)
+#include <x86intrin.h>
+#define NODE_STATS_TSC
+#endif
+#endif
+
+#include "core/framework/node_stats.h"
+#include "core/framework/op_kernel_context_internal.h"
+
+namespace onnxruntime {
+
+uint64_t NodeStats::Now() {
+#if defined(NODE_STATS_TSC)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#endif
+}
+
+NodeStats::NodeStats(size_t num_nodes)
+    : num_nodes_(num_nodes),
+      counters_(new Counters[num_nodes]),
+      start_ticks_(Now()),
+      start_time_(std::chrono::steady_clock::now()) {
+  for (size_t i = 0; i < num_nodes_; ++i) {
+    Counters& c = counters_[i];
+    c.calls.store(0, std::memory_order_relaxed);
+    c.output_bytes.store(0, std::memory_order_relaxed);
+    c.total_ticks.store(0, std::memory_order_relaxed);
+    c.max_ticks.store(0, std::memory_order_relaxed);
+    for (auto& bucket : c.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void NodeStats::Record(NodeIndex node_index, uint64_t start_ticks, uint64_t end_ticks, size_t output_bytes) {
+  if (node_index >= num_nodes_) {
+    return;
+  }
+
+  const uint64_t ticks = end_ticks > start_ticks ? end_ticks - start_ticks : 0;
+  size_t bucket = 0;
+  for (uint64_t t = ticks >> 1; t != 0 && bucket + 1 < kNumBuckets; t >>= 1) {
+    ++bucket;
+  }
+
+  Counters& c = counters_[node_index];
+  c.calls.fetch_add(1, std::memory_order_relaxed);
+  c.output_bytes.fetch_add(output_bytes, std::memory_order_relaxed);
+  c.total_ticks.fetch_add(ticks, std::memory_order_relaxed);
+  c.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  uint64_t max_ticks = c.max_ticks.load(std::memory_order_relaxed);
+  while (ticks > max_ticks && !c.max_ticks.compare_exchange_weak(max_ticks, ticks, std::memory_order_relaxed)) {
+  }
+}
+
+size_t NodeStats::OutputBytes(OpKernelContextInternal& context) {
+  size_t output_bytes = 0;
+  for (int i = 0; i < context.OutputCount(); ++i) {
+    const OrtValue* output = context.GetOutputMLValue(i);
+    if (output != nullptr && output->IsTensor()) {
+      output_bytes += output->Get<Tensor>().SizeInBytes();
+    }
+  }
+  return output_bytes;
+}
+
+double NodeStats::NanosecondsPerTick() const {
+  // Without a time stamp counter ticks are nanoseconds of the steady clock, and this is about 1.
+  const uint64_t ticks = Now() - start_ticks_;
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_);
+  if (ticks == 0 || ns.count() <= 0) {
+    return 1.0;
+  }
+  return static_cast<double>(ns.count()) / static_cast<double>(ticks);
+}
+
+void NodeStats::GetNodeCounters(NodeIndex node_index, NodeCounters& counters) const {
+  counters = NodeCounters();
+  if (node_index >= num_nodes_) {
+    return;
+  }
+
+  const double ns_per_tick = NanosecondsPerTick();
+  const Counters& c = counters_[node_index];
+  counters.calls = c.calls.load(std::memory_order_relaxed);
+  counters.output_bytes = c.output_bytes.load(std::memory_order_relaxed);
+  counters.total_ns = static_cast<double>(c.total_ticks.load(std::memory_order_relaxed)) * ns_per_tick;
+  counters.max_ns = static_cast<double>(c.max_ticks.load(std::memory_order_relaxed)) * ns_per_tick;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    const uint64_t calls = c.buckets[i].load(std::memory_order_relaxed);
+    if (calls > 0) {
+      counters.histogram.emplace_back(static_cast<double>(uint64_t{2} << i) * ns_per_tick, calls);
+    }
+  }
+}
+
+}  // namespace onnxruntime
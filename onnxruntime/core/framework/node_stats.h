@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class OpKernelContextInternal;
+
+// Latency statistics of the nodes of a graph that are cheap enough to leave on in production, unlike the Profiler.
+// Every node has a fixed set of counters that is updated with relaxed atomics, so recording a node neither
+// allocates nor locks, and concurrent runs of a session can record the same node.
+// Nodes are timed with the time stamp counter of the CPU where there is one, and the ticks are converted to
+// nanoseconds when the counters are read, by comparing the ticks with the steady clock since the creation.
+class NodeStats {
+ public:
+  // Latencies are counted in buckets of powers of two ticks: bucket i has the calls that took [2^i, 2^(i+1)) ticks,
+  // and the last bucket also has the longer ones.
+  static constexpr size_t kNumBuckets = 40;
+
+  explicit NodeStats(size_t num_nodes);
+
+  // Current value of the tick counter.
+  static uint64_t Now();
+
+  // Add a call of a node that ran from start_ticks to end_ticks and produced output_bytes of tensors.
+  void Record(NodeIndex node_index, uint64_t start_ticks, uint64_t end_ticks, size_t output_bytes);
+
+  // Total size of the output tensors of a kernel.
+  static size_t OutputBytes(OpKernelContextInternal& context);
+
+  // Counters of a node with the latencies in nanoseconds.
+  struct NodeCounters {
+    uint64_t calls{0};
+    uint64_t output_bytes{0};
+    double total_ns{0};
+    double max_ns{0};
+    // Upper bound in nanoseconds and number of calls of the buckets with calls.
+    std::vector<std::pair<double, uint64_t>> histogram;
+  };
+
+  // Copy the counters of a node. This can be called at any time, also while the node is being recorded.
+  void GetNodeCounters(NodeIndex node_index, NodeCounters& counters) const;
+
+  size_t NumNodes() const { return num_nodes_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeStats);
+
+  struct Counters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> output_bytes;
+    std::atomic<uint64_t> total_ticks;
+    std::atomic<uint64_t> max_ticks;
+    std::atomic<uint64_t> buckets[kNumBuckets];
+  };
+
+  double NanosecondsPerTick() const;
+
+  const size_t num_nodes_;
+  std::unique_ptr<Counters[]> counters_;
+  const uint64_t start_ticks_;
+  const std::chrono::steady_clock::time_point start_time_;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -15,13 +16,16 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
 #include "core/platform/threadpool.h"
+#include "core/platform/tracing.h"
 
 namespace onnxruntime {
 
 ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+    : out_standings_(0), has_errors_(false), terminate_flag_(terminate_flag),
+      critical_path_lengths_(session_state.GetCriticalPathLengths()),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   const auto& graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer.MaxNodeIndex());
+  node_refs_.reset(new std::atomic<size_t>[graph_viewer.MaxNodeIndex()]);
   for (auto& node : graph_viewer.Nodes()) {
     node_refs_[node.Index()] = node.GetInputEdgesCount();
   }
@@ -40,14 +44,10 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
 
   root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                          fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
   for (auto node_index : session_state.GetGraphViewer().GetRootNodes()) {
-    auto p_op_kernel = session_state.GetKernel(node_index);
-    if (!p_op_kernel)
-      continue;
-
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
-    EnqueueNode(node_index, session_state, logger);
+    if (session_state.GetKernel(node_index)) {
+      EnqueueNode(node_index, session_state, logger);
+    }
   }
 
   // Wait for finish.
@@ -120,9 +120,10 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  NodeStats* const node_stats = session_state.GetNodeStats();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  std::vector<size_t> ready_nodes;
 
-  // Avoid context switching if possible.
   while (keep_running) {
     // TODO: Convert RunNodeAsync return Status.
     // to also handle exception propagation
@@ -190,10 +191,13 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
     // Execute the kernel.
+    ORT_TRACE_PROBE3(node_begin, node_index, node.OpType().c_str(), node.Name().c_str());
+    const uint64_t node_stats_begin = node_stats ? NodeStats::Now() : 0;
     ORT_TRY {
       if (p_op_kernel->KernelDef().AllocateInputsContiguously())
         utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context);
 
+      concurrency::ThreadPool::LoopScope loop_scope(node.OpType(), node.Name());
       status = p_op_kernel->Compute(&op_kernel_context);
     }
     ORT_CATCH(const std::exception& ex) {
@@ -201,6 +205,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
         status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
       });
     }
+    ORT_TRACE_PROBE3(node_end, node_index, node.OpType().c_str(), static_cast<int>(status.Code()));
 
     if (!status.IsOK()) {
       std::ostringstream ss;
@@ -212,6 +217,10 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
+    if (node_stats) {
+      node_stats->Record(node_index, node_stats_begin, NodeStats::Now(), NodeStats::OutputBytes(op_kernel_context));
+    }
+
     if (f_profiler_enabled) {
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      node.Name() + "_kernel_time",
@@ -250,30 +259,26 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
     }
 
-    //std::cout << "Run async node finish: " << p_node_index << std::endl;
-
-    keep_running = false;
-
     // Checking which output nodes ready for running.
-    {
-      auto begin = node.OutputEdgesBegin();
-      auto end = node.OutputEdgesEnd();
-
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
-        }
+    ready_nodes.clear();
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      auto idx = (*it).GetNode().Index();
+      if (node_refs_[idx].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ready_nodes.push_back(idx);
+      }
+    }
 
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+    // Avoid context switching if possible: keep running the ready node with the longest critical path
+    // on this thread and hand the others to the thread pool.
+    keep_running = !ready_nodes.empty();
+    if (keep_running) {
+      auto longest = std::max_element(ready_nodes.cbegin(), ready_nodes.cend(),
+                                      [this](size_t lhs, size_t rhs) { return HasShorterCriticalPath(lhs, rhs); });
+      node_index = *longest;
+      for (auto it = ready_nodes.cbegin(), end = ready_nodes.cend(); it != end; ++it) {
+        if (it != longest) {
+          EnqueueNode(*it, session_state, logger);
+        }
       }
     }
   }
@@ -281,17 +286,42 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   return status;
 }
 
+bool ParallelExecutor::HasShorterCriticalPath(size_t lhs, size_t rhs) const {
+  const size_t lhs_length = lhs < critical_path_lengths_.size() ? critical_path_lengths_[lhs] : 0;
+  const size_t rhs_length = rhs < critical_path_lengths_.size() ? critical_path_lengths_[rhs] : 0;
+  return lhs_length < rhs_length;
+}
+
+size_t ParallelExecutor::PopReadyNode() {
+  std::lock_guard<OrtMutex> lock(ready_nodes_mutex_);
+  ORT_ENFORCE(!ready_nodes_.empty(), "A node run was scheduled without a ready node.");
+  std::pop_heap(ready_nodes_.begin(), ready_nodes_.end(),
+                [this](size_t lhs, size_t rhs) { return HasShorterCriticalPath(lhs, rhs); });
+  const size_t node_index = ready_nodes_.back();
+  ready_nodes_.pop_back();
+  return node_index;
+}
+
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
+  // if there are errors there's no point queuing more work
+  if (has_errors_) {
+    return;
+  }
 
-    out_standings_++;
+  {
+    std::lock_guard<OrtMutex> lock(ready_nodes_mutex_);
+    ready_nodes_.push_back(p_node_index);
+    std::push_heap(ready_nodes_.begin(), ready_nodes_.end(),
+                   [this](size_t lhs, size_t rhs) { return HasShorterCriticalPath(lhs, rhs); });
   }
 
-  onnxruntime::concurrency::ThreadPool::Schedule(executor_pool_, [this, p_node_index, &session_state, &logger]() {
+  out_standings_++;
+
+  // The task runs whichever ready node has the longest critical path when a thread gets to it, rather than
+  // p_node_index. The pool runs the tasks that a worker schedules in the opposite order on that worker, and in the
+  // order they were scheduled on the threads that steal them, so the order of the tasks can't express the priority.
+  onnxruntime::concurrency::ThreadPool::Schedule(executor_pool_, [this, &session_state, &logger]() {
+    const size_t p_node_index = PopReadyNode();
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
       const auto* node = session_state.GetGraphViewer().GetNode(p_node_index);
 
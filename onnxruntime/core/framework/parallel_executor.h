@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -35,31 +36,41 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // Whether the critical path of node lhs is shorter than that of node rhs.
+  bool HasShorterCriticalPath(size_t lhs, size_t rhs) const;
+
+  // Remove the ready node with the longest critical path from ready_nodes_.
+  size_t PopReadyNode();
+
   void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
+    if (!status.IsOK()) {
       std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
+      errors_.push_back(status);
+      has_errors_ = true;
     }
 
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
+    if (--out_standings_ == 0) {
+      //Take the lock so the notification can't be lost between the test("while (out_standings_ > 0)") and the wait
+      std::lock_guard<OrtMutex> lock(complete_mutex_);
       complete_cv_.notify_all();
     }
   }
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  // Number of input edges of each node that are not produced yet
+  std::unique_ptr<std::atomic<size_t>[]> node_refs_;
+  // Nodes whose inputs are available and that wait for a thread, as a heap with the longest critical path on top.
+  std::vector<size_t> ready_nodes_;  //protected by ready_nodes_mutex_
+  OrtMutex ready_nodes_mutex_;
+  std::atomic<int> out_standings_;
+  std::atomic<bool> has_errors_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+  std::vector<Status> errors_;  //protected by complete_mutex_
 
   const bool& terminate_flag_;
+  // See SessionState::GetCriticalPathLengths.
+  const std::vector<size_t>& critical_path_lengths_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
   onnxruntime::concurrency::ThreadPool* const executor_pool_{};
 };
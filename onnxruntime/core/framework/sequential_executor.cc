@@ -14,6 +14,8 @@
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
+#include "core/platform/tracing.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/debug_node_inputs_outputs_utils.h"
@@ -39,7 +41,6 @@ using namespace Concurrency;
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
 #include <Windows.h>
-#include "core/platform/tracing.h"
 namespace {
 LARGE_INTEGER OrtGetPerformanceFrequency() {
   LARGE_INTEGER v;
@@ -128,6 +129,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
   const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  NodeStats* const node_stats = session_state.GetNodeStats();
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
@@ -296,6 +298,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                input_activation_sizes, input_parameter_sizes, node_name_for_profiling);
     }
 
+    ORT_TRACE_PROBE3(node_begin, node_index, node.OpType().c_str(), node.Name().c_str());
+    const uint64_t node_stats_begin = node_stats ? NodeStats::Now() : 0;
     Status compute_status;
     {
 #ifdef CONCURRENCY_VISUALIZER
@@ -310,6 +314,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
         if (p_op_kernel->KernelDef().AllocateInputsContiguously())
           utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context);
           
+        concurrency::ThreadPool::LoopScope loop_scope(node.OpType(), node.Name());
         compute_status = p_op_kernel->Compute(&op_kernel_context);
       }
       ORT_CATCH(const std::exception& ex) {
@@ -322,6 +327,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       node_compute_range.End();
 #endif
     }
+    ORT_TRACE_PROBE3(node_end, node_index, node.OpType().c_str(), static_cast<int>(compute_status.Code()));
 
     if (!compute_status.IsOK()) {
       std::ostringstream ss;
@@ -332,6 +338,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       return Status(compute_status.Category(), compute_status.Code(), msg_string);
     }
 
+    if (node_stats) {
+      node_stats->Record(node_index, node_stats_begin, NodeStats::Now(), NodeStats::OutputBytes(op_kernel_context));
+    }
+
     if (is_profiler_enabled) {
       // Calculate total output sizes for this operation.
       CalculateTotalOutputSizes(&op_kernel_context, total_output_sizes, node_name_for_profiling);
@@ -3,6 +3,8 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
@@ -691,6 +693,15 @@ const SessionState* SessionState::GetSubgraphSessionState(onnxruntime::NodeIndex
   return const_cast<SessionState*>(this)->GetMutableSubgraphSessionState(index, attribute_name);
 }
 
+void SessionState::VisitSubgraphSessionStates(
+    const std::function<void(NodeIndex, const std::string&, const SessionState&)>& visit) const {
+  for (const auto& node_subgraphs : subgraph_session_states_) {
+    for (const auto& attr_subgraph : node_subgraphs.second) {
+      visit(node_subgraphs.first, attr_subgraph.first, *attr_subgraph.second);
+    }
+  }
+}
+
 const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   ORT_ENFORCE(node_index_info_, "SetGraphAndCreateKernels must be called prior to GetExecutionInfo.");
   return *node_index_info_;
@@ -960,6 +971,51 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
                                   remove_initializers, constant_initializers_use_count);
 }
 
+Status SessionState::CreateStreamExecutionPlan(const SessionOptions& session_options) {
+  if (session_options.execution_mode != ExecutionMode::ORT_PARALLEL || inter_op_thread_pool_ == nullptr) {
+    return Status::OK();
+  }
+
+  const auto num_streams_config = session_options.GetConfigOrDefault(kOrtSessionOptionsConfigInterOpNumStreams, "0");
+  char* end = nullptr;
+  const long num_streams_value = std::strtol(num_streams_config.c_str(), &end, 10);
+  ORT_RETURN_IF_NOT(end != num_streams_config.c_str() && *end == '\0' && num_streams_value >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigInterOpNumStreams, ": ", num_streams_config);
+
+  // streams beyond the number of threads that can run them at the same time only add synchronization
+  const int num_streams = static_cast<int>(
+      std::min<long>(num_streams_value, concurrency::ThreadPool::DegreeOfParallelism(inter_op_thread_pool_)));
+  if (num_streams <= 1) {
+    return Status::OK();
+  }
+
+  // the StreamExecutor doesn't synchronize fences, so it's limited to graphs that run entirely on CPU
+  for (const auto& node : graph_viewer_->Nodes()) {
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+      LOGS(logger_, WARNING) << "Node " << node.Name() << " is assigned to " << node.GetExecutionProviderType()
+                             << ". Inter-op streams are only supported for CPU graphs, the parallel executor will be used.";
+      return Status::OK();
+    }
+  }
+
+  return StreamPartitioner::CreatePlan(*graph_viewer_, *p_seq_exec_plan_, num_streams, p_stream_exec_plan_);
+}
+
+void SessionState::ComputeCriticalPathLengths() {
+  critical_path_lengths_.assign(graph_viewer_->MaxNodeIndex(), 0);
+
+  // visit consumers before producers so a node's path length is final when its producers read it.
+  const auto& order = graph_viewer_->GetNodesInTopologicalOrder();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const auto* node = graph_viewer_->GetNode(*it);
+    size_t longest_consumer_path = 0;
+    for (auto edge = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); edge != end; ++edge) {
+      longest_consumer_path = std::max(longest_consumer_path, critical_path_lengths_[edge->GetNode().Index()]);
+    }
+    critical_path_lengths_[*it] = longest_consumer_path + 1;
+  }
+}
+
 Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
                                               KernelRegistryManager& kernel_registry_manager,
                                               _In_opt_ const Node* parent_node,
@@ -988,6 +1044,27 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                                     execution_providers_, kernel_create_info_map_,
                                                     ort_value_name_idx_map_, context, p_seq_exec_plan_));
 
+  // subgraphs are always executed sequentially, so only the main graph of a parallel session gets streams and
+  // critical paths
+  if (parent_node == nullptr && session_options.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    ORT_RETURN_IF_ERROR(CreateStreamExecutionPlan(session_options));
+    ComputeCriticalPathLengths();
+  }
+
+  if (session_options.GetConfigOrDefault(kOrtSessionOptionsConfigNodeStats, "0") == "1") {
+    node_stats_ = onnxruntime::make_unique<NodeStats>(graph_viewer_->MaxNodeIndex());
+  }
+
+  if (parent_node == nullptr &&
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryProfile, "0") == "1") {
+    memory_profiler_ = onnxruntime::make_unique<MemoryProfiler>(*graph_viewer_, ort_value_name_idx_map_, profiler_);
+  }
+
+  if (parent_node == nullptr &&
+      session_options.GetConfigOrDefault(kOrtSessionOptionsConfigKernelReplay, "0") == "1") {
+    kernel_replay_ = onnxruntime::make_unique<KernelReplay>();
+  }
+
   // Uncomment the below to dump the allocation plan to std::cout
   // LOGS(logger_, VERBOSE) << std::make_pair(p_seq_exec_plan_.get(), this);
 
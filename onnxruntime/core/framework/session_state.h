@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -22,10 +23,14 @@
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/kernel_replay.h"
+#include "core/framework/memory_profiler.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/node_stats.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/stream_execution_plan.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -172,6 +177,15 @@ class SessionState {
 
   // execution plan. nullptr until FinalizeSessionState is called
   const SequentialExecutionPlan* GetExecutionPlan() const;
+
+  // partition of the execution plan into streams for the StreamExecutor.
+  // nullptr unless the session is configured to use multiple inter-op streams.
+  const StreamExecutionPlan* GetStreamExecutionPlan() const { return p_stream_exec_plan_.get(); }
+
+  // number of nodes on the longest path from each node to a graph output, including the node itself, by node index.
+  // the ParallelExecutor runs the ready nodes with the longest paths first.
+  // empty unless this is the main graph of a session with ExecutionMode::ORT_PARALLEL.
+  const std::vector<size_t>& GetCriticalPathLengths() const noexcept { return critical_path_lengths_; }
   /**
   Get the logger for this session.
   Falls back to returning Logging::LoggingManager::DefaultLogger if SetLogger has not been called.
@@ -184,6 +198,24 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
+  /**
+  Get the latency statistics of the nodes of this graph, see kOrtSessionOptionsConfigNodeStats.
+  nullptr if they are not enabled.
+  */
+  NodeStats* GetNodeStats() const noexcept { return node_stats_.get(); }
+
+  /**
+  Get the memory timeline of the runs of this graph, see kOrtSessionOptionsConfigMemoryProfile.
+  nullptr if it is not enabled, and for subgraphs.
+  */
+  MemoryProfiler* GetMemoryProfiler() const noexcept { return memory_profiler_.get(); }
+
+  /**
+  Get the replay of the kernels of this graph, see kOrtSessionOptionsConfigKernelReplay.
+  nullptr if it is not enabled, and for subgraphs.
+  */
+  KernelReplay* GetKernelReplay() const noexcept { return kernel_replay_.get(); }
+
   /**
   Get cached memory pattern based on input shapes
   */
@@ -246,6 +278,10 @@ class SessionState {
   /// Return SessionState for the given Node index and attribute name if found.
   const SessionState* GetSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name) const;
 
+  /// Call visit for the SessionState of each subgraph, with the index of its node and the attribute name.
+  void VisitSubgraphSessionStates(
+      const std::function<void(NodeIndex, const std::string&, const SessionState&)>& visit) const;
+
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
@@ -320,6 +356,11 @@ class SessionState {
   Status PopulateKernelCreateInfo(KernelRegistryManager& kernel_registry_manager, bool saving_ort_format);
 #endif
 
+  // Partitions the execution plan into streams if the session is configured to use inter-op streams.
+  Status CreateStreamExecutionPlan(const SessionOptions& session_options);
+
+  void ComputeCriticalPathLengths();
+
   Status FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                   KernelRegistryManager& kernel_registry_manager,
                                   _In_opt_ const Node* parent_node,
@@ -400,9 +441,14 @@ class SessionState {
   std::unordered_map<int, OrtCallback> deleter_for_initialized_tensors_;
   std::vector<BufferUniquePtr> weights_buffers_;
   std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
+  std::unique_ptr<StreamExecutionPlan> p_stream_exec_plan_ = nullptr;
+  std::vector<size_t> critical_path_lengths_;
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
+  std::unique_ptr<NodeStats> node_stats_;
+  std::unique_ptr<MemoryProfiler> memory_profiler_;
+  std::unique_ptr<KernelReplay> kernel_replay_;
 
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
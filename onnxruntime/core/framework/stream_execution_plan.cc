@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/stream_execution_plan.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+// Number of elements of a value, with the dimensions that are not known statically counted as 1.
+static double ElementCount(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return 1.0;
+  }
+
+  double count = 1.0;
+  for (const auto& dim : arg->Shape()->dim()) {
+    if (dim.has_dim_value() && dim.dim_value() > 0) {
+      count *= static_cast<double>(dim.dim_value());
+    }
+  }
+  return count;
+}
+
+// Size of a dimension of a value, 1 if it is not known statically.
+static double DimValue(const NodeArg* arg, int axis) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return 1.0;
+  }
+
+  const auto& shape = *arg->Shape();
+  const int rank = shape.dim_size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  if (axis < 0 || axis >= rank || !shape.dim(axis).has_dim_value() || shape.dim(axis).dim_value() <= 0) {
+    return 1.0;
+  }
+  return static_cast<double>(shape.dim(axis).dim_value());
+}
+
+double StreamPartitioner::EstimateNodeCost(const Node& node) {
+  const auto& inputs = node.InputDefs();
+  double output_elements = 0.0;
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      output_elements += ElementCount(output);
+    }
+  }
+
+  // Multiply-adds per output element.
+  double work_per_element = 1.0;
+  const auto& op_type = node.OpType();
+  if (op_type == "MatMul" && !inputs.empty()) {
+    work_per_element = DimValue(inputs[0], -1);
+  } else if (op_type == "Gemm" && !inputs.empty()) {
+    const auto& attributes = node.GetAttributes();
+    auto trans_a = attributes.find("transA");
+    const bool transposed = trans_a != attributes.end() && trans_a->second.i() != 0;
+    work_per_element = DimValue(inputs[0], transposed ? 0 : 1);
+  } else if (op_type == "Conv" && inputs.size() > 1) {
+    // W is [M, C/group, kernel...]
+    work_per_element = ElementCount(inputs[1]) / DimValue(inputs[1], 0);
+  }
+
+  return std::max(1.0, output_elements * work_per_element);
+}
+
+Status StreamPartitioner::CreatePlan(const GraphViewer& graph_viewer, const SequentialExecutionPlan& sequential_plan,
+                                     int num_streams, std::unique_ptr<StreamExecutionPlan>& plan) {
+  ORT_RETURN_IF_NOT(num_streams > 0, "num_streams must be positive. Got ", num_streams);
+
+  const auto& execution_plan = sequential_plan.execution_plan;
+  const size_t max_node_index = graph_viewer.MaxNodeIndex();
+
+  std::vector<double> costs(max_node_index, 0.0);
+  double total_cost = 0.0;
+  for (const auto& step : execution_plan) {
+    const auto* node = graph_viewer.GetNode(step.node_index);
+    ORT_RETURN_IF_NOT(node != nullptr, "Execution plan refers to a missing node: ", step.node_index);
+    costs[step.node_index] = EstimateNodeCost(*node);
+    total_cost += costs[step.node_index];
+  }
+
+  // Waiting for a producer in another stream costs about as much as an average node.
+  const double sync_cost = execution_plan.empty() ? 0.0 : total_cost / static_cast<double>(execution_plan.size());
+
+  std::vector<int> node_streams(max_node_index, -1);
+  std::vector<double> finish_times(max_node_index, 0.0);
+  std::vector<double> stream_finish_times(static_cast<size_t>(num_streams), 0.0);
+  std::vector<int> candidates;
+
+  for (const auto& step : execution_plan) {
+    const auto& node = *graph_viewer.GetNode(step.node_index);
+
+    // Try the streams of the producers first so that chains stay in one stream when it costs nothing.
+    candidates.clear();
+    for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+      const int stream = node_streams[it->GetNode().Index()];
+      if (stream >= 0 && std::find(candidates.begin(), candidates.end(), stream) == candidates.end()) {
+        candidates.push_back(stream);
+      }
+    }
+    for (int stream = 0; stream < num_streams; ++stream) {
+      if (std::find(candidates.begin(), candidates.end(), stream) == candidates.end()) {
+        candidates.push_back(stream);
+      }
+    }
+
+    int best_stream = -1;
+    double best_start_time = std::numeric_limits<double>::max();
+    for (int stream : candidates) {
+      double start_time = stream_finish_times[stream];
+      for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+        const auto producer = it->GetNode().Index();
+        if (node_streams[producer] < 0) {
+          continue;
+        }
+        const double ready_time = finish_times[producer] + (node_streams[producer] != stream ? sync_cost : 0.0);
+        start_time = std::max(start_time, ready_time);
+      }
+      if (start_time < best_start_time) {
+        best_start_time = start_time;
+        best_stream = stream;
+      }
+    }
+
+    node_streams[step.node_index] = best_stream;
+    finish_times[step.node_index] = best_start_time + costs[step.node_index];
+    stream_finish_times[best_stream] = finish_times[step.node_index];
+  }
+
+  // Drop the streams that got no nodes.
+  std::vector<int> stream_ids(static_cast<size_t>(num_streams), -1);
+  int used_streams = 0;
+  for (const auto& step : execution_plan) {
+    int& id = stream_ids[node_streams[step.node_index]];
+    if (id < 0) {
+      id = used_streams++;
+    }
+  }
+
+  plan = onnxruntime::make_unique<StreamExecutionPlan>();
+  plan->streams.resize(static_cast<size_t>(used_streams));
+  plan->node_streams.assign(max_node_index, -1);
+  plan->node_positions.assign(max_node_index, 0);
+  plan->cross_stream_input_counts.assign(max_node_index, 0);
+  plan->cross_stream_consumers.resize(max_node_index);
+
+  for (const auto& step : execution_plan) {
+    const int stream = stream_ids[node_streams[step.node_index]];
+    plan->node_streams[step.node_index] = stream;
+    plan->node_positions[step.node_index] = plan->streams[stream].size();
+    plan->streams[stream].push_back(step.node_index);
+  }
+
+  for (const auto& step : execution_plan) {
+    const auto& node = *graph_viewer.GetNode(step.node_index);
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      const auto consumer = it->GetNode().Index();
+      if (plan->node_streams[consumer] >= 0 && plan->node_streams[consumer] != plan->node_streams[step.node_index]) {
+        plan->cross_stream_consumers[step.node_index].push_back(consumer);
+        ++plan->cross_stream_input_counts[consumer];
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+// Static partition of a graph into streams for the StreamExecutor.
+// The nodes of a stream run in order, one at a time. A node only waits for the inputs it consumes
+// from other streams, which are counted in cross_stream_input_counts.
+struct StreamExecutionPlan {
+  // Nodes of each stream in execution order.
+  std::vector<std::vector<NodeIndex>> streams;
+
+  // The following are indexed by NodeIndex.
+  // Stream that runs each node, -1 for nodes that are not in the plan.
+  std::vector<int> node_streams;
+  // Position of each node in its stream.
+  std::vector<size_t> node_positions;
+  // Number of input edges of each node that come from nodes in other streams.
+  std::vector<int> cross_stream_input_counts;
+  // Consumers of each node in other streams, one entry per edge.
+  std::vector<std::vector<NodeIndex>> cross_stream_consumers;
+};
+
+class StreamPartitioner {
+ public:
+  // Estimated cost of running a node: the multiply-adds of MatMul, Gemm and Conv, and the number of output
+  // elements of other nodes. Dimensions that are not known statically count as 1.
+  static double EstimateNodeCost(const Node& node);
+
+  // Partitions the nodes of the sequential plan into at most num_streams streams. Nodes are visited in the
+  // sequential execution order and each is given to the stream where it can start first given the estimated
+  // finish times of its producers, with a synchronization cost added for producers in other streams.
+  static Status CreatePlan(const GraphViewer& graph_viewer, const SequentialExecutionPlan& sequential_plan,
+                           int num_streams, std::unique_ptr<StreamExecutionPlan>& plan);
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/stream_executor.h"
+
+#include <sstream>
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/session_state.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
+#include "core/platform/tracing.h"
+
+namespace onnxruntime {
+
+StreamExecutor::StreamExecutor(const SessionState& session_state, const bool& terminate_flag)
+    : plan_(*session_state.GetStreamExecutionPlan()),
+      running_streams_(0),
+      has_errors_(false),
+      terminate_flag_(terminate_flag),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
+  const size_t max_node_index = plan_.cross_stream_input_counts.size();
+  pending_inputs_.reset(new std::atomic<int>[max_node_index]);
+  for (size_t i = 0; i < max_node_index; ++i) {
+    pending_inputs_[i] = plan_.cross_stream_input_counts[i] + 1;
+  }
+}
+
+Status StreamExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
+                               const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
+                               std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                               const logging::Logger& logger) {
+  TimePoint tp;
+  const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  if (is_profiler_enabled) {
+    tp = session_state.Profiler().StartTime();
+  }
+
+  root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                         fetch_allocators, session_state);
+
+  const size_t num_streams = plan_.streams.size();
+  running_streams_ = num_streams;
+
+  // The calling thread runs the first stream, the others start on the thread pool.
+  bool run_first_stream = false;
+  for (size_t stream = 0; stream < num_streams; ++stream) {
+    if (Arrive(plan_.streams[stream].front())) {
+      if (stream == 0) {
+        run_first_stream = true;
+      } else {
+        ScheduleStream(stream, 0, session_state, logger);
+      }
+    }
+  }
+  if (run_first_stream) {
+    RunStream(0, 0, session_state, logger);
+  }
+
+  // Wait for finish.
+  {
+    std::unique_lock<OrtMutex> lock(complete_mutex_);
+    while (running_streams_ > 0) complete_cv_.wait(lock);
+  }
+
+  if (!errors_.empty()) {
+    Status status;
+    if (errors_.size() == 1) {
+      status = errors_.front();
+    } else {
+      std::stringstream ss;
+      ss << "Multiple errors were found.";
+      for (const auto& s : errors_) {
+        ss << '\n'
+           << s;
+      }
+
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ss.str());
+    }
+
+    LOGS(logger, ERROR) << status;
+    return status;
+  }
+
+  VLOGS(logger, 1) << "Fetching output.";
+  ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
+  VLOGS(logger, 1) << "Done execution.";
+
+  if (is_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "StreamExecutor::Execute", tp);
+  }
+
+  return Status::OK();
+}
+
+void StreamExecutor::RunStream(size_t stream, size_t position, const SessionState& session_state,
+                               const logging::Logger& logger) {
+  const auto& nodes = plan_.streams[stream];
+  while (true) {
+    const NodeIndex node_index = nodes[position];
+
+    // After an error the remaining nodes are not run, but they still release their consumers
+    // so that every parked stream reaches its end.
+    if (!has_errors_) {
+      Status status = RunNode(node_index, session_state, logger);
+      if (!status.IsOK()) {
+        RecordError(status);
+      }
+    }
+
+    for (auto consumer : plan_.cross_stream_consumers[node_index]) {
+      if (pending_inputs_[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ScheduleStream(plan_.node_streams[consumer], plan_.node_positions[consumer], session_state, logger);
+      }
+    }
+
+    if (++position == nodes.size()) {
+      break;
+    }
+    if (!Arrive(nodes[position])) {
+      return;
+    }
+  }
+
+  FinishStream();
+}
+
+Status StreamExecutor::RunNode(NodeIndex node_index, const SessionState& session_state,
+                               const logging::Logger& logger) {
+  if (terminate_flag_) {
+    LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+  }
+
+  const auto* p_op_kernel = session_state.GetKernel(node_index);
+  const auto& node = *session_state.GetGraphViewer().GetNode(node_index);
+
+  // if a kernel has been added in the session state, it better be NON-null.
+  if (p_op_kernel == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Got nullptr from GetKernel for node: ", node.Name());
+  }
+
+  OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+
+  TimePoint kernel_begin_time;
+  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  if (f_profiler_enabled) {
+    kernel_begin_time = session_state.Profiler().StartTime();
+  }
+
+  VLOGS(logger, 1) << "Computing kernel: " << node.Name();
+
+  NodeStats* const node_stats = session_state.GetNodeStats();
+  ORT_TRACE_PROBE3(node_begin, node_index, node.OpType().c_str(), node.Name().c_str());
+  const uint64_t node_stats_begin = node_stats ? NodeStats::Now() : 0;
+  Status status;
+  ORT_TRY {
+    if (p_op_kernel->KernelDef().AllocateInputsContiguously())
+      utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context);
+
+    concurrency::ThreadPool::LoopScope loop_scope(node.OpType(), node.Name());
+    status = p_op_kernel->Compute(&op_kernel_context);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+  ORT_TRACE_PROBE3(node_end, node_index, node.OpType().c_str(), static_cast<int>(status.Code()));
+
+  if (!status.IsOK()) {
+    std::ostringstream ss;
+    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+       << "' Status Message: " << status.ErrorMessage();
+    const auto msg_string = ss.str();
+    LOGS(logger, ERROR) << msg_string;
+    return Status(status.Category(), status.Code(), msg_string);
+  }
+
+  if (node_stats) {
+    node_stats->Record(node_index, node_stats_begin, NodeStats::Now(), NodeStats::OutputBytes(op_kernel_context));
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_kernel_time",
+                                                   kernel_begin_time,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                    {"provider", p_op_kernel->KernelDef().Provider()},
+                                                    {"stream", std::to_string(plan_.node_streams[node_index])}});
+  }
+
+  return Status::OK();
+}
+
+void StreamExecutor::ScheduleStream(size_t stream, size_t position, const SessionState& session_state,
+                                    const logging::Logger& logger) {
+  onnxruntime::concurrency::ThreadPool::Schedule(executor_pool_, [this, stream, position, &session_state, &logger]() {
+    RunStream(stream, position, session_state, logger);
+  });
+}
+
+void StreamExecutor::RecordError(const Status& status) {
+  std::lock_guard<OrtMutex> lock(complete_mutex_);
+  errors_.push_back(status);
+  has_errors_ = true;
+}
+
+void StreamExecutor::FinishStream() {
+  if (--running_streams_ == 0) {
+    //Take the lock so the notification can't be lost between the test("while (running_streams_ > 0)") and the wait
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    complete_cv_.notify_all();
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/iexecutor.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/session_state.h"
+#include "core/framework/stream_execution_plan.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+
+// Runs the streams of the session's StreamExecutionPlan on the inter-op thread pool.
+// Every stream runs its nodes in order. When the next node still waits for inputs from other streams the
+// stream is parked without holding a thread, and the stream that produces the last of those inputs schedules
+// it again. Nodes with no cross stream inputs run without any synchronization.
+class StreamExecutor : public IExecutor {
+ public:
+  StreamExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+
+  common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
+                         const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
+                         std::vector<OrtValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StreamExecutor);
+
+  // Runs the nodes of a stream from position, whose node must be ready, until the stream finishes or parks.
+  void RunStream(size_t stream, size_t position, const SessionState& session_state, const logging::Logger& logger);
+
+  // Called when a stream reaches a node. Returns true if the node can run now, otherwise the stream is parked
+  // on it until the last producer in another stream finishes.
+  bool Arrive(NodeIndex node_index) {
+    return plan_.cross_stream_input_counts[node_index] == 0 ||
+           pending_inputs_[node_index].fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+  Status RunNode(NodeIndex node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  void ScheduleStream(size_t stream, size_t position, const SessionState& session_state,
+                      const logging::Logger& logger);
+
+  void RecordError(const Status& status);
+
+  void FinishStream();
+
+  const StreamExecutionPlan& plan_;
+  std::unique_ptr<ExecutionFrame> root_frame_;
+  // Number of cross stream inputs of each node that are not produced yet, plus one for the arrival of its
+  // own stream. The stream or producer that brings it to zero runs the node.
+  std::unique_ptr<std::atomic<int>[]> pending_inputs_;
+  std::atomic<size_t> running_streams_;
+  std::atomic<bool> has_errors_;
+  OrtMutex complete_mutex_;
+  OrtCondVar complete_cv_;
+  std::vector<Status> errors_;  //protected by complete_mutex_
+
+  const bool& terminate_flag_;
+  onnxruntime::concurrency::ThreadPool* const executor_pool_{};
+};
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/string_view.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+/**
+ * Collects the elements of a string tensor in one buffer of chars and their offsets, and stores them in the tensor
+ * with Tensor::SetStrings, so a kernel doesn't allocate a std::string per output element.
+ */
+class StringTensorBuilder {
+ public:
+  explicit StringTensorBuilder(size_t num_strings, size_t num_chars = 0) {
+    offsets_.reserve(num_strings + 1);
+    offsets_.push_back(0);
+    chars_.reserve(num_chars);
+  }
+
+  void Append(StringView s) {
+    chars_.insert(chars_.end(), s.begin(), s.end());
+    offsets_.push_back(chars_.size());
+  }
+
+  void Append(char c) {
+    chars_.push_back(c);
+    offsets_.push_back(chars_.size());
+  }
+
+  size_t NumStrings() const noexcept {
+    return offsets_.size() - 1;
+  }
+
+  // The tensor must have as many elements as were appended.
+  void Build(Tensor& tensor) const {
+    tensor.SetStrings(chars_, offsets_);
+  }
+
+ private:
+  std::vector<char> chars_;
+  std::vector<size_t> offsets_;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/tensor.h"
 
+#include <cstring>
 #include <utility>
 #include "core/common/safeint.h"
 #include "core/framework/allocatormgr.h"
@@ -72,7 +73,8 @@ Tensor::Tensor(Tensor&& other) noexcept
       shape_(other.shape_),
       dtype_(other.dtype_),
       alloc_info_(other.alloc_info_),
-      byte_offset_(other.byte_offset_) {
+      byte_offset_(other.byte_offset_),
+      strings_(std::move(other.strings_)) {
   other.dtype_ = DataTypeImpl::GetType<float>()->AsPrimitiveDataType();
   other.shape_ = TensorShape(std::vector<int64_t>(1, 0));
   other.p_data_ = nullptr;
@@ -90,6 +92,7 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     byte_offset_ = other.byte_offset_;
     p_data_ = other.p_data_;
     buffer_deleter_ = other.buffer_deleter_;
+    strings_ = std::move(other.strings_);
 
     other.dtype_ = DataTypeImpl::GetType<float>()->AsPrimitiveDataType();
     other.shape_ = TensorShape(std::vector<int64_t>(1, 0));
@@ -105,6 +108,8 @@ Tensor::~Tensor() {
 }
 
 void Tensor::ReleaseBuffer() {
+  strings_.reset();
+
   if (buffer_deleter_) {
     // if current tensor is responsible for deleting the buffer
     // and it is a string tensor, need to explicitly call string(s)
@@ -120,4 +125,49 @@ void Tensor::ReleaseBuffer() {
   }
 }
 
+void Tensor::SetStrings(gsl::span<const char> chars, gsl::span<const size_t> offsets) {
+  ORT_ENFORCE(IsDataTypeString(), "SetStrings requires a string tensor. Got: ", DataTypeImpl::ToString(dtype_));
+  const size_t num_strings = static_cast<size_t>(shape_.Size());
+  ORT_ENFORCE(static_cast<size_t>(offsets.size()) == num_strings + 1, "Expected ", num_strings + 1,
+              " offsets for ", num_strings, " strings. Got: ", offsets.size());
+  ORT_ENFORCE(offsets[0] == 0 && offsets[num_strings] == static_cast<size_t>(chars.size()),
+              "The offsets must start at 0 and end at the number of chars.");
+  for (size_t i = 0; i < num_strings; ++i) {
+    ORT_ENFORCE(offsets[i] <= offsets[i + 1], "The offsets must not decrease. Offset ", i + 1, " is ",
+                offsets[i + 1], " after ", offsets[i]);
+  }
+
+  // the offsets come first in the buffer so they are aligned
+  const size_t offsets_bytes = SafeInt<size_t>(offsets.size()) * sizeof(size_t);
+  const size_t buffer_bytes = SafeInt<size_t>(offsets_bytes) + chars.size();
+  AllocatorPtr allocator = buffer_deleter_ ? buffer_deleter_ : std::make_shared<CPUAllocator>();
+  auto strings = onnxruntime::make_unique<ContiguousStrings>();
+  strings->buffer = BufferUniquePtr(allocator->Alloc(buffer_bytes), BufferDeleter(allocator));
+  ORT_ENFORCE(strings->buffer != nullptr, "Failed to allocate ", buffer_bytes, " bytes for the strings.");
+
+  auto* buffer = static_cast<char*>(strings->buffer.get());
+  memcpy(buffer, offsets.data(), offsets_bytes);
+  if (!chars.empty()) {
+    memcpy(buffer + offsets_bytes, chars.data(), chars.size());
+  }
+  strings->offsets = reinterpret_cast<const size_t*>(buffer);
+  strings->chars = buffer + offsets_bytes;
+  strings_ = std::move(strings);
+}
+
+void Tensor::MaterializeStrings() const {
+  ContiguousStrings& strings = *strings_;
+  std::call_once(strings.materialized, [this, &strings]() {
+    auto* ptr = reinterpret_cast<std::string*>(static_cast<char*>(p_data_) + byte_offset_);
+    for (int64_t i = 0, n = shape_.Size(); i < n; ++i) {
+      ptr[i].assign(strings.chars + strings.offsets[i], strings.offsets[i + 1] - strings.offsets[i]);
+    }
+  });
+}
+
+void Tensor::ReleaseContiguousStrings() {
+  MaterializeStrings();
+  strings_.reset();
+}
+
 }  // namespace onnxruntime
@@ -14,6 +14,7 @@
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/parallel_executor.h"
+#include "core/framework/stream_executor.h"
 #include "core/framework/session_state.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/tensorprotoutils.h"
@@ -446,6 +447,8 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
     if (!p_inter_op_thread_pool) {
       LOGS(logger, WARNING) << "Only one thread was configured for parallel execution. Hence will use sequential execution.";
       p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag, only_execute_path_to_fetches));
+    } else if (session_state.GetStreamExecutionPlan()) {
+      p_exec = std::unique_ptr<IExecutor>(new StreamExecutor(session_state, terminate_flag));
     } else {
       p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
     }
@@ -515,6 +518,18 @@ common::Status ExecuteGraph(const SessionState& session_state,
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
 
+  // replay the kernels of a previous run if the session enabled it and this run can be replayed
+  KernelReplay* kernel_replay = session_state.GetKernelReplay();
+  if (kernel_replay && execution_mode == ExecutionMode::ORT_SEQUENTIAL && !only_execute_path_to_fetches &&
+      feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::NoCopy) {
+    bool replayed = false;
+    ORT_RETURN_IF_ERROR(kernel_replay->TryRun(session_state, feeds_fetches_manager, feeds, fetches,
+                                              terminate_flag, logger, replayed));
+    if (replayed) {
+      return Status::OK();
+    }
+  }
+
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
                                  execution_mode, terminate_flag, logger, only_execute_path_to_fetches);
 
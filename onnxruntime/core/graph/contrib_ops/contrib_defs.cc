@@ -165,6 +165,13 @@ using ONNX_NAMESPACE::AttributeProto;
 using ONNX_NAMESPACE::OpSchema;
 using ONNX_NAMESPACE::OPTIONAL_VALUE;
 
+void convPoolShapeInferenceNhwc(
+    ONNX_NAMESPACE::InferenceContext& ctx,
+    bool use_dilation,
+    bool require_kernel_shape,
+    int input1Idx,
+    int input2Idx);
+
 void ValidateTypeAndShapeForScaleAndZP(ONNX_NAMESPACE::InferenceContext& ctx, int index, ::google::protobuf::int32 expectedType, bool isScalar, int expectedTensorSize = 0) {
   if (ctx.getNumInputs() > static_cast<size_t>(index)) {
     auto data_type = ctx.getInputType(index);
@@ -306,6 +313,49 @@ void FusedMatMulShapeInference(ONNX_NAMESPACE::InferenceContext& ctx) {
   updateOutputShape(ctx, 0, resultShape);
 }
 
+// The decoder subgraph of GreedySearch and BeamSearch is type inferred with the types it declares for its inputs.
+// The sequences output has the batch size of input_ids and output_rank dimensions.
+void GenerationShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int output_rank) {
+  updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT32);
+  if (ctx.getNumOutputs() > 1) {
+    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::FLOAT);
+  }
+
+  const auto* decoder = ctx.getAttribute("decoder");
+  auto* graph_inferencer = ctx.getGraphAttributeInferencer("decoder");
+  if (decoder != nullptr && graph_inferencer != nullptr) {
+    std::vector<const ONNX_NAMESPACE::TypeProto*> input_types;
+    std::vector<const ONNX_NAMESPACE::TensorProto*> input_data;
+    for (const auto& input : decoder->g().input()) {
+      input_types.push_back(&input.type());
+      input_data.push_back(nullptr);
+    }
+    graph_inferencer->doInferencing(input_types, input_data);
+  }
+
+  if (!hasInputShape(ctx, 0)) {
+    return;
+  }
+  auto& input_ids_shape = getInputShape(ctx, 0);
+  if (input_ids_shape.dim_size() != 2) {
+    fail_shape_inference("Inputs 0 shall be 2 dimensions");
+  }
+
+  ONNX_NAMESPACE::TensorShapeProto sequences_shape;
+  *sequences_shape.add_dim() = input_ids_shape.dim(0);
+  for (int i = 1; i < output_rank; i++) {
+    sequences_shape.add_dim();
+  }
+  updateOutputShape(ctx, 0, sequences_shape);
+
+  if (ctx.getNumOutputs() > 1) {
+    ONNX_NAMESPACE::TensorShapeProto scores_shape;
+    *scores_shape.add_dim() = input_ids_shape.dim(0);
+    scores_shape.add_dim();
+    updateOutputShape(ctx, 1, scores_shape);
+  }
+}
+
 std::function<void(OpSchema&)> QLinearMathDocGenerator(const char* name, const char* additionalDocumentation) {
   return [=](OpSchema& schema) {
     std::string doc = R"DOC(
@@ -626,6 +676,232 @@ will be calculated.)DOC";
         updateOutputShape(ctx, 1, mask_index_shape);
       });
 
+  static const char* RemovePadding_ver1_doc = R"DOC(
+Removes the padding tokens of a batch. The real tokens of all sequences are concatenated into a single packed
+sequence with shape (1, total_token_count, hidden_size), so that token-wise operators only compute the real tokens.
+The mask_index input has the same format as the one of Attention without past state: either the number of real
+tokens of each sequence for right-side padding, like the mask_index output of EmbedLayerNormalization, or a raw
+attention mask where a token is real when its value is not zero. The token_offset output is the index of each token
+in the packed sequence, or -1 for a padding token, and is used by RestorePadding. The cumulative_sequence_length
+output has the start offset of each sequence in the packed sequence followed by total_token_count, and is used by
+PackedAttention.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(RemovePadding)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(RemovePadding_ver1_doc)
+      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Input(1, "mask_index", "Mask index with shape (batch_size), or raw attention mask with shape (batch_size, sequence_length)", "M")
+      .Output(0, "output", "3D output tensor with shape (1, total_token_count, hidden_size)", "T")
+      .Output(1, "token_offset", "2D tensor with shape (batch_size, sequence_length)", "M")
+      .Output(2, "cumulative_sequence_length", "1D tensor with shape (batch_size + 1)", "M")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index and offsets to integer types")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        propagateElemTypeFromInputToOutput(ctx, 1, 1);
+        propagateElemTypeFromInputToOutput(ctx, 1, 2);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 3) {
+          fail_shape_inference("Inputs 0 shall be 3 dimensions");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        output_shape.add_dim()->set_dim_value(1);
+        output_shape.add_dim();
+        *output_shape.add_dim() = input_shape.dim(2);
+        updateOutputShape(ctx, 0, output_shape);
+
+        ONNX_NAMESPACE::TensorShapeProto token_offset_shape;
+        *token_offset_shape.add_dim() = input_shape.dim(0);
+        *token_offset_shape.add_dim() = input_shape.dim(1);
+        updateOutputShape(ctx, 1, token_offset_shape);
+
+        ONNX_NAMESPACE::TensorShapeProto cumulative_sequence_length_shape;
+        auto* batch_dim = cumulative_sequence_length_shape.add_dim();
+        if (input_shape.dim(0).has_dim_value()) {
+          batch_dim->set_dim_value(input_shape.dim(0).dim_value() + 1);
+        }
+        updateOutputShape(ctx, 2, cumulative_sequence_length_shape);
+      });
+
+  static const char* RestorePadding_ver1_doc = R"DOC(
+Scatters the tokens of a packed sequence produced by RemovePadding back to the padded batch. The padding tokens of
+the output are set to zero.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(RestorePadding)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(RestorePadding_ver1_doc)
+      .Input(0, "input", "3D input tensor with shape (1, total_token_count, hidden_size)", "T")
+      .Input(1, "token_offset", "2D tensor with shape (batch_size, sequence_length)", "M")
+      .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("M", {"tensor(int32)"}, "Constrain token offset to integer types")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+          return;
+        }
+
+        auto& input_shape = getInputShape(ctx, 0);
+        auto& token_offset_shape = getInputShape(ctx, 1);
+        if (input_shape.dim_size() != 3) {
+          fail_shape_inference("Inputs 0 shall be 3 dimensions");
+        }
+        if (token_offset_shape.dim_size() != 2) {
+          fail_shape_inference("Inputs 1 shall be 2 dimensions");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        *output_shape.add_dim() = token_offset_shape.dim(0);
+        *output_shape.add_dim() = token_offset_shape.dim(1);
+        *output_shape.add_dim() = input_shape.dim(2);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  static const char* PackedAttention_ver1_doc = R"DOC(
+Multi-Head Self Attention over a packed sequence produced by RemovePadding. The input contains the real tokens of all
+sequences of a batch concatenated together, and each token only attends to the tokens of its own sequence as given by
+cumulative_sequence_length. The QKV projection is computed for the real tokens only and the attention is computed for
+each sequence separately, so no work is spent on padding. When unidirectional is 1, each token only attends to the
+previous tokens of its sequence.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(PackedAttention)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(PackedAttention_ver1_doc)
+      .Attr("num_heads", "Number of attention heads", AttributeProto::INT)
+      .Attr("unidirectional",
+            "Whether every token can only attend to previous tokens. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Input(0, "input", "3D input tensor with shape (1, total_token_count, hidden_size), hidden_size = num_heads * head_size", "T")
+      .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size)", "T")
+      .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
+      .Input(3, "cumulative_sequence_length", "1D tensor with shape (batch_size + 1)", "M")
+      .Output(0, "output", "3D output tensor with shape (1, total_token_count, hidden_size)", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("M", {"tensor(int32)"}, "Constrain cumulative sequence length to integer types")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (hasInputShape(ctx, 0)) {
+          propagateShapeFromInputToOutput(ctx, 0, 0);
+        }
+      });
+
+  static const char* GreedySearch_ver1_doc = R"DOC(
+Generates sequences from a prompt with a GPT-2 style decoder subgraph, choosing the token with the highest probability
+at each step, or sampling it when do_sample is 1. The decoder subgraph is run inside the operator until every sequence
+has generated eos_token_id or max_length tokens, so the whole generation is a single node.
+
+The decoder subgraph has inputs input_ids (batch_size, sequence_length), position_ids (batch_size, sequence_length)
+and attention_mask (batch_size, total_sequence_length) of int32, followed by one float past state per layer with
+shape (2, batch_size, num_heads, past_sequence_length, head_size). Its outputs are the float logits
+(batch_size, sequence_length, vocab_size) followed by one present state per layer with shape
+(2, batch_size, num_heads, total_sequence_length, head_size). The present states are fed back as the past states of
+the next step, which only feeds the new token. A decoder without past states is fed the whole sequence at each step.
+Sequences that finish before the others are padded with pad_token_id.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GreedySearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(GreedySearch_ver1_doc)
+      .Attr("eos_token_id", "The id of the end-of-sequence token", AttributeProto::INT)
+      .Attr("pad_token_id", "The id of the padding token", AttributeProto::INT)
+      .Attr("no_repeat_ngram_size",
+            "If positive, an n-gram of this size can only occur once in a sequence. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("do_sample",
+            "Whether the next token is sampled from its probabilities instead of being the most likely token. "
+            "Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("seed", "(Optional) Seed to the random generator used when do_sample is 1.", AttributeProto::FLOAT,
+            OPTIONAL_VALUE)
+      .Attr("decoder", "The GPT-2 style decoder subgraph that computes the logits of the next token.",
+            AttributeProto::GRAPH)
+      .Input(0, "input_ids", "2D tensor with shape (batch_size, sequence_length) of the prompt tokens", "I")
+      .Input(1, "max_length", "Scalar with the maximum length of the sequences, including the prompt", "I")
+      .Input(2, "min_length", "Scalar with the minimum length of the sequences. Default value is 0.", "I",
+             OpSchema::Optional)
+      .Input(3, "repetition_penalty",
+             "Scalar that divides the positive logits and multiplies the negative logits of tokens already in the "
+             "sequence. Default value is 1.0.",
+             "T", OpSchema::Optional)
+      .Input(4, "temperature", "Scalar that divides the logits. Default value is 1.0.", "T", OpSchema::Optional)
+      .Input(5, "top_k",
+             "Scalar with the number of most likely tokens that can be sampled, or 0 for all of them. "
+             "Default value is 0.",
+             "I", OpSchema::Optional)
+      .Input(6, "top_p",
+             "Scalar with the cumulative probability of the most likely tokens that can be sampled. "
+             "Default value is 1.0.",
+             "T", OpSchema::Optional)
+      .Output(0, "sequences", "2D tensor with shape (batch_size, max_length) of the generated sequences", "I")
+      .TypeConstraint("I", {"tensor(int32)"}, "Constrain token ids and lengths to int32 tensors.")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain the logits processing parameters to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        GenerationShapeInference(ctx, 2);
+      });
+
+  static const char* BeamSearch_ver1_doc = R"DOC(
+Generates sequences from a prompt with beam search over a GPT-2 style decoder subgraph, which has the same inputs and
+outputs as the decoder of GreedySearch. num_beams sequences are kept for each batch entry, and the decoder is run on
+all of them at once. The prompt is only run once per batch entry, and the past states of the decoder are reordered
+only when the beams change. A sequence is finished when it generates eos_token_id, and is scored with the sum of the
+log probabilities of its tokens divided by its length to the power of length_penalty.)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(BeamSearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(BeamSearch_ver1_doc)
+      .Attr("eos_token_id", "The id of the end-of-sequence token", AttributeProto::INT)
+      .Attr("pad_token_id", "The id of the padding token", AttributeProto::INT)
+      .Attr("no_repeat_ngram_size",
+            "If positive, an n-gram of this size can only occur once in a sequence. Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("early_stopping",
+            "Whether the search of a batch entry stops as soon as num_beams sequences are finished. "
+            "Default value is 0.",
+            AttributeProto::INT,
+            static_cast<int64_t>(0))
+      .Attr("decoder", "The GPT-2 style decoder subgraph that computes the logits of the next token.",
+            AttributeProto::GRAPH)
+      .Input(0, "input_ids", "2D tensor with shape (batch_size, sequence_length) of the prompt tokens", "I")
+      .Input(1, "max_length", "Scalar with the maximum length of the sequences, including the prompt", "I")
+      .Input(2, "min_length", "Scalar with the minimum length of the sequences. Default value is 0.", "I",
+             OpSchema::Optional)
+      .Input(3, "num_beams", "Scalar with the number of beams", "I")
+      .Input(4, "num_return_sequences",
+             "Scalar with the number of sequences returned for each batch entry, which is not larger than "
+             "num_beams. Default value is 1.",
+             "I", OpSchema::Optional)
+      .Input(5, "temperature", "Scalar that divides the logits. Default value is 1.0.", "T", OpSchema::Optional)
+      .Input(6, "length_penalty",
+             "Scalar exponent of the sequence length that divides the score of a finished sequence. "
+             "Default value is 1.0.",
+             "T", OpSchema::Optional)
+      .Input(7, "repetition_penalty",
+             "Scalar that divides the positive logits and multiplies the negative logits of tokens already in the "
+             "sequence. Default value is 1.0.",
+             "T", OpSchema::Optional)
+      .Output(0, "sequences",
+              "3D tensor with shape (batch_size, num_return_sequences, max_length) of the best sequences", "I")
+      .Output(1, "sequences_scores", "2D tensor with shape (batch_size, num_return_sequences) of their scores", "T",
+              OpSchema::Optional)
+      .TypeConstraint("I", {"tensor(int32)"}, "Constrain token ids and lengths to int32 tensors.")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain scores and the logits processing parameters to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        GenerationShapeInference(ctx, 3);
+      });
+
   static const char* FastGelu_ver1_doc = R"DOC(
 GELU (Gaussian Error Linear Unit) approximation: Y=0.5*X*(1+tanh(0.797885*X+0.035677*X*X*X)) with an optional input of bias that will be added to X before GELU.)DOC";
 
@@ -1316,7 +1592,8 @@ Sample echo operator.)DOC");
       .SinceVersion(1)
       .SetDoc(R"DOC(
 The fused convolution operator schema is the same as Conv besides it includes an attribute
-activation.)DOC")
+activation. If the attribute channels_last is set, the input and output tensors use the
+channels last (NHWC) layout while the weight tensor remains in the OIHW layout.)DOC")
       .Attr(
           "auto_pad",
           "",
@@ -1357,6 +1634,11 @@ activation.)DOC")
           "",
           AttributeProto::FLOATS,
           OPTIONAL_VALUE)
+      .Attr(
+          "channels_last",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(0))
       .Input(
           0,
           "X",
@@ -1381,7 +1663,11 @@ activation.)DOC")
       .TypeConstraint("T", {"tensor(float16)", "tensor(float)", "tensor(double)"}, "Constrain input and output types to float tensors")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
         ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
-        ONNX_NAMESPACE::convPoolShapeInference(ctx, true, false, 0, 1);
+        if (ONNX_NAMESPACE::getAttribute(ctx, "channels_last", 0) == 0) {
+          ONNX_NAMESPACE::convPoolShapeInference(ctx, true, false, 0, 1);
+        } else {
+          convPoolShapeInferenceNhwc(ctx, true, false, 0, 1);
+        }
       });
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(FusedGemm)
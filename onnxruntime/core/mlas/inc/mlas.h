@@ -122,6 +122,10 @@ enum MLAS_ACTIVATION_KIND {
     MlasTanhActivation,
     MlasLogisticActivation,
     MlasClipActivation,
+    MlasGeluActivation,
+    MlasFastGeluActivation,
+    MlasSwishActivation,
+    MlasSoftplusActivation,
 };
 
 struct MLAS_ACTIVATION {
@@ -134,6 +138,9 @@ struct MLAS_ACTIVATION {
             float minimum;
             float maximum;
         } Clip;
+        struct {
+            float alpha;
+        } Swish;
         float Values[2];
     } Parameters;
 };
@@ -368,6 +375,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -445,6 +453,19 @@ MlasConvDepthwise(
     size_t KernelSize
     );
 
+void
+MLASCALL
+MlasConvDepthwise(
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize,
+    const MLAS_ACTIVATION* Activation
+    );
+
 //
 // Pooling routines.
 //
@@ -474,6 +495,14 @@ MlasPool(
 //
 // Miscellaneous compute routines.
 //
+// The fast compute mode trades accuracy for throughput by using cheaper
+// approximations or hardware estimates where available.
+//
+
+enum MLAS_COMPUTE_MODE {
+    MlasComputeModeAccurate,
+    MlasComputeModeFast,
+};
 
 void
 MLASCALL
@@ -510,6 +539,18 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasComputeSoftmaxStrided(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    size_t Stride,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -518,6 +559,77 @@ MlasComputeTanh(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeReciprocalSqrt(
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_COMPUTE_MODE Mode
+    );
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Exponent
+    );
+
+void
+MLASCALL
+MlasComputeGelu(
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    MLAS_COMPUTE_MODE Mode
+    );
+
+void
+MLASCALL
+MlasComputeSwish(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Alpha
+    );
+
+void
+MLASCALL
+MlasComputeSoftplus(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InverseStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -464,5 +464,77 @@ Return Value:
             MlasActivationKernel<MlasClipActivation>(Activation, Buffer, Bias, M, N, ldc);
             break;
         }
+
+        case MlasGeluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            if (N == ldc) {
+                MlasComputeGelu(Buffer, nullptr, Buffer, M * N, MlasComputeModeAccurate);
+            } else {
+                while (M-- > 0) {
+                    MlasComputeGelu(Buffer, nullptr, Buffer, N, MlasComputeModeAccurate);
+                    Buffer += ldc;
+                }
+            }
+
+            break;
+        }
+
+        case MlasFastGeluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            if (N == ldc) {
+                MlasComputeGelu(Buffer, nullptr, Buffer, M * N, MlasComputeModeFast);
+            } else {
+                while (M-- > 0) {
+                    MlasComputeGelu(Buffer, nullptr, Buffer, N, MlasComputeModeFast);
+                    Buffer += ldc;
+                }
+            }
+
+            break;
+        }
+
+        case MlasSwishActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            if (N == ldc) {
+                MlasComputeSwish(Buffer, Buffer, M * N, Activation->Parameters.Swish.alpha);
+            } else {
+                while (M-- > 0) {
+                    MlasComputeSwish(Buffer, Buffer, N, Activation->Parameters.Swish.alpha);
+                    Buffer += ldc;
+                }
+            }
+
+            break;
+        }
+
+        case MlasSoftplusActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            if (N == ldc) {
+                MlasComputeSoftplus(Buffer, Buffer, M * N);
+            } else {
+                while (M-- > 0) {
+                    MlasComputeSoftplus(Buffer, Buffer, N);
+                    Buffer += ldc;
+                }
+            }
+
+            break;
+        }
     }
 }
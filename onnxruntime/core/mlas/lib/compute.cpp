@@ -75,8 +75,17 @@ struct MLAS_SOFTMAX_WORK_BLOCK {
     float* Output;
     size_t N;
     size_t D;
+    size_t Stride;
 };
 
+//
+// Define the number of columns of a strided softmax operation that are
+// processed as a unit. The intermediate per column values are kept in local
+// buffers of this size.
+//
+
+#define MLAS_SOFTMAX_STRIDED_BLOCK_SIZE     128
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasComputeExpVector(
@@ -989,3 +998,276 @@ Return Value:
 
     MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, ThreadCountN, ThreadPool);
 }
+
+void
+MlasComputeSoftmaxStridedThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    strided softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    const size_t D = WorkBlock->D;
+    const size_t Stride = WorkBlock->Stride;
+    const bool LogSoftmax = WorkBlock->LogSoftmax;
+
+    //
+    // Partition the operation along the N dimension and the blocks of columns
+    // of the stride dimension.
+    //
+
+    const size_t BlockCountS = (Stride + MLAS_SOFTMAX_STRIDED_BLOCK_SIZE - 1) /
+        MLAS_SOFTMAX_STRIDED_BLOCK_SIZE;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N * BlockCountS,
+        &WorkIndex, &WorkRemaining);
+
+    MLAS_DECLSPEC_ALIGN(float Maximum[MLAS_SOFTMAX_STRIDED_BLOCK_SIZE], 16 * sizeof(float));
+    MLAS_DECLSPEC_ALIGN(float Accumulation[MLAS_SOFTMAX_STRIDED_BLOCK_SIZE], 16 * sizeof(float));
+    MLAS_DECLSPEC_ALIGN(float Buffer[MLAS_SOFTMAX_STRIDED_BLOCK_SIZE], 16 * sizeof(float));
+
+    while (WorkRemaining > 0) {
+
+        const size_t n = WorkIndex / BlockCountS;
+        const size_t s = (WorkIndex % BlockCountS) * MLAS_SOFTMAX_STRIDED_BLOCK_SIZE;
+        const size_t CountS = std::min(Stride - s, size_t(MLAS_SOFTMAX_STRIDED_BLOCK_SIZE));
+
+        const float* Input = WorkBlock->Input + n * D * Stride + s;
+        float* Output = WorkBlock->Output + n * D * Stride + s;
+
+        //
+        // Find the maximum value for each column.
+        //
+
+        std::copy_n(Input, CountS, Maximum);
+
+        for (size_t d = 1; d < D; d++) {
+
+            const float* InputRow = Input + d * Stride;
+            size_t i = 0;
+
+            for (; i + 4 <= CountS; i += 4) {
+                MlasStoreAlignedFloat32x4(&Maximum[i], MlasMaximumFloat32x4(
+                    MlasLoadFloat32x4(&Maximum[i]), MlasLoadFloat32x4(&InputRow[i])));
+            }
+
+            for (; i < CountS; i++) {
+                Maximum[i] = std::max(Maximum[i], InputRow[i]);
+            }
+        }
+
+        //
+        // Compute the exponential function for each element shifted by the
+        // maximum of its column and accumulate the sum for each column. The
+        // softmax operation stores the exponential values to the output, while
+        // the log softmax operation only needs the sums.
+        //
+
+        std::fill_n(Accumulation, CountS, 0.0f);
+
+        for (size_t d = 0; d < D; d++) {
+
+            const float* InputRow = Input + d * Stride;
+            float* ExpRow = LogSoftmax ? Buffer : Output + d * Stride;
+            size_t i = 0;
+
+            for (; i + 4 <= CountS; i += 4) {
+                MlasStoreAlignedFloat32x4(&Buffer[i], MlasSubtractFloat32x4(
+                    MlasLoadFloat32x4(&InputRow[i]), MlasLoadFloat32x4(&Maximum[i])));
+            }
+
+            for (; i < CountS; i++) {
+                Buffer[i] = InputRow[i] - Maximum[i];
+            }
+
+#if defined(MLAS_TARGET_AMD64)
+            MlasPlatform.ComputeExpF32Kernel(Buffer, ExpRow, CountS);
+#else
+            MlasComputeExpF32Kernel(Buffer, ExpRow, CountS);
+#endif
+
+            for (i = 0; i + 4 <= CountS; i += 4) {
+                MlasStoreAlignedFloat32x4(&Accumulation[i], MlasAddFloat32x4(
+                    MlasLoadFloat32x4(&Accumulation[i]), MlasLoadFloat32x4(&ExpRow[i])));
+            }
+
+            for (; i < CountS; i++) {
+                Accumulation[i] += ExpRow[i];
+            }
+        }
+
+        if (LogSoftmax) {
+
+            //
+            // Compute the log softmax output as the input shifted by the
+            // maximum and then by the logarithm of the sum for each column.
+            // The shifts are applied separately to avoid losing precision
+            // when the maximum is large in magnitude.
+            //
+
+            MlasComputeLog(Accumulation, Accumulation, CountS);
+
+            for (size_t d = 0; d < D; d++) {
+
+                const float* InputRow = Input + d * Stride;
+                float* OutputRow = Output + d * Stride;
+                size_t i = 0;
+
+                for (; i + 4 <= CountS; i += 4) {
+                    MLAS_FLOAT32X4 Vector = MlasSubtractFloat32x4(MlasLoadFloat32x4(&InputRow[i]),
+                        MlasLoadFloat32x4(&Maximum[i]));
+                    MlasStoreFloat32x4(&OutputRow[i], MlasSubtractFloat32x4(Vector,
+                        MlasLoadFloat32x4(&Accumulation[i])));
+                }
+
+                for (; i < CountS; i++) {
+                    OutputRow[i] = (InputRow[i] - Maximum[i]) - Accumulation[i];
+                }
+            }
+
+        } else {
+
+            //
+            // Normalize the softmax output by the reciprocal of the sum for
+            // each column.
+            //
+
+            for (size_t i = 0; i < CountS; i++) {
+                Accumulation[i] = 1.0f / Accumulation[i];
+            }
+
+            for (size_t d = 0; d < D; d++) {
+
+                float* OutputRow = Output + d * Stride;
+                size_t i = 0;
+
+                for (; i + 4 <= CountS; i += 4) {
+                    MlasStoreFloat32x4(&OutputRow[i], MlasMultiplyFloat32x4(
+                        MlasLoadFloat32x4(&OutputRow[i]), MlasLoadFloat32x4(&Accumulation[i])));
+                }
+
+                for (; i < CountS; i++) {
+                    OutputRow[i] *= Accumulation[i];
+                }
+            }
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxStrided(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    size_t Stride,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along the middle
+    dimension of a tensor with shape [N, D, Stride]. The columns of the stride
+    dimension are processed with vector operations, so no transpose of the
+    tensor is required.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of outer elements to process.
+
+    D - Supplies the number of elements along the softmax dimension.
+
+    Stride - Supplies the number of elements between consecutive elements
+        along the softmax dimension.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Stride == 1) {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, ThreadPool);
+        return;
+    }
+
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the softmax parameters to the work block.
+    //
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Stride = Stride;
+
+    //
+    // Compute the number of target threads given the complexity of the softmax
+    // operation. Limit the number of threads to the number of blocks of
+    // columns and try to keep each thread processing a minimum number of
+    // elements before using another thread.
+    //
+
+    const size_t BlockCount = N * ((Stride + MLAS_SOFTMAX_STRIDED_BLOCK_SIZE - 1) /
+        MLAS_SOFTMAX_STRIDED_BLOCK_SIZE);
+
+    int32_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = int32_t(BlockCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t ElementBlockCount = ((N * D * Stride) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > ElementBlockCount) {
+        ThreadCountN = int32_t(ElementBlockCount);
+    }
+
+    WorkBlock.ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxStridedThreaded, &WorkBlock, ThreadCountN, ThreadPool);
+}
@@ -736,6 +736,256 @@ Return Value:
     }
 }
 
+void
+MlasConvDepthwiseOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the depthwise convolution operation for a single
+    input channel plane and a single filter.
+
+    Each output row is accumulated in place by sweeping the kernel taps over
+    the corresponding input rows, which keeps the output row resident in the
+    cache and avoids the image expansion required by the GEMM based paths.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input channel plane.
+
+    Filter - Supplies the filter for the input channel plane.
+
+    Output - Supplies the output channel plane.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = Parameters->KernelShape[1];
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
+
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        float* output = Output + oh * OutputWidth;
+
+        size_t n = 0;
+
+        for (; n + 4 <= OutputWidth; n += 4) {
+            MlasStoreFloat32x4(&output[n], ZeroFloat32x4);
+        }
+
+        for (; n < OutputWidth; n++) {
+            output[n] = 0.0f;
+        }
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            //
+            // N.B. The input row index wraps around for rows inside the top
+            // padding region, so a single unsigned comparison rejects rows in
+            // both padding regions.
+            //
+
+            const size_t ih = oh * StrideHeight + ky * DilationHeight - PaddingTop;
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            const float* InputRow = Input + ih * InputWidth;
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                //
+                // Compute the range of output columns that sample from inside
+                // the input row for this kernel tap.
+                //
+
+                const size_t KernelOffset = kx * DilationWidth;
+
+                if (KernelOffset >= InputWidth + PaddingLeft) {
+                    break;
+                }
+
+                size_t OutputStart = 0;
+
+                if (KernelOffset < PaddingLeft) {
+                    OutputStart = (PaddingLeft - KernelOffset + StrideWidth - 1) / StrideWidth;
+                }
+
+                size_t OutputEnd = (InputWidth + PaddingLeft - KernelOffset + StrideWidth - 1) / StrideWidth;
+
+                if (OutputEnd > OutputWidth) {
+                    OutputEnd = OutputWidth;
+                }
+
+                if (OutputStart >= OutputEnd) {
+                    continue;
+                }
+
+                const float FilterValue = Filter[ky * KernelWidth + kx];
+                const float* input = InputRow + OutputStart * StrideWidth + KernelOffset - PaddingLeft;
+                float* out = output + OutputStart;
+                size_t CountN = OutputEnd - OutputStart;
+
+                if (StrideWidth == 1) {
+
+                    const MLAS_FLOAT32X4 FilterVector = MlasBroadcastFloat32x4(FilterValue);
+
+                    while (CountN >= 8) {
+
+                        MLAS_FLOAT32X4 Output0 = MlasLoadFloat32x4(&out[0]);
+                        MLAS_FLOAT32X4 Output1 = MlasLoadFloat32x4(&out[4]);
+
+                        Output0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&input[0]), FilterVector, Output0);
+                        Output1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&input[4]), FilterVector, Output1);
+
+                        MlasStoreFloat32x4(&out[0], Output0);
+                        MlasStoreFloat32x4(&out[4], Output1);
+
+                        input += 8;
+                        out += 8;
+                        CountN -= 8;
+                    }
+
+                    if (CountN >= 4) {
+
+                        MLAS_FLOAT32X4 Output0 = MlasLoadFloat32x4(out);
+
+                        Output0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input), FilterVector, Output0);
+
+                        MlasStoreFloat32x4(out, Output0);
+
+                        input += 4;
+                        out += 4;
+                        CountN -= 4;
+                    }
+
+                    while (CountN > 0) {
+                        *out++ += *input++ * FilterValue;
+                        CountN--;
+                    }
+
+                } else {
+
+                    while (CountN > 0) {
+                        *out++ += *input * FilterValue;
+                        input += StrideWidth;
+                        CountN--;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of indices to use for this thread.
+    //
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+
+    size_t BatchGroupStart;
+    size_t BatchGroupRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, BatchGroupCount,
+        &BatchGroupStart, &BatchGroupRemaining);
+
+    const size_t BatchGroupEnd = BatchGroupStart + BatchGroupRemaining;
+
+    //
+    // Iterate over the batch and groups allocated to this thread. Each group
+    // has a single input channel that produces FilterCount output channels.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        const float* input = WorkBlock->Input + bg * InputSize;
+        const float* filter = WorkBlock->Filter + group * FilterCount * K;
+        float* output = WorkBlock->Output + bg * FilterCount * OutputSize;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            MlasConvDepthwiseOperation(Parameters, input, filter, output);
+
+            filter += K;
+            output += OutputSize;
+        }
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasActivation(Parameters->Activation, output - FilterCount * OutputSize,
+            bias, FilterCount, OutputSize, OutputSize);
+    }
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -881,6 +1131,35 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // Schedule batches of depthwise convolutions across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= BatchGroupCount) {
+            TargetThreadCount = int32_t(BatchGroupCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -988,6 +1267,16 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmDepthwise:
+                {
+                    //
+                    // Depthwise convolutions are scheduled above across all
+                    // batches and groups.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1148,6 +1437,19 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect a depthwise convolution where each group has a single input
+    // channel. These are computed directly from the input tensor instead of
+    // expanding the image for a GEMM with a tiny K dimension.
+    //
+
+    if (Dimensions == 2 && InputChannels == 1 && GroupCount > 1) {
+
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -1381,3 +1683,145 @@ MlasConvDepthwise<uint8_t>(
     size_t OutputCount,
     size_t KernelSize
     );
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize,
+    const MLAS_ACTIVATION* Activation
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the depthwise convolution operation for channels
+    last (NHWC) tensors.
+
+Arguments:
+
+    Input - Supplies the expanded input buffer. For each output element, the
+        buffer contains KernelSize rows of Channels elements.
+
+    Filter - Supplies the filter buffer. The buffer contains KernelSize rows
+        of Channels elements.
+
+    Bias - Optionally supplies the bias vector of Channels elements.
+
+    Output - Supplies the output buffer. The buffer receives OutputCount rows
+        of Channels elements.
+
+    Channels - Supplies the number of channels.
+
+    OutputCount - Supplies the number of output elements to produce.
+
+    KernelSize - Supplies the total number of elements of the kernel.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool ApplyActivation = (Activation->ActivationKind != MlasIdentityActivation);
+
+    while (OutputCount > 0) {
+
+        size_t ChannelOffset = 0;
+        size_t c = Channels;
+
+        while (c >= 8) {
+
+            MLAS_FLOAT32X4 Accumulator0;
+            MLAS_FLOAT32X4 Accumulator1;
+
+            if (Bias != nullptr) {
+                Accumulator0 = MlasLoadFloat32x4(&Bias[ChannelOffset]);
+                Accumulator1 = MlasLoadFloat32x4(&Bias[ChannelOffset + 4]);
+            } else {
+                Accumulator0 = MlasZeroFloat32x4();
+                Accumulator1 = MlasZeroFloat32x4();
+            }
+
+            size_t ChannelKernelOffset = ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                MLAS_FLOAT32X4 InputVector0 = MlasLoadFloat32x4(&Input[ChannelKernelOffset]);
+                MLAS_FLOAT32X4 InputVector1 = MlasLoadFloat32x4(&Input[ChannelKernelOffset + 4]);
+                MLAS_FLOAT32X4 FilterVector0 = MlasLoadFloat32x4(&Filter[ChannelKernelOffset]);
+                MLAS_FLOAT32X4 FilterVector1 = MlasLoadFloat32x4(&Filter[ChannelKernelOffset + 4]);
+
+                Accumulator0 = MlasMultiplyAddFloat32x4(InputVector0, FilterVector0, Accumulator0);
+                Accumulator1 = MlasMultiplyAddFloat32x4(InputVector1, FilterVector1, Accumulator1);
+                ChannelKernelOffset += Channels;
+            }
+
+            MlasStoreFloat32x4(&Output[ChannelOffset], Accumulator0);
+            MlasStoreFloat32x4(&Output[ChannelOffset + 4], Accumulator1);
+
+            ChannelOffset += 8;
+            c -= 8;
+        }
+
+        if (c >= 4) {
+
+            MLAS_FLOAT32X4 Accumulator = (Bias != nullptr) ?
+                MlasLoadFloat32x4(&Bias[ChannelOffset]) : MlasZeroFloat32x4();
+
+            size_t ChannelKernelOffset = ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&Input[ChannelKernelOffset]);
+                MLAS_FLOAT32X4 FilterVector = MlasLoadFloat32x4(&Filter[ChannelKernelOffset]);
+
+                Accumulator = MlasMultiplyAddFloat32x4(InputVector, FilterVector, Accumulator);
+                ChannelKernelOffset += Channels;
+            }
+
+            MlasStoreFloat32x4(&Output[ChannelOffset], Accumulator);
+
+            ChannelOffset += 4;
+            c -= 4;
+        }
+
+        while (c > 0) {
+
+            float Accumulator = (Bias != nullptr) ? Bias[ChannelOffset] : 0.0f;
+            size_t ChannelKernelOffset = ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                Accumulator += Input[ChannelKernelOffset] * Filter[ChannelKernelOffset];
+                ChannelKernelOffset += Channels;
+            }
+
+            Output[ChannelOffset] = Accumulator;
+
+            ChannelOffset += 1;
+            c -= 1;
+        }
+
+        //
+        // Apply the activation to the output row while it is still resident
+        // in the cache.
+        //
+
+        if (ApplyActivation) {
+            MlasActivation(Activation, Output, nullptr, 1, Channels, Channels);
+        }
+
+        Input += Channels * KernelSize;
+        Output += Channels;
+        OutputCount -= 1;
+    }
+}
@@ -0,0 +1,298 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels for the layer normalization operation
+    using AVX2/FMA3 instructions.
+
+--*/
+
+#include "../../mlasi.h"
+
+MLAS_FORCEINLINE
+static
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasLayerNormStatisticsF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    float* Output,
+    size_t N,
+    float Shift,
+    float* Statistics
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel to compute the sum and the sum of
+    squares of the elements of a row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Optionally supplies the skip buffer to add to the input buffer.
+
+    SkipBias - Optionally supplies the bias buffer to add to the input buffer.
+        This parameter is only used if Skip is supplied.
+
+    Output - Supplies the output buffer that receives the sum of the input,
+        skip, and bias buffers. This parameter is only used if Skip is
+        supplied.
+
+    N - Supplies the number of elements to process.
+
+    Shift - Supplies the value subtracted from each element before the
+        accumulation. Shifting the elements by a value close to the mean
+        avoids catastrophic cancellation when computing the variance.
+
+    Statistics - Supplies an array that receives the sum and the sum of
+        squares of the shifted elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Sum = 0.0f;
+    float SquareSum = 0.0f;
+
+    if (N >= 8) {
+
+        const __m256 ShiftVector = _mm256_set1_ps(Shift);
+
+        __m256 SumVector0 = _mm256_setzero_ps();
+        __m256 SquareSumVector0 = _mm256_setzero_ps();
+
+        if (N >= 16) {
+
+            __m256 SumVector1 = _mm256_setzero_ps();
+            __m256 SquareSumVector1 = _mm256_setzero_ps();
+
+            while (N >= 16) {
+
+                __m256 Vector0 = _mm256_loadu_ps(Input);
+                __m256 Vector1 = _mm256_loadu_ps(Input + 8);
+
+                if (Skip != nullptr) {
+
+                    Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(Skip));
+                    Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(Skip + 8));
+
+                    if (SkipBias != nullptr) {
+                        Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(SkipBias));
+                        Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(SkipBias + 8));
+                        SkipBias += 16;
+                    }
+
+                    _mm256_storeu_ps(Output, Vector0);
+                    _mm256_storeu_ps(Output + 8, Vector1);
+
+                    Skip += 16;
+                    Output += 16;
+                }
+
+                Vector0 = _mm256_sub_ps(Vector0, ShiftVector);
+                Vector1 = _mm256_sub_ps(Vector1, ShiftVector);
+
+                SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+                SumVector1 = _mm256_add_ps(SumVector1, Vector1);
+
+                SquareSumVector0 = _mm256_fmadd_ps(Vector0, Vector0, SquareSumVector0);
+                SquareSumVector1 = _mm256_fmadd_ps(Vector1, Vector1, SquareSumVector1);
+
+                Input += 16;
+                N -= 16;
+            }
+
+            SumVector0 = _mm256_add_ps(SumVector0, SumVector1);
+            SquareSumVector0 = _mm256_add_ps(SquareSumVector0, SquareSumVector1);
+        }
+
+        while (N >= 8) {
+
+            __m256 Vector0 = _mm256_loadu_ps(Input);
+
+            if (Skip != nullptr) {
+
+                Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(Skip));
+
+                if (SkipBias != nullptr) {
+                    Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(SkipBias));
+                    SkipBias += 8;
+                }
+
+                _mm256_storeu_ps(Output, Vector0);
+
+                Skip += 8;
+                Output += 8;
+            }
+
+            Vector0 = _mm256_sub_ps(Vector0, ShiftVector);
+
+            SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+            SquareSumVector0 = _mm256_fmadd_ps(Vector0, Vector0, SquareSumVector0);
+
+            Input += 8;
+            N -= 8;
+        }
+
+        Sum = MlasReduceAddFloat32x8(SumVector0);
+        SquareSum = MlasReduceAddFloat32x8(SquareSumVector0);
+    }
+
+    while (N > 0) {
+
+        float Value = *Input++;
+
+        if (Skip != nullptr) {
+
+            Value += *Skip++;
+
+            if (SkipBias != nullptr) {
+                Value += *SkipBias++;
+            }
+
+            *Output++ = Value;
+        }
+
+        Value -= Shift;
+
+        Sum += Value;
+        SquareSum += Value * Value;
+
+        N -= 1;
+    }
+
+    Statistics[0] = Sum;
+    Statistics[1] = SquareSum;
+}
+
+void
+MLASCALL
+MlasLayerNormOutputF32KernelAvx2(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Bias,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel to produce the final output for
+    the layer normalization operation.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    Scale - Supplies the scale buffer.
+
+    Bias - Optionally supplies the bias buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the mean and inverse standard
+        deviation values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Mean = Parameters[0];
+    const float InverseStdDev = Parameters[1];
+
+    const __m256 MeanVector = _mm256_set1_ps(Mean);
+    const __m256 InverseStdDevVector = _mm256_set1_ps(InverseStdDev);
+
+    while (N >= 16) {
+
+        __m256 Vector0 = _mm256_sub_ps(_mm256_loadu_ps(Input), MeanVector);
+        __m256 Vector1 = _mm256_sub_ps(_mm256_loadu_ps(Input + 8), MeanVector);
+
+        Vector0 = _mm256_mul_ps(Vector0, InverseStdDevVector);
+        Vector1 = _mm256_mul_ps(Vector1, InverseStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector0 = _mm256_fmadd_ps(Vector0, _mm256_loadu_ps(Scale), _mm256_loadu_ps(Bias));
+            Vector1 = _mm256_fmadd_ps(Vector1, _mm256_loadu_ps(Scale + 8), _mm256_loadu_ps(Bias + 8));
+            Bias += 16;
+        } else {
+            Vector0 = _mm256_mul_ps(Vector0, _mm256_loadu_ps(Scale));
+            Vector1 = _mm256_mul_ps(Vector1, _mm256_loadu_ps(Scale + 8));
+        }
+
+        _mm256_storeu_ps(Output, Vector0);
+        _mm256_storeu_ps(Output + 8, Vector1);
+
+        Input += 16;
+        Output += 16;
+        Scale += 16;
+        N -= 16;
+    }
+
+    while (N >= 8) {
+
+        __m256 Vector0 = _mm256_sub_ps(_mm256_loadu_ps(Input), MeanVector);
+
+        Vector0 = _mm256_mul_ps(Vector0, InverseStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector0 = _mm256_fmadd_ps(Vector0, _mm256_loadu_ps(Scale), _mm256_loadu_ps(Bias));
+            Bias += 8;
+        } else {
+            Vector0 = _mm256_mul_ps(Vector0, _mm256_loadu_ps(Scale));
+        }
+
+        _mm256_storeu_ps(Output, Vector0);
+
+        Input += 8;
+        Output += 8;
+        Scale += 8;
+        N -= 8;
+    }
+
+    while (N > 0) {
+
+        float Value = (*Input++ - Mean) * InverseStdDev * *Scale++;
+
+        if (Bias != nullptr) {
+            Value += *Bias++;
+        }
+
+        *Output++ = Value;
+
+        N -= 1;
+    }
+}
@@ -0,0 +1,239 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernels for the layer normalization operation
+    using AVX512F instructions.
+
+    The remaining elements of a row are processed using masked loads and
+    stores, so no scalar tail loop is required.
+
+--*/
+
+#include "../../mlasi.h"
+
+MLAS_FORCEINLINE
+static
+float
+MlasReduceAddFloat32x16(
+    __m512 Vector
+    )
+{
+    Vector = _mm512_add_ps(Vector, _mm512_maskz_shuffle_f32x4(0xFFFF, Vector, Vector, _MM_SHUFFLE(1, 0, 3, 2)));
+    Vector = _mm512_add_ps(Vector, _mm512_maskz_shuffle_f32x4(0xFFFF, Vector, Vector, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    __m128 Vector128 = _mm512_maskz_extractf32x4_ps(0xF, Vector, 0);
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasLayerNormStatisticsF32KernelAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    float* Output,
+    size_t N,
+    float Shift,
+    float* Statistics
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel to compute the sum and the sum
+    of squares of the elements of a row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Optionally supplies the skip buffer to add to the input buffer.
+
+    SkipBias - Optionally supplies the bias buffer to add to the input buffer.
+        This parameter is only used if Skip is supplied.
+
+    Output - Supplies the output buffer that receives the sum of the input,
+        skip, and bias buffers. This parameter is only used if Skip is
+        supplied.
+
+    N - Supplies the number of elements to process.
+
+    Shift - Supplies the value subtracted from each element before the
+        accumulation. Shifting the elements by a value close to the mean
+        avoids catastrophic cancellation when computing the variance.
+
+    Statistics - Supplies an array that receives the sum and the sum of
+        squares of the shifted elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m512 ShiftVector = _mm512_set1_ps(Shift);
+
+    __m512 SumVector0 = _mm512_setzero_ps();
+    __m512 SquareSumVector0 = _mm512_setzero_ps();
+
+    if (N >= 32) {
+
+        __m512 SumVector1 = _mm512_setzero_ps();
+        __m512 SquareSumVector1 = _mm512_setzero_ps();
+
+        while (N >= 32) {
+
+            __m512 Vector0 = _mm512_loadu_ps(Input);
+            __m512 Vector1 = _mm512_loadu_ps(Input + 16);
+
+            if (Skip != nullptr) {
+
+                Vector0 = _mm512_add_ps(Vector0, _mm512_loadu_ps(Skip));
+                Vector1 = _mm512_add_ps(Vector1, _mm512_loadu_ps(Skip + 16));
+
+                if (SkipBias != nullptr) {
+                    Vector0 = _mm512_add_ps(Vector0, _mm512_loadu_ps(SkipBias));
+                    Vector1 = _mm512_add_ps(Vector1, _mm512_loadu_ps(SkipBias + 16));
+                    SkipBias += 32;
+                }
+
+                _mm512_storeu_ps(Output, Vector0);
+                _mm512_storeu_ps(Output + 16, Vector1);
+
+                Skip += 32;
+                Output += 32;
+            }
+
+            Vector0 = _mm512_sub_ps(Vector0, ShiftVector);
+            Vector1 = _mm512_sub_ps(Vector1, ShiftVector);
+
+            SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+            SumVector1 = _mm512_add_ps(SumVector1, Vector1);
+
+            SquareSumVector0 = _mm512_fmadd_ps(Vector0, Vector0, SquareSumVector0);
+            SquareSumVector1 = _mm512_fmadd_ps(Vector1, Vector1, SquareSumVector1);
+
+            Input += 32;
+            N -= 32;
+        }
+
+        SumVector0 = _mm512_add_ps(SumVector0, SumVector1);
+        SquareSumVector0 = _mm512_add_ps(SquareSumVector0, SquareSumVector1);
+    }
+
+    while (N > 0) {
+
+        __mmask16 Mask = (N >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << N) - 1);
+
+        __m512 Vector0 = _mm512_maskz_loadu_ps(Mask, Input);
+
+        if (Skip != nullptr) {
+
+            Vector0 = _mm512_add_ps(Vector0, _mm512_maskz_loadu_ps(Mask, Skip));
+
+            if (SkipBias != nullptr) {
+                Vector0 = _mm512_add_ps(Vector0, _mm512_maskz_loadu_ps(Mask, SkipBias));
+                SkipBias += 16;
+            }
+
+            _mm512_mask_storeu_ps(Output, Mask, Vector0);
+
+            Skip += 16;
+            Output += 16;
+        }
+
+        //
+        // Keep the masked off elements at zero so that they do not contribute
+        // to the accumulators.
+        //
+
+        Vector0 = _mm512_maskz_sub_ps(Mask, Vector0, ShiftVector);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+        SquareSumVector0 = _mm512_fmadd_ps(Vector0, Vector0, SquareSumVector0);
+
+        Input += 16;
+        N -= (N >= 16) ? 16 : N;
+    }
+
+    Statistics[0] = MlasReduceAddFloat32x16(SumVector0);
+    Statistics[1] = MlasReduceAddFloat32x16(SquareSumVector0);
+}
+
+void
+MLASCALL
+MlasLayerNormOutputF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Bias,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel to produce the final output for
+    the layer normalization operation.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    Scale - Supplies the scale buffer.
+
+    Bias - Optionally supplies the bias buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the mean and inverse standard
+        deviation values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m512 MeanVector = _mm512_set1_ps(Parameters[0]);
+    const __m512 InverseStdDevVector = _mm512_set1_ps(Parameters[1]);
+
+    while (N > 0) {
+
+        __mmask16 Mask = (N >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << N) - 1);
+
+        __m512 Vector0 = _mm512_sub_ps(_mm512_maskz_loadu_ps(Mask, Input), MeanVector);
+
+        Vector0 = _mm512_mul_ps(Vector0, InverseStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector0 = _mm512_fmadd_ps(Vector0, _mm512_maskz_loadu_ps(Mask, Scale), _mm512_maskz_loadu_ps(Mask, Bias));
+            Bias += 16;
+        } else {
+            Vector0 = _mm512_mul_ps(Vector0, _mm512_maskz_loadu_ps(Mask, Scale));
+        }
+
+        _mm512_mask_storeu_ps(Output, Mask, Vector0);
+
+        Input += 16;
+        Output += 16;
+        Scale += 16;
+        N -= (N >= 16) ? 16 : N;
+    }
+}
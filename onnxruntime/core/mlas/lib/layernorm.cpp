@@ -0,0 +1,563 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute layer normalization.
+
+    The statistics for a row are gathered in a single pass over the input by
+    accumulating both the sum and the sum of squares of the elements. The
+    elements are shifted by the first element of the row before accumulating
+    to avoid the cancellation that otherwise occurs when the mean is large
+    relative to the standard deviation. For skip layer normalization, the
+    element-wise addition of the skip and bias tensors is fused into this pass.
+
+    Our usage requires building platform specific versions of the algorithm to
+    target different instruction sets. The implementation below targets the
+    base instruction set (typically SSE2) while intrinsic implementations
+    target newer instruction sets (such as AVX2 and AVX512F).
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a layer normalization
+// operation on worker threads.
+//
+
+struct MLAS_LAYERNORM_WORK_BLOCK {
+    int32_t ThreadCountN;
+    bool Simplified;
+    float Epsilon;
+    const float* Input;
+    const float* Skip;
+    const float* SkipBias;
+    const float* Scale;
+    const float* Bias;
+    float* Output;
+    float* Mean;
+    float* InverseStdDev;
+    size_t N;
+    size_t D;
+};
+
+void
+MLASCALL
+MlasLayerNormStatisticsF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    float* Output,
+    size_t N,
+    float Shift,
+    float* Statistics
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to compute the sum and the sum
+    of squares of the elements of a row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Optionally supplies the skip buffer to add to the input buffer.
+
+    SkipBias - Optionally supplies the bias buffer to add to the input buffer.
+        This parameter is only used if Skip is supplied.
+
+    Output - Supplies the output buffer that receives the sum of the input,
+        skip, and bias buffers. This parameter is only used if Skip is
+        supplied.
+
+    N - Supplies the number of elements to process.
+
+    Shift - Supplies the value subtracted from each element before the
+        accumulation. Shifting the elements by a value close to the mean
+        avoids catastrophic cancellation when computing the variance.
+
+    Statistics - Supplies an array that receives the sum and the sum of
+        squares of the shifted elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Sum = 0.0f;
+    float SquareSum = 0.0f;
+
+    if (N >= 4) {
+
+        const MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(Shift);
+
+        MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SquareSumVector0 = MlasZeroFloat32x4();
+
+        if (N >= 8) {
+
+            MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+            MLAS_FLOAT32X4 SquareSumVector1 = MlasZeroFloat32x4();
+
+            while (N >= 8) {
+
+                MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+                MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+
+                if (Skip != nullptr) {
+
+                    Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Skip));
+                    Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Skip + 4));
+
+                    if (SkipBias != nullptr) {
+                        Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(SkipBias));
+                        Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(SkipBias + 4));
+                        SkipBias += 8;
+                    }
+
+                    MlasStoreFloat32x4(Output, Vector0);
+                    MlasStoreFloat32x4(Output + 4, Vector1);
+
+                    Skip += 8;
+                    Output += 8;
+                }
+
+                Vector0 = MlasSubtractFloat32x4(Vector0, ShiftVector);
+                Vector1 = MlasSubtractFloat32x4(Vector1, ShiftVector);
+
+                SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+                SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+
+                SquareSumVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SquareSumVector0);
+                SquareSumVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SquareSumVector1);
+
+                Input += 8;
+                N -= 8;
+            }
+
+            SumVector0 = MlasAddFloat32x4(SumVector0, SumVector1);
+            SquareSumVector0 = MlasAddFloat32x4(SquareSumVector0, SquareSumVector1);
+        }
+
+        while (N >= 4) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+
+            if (Skip != nullptr) {
+
+                Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Skip));
+
+                if (SkipBias != nullptr) {
+                    Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(SkipBias));
+                    SkipBias += 4;
+                }
+
+                MlasStoreFloat32x4(Output, Vector0);
+
+                Skip += 4;
+                Output += 4;
+            }
+
+            Vector0 = MlasSubtractFloat32x4(Vector0, ShiftVector);
+
+            SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+            SquareSumVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SquareSumVector0);
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Sum = MlasReduceAddFloat32x4(SumVector0);
+        SquareSum = MlasReduceAddFloat32x4(SquareSumVector0);
+    }
+
+    while (N > 0) {
+
+        float Value = *Input++;
+
+        if (Skip != nullptr) {
+
+            Value += *Skip++;
+
+            if (SkipBias != nullptr) {
+                Value += *SkipBias++;
+            }
+
+            *Output++ = Value;
+        }
+
+        Value -= Shift;
+
+        Sum += Value;
+        SquareSum += Value * Value;
+
+        N -= 1;
+    }
+
+    Statistics[0] = Sum;
+    Statistics[1] = SquareSum;
+}
+
+void
+MLASCALL
+MlasLayerNormOutputF32Kernel(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Bias,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to produce the final output for
+    the layer normalization operation.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    Scale - Supplies the scale buffer.
+
+    Bias - Optionally supplies the bias buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the mean and inverse standard
+        deviation values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Mean = Parameters[0];
+    const float InverseStdDev = Parameters[1];
+
+    const MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    const MLAS_FLOAT32X4 InverseStdDevVector = MlasBroadcastFloat32x4(InverseStdDev);
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+        MLAS_FLOAT32X4 Vector1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + 4), MeanVector);
+
+        Vector0 = MlasMultiplyFloat32x4(Vector0, InverseStdDevVector);
+        Vector1 = MlasMultiplyFloat32x4(Vector1, InverseStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector0 = MlasMultiplyAddFloat32x4(Vector0, MlasLoadFloat32x4(Scale), MlasLoadFloat32x4(Bias));
+            Vector1 = MlasMultiplyAddFloat32x4(Vector1, MlasLoadFloat32x4(Scale + 4), MlasLoadFloat32x4(Bias + 4));
+            Bias += 8;
+        } else {
+            Vector0 = MlasMultiplyFloat32x4(Vector0, MlasLoadFloat32x4(Scale));
+            Vector1 = MlasMultiplyFloat32x4(Vector1, MlasLoadFloat32x4(Scale + 4));
+        }
+
+        MlasStoreFloat32x4(Output, Vector0);
+        MlasStoreFloat32x4(Output + 4, Vector1);
+
+        Input += 8;
+        Output += 8;
+        Scale += 8;
+        N -= 8;
+    }
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+
+        Vector0 = MlasMultiplyFloat32x4(Vector0, InverseStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector0 = MlasMultiplyAddFloat32x4(Vector0, MlasLoadFloat32x4(Scale), MlasLoadFloat32x4(Bias));
+            Bias += 4;
+        } else {
+            Vector0 = MlasMultiplyFloat32x4(Vector0, MlasLoadFloat32x4(Scale));
+        }
+
+        MlasStoreFloat32x4(Output, Vector0);
+
+        Input += 4;
+        Output += 4;
+        Scale += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        float Value = (*Input++ - Mean) * InverseStdDev * *Scale++;
+
+        if (Bias != nullptr) {
+            Value += *Bias++;
+        }
+
+        *Output++ = Value;
+
+        N -= 1;
+    }
+}
+
+void
+MlasComputeLayerNormalizationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    layer normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_LAYERNORM_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    //
+    // Compute the layer normalization.
+    //
+
+    const size_t D = WorkBlock->D;
+    const bool Simplified = WorkBlock->Simplified;
+
+    const float* Input = WorkBlock->Input + n * D;
+    const float* Skip = WorkBlock->Skip;
+    float* Output = WorkBlock->Output + n * D;
+
+    if (Skip != nullptr) {
+        Skip += n * D;
+    }
+
+    for (size_t i = n; i < n + CountN; i++) {
+
+        //
+        // Compute the sum and the sum of squares for the row. If a skip buffer
+        // is supplied, then the sum of the input and skip buffers is stored to
+        // the output buffer and becomes the input for the normalization pass.
+        //
+        // The elements are shifted by the first element of the row to keep the
+        // single pass variance computation numerically stable. The simplified
+        // form normalizes by the root mean square, so no shift is applied.
+        //
+
+        float Shift = 0.0f;
+
+        if (!Simplified) {
+
+            Shift = Input[0];
+
+            if (Skip != nullptr) {
+
+                Shift += Skip[0];
+
+                if (WorkBlock->SkipBias != nullptr) {
+                    Shift += WorkBlock->SkipBias[0];
+                }
+            }
+        }
+
+        float Statistics[2];
+
+#if defined(MLAS_TARGET_AMD64)
+        MlasPlatform.LayerNormStatisticsF32Kernel(Input, Skip, WorkBlock->SkipBias, Output, D, Shift, Statistics);
+#else
+        MlasLayerNormStatisticsF32Kernel(Input, Skip, WorkBlock->SkipBias, Output, D, Shift, Statistics);
+#endif
+
+        const float* NormalizeInput = (Skip != nullptr) ? Output : Input;
+
+        float Mean = 0.0f;
+        float Variance;
+
+        if (Simplified) {
+            Variance = Statistics[1] / D;
+        } else {
+            const float ShiftedMean = Statistics[0] / D;
+            Mean = Shift + ShiftedMean;
+            Variance = std::max(Statistics[1] / D - ShiftedMean * ShiftedMean, 0.0f);
+        }
+
+        float Parameters[] = { Mean, 1.0f / std::sqrt(Variance + WorkBlock->Epsilon) };
+
+#if defined(MLAS_TARGET_AMD64)
+        MlasPlatform.LayerNormOutputF32Kernel(NormalizeInput, Output, WorkBlock->Scale,
+            Simplified ? nullptr : WorkBlock->Bias, D, Parameters);
+#else
+        MlasLayerNormOutputF32Kernel(NormalizeInput, Output, WorkBlock->Scale,
+            Simplified ? nullptr : WorkBlock->Bias, D, Parameters);
+#endif
+
+        if (WorkBlock->Mean != nullptr) {
+            WorkBlock->Mean[i] = Mean;
+        }
+
+        if (WorkBlock->InverseStdDev != nullptr) {
+            WorkBlock->InverseStdDev[i] = Parameters[1];
+        }
+
+        Input += D;
+        Output += D;
+
+        if (Skip != nullptr) {
+            Skip += D;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasComputeLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InverseStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization function over the rows of
+    the input buffer:
+
+        Output = (Input - Mean) * InverseStdDev * Scale + Bias
+
+    If Skip is supplied, then the input for the normalization is the sum of
+    the input, skip, and optional skip bias buffers.
+
+    If Simplified is true, then the mean is not subtracted and the bias is not
+    added (root mean square normalization).
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Optionally supplies the skip buffer with the same shape as the input
+        buffer.
+
+    SkipBias - Optionally supplies the bias buffer of D elements to add to the
+        input buffer. This parameter is only used if Skip is supplied.
+
+    Scale - Supplies the scale buffer of D elements.
+
+    Bias - Optionally supplies the bias buffer of D elements.
+
+    Output - Supplies the output buffer.
+
+    Mean - Optionally supplies the buffer of N elements that receives the mean
+        of each row.
+
+    InverseStdDev - Optionally supplies the buffer of N elements that receives
+        the inverse standard deviation of each row.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Epsilon - Supplies the value added to the variance to avoid division by
+        zero.
+
+    Simplified - Supplies true if this is a simplified layer normalization
+        operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_LAYERNORM_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the layer normalization parameters to the work block.
+    //
+
+    WorkBlock.Simplified = Simplified;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Input = Input;
+    WorkBlock.Skip = Skip;
+    WorkBlock.SkipBias = (Skip != nullptr) ? SkipBias : nullptr;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Mean = Mean;
+    WorkBlock.InverseStdDev = InverseStdDev;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+
+    //
+    // Compute the number of target threads given the complexity of the layer
+    // normalization operation. Limit the number of threads to the number of
+    // rows and try to keep each thread processing a minimum number of elements
+    // before using another thread.
+    //
+
+    int32_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = int32_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = int32_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasComputeLayerNormalizationThreaded, &WorkBlock, ThreadCountN, ThreadPool);
+}
@@ -453,6 +453,33 @@ void
 
 typedef MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL;
 
+typedef
+void
+(MLASCALL MLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    float* Output,
+    size_t N,
+    float Shift,
+    float* Statistics
+    );
+
+typedef MLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL* PMLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL)(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Bias,
+    size_t N,
+    const float* Parameters
+    );
+
+typedef MLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL* PMLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL;
+
 typedef
 void
 (MLASCALL MLAS_QLINEAR_BINARY_OP_S8_KERNEL)(
@@ -602,6 +629,15 @@ extern "C" {
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
 
+    MLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL MlasLayerNormStatisticsF32Kernel;
+    MLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL MlasLayerNormOutputF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL MlasLayerNormStatisticsF32KernelAvx2;
+    MLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL MlasLayerNormOutputF32KernelAvx2;
+    MLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL MlasLayerNormStatisticsF32KernelAvx512F;
+    MLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL MlasLayerNormOutputF32KernelAvx512F;
+#endif
+
 }
 
 //
@@ -713,6 +749,8 @@ struct MLAS_PLATFORM {
     PMLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL ComputeLogSoftmaxOutputF32Kernel;
     PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL ReduceMaximumF32Kernel;
     PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL ReduceMinimumMaximumF32Kernel;
+    PMLAS_LAYERNORM_STATISTICS_FLOAT_KERNEL LayerNormStatisticsF32Kernel;
+    PMLAS_LAYERNORM_OUTPUT_FLOAT_KERNEL LayerNormOutputF32Kernel;
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
 #endif
@@ -1026,6 +1064,20 @@ MlasShiftLeftInt32x4(MLAS_INT32X4 Vector)
 #endif
 }
 
+template<unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasShiftRightInt32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vshrq_n_s32(Vector, ShiftCount);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_srai_epi32(Vector, ShiftCount);
+#else
+    return Vector >> ShiftCount;
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_INT32X4
 MlasMaximumInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
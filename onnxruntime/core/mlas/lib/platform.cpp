@@ -138,6 +138,8 @@ Return Value:
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->LayerNormStatisticsF32Kernel = MlasLayerNormStatisticsF32Kernel;
+    this->LayerNormOutputF32Kernel = MlasLayerNormOutputF32Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
     this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
 
@@ -221,6 +223,8 @@ Return Value:
                 this->QLinearAddS8Kernel = MlasQLinearAddS8KernelAvx2;
                 this->QLinearAddU8Kernel = MlasQLinearAddU8KernelAvx2;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormStatisticsF32Kernel = MlasLayerNormStatisticsF32KernelAvx2;
+                this->LayerNormOutputF32Kernel = MlasLayerNormOutputF32KernelAvx2;
                 
                 //
                 // Check if the processor supports AVXVNNI features.
@@ -261,6 +265,8 @@ Return Value:
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->LayerNormStatisticsF32Kernel = MlasLayerNormStatisticsF32KernelAvx512F;
+                    this->LayerNormOutputF32Kernel = MlasLayerNormOutputF32KernelAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
 
@@ -0,0 +1,804 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transcendental.cpp
+
+Abstract:
+
+    This module implements routines to compute the natural logarithm,
+    reciprocal square root, power, GELU, swish, and softplus functions.
+
+    The natural logarithm uses the same polynomial coefficients and algorithm
+    as found in the Cephes Math Library (logf).
+
+    The routines that are composed from the exponential, error, logistic, or
+    hyperbolic tangent functions stage blocks of elements through a local
+    buffer so that the platform specific kernels for those functions are
+    used.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of elements staged through the local buffer of the composite
+// routines.
+//
+
+#define MLAS_TRANSCENDENTAL_BLOCK_SIZE      256
+
+//
+// Bundles the constants for use by the logarithm kernel.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float MinimumNormal;
+    float MinimumDenormal;
+    float MaximumFinite;
+    float DenormalScale;
+    float DenormalExponent;
+    float NegativeZero;
+    float PositiveInfinity;
+    float NegativeInfinity;
+    float NaN;
+    float One;
+    float Half;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+    float poly_7;
+    float poly_8;
+    float Log2High;
+    float Log2Low;
+    int32_t SqrtHalf;
+    int32_t MantissaMask;
+} MlasLogConstants = {
+    std::numeric_limits<float>::min(),
+    std::numeric_limits<float>::denorm_min(),
+    std::numeric_limits<float>::max(),
+    8388608.0f,
+    -23.0f,
+    -0.0f,
+    std::numeric_limits<float>::infinity(),
+    -std::numeric_limits<float>::infinity(),
+    std::numeric_limits<float>::quiet_NaN(),
+    1.0f,
+    0.5f,
+    7.0376836292E-2f,
+    -1.1514610310E-1f,
+    1.1676998740E-1f,
+    -1.2420140846E-1f,
+    1.4249322787E-1f,
+    -1.6668057665E-1f,
+    2.0000714765E-1f,
+    -2.4999993993E-1f,
+    3.3333331174E-1f,
+    0.693359375f,
+    -2.12194440E-4f,
+    int32_t(0x3F3504F3),
+    int32_t(0x007FFFFF),
+};
+
+//
+// Bundles the constants for use by the GELU kernels. The approximation of
+// GELU is 0.5 * x * (1 + tanh(x * (C * x * x + B))).
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float Half;
+    float One;
+    float SqrtHalf;
+    float B;
+    float C;
+} MlasGeluConstants = {
+    0.5f,
+    1.0f,
+    0.70710678118654752440f,
+    0.7978845608028654f,
+    0.035677408136300125f,
+};
+
+template<typename Function>
+MLAS_FORCEINLINE
+void
+MlasTranscendentalTransform(
+    const float* Input,
+    float* Output,
+    size_t N,
+    Function Transform
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the supplied vector transform to each element of the
+    input buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Transform - Supplies the vector transform.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, Transform(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+#if defined(MLAS_SSE2_INTRINSICS)
+        // N.B. SSE2 lacks a broadcast load instruction, so avoid a shuffle
+        // and use zeroes for the upper elements.
+        MLAS_FLOAT32X4 Vector = _mm_load_ss(Input);
+#else
+        MLAS_FLOAT32X4 Vector = MlasBroadcastFloat32x4(Input);
+#endif
+
+        MlasStoreLaneFloat32x4<0>(Output, Transform(Vector));
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+template<typename Function>
+MLAS_FORCEINLINE
+void
+MlasTranscendentalTransform(
+    const float* Input1,
+    const float* Input2,
+    float* Output,
+    size_t N,
+    Function Transform
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the supplied vector transform to each pair of
+    elements from the input buffers.
+
+Arguments:
+
+    Input1 - Supplies the first input buffer.
+
+    Input2 - Supplies the second input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Transform - Supplies the vector transform.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input1);
+        MLAS_FLOAT32X4 Vector2 = MlasLoadFloat32x4(Input2);
+
+        MlasStoreFloat32x4(Output, Transform(Vector1, Vector2));
+
+        Input1 += 4;
+        Input2 += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+#if defined(MLAS_SSE2_INTRINSICS)
+        MLAS_FLOAT32X4 Vector1 = _mm_load_ss(Input1);
+        MLAS_FLOAT32X4 Vector2 = _mm_load_ss(Input2);
+#else
+        MLAS_FLOAT32X4 Vector1 = MlasBroadcastFloat32x4(Input1);
+        MLAS_FLOAT32X4 Vector2 = MlasBroadcastFloat32x4(Input2);
+#endif
+
+        MlasStoreLaneFloat32x4<0>(Output, Transform(Vector1, Vector2));
+
+        Input1 += 1;
+        Input2 += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeLogVector(
+    MLAS_FLOAT32X4 Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm for the supplied vector.
+
+Arguments:
+
+    Value - Supplies the values to operate on.
+
+Return Value:
+
+    Returns the natural logarithm of the input.
+
+--*/
+{
+    //
+    // Scale denormal inputs into the normal range and account for the scaling
+    // in the exponent.
+    //
+
+    const MLAS_FLOAT32X4 DenormalMask =
+        MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.MinimumNormal), Value);
+
+    MLAS_FLOAT32X4 x = MlasBlendFloat32x4(Value,
+        MlasMultiplyFloat32x4(Value, MlasBroadcastFloat32x4(MlasLogConstants.DenormalScale)), DenormalMask);
+
+    MLAS_FLOAT32X4 e = MlasAndFloat32x4(DenormalMask, MlasBroadcastFloat32x4(MlasLogConstants.DenormalExponent));
+
+    //
+    // Decompose the input into "(2 ^ e) * m" where m is in the range
+    // [sqrt(0.5), sqrt(2)).
+    //
+
+    const MLAS_INT32X4 SqrtHalf = MlasBroadcastInt32x4(MlasLogConstants.SqrtHalf);
+
+    MLAS_INT32X4 Bits = MlasSubtractInt32x4(MlasReinterpretAsInt32x4(x), SqrtHalf);
+
+    e = MlasAddFloat32x4(e, MlasCastToFloat32x4(MlasShiftRightInt32x4<23>(Bits)));
+
+    Bits = MlasAndInt32x4(Bits, MlasBroadcastInt32x4(MlasLogConstants.MantissaMask));
+    x = MlasReinterpretAsFloat32x4(MlasAddInt32x4(Bits, SqrtHalf));
+    x = MlasSubtractFloat32x4(x, MlasBroadcastFloat32x4(MlasLogConstants.One));
+
+    //
+    // Compute the polynomial approximation of log(1 + x) and add the scaled
+    // exponent split into high and low parts.
+    //
+
+    MLAS_FLOAT32X4 z = MlasMultiplyFloat32x4(x, x);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasLogConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_1);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_2);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_3);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_4);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_5);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_6);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_7);
+    p = MlasMultiplyAddFloat32x4(p, x, MlasLogConstants.poly_8);
+    p = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(p, x), z);
+
+    p = MlasMultiplyAddFloat32x4(e, MlasBroadcastFloat32x4(MlasLogConstants.Log2Low), p);
+    p = MlasMultiplyAddFloat32x4(z, MlasBroadcastFloat32x4(-MlasLogConstants.Half), p);
+    x = MlasAddFloat32x4(x, p);
+    x = MlasMultiplyAddFloat32x4(e, MlasBroadcastFloat32x4(MlasLogConstants.Log2High), x);
+
+    //
+    // Produce NaN for negative and NaN inputs, negative infinity for zero
+    // inputs, and positive infinity for positive infinity inputs.
+    //
+
+    const MLAS_FLOAT32X4 AbsValue =
+        MlasAndNotFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.NegativeZero), Value);
+
+    x = MlasBlendFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.NaN), x,
+        MlasGreaterThanFloat32x4(Value, MlasZeroFloat32x4()));
+    x = MlasBlendFloat32x4(x, MlasBroadcastFloat32x4(MlasLogConstants.NegativeInfinity),
+        MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.MinimumDenormal), AbsValue));
+    x = MlasBlendFloat32x4(x, MlasBroadcastFloat32x4(MlasLogConstants.PositiveInfinity),
+        MlasGreaterThanFloat32x4(Value, MlasBroadcastFloat32x4(MlasLogConstants.MaximumFinite)));
+
+    return x;
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm function.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTranscendentalTransform(Input, Output, N, [](MLAS_FLOAT32X4 Vector) {
+        return MlasComputeLogVector(Vector);
+    });
+}
+
+void
+MLASCALL
+MlasComputeReciprocalSqrt(
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_COMPUTE_MODE Mode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the reciprocal square root function.
+
+    In fast mode, the hardware estimate is refined with Newton-Raphson
+    iterations. Denormal inputs may be treated as zero in this mode.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Mode - Supplies the compute mode.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON64_INTRINSICS)
+
+    const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+
+    if (Mode == MlasComputeModeFast) {
+
+        const MLAS_FLOAT32X4 MaximumFinite = MlasBroadcastFloat32x4(std::numeric_limits<float>::max());
+
+        MlasTranscendentalTransform(Input, Output, N, [&](MLAS_FLOAT32X4 Vector) {
+
+#if defined(MLAS_SSE2_INTRINSICS)
+            const MLAS_FLOAT32X4 Estimate = _mm_rsqrt_ps(Vector);
+            MLAS_FLOAT32X4 Refined = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Vector, Estimate), Estimate);
+            Refined = MlasMultiplyAddFloat32x4(Refined, -0.5f, MlasBroadcastFloat32x4(1.5f));
+            Refined = MlasMultiplyFloat32x4(Refined, Estimate);
+#else
+            const MLAS_FLOAT32X4 Estimate = vrsqrteq_f32(Vector);
+            MLAS_FLOAT32X4 Refined = vmulq_f32(Estimate, vrsqrtsq_f32(vmulq_f32(Vector, Estimate), Estimate));
+            Refined = vmulq_f32(Refined, vrsqrtsq_f32(vmulq_f32(Vector, Refined), Refined));
+#endif
+
+            //
+            // Keep the estimate for zero, infinity, and NaN inputs where the
+            // refinement would produce a NaN.
+            //
+
+            const MLAS_FLOAT32X4 RefineMask = MlasAndFloat32x4(
+                MlasGreaterThanFloat32x4(Estimate, MlasZeroFloat32x4()),
+                MlasGreaterThanFloat32x4(MaximumFinite, Estimate));
+
+            return MlasBlendFloat32x4(Estimate, Refined, RefineMask);
+        });
+
+        return;
+    }
+
+    MlasTranscendentalTransform(Input, Output, N, [&](MLAS_FLOAT32X4 Vector) {
+#if defined(MLAS_SSE2_INTRINSICS)
+        return MlasDivideFloat32x4(One, _mm_sqrt_ps(Vector));
+#else
+        return MlasDivideFloat32x4(One, vsqrtq_f32(Vector));
+#endif
+    });
+
+#else
+
+    MLAS_UNREFERENCED_PARAMETER(Mode);
+
+    while (N > 0) {
+        *Output++ = 1.0f / std::sqrt(*Input++);
+        N -= 1;
+    }
+
+#endif
+}
+
+void
+MLASCALL
+MlasComputePow(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Exponent
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the power function for a scalar exponent.
+
+    Common integral exponents are computed with multiplications, otherwise the
+    result is computed as "exp(Exponent * log(abs(x)))" with the sign and NaN
+    results of negative bases fixed up.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Exponent - Supplies the exponent.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Exponent == 1.0f) {
+
+        if (Input != Output) {
+            std::copy_n(Input, N, Output);
+        }
+
+        return;
+    }
+
+    if (Exponent == 0.0f) {
+        std::fill_n(Output, N, 1.0f);
+        return;
+    }
+
+    if (Exponent == 2.0f) {
+        MlasTranscendentalTransform(Input, Output, N, [](MLAS_FLOAT32X4 Vector) {
+            return MlasMultiplyFloat32x4(Vector, Vector);
+        });
+        return;
+    }
+
+    if (Exponent == 3.0f) {
+        MlasTranscendentalTransform(Input, Output, N, [](MLAS_FLOAT32X4 Vector) {
+            return MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Vector, Vector), Vector);
+        });
+        return;
+    }
+
+    if (Exponent == -1.0f) {
+        const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+        MlasTranscendentalTransform(Input, Output, N, [&](MLAS_FLOAT32X4 Vector) {
+            return MlasDivideFloat32x4(One, Vector);
+        });
+        return;
+    }
+
+    //
+    // Infinite and NaN exponents have many special cases, so defer to the
+    // standard library.
+    //
+
+    if (!std::isfinite(Exponent)) {
+
+        while (N > 0) {
+            *Output++ = std::pow(*Input++, Exponent);
+            N -= 1;
+        }
+
+        return;
+    }
+
+    const bool IsInteger = (std::floor(Exponent) == Exponent);
+    const bool IsOdd = IsInteger && (std::fmod(Exponent, 2.0f) != 0.0f);
+
+    const MLAS_FLOAT32X4 ExponentBroadcast = MlasBroadcastFloat32x4(Exponent);
+    const MLAS_FLOAT32X4 SignMask = MlasBroadcastFloat32x4(MlasLogConstants.NegativeZero);
+    const MLAS_FLOAT32X4 OddMask = MlasReinterpretAsFloat32x4(MlasBroadcastInt32x4(IsOdd ? -1 : 0));
+    const MLAS_FLOAT32X4 NonIntegerMask = MlasReinterpretAsFloat32x4(MlasBroadcastInt32x4(IsInteger ? 0 : -1));
+    const MLAS_FLOAT32X4 NaN = MlasBroadcastFloat32x4(MlasLogConstants.NaN);
+    const MLAS_FLOAT32X4 NegativeInfinity = MlasBroadcastFloat32x4(MlasLogConstants.NegativeInfinity);
+
+    float Buffer[MLAS_TRANSCENDENTAL_BLOCK_SIZE];
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, size_t(MLAS_TRANSCENDENTAL_BLOCK_SIZE));
+
+        MlasTranscendentalTransform(Input, Buffer, CountN, [&](MLAS_FLOAT32X4 Vector) {
+            Vector = MlasAndNotFloat32x4(SignMask, Vector);
+            return MlasMultiplyFloat32x4(ExponentBroadcast, MlasComputeLogVector(Vector));
+        });
+
+        MlasComputeExp(Buffer, Buffer, CountN);
+
+        MlasTranscendentalTransform(Input, Buffer, Output, CountN, [&](MLAS_FLOAT32X4 Vector, MLAS_FLOAT32X4 Result) {
+
+            //
+            // Negate the result for negative bases with an odd exponent and
+            // produce NaN for finite negative bases with a non-integral
+            // exponent.
+            //
+
+            Result = MlasXorFloat32x4(Result, MlasAndFloat32x4(MlasAndFloat32x4(Vector, SignMask), OddMask));
+
+            const MLAS_FLOAT32X4 NaNMask = MlasAndFloat32x4(NonIntegerMask,
+                MlasAndFloat32x4(MlasGreaterThanFloat32x4(MlasZeroFloat32x4(), Vector),
+                    MlasGreaterThanFloat32x4(Vector, NegativeInfinity)));
+
+            return MlasBlendFloat32x4(Result, NaN, NaNMask);
+        });
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
+
+void
+MLASCALL
+MlasComputeGelu(
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    MLAS_COMPUTE_MODE Mode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the Gaussian error linear unit function.
+
+    The accurate mode computes "0.5 * x * (1 + erf(x / sqrt(2)))". The fast
+    mode computes the hyperbolic tangent approximation of the function.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Bias - Optionally supplies a bias buffer of N elements that is added to
+        the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Mode - Supplies the compute mode.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 Half = MlasBroadcastFloat32x4(MlasGeluConstants.Half);
+    const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(MlasGeluConstants.One);
+
+    float Buffer[MLAS_TRANSCENDENTAL_BLOCK_SIZE];
+    float BiasedInput[MLAS_TRANSCENDENTAL_BLOCK_SIZE];
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, size_t(MLAS_TRANSCENDENTAL_BLOCK_SIZE));
+
+        const float* x = Input;
+
+        if (Bias != nullptr) {
+
+            MlasTranscendentalTransform(Input, Bias, BiasedInput, CountN, [](MLAS_FLOAT32X4 Vector, MLAS_FLOAT32X4 BiasVector) {
+                return MlasAddFloat32x4(Vector, BiasVector);
+            });
+
+            x = BiasedInput;
+            Bias += CountN;
+        }
+
+        if (Mode == MlasComputeModeFast) {
+
+            const MLAS_FLOAT32X4 B = MlasBroadcastFloat32x4(MlasGeluConstants.B);
+            const MLAS_FLOAT32X4 C = MlasBroadcastFloat32x4(MlasGeluConstants.C);
+
+            MlasTranscendentalTransform(x, Buffer, CountN, [&](MLAS_FLOAT32X4 Vector) {
+                return MlasMultiplyFloat32x4(Vector, MlasMultiplyAddFloat32x4(MlasMultiplyFloat32x4(Vector, Vector), C, B));
+            });
+
+            MlasComputeTanh(Buffer, Buffer, CountN);
+
+        } else {
+
+            const MLAS_FLOAT32X4 SqrtHalf = MlasBroadcastFloat32x4(MlasGeluConstants.SqrtHalf);
+
+            MlasTranscendentalTransform(x, Buffer, CountN, [&](MLAS_FLOAT32X4 Vector) {
+                return MlasMultiplyFloat32x4(Vector, SqrtHalf);
+            });
+
+            MlasComputeErf(Buffer, Buffer, CountN);
+        }
+
+        MlasTranscendentalTransform(x, Buffer, Output, CountN, [&](MLAS_FLOAT32X4 Vector, MLAS_FLOAT32X4 Result) {
+            return MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Half, Vector), MlasAddFloat32x4(Result, One));
+        });
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSwish(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the swish function "x * logistic(Alpha * x)". The
+    SiLU function is the swish function with an alpha of one.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Alpha - Supplies the scale applied to the input of the logistic function.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(Alpha);
+
+    float Buffer[MLAS_TRANSCENDENTAL_BLOCK_SIZE];
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, size_t(MLAS_TRANSCENDENTAL_BLOCK_SIZE));
+
+        MlasTranscendentalTransform(Input, Buffer, CountN, [&](MLAS_FLOAT32X4 Vector) {
+            return MlasMultiplyFloat32x4(Vector, AlphaBroadcast);
+        });
+
+        MlasComputeLogistic(Buffer, Buffer, CountN);
+
+        MlasTranscendentalTransform(Input, Buffer, Output, CountN, [](MLAS_FLOAT32X4 Vector, MLAS_FLOAT32X4 Result) {
+            return MlasMultiplyFloat32x4(Vector, Result);
+        });
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftplus(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softplus function "log(1 + exp(x))".
+
+    The function is evaluated as "max(x, 0) + log1p(exp(-abs(x)))" to avoid
+    overflow for large inputs. The log1p term is computed from the logarithm
+    with a correction that preserves accuracy for small arguments.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 SignMask = MlasBroadcastFloat32x4(MlasLogConstants.NegativeZero);
+    const MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(MlasLogConstants.One);
+
+    float Buffer[MLAS_TRANSCENDENTAL_BLOCK_SIZE];
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, size_t(MLAS_TRANSCENDENTAL_BLOCK_SIZE));
+
+        MlasTranscendentalTransform(Input, Buffer, CountN, [&](MLAS_FLOAT32X4 Vector) {
+            return MlasOrFloat32x4(Vector, SignMask);
+        });
+
+        MlasComputeExp(Buffer, Buffer, CountN);
+
+        MlasTranscendentalTransform(Input, Buffer, Output, CountN, [&](MLAS_FLOAT32X4 Vector, MLAS_FLOAT32X4 Exp) {
+
+            //
+            // Compute log1p(u) as "log(w) * u / (w - 1)" where "w = 1 + u",
+            // which cancels the rounding error of the addition. If the
+            // addition rounds to one, then log1p(u) is u.
+            //
+
+            MLAS_FLOAT32X4 w = MlasAddFloat32x4(One, Exp);
+            MLAS_FLOAT32X4 wMinusOne = MlasSubtractFloat32x4(w, One);
+
+            MLAS_FLOAT32X4 Log1p = MlasDivideFloat32x4(MlasMultiplyFloat32x4(MlasComputeLogVector(w), Exp),
+                MlasMaximumFloat32x4(wMinusOne, MlasBroadcastFloat32x4(MlasLogConstants.MinimumNormal)));
+            Log1p = MlasBlendFloat32x4(Exp, Log1p, MlasGreaterThanFloat32x4(wMinusOne, MlasZeroFloat32x4()));
+
+            return MlasAddFloat32x4(MlasMaximumFloat32x4(MlasZeroFloat32x4(), Vector), Log1p);
+        });
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
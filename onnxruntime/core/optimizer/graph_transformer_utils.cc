@@ -29,6 +29,7 @@
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/nhwc_transformer.h"
+#include "core/optimizer/packed_attention_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
@@ -192,6 +193,9 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
   if (level == TransformerLevel::Level2) {
     std::unordered_set<std::string> cuda_execution_providers = {onnxruntime::kCudaExecutionProvider};
     transformers.emplace_back(onnxruntime::make_unique<GeluApproximation>(cuda_execution_providers));
+
+    std::unordered_set<std::string> cpu_execution_providers = {onnxruntime::kCpuExecutionProvider};
+    transformers.emplace_back(onnxruntime::make_unique<PackedAttentionFusion>(cpu_execution_providers));
   }
 #endif
 
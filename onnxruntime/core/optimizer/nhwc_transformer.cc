@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <deque>
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/nhwc_transformer.h"
@@ -47,6 +48,8 @@ class NhwcTransformerImpl {
   void TransformQLinearConv(Node& node);
   void TransformQLinearBinary(Node& node);
   void TransformQLinearActivation(Node& node);
+  void TransformConv(Node& node);
+  void TransformActivation(Node& node);
 
   Graph& graph_;
 
@@ -213,6 +216,71 @@ void NhwcTransformerImpl::TransformQLinearActivation(Node& node) {
   CreateNhwcArgument(node, node, nhwc_input->rank_);
 }
 
+void NhwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Require that the weights tensor have a shape so that the necessary
+  // Transpose nodes can be inserted into the graph.
+  auto* weights_shape = input_defs[1]->Shape();
+  if (weights_shape == nullptr || weights_shape->dim_size() < 3) {
+    return;
+  }
+
+  // The float channels last path is only a win for depthwise convolutions,
+  // which avoid the strided channel accesses of the NCHW implementation. Other
+  // convolutions are only converted if the input is already in NHWC format,
+  // so that the data stays in channels last format between depthwise layers.
+  auto* nhwc_input = LookupNhwcArgument(input_defs[0]);
+  if (nhwc_input == nullptr) {
+    const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+    const int64_t group = (group_attr != nullptr) ? group_attr->i() : 1;
+    if (!utils::HasDimValue(weights_shape->dim(0)) ||
+        !utils::HasDimValue(weights_shape->dim(1)) ||
+        weights_shape->dim(0).dim_value() != group ||
+        weights_shape->dim(1).dim_value() != 1 ||
+        group == 1) {
+      return;
+    }
+  }
+
+  // Create the replacement node. Both Conv and FusedConv are implemented by
+  // the FusedConv kernel, which supports the channels last layout.
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "FusedConv",
+                                   nhwc_node_name,
+                                   input_defs,
+                                   output_defs,
+                                   &node.GetAttributes(),
+                                   kMSDomain);
+  nhwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+  nhwc_node.AddAttribute("channels_last", static_cast<int64_t>(1));
+
+  if (nhwc_input == nullptr) {
+    InsertReorderInput(nhwc_node, weights_shape->dim_size());
+  } else {
+    nhwc_node.MutableInputDefs()[0] = nhwc_input->nhwc_arg_;
+    nhwc_input->remaining_original_uses_--;
+  }
+
+  CreateNhwcArgument(node, nhwc_node, weights_shape->dim_size());
+  removed_nodes_.push_front(node.Index());
+}
+
+void NhwcTransformerImpl::TransformActivation(Node& node) {
+  // Element-wise activations are layout agnostic, so keep the data in NHWC
+  // format if the input is already NHWC. Only the float variants are handled
+  // here as other types may not be supported by the CPU provider.
+  auto* input_type = node.InputDefs()[0]->TypeAsProto();
+  if (input_type == nullptr ||
+      input_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return;
+  }
+
+  TransformQLinearActivation(node);
+}
+
 void NhwcTransformerImpl::Transform(Node& node) {
   if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "QLinearConv", {10})) {
     TransformQLinearConv(node);
@@ -222,6 +290,14 @@ void NhwcTransformerImpl::Transform(Node& node) {
   } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "QLinearLeakyRelu", {1}, kMSDomain) ||
              graph_utils::IsSupportedOptypeVersionAndDomain(node, "QLinearSigmoid", {1}, kMSDomain)) {
     TransformQLinearActivation(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
+    TransformConv(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6})) {
+    TransformActivation(node);
   }
 }
 
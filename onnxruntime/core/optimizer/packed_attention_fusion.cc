@@ -0,0 +1,328 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/packed_attention_fusion.h"
+#include "core/graph/contrib_ops/contrib_defs.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+
+#include <algorithm>
+
+#define DEBUG_LOG(x) LOGS(logger, VERBOSE) << x
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// Returns whether the value is a constant that broadcasts the same values to every token, like a bias.
+static bool IsTokenBroadcastConstant(const Graph& graph, const NodeArg& arg) {
+  const auto* initializer = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (initializer == nullptr) {
+    return false;
+  }
+
+  for (int i = 0; i + 1 < initializer->dims_size(); i++) {
+    if (initializer->dims(i) != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether the mask of attention can drive RemovePadding: the mask index output of EmbedLayerNormalization, or
+// an int32 mask with shape (batch_size) or (batch_size, sequence_length) that does not depend on the embedding. A 1D
+// mask index with shape (2 * batch_size) has start positions that RemovePadding does not support.
+static bool IsPackingMask(const Graph& graph, const NodeArg& mask, const Node& embed_node,
+                          const std::unordered_set<NodeIndex>& embed_descendants) {
+  const auto& embed_outputs = embed_node.OutputDefs();
+  if (embed_outputs.size() > 1 && &mask == embed_outputs[1]) {
+    return true;
+  }
+
+  const auto* mask_shape = mask.Shape();
+  if (mask_shape == nullptr || mask.TypeAsProto() == nullptr ||
+      mask.TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_INT32) {
+    return false;
+  }
+
+  if (mask_shape->dim_size() == 1) {
+    const auto* embedding_shape = embed_outputs[0]->Shape();
+    if (embedding_shape == nullptr || embedding_shape->dim_size() != 3) {
+      return false;
+    }
+    const auto& mask_dim = mask_shape->dim(0);
+    const auto& batch_dim = embedding_shape->dim(0);
+    const bool same_batch = (utils::HasDimValue(mask_dim) && utils::HasDimValue(batch_dim) &&
+                             mask_dim.dim_value() == batch_dim.dim_value()) ||
+                            (utils::HasDimParam(mask_dim) && utils::HasDimParam(batch_dim) &&
+                             mask_dim.dim_param() == batch_dim.dim_param());
+    if (!same_batch) {
+      return false;
+    }
+  } else if (mask_shape->dim_size() != 2) {
+    return false;
+  }
+
+  // RemovePadding runs right after the embedding, so the mask cannot be computed from it.
+  const Node* producer = graph.GetProducerNode(mask.Name());
+  return producer == nullptr || embed_descendants.count(producer->Index()) == 0;
+}
+
+// Returns whether the node computes each token independently of the other tokens, so that it produces the same
+// results for the real tokens when the inputs in packed_args are packed. All attention nodes shall share one mask,
+// which is selected by the first one.
+static bool IsTokenWiseNode(const Graph& graph, const Node& node, const std::unordered_set<const NodeArg*>& packed_args,
+                            const Node& embed_node, const std::unordered_set<NodeIndex>& embed_descendants,
+                            const NodeArg*& mask) {
+  const auto& inputs = node.InputDefs();
+  auto is_packed = [&](size_t i) {
+    return i < inputs.size() && packed_args.count(inputs[i]) > 0;
+  };
+  auto none_packed_from = [&](size_t first) {
+    for (size_t i = first; i < inputs.size(); i++) {
+      if (is_packed(i)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Attention", {1}, kMSDomain)) {
+    // Only masked attention can be packed. Past state needs the padded layout.
+    const auto& outputs = node.OutputDefs();
+    const auto* swapped_attr = graph_utils::GetNodeAttribute(node, "input_dimension_swapped");
+    if (!is_packed(0) || !none_packed_from(1) || inputs.size() <= 3 || !inputs[3]->Exists() ||
+        (inputs.size() > 4 && inputs[4]->Exists()) ||
+        (outputs.size() > 1 && outputs[1]->Exists()) ||
+        (swapped_attr != nullptr && swapped_attr->i() != 0)) {
+      return false;
+    }
+
+    if (mask == nullptr && IsPackingMask(graph, *inputs[3], embed_node, embed_descendants)) {
+      mask = inputs[3];
+    }
+    return inputs[3] == mask;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+    const auto* weights = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+    return is_packed(0) && weights != nullptr && weights->dims_size() == 2;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13})) {
+    return (is_packed(0) && (is_packed(1) || IsTokenBroadcastConstant(graph, *inputs[1]))) ||
+           (is_packed(1) && IsTokenBroadcastConstant(graph, *inputs[0]));
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "SkipLayerNormalization", {1}, kMSDomain)) {
+    return is_packed(0) && is_packed(1) && none_packed_from(2);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LayerNormalization", {1}, kOnnxDomain)) {
+    // The packed values keep the rank of the padded values, so the last axis is still the hidden dimension.
+    const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+    const int64_t axis = axis_attr == nullptr ? -1 : axis_attr->i();
+    return is_packed(0) && none_packed_from(1) && (axis == -1 || axis == 2);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "BiasGelu", {1}, kMSDomain) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain)) {
+    return is_packed(0) && none_packed_from(1);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13})) {
+    return is_packed(0);
+  }
+
+  return false;
+}
+
+// Returns whether only the first output of the node is used.
+static bool IsOnlyFirstOutputUsed(const Graph& graph, const Node& node) {
+  const auto& outputs = node.OutputDefs();
+  const auto graph_outputs = graph.GetNodeOutputsInGraphOutputs(node);
+  for (int i = 1; i < static_cast<int>(outputs.size()); i++) {
+    if (outputs[i]->Exists() &&
+        (graph_utils::IsOutputUsed(node, i) ||
+         std::find(graph_outputs.begin(), graph_outputs.end(), i) != graph_outputs.end())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PackedAttentionFusion::PackSequences(Graph& graph, Node& embed_node,
+                                          const std::vector<NodeIndex>& node_topology_list,
+                                          const logging::Logger& logger) const {
+  NodeArg* embedding_arg = embed_node.MutableOutputDefs()[0];
+
+  // Find the nodes that depend on the embedding, which cannot compute the mask.
+  std::unordered_set<NodeIndex> embed_descendants;
+  std::vector<const Node*> pending{&embed_node};
+  while (!pending.empty()) {
+    const Node* node = pending.back();
+    pending.pop_back();
+    for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+      if (embed_descendants.insert(it->Index()).second) {
+        pending.push_back(&*it);
+      }
+    }
+  }
+
+  // Find the nodes that can run on packed sequences, in topological order.
+  std::unordered_set<const NodeArg*> packed_args{embedding_arg};
+  std::unordered_set<NodeIndex> packed_node_indices;
+  std::vector<Node*> packed_nodes;
+  const NodeArg* mask = nullptr;
+  size_t attention_count = 0;
+
+  for (auto node_index : node_topology_list) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr || node == &embed_node) {
+      continue;
+    }
+
+    const auto& inputs = node->InputDefs();
+    if (std::none_of(inputs.begin(), inputs.end(), [&](const NodeArg* arg) { return packed_args.count(arg) > 0; })) {
+      continue;
+    }
+
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        !IsOnlyFirstOutputUsed(graph, *node) ||
+        !IsTokenWiseNode(graph, *node, packed_args, embed_node, embed_descendants, mask)) {
+      continue;
+    }
+
+    if (node->OpType() == "Attention") {
+      attention_count++;
+    }
+
+    packed_args.insert(node->OutputDefs()[0]);
+    packed_node_indices.insert(node_index);
+    packed_nodes.push_back(node);
+  }
+
+  if (attention_count == 0) {
+    DEBUG_LOG("No attention to pack after " << embed_node.Name());
+    return false;
+  }
+
+  // Determine which values are still consumed in the padded layout before changing any edges.
+  std::vector<bool> restore_padding(packed_nodes.size());
+  for (size_t n = 0; n < packed_nodes.size(); n++) {
+    const Node& node = *packed_nodes[n];
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      if (packed_node_indices.count(it->GetNode().Index()) == 0) {
+        restore_padding[n] = true;
+      }
+    }
+    if (!graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+      restore_padding[n] = true;
+    }
+  }
+
+  // The edges are rebuilt from the node definitions when the graph is resolved.
+  graph_utils::RemoveNodeOutputEdges(graph, embed_node);
+  for (Node* node : packed_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+  }
+
+  const auto& provider_type = embed_node.GetExecutionProviderType();
+
+  auto* packed_embedding_arg = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("packed"), nullptr);
+  auto* token_offset_arg = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("token_offset"), nullptr);
+  auto* cumulative_sequence_length_arg =
+      &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("cumulative_sequence_length"), nullptr);
+
+  Node& remove_padding_node = graph.AddNode(graph.GenerateNodeName("RemovePadding"),
+                                            "RemovePadding",
+                                            "Pack the real tokens of all sequences",
+                                            {embedding_arg, graph.GetNodeArg(mask->Name())},
+                                            {packed_embedding_arg, token_offset_arg, cumulative_sequence_length_arg},
+                                            nullptr,
+                                            kMSDomain);
+  remove_padding_node.SetExecutionProviderType(provider_type);
+
+  std::unordered_map<const NodeArg*, NodeArg*> packed_arg_map{{embedding_arg, packed_embedding_arg}};
+
+  for (size_t n = 0; n < packed_nodes.size(); n++) {
+    Node& node = *packed_nodes[n];
+
+    auto& input_defs = node.MutableInputDefs();
+    for (auto& input_def : input_defs) {
+      auto it = packed_arg_map.find(input_def);
+      if (it != packed_arg_map.end()) {
+        input_def = it->second;
+      }
+    }
+
+    NodeArg* padded_output_arg = node.MutableOutputDefs()[0];
+    auto* packed_output_arg = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("packed"), nullptr);
+    packed_arg_map[padded_output_arg] = packed_output_arg;
+
+    if (node.OpType() == "Attention") {
+      NodeAttributes attributes;
+      for (const auto* attr_name : {"num_heads", "unidirectional"}) {
+        const auto* attr = graph_utils::GetNodeAttribute(node, attr_name);
+        if (attr != nullptr) {
+          attributes[attr_name] = *attr;
+        }
+      }
+
+      Node& packed_attention_node = graph.AddNode(graph.GenerateNodeName("PackedAttention"),
+                                                  "PackedAttention",
+                                                  "Attention over packed sequences",
+                                                  {input_defs[0], input_defs[1], input_defs[2],
+                                                   cumulative_sequence_length_arg},
+                                                  {packed_output_arg},
+                                                  &attributes,
+                                                  kMSDomain);
+      packed_attention_node.SetExecutionProviderType(node.GetExecutionProviderType());
+      graph.RemoveNode(node.Index());
+    } else {
+      node.MutableOutputDefs()[0] = packed_output_arg;
+    }
+
+    if (restore_padding[n]) {
+      Node& restore_padding_node = graph.AddNode(graph.GenerateNodeName("RestorePadding"),
+                                                 "RestorePadding",
+                                                 "Scatter the real tokens back to the padded layout",
+                                                 {packed_output_arg, token_offset_arg},
+                                                 {padded_output_arg},
+                                                 nullptr,
+                                                 kMSDomain);
+      restore_padding_node.SetExecutionProviderType(provider_type);
+    }
+  }
+
+  DEBUG_LOG("Packed " << packed_nodes.size() << " nodes including " << attention_count << " attention nodes");
+  return true;
+}
+
+Status PackedAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // we removed the node as part of an earlier rewrite
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "EmbedLayerNormalization", {1}, kMSDomain) &&
+        graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      if (PackSequences(graph, node, node_topology_list, logger)) {
+        modified = true;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class PackedAttentionFusion
+
+Rewrite a BERT graph fused by EmbedLayerNormFusion and AttentionFusion to run on packed sequences. The output of
+EmbedLayerNormalization is packed by RemovePadding with the mask shared by the attention nodes, so that the following
+token-wise nodes (MatMul, Add, layer normalization and activations) only compute the real tokens, and Attention is
+replaced by PackedAttention which computes each sequence separately. RestorePadding is inserted wherever a value is consumed in the padded layout.
+
+The padding tokens of the restored values are zero instead of the values computed by the dense graph, so this
+transformer is only enabled by a custom transformer list.
+*/
+class PackedAttentionFusion : public GraphTransformer {
+ public:
+  PackedAttentionFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("PackedAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+ private:
+  bool PackSequences(Graph& graph, Node& embed_node, const std::vector<NodeIndex>& node_topology_list,
+                     const logging::Logger& logger) const;
+};
+
+}  // namespace onnxruntime
@@ -66,8 +66,20 @@ struct ThreadOptions {
   // processor group [0,1,2,3] may only contain half of the physical cores.
   std::vector<size_t> affinity;
 
+  // If the vector is not empty, thread i can run on any of the logical processors in cpu_sets[i % cpu_sets.size()],
+  // for example on all the processors of one NUMA node. Values are CPU IDs, starting from zero. It takes precedence
+  // over affinity.
+  std::vector<std::vector<size_t>> cpu_sets;
+
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
+
+  // Collect the utilization counters of the threads and parallel loops, see ThreadPool::GetStats.
+  bool collect_stats = false;
+
+  // Measure the cost of the parallel loops run by the pool and use it in place of the estimates
+  // passed to ThreadPool::TryParallelFor.
+  bool adaptive_loop_costs = false;
 };
 /// \brief An interface used by the onnxruntime implementation to
 /// access operating system functionality like the filesystem etc.
@@ -111,6 +123,13 @@ class Env {
   // This function doesn't support systems with more than 64 logical processors
   virtual std::vector<size_t> GetThreadAffinityMasks() const = 0;
 
+  /// \brief Returns the logical processors of each NUMA node, indexed by node number.
+  ///
+  /// The result is empty if the topology isn't available on this platform.
+  virtual std::vector<std::vector<size_t>> GetNumaNodeCpus() const {
+    return {};
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -27,6 +27,7 @@ limitations under the License.
 #include <dlfcn.h>
 #include <ftw.h>
 #include <string.h>
+#include <fstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -98,6 +99,45 @@ int nftw_remove(
   return result;
 }
 
+#if defined(__linux__)
+// Parses a CPU list in the kernel's cpulist format, e.g. "0-3,8,10-11". Returns false if it is malformed.
+bool ParseCpuList(const std::string& cpu_list, std::vector<size_t>& cpus) {
+  cpus.clear();
+  const char* p = cpu_list.c_str();
+  while (*p != '\0' && *p != '\n') {
+    char* end = nullptr;
+    const unsigned long first = strtoul(p, &end, 10);
+    if (end == p) {
+      return false;
+    }
+    unsigned long last = first;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      last = strtoul(p, &end, 10);
+      if (end == p || last < first) {
+        return false;
+      }
+      p = end;
+    }
+    for (unsigned long cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(static_cast<size_t>(cpu));
+    }
+    if (*p == ',') {
+      ++p;
+    }
+  }
+  return true;
+}
+
+// Reads a file of the sysfs node topology, which holds a single cpulist formatted line.
+bool ReadSysfsList(const std::string& path, std::vector<size_t>& values) {
+  std::ifstream file(path);
+  std::string line;
+  return file && std::getline(file, line) && ParseCpuList(line, values);
+}
+#endif
+
 template <typename T>
 struct Freer {
   void operator()(T* p) { ::free(p); }
@@ -133,7 +173,22 @@ class PosixThread : public EnvThread {
     if (s != 0)
       ORT_THROW("pthread_create failed");
 #if !defined(__APPLE__) && !defined(__ANDROID__)
-    if (!thread_options.affinity.empty()) {
+    if (!thread_options.cpu_sets.empty()) {
+      const auto& cpus = thread_options.cpu_sets[index % thread_options.cpu_sets.size()];
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      for (size_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+          CPU_SET(cpu, &cpuset);
+        }
+      }
+      // like on Windows a set that can't be applied, e.g. because none of its processors is allowed for the
+      // process, leaves the thread unbound rather than failing the creation of the pool.
+      s = pthread_setaffinity_np(hThread, sizeof(cpu_set_t), &cpuset);
+      if (s != 0)
+        LOGS_DEFAULT(WARNING) << "Failed to bind thread " << index << " to its CPU set, error code: " << s
+                              << ". The thread can run on any processor.";
+    } else if (!thread_options.affinity.empty()) {
       cpu_set_t cpuset;
       CPU_ZERO(&cpuset);
       CPU_SET(thread_options.affinity[index], &cpuset);
@@ -200,6 +255,28 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<std::vector<size_t>> GetNumaNodeCpus() const override {
+    std::vector<std::vector<size_t>> node_cpus;
+#if defined(__linux__)
+    // Parse the sysfs topology rather than depending on libnuma.
+    std::vector<size_t> nodes;
+    if (!ReadSysfsList("/sys/devices/system/node/online", nodes)) {
+      return {};
+    }
+    for (size_t node : nodes) {
+      std::vector<size_t> cpus;
+      if (!ReadSysfsList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", cpus)) {
+        return {};
+      }
+      if (node >= node_cpus.size()) {
+        node_cpus.resize(node + 1);
+      }
+      node_cpus[node] = std::move(cpus);
+    }
+#endif
+    return node_cpus;
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -77,7 +77,17 @@ class WindowsThread : public EnvThread {
   static unsigned __stdcall ThreadMain(void* param) {
     std::unique_ptr<Param> p((Param*)param);
     // TODO: should I try to use SetThreadSelectedCpuSets?
-    if (!p->thread_options.affinity.empty())
+    if (!p->thread_options.cpu_sets.empty()) {
+      const auto& cpus = p->thread_options.cpu_sets[p->index % p->thread_options.cpu_sets.size()];
+      // Only the processors of the current processor group can be set.
+      DWORD_PTR mask = 0;
+      for (size_t cpu : cpus) {
+        if (cpu < sizeof(DWORD_PTR) * 8)
+          mask |= static_cast<DWORD_PTR>(1) << cpu;
+      }
+      if (mask != 0)
+        SetThreadAffinityMask(GetCurrentThread(), mask);
+    } else if (!p->thread_options.affinity.empty())
       SetThreadAffinityMask(GetCurrentThread(), p->thread_options.affinity[p->index]);
 #if WINVER >= _WIN32_WINNT_WIN10
     constexpr SetThreadDescriptionFunc pSetThrDesc = SetThreadDescription;
@@ -172,6 +182,29 @@ class WindowsEnv : public Env {
     return ret;
   }
 
+  std::vector<std::vector<size_t>> GetNumaNodeCpus() const override {
+    std::vector<std::vector<size_t>> node_cpus;
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+    ULONG highest_node = 0;
+    if (GetNumaHighestNodeNumber(&highest_node) == FALSE) {
+      return node_cpus;
+    }
+    node_cpus.resize(static_cast<size_t>(highest_node) + 1);
+    for (ULONG node = 0; node <= highest_node; ++node) {
+      ULONGLONG mask = 0;
+      if (GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask) == FALSE) {
+        continue;
+      }
+      for (size_t cpu = 0; cpu < 64; ++cpu) {
+        if (mask & (1ULL << cpu)) {
+          node_cpus[node].push_back(cpu);
+        }
+      }
+    }
+#endif
+    return node_cpus;
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
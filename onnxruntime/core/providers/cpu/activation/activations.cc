@@ -87,6 +87,13 @@ template Status ElementWiseRangedTransform<float>::Create(const std::string& typ
       KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()), x<float>);
 
 namespace functors {
+template <>
+void Softplus<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeSoftplus(input + first, output_ptr, static_cast<size_t>(len));
+}
+
 template <>
 void Sigmoid<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
   ptrdiff_t len = last - first;
@@ -12,6 +12,8 @@
 #include "core/providers/cpu/controlflow/loop.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
+#include <array>
+
 #include "core/framework/allocator.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -157,6 +159,21 @@ struct Loop::Info {
     for (int i = 0; i < num_subgraph_outputs; ++i) {
       auto& output = subgraph_outputs[i];
       subgraph_output_names.push_back(output->Name());
+
+      const auto* type = output->TypeAsProto();
+      subgraph_output_is_tensor.push_back(type != nullptr &&
+                                          type->value_case() == ONNX_NAMESPACE::TypeProto::kTensorType);
+    }
+
+    // the number of iterations is known up front when the subgraph passes the condition through unchanged,
+    // which is how a 'for' loop with only a trip count is usually exported.
+    const auto& condition_in = subgraph_input_names[1];
+    const auto& condition_out = subgraph_output_names[0];
+    condition_is_loop_invariant = condition_in == condition_out;
+    if (!condition_is_loop_invariant) {
+      const auto* producer = subgraph.GetProducerNode(condition_out);
+      condition_is_loop_invariant = producer != nullptr && producer->OpType() == "Identity" &&
+                                    producer->InputDefs()[0]->Name() == condition_in;
     }
   }
 
@@ -171,6 +188,10 @@ struct Loop::Info {
 
   std::vector<std::string> subgraph_input_names;
   std::vector<std::string> subgraph_output_names;
+
+  // custom allocators are only used for subgraph outputs that are tensors
+  std::vector<bool> subgraph_output_is_tensor;
+  bool condition_is_loop_invariant;
 };
 
 class LoopImpl {
@@ -189,11 +210,34 @@ class LoopImpl {
 
  private:
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
-  void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  Status SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // setup the custom allocators that let the subgraph write its outputs directly into re-used buffers
+  void CreateFetchAllocators(std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // custom allocator for a loop carried var. alternates between two buffers so the output of one iteration can be
+  // fed to the next while the buffer from the previous iteration is written. if the trip count is known the last
+  // iteration writes directly to the Loop output.
+  Status AllocateLoopCarriedVar(int index, const TensorShape& shape, const OrtMemoryInfo& location,
+                                OrtValue& ort_value, bool& allocated);
+
+  // custom allocator for a scan output when the trip count is known. each iteration writes to its slice of the
+  // Loop output, which is allocated by the first iteration.
+  Status AllocateScanOutput(int output_index, const TensorShape& shape, const OrtMemoryInfo& location,
+                            OrtValue& ort_value, bool& allocated);
+
+  // copy the scan output of an iteration to its slice of the Loop output if the subgraph didn't write it there.
+  Status SaveScanOutput(int output_index, const OrtValue& value);
+
+  // returns an OrtValue for the slice of a scan output written by the current iteration
+  OrtValue GetScanOutputSlice(int output_index) const;
+
+  // stop re-using a loop carried var buffer that is still referenced by a value we are keeping
+  void ReleaseAliasedBuffers(const OrtValue& value);
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -206,10 +250,24 @@ class LoopImpl {
   OrtValue iter_num_mlvalue_;
   OrtValue condition_mlvalue_;
 
+  // number of iterations if known before execution, or -1.
+  int64_t trip_count_ = -1;
+  int64_t iteration_ = 0;
+
   // collection of OrtValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // Loop outputs for the scan outputs if the trip count is known
+  std::vector<Tensor*> scan_outputs_;
+
+  // the two buffers used for each loop carried var, and the data type they are allocated with
+  std::vector<std::array<OrtValue, 2>> loop_carried_buffers_;
+  std::vector<MLDataType> loop_carried_types_;
+
+  // the buffers that the current iteration's feeds use. a buffer is not handed out while it's being read.
+  std::vector<const void*> feed_buffers_;
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
@@ -405,6 +463,18 @@ Status LoopImpl::Initialize() {
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
 
+  if (max_trip_count_tensor && info_.condition_is_loop_invariant) {
+    trip_count_ = condition_ ? std::max<int64_t>(max_trip_count_, 0) : 0;
+    scan_outputs_.resize(info_.num_outputs - info_.num_loop_carried_vars, nullptr);
+  }
+
+  loop_carried_buffers_.resize(info_.num_loop_carried_vars);
+  loop_carried_types_.reserve(info_.num_loop_carried_vars);
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    const auto* input = context_.GetInputMLValue(i + 2);  // skip 'M' and 'cond'
+    loop_carried_types_.push_back(input->IsTensor() ? input->Get<Tensor>().DataType() : nullptr);
+  }
+
   return status;
 }
 
@@ -426,8 +496,8 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
-void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
-                                         std::vector<OrtValue>& next_inputs) {
+Status LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
+                                           std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
@@ -436,10 +506,150 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
-  // save loop outputs as we have to concatenate at the end
   for (int j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+    const auto& output = last_outputs[j + 1];  // skip 'cond' in output
+    ORT_ENFORCE(output.IsTensor(), "All scan outputs MUST be tensors");
+
+    if (trip_count_ >= 0) {
+      ORT_RETURN_IF_ERROR(SaveScanOutput(j, output));
+    } else {
+      // save loop outputs as we have to concatenate at the end
+      ReleaseAliasedBuffers(output);
+      loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(output);
+    }
+  }
+
+  return Status::OK();
+}
+
+void LoopImpl::CreateFetchAllocators(std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // the fetch index is the subgraph output index, so + 1 to skip 'cond'
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    if (info_.subgraph_output_is_tensor[i + 1] && loop_carried_types_[i] != nullptr) {
+      fetch_allocators[i + 1] = [this, i](const TensorShape& shape, const OrtMemoryInfo& location,
+                                          OrtValue& ort_value, bool& allocated) {
+        return AllocateLoopCarriedVar(i, shape, location, ort_value, allocated);
+      };
+    }
+  }
+
+  if (trip_count_ >= 0) {
+    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+      if (info_.subgraph_output_is_tensor[i + 1]) {
+        fetch_allocators[i + 1] = [this, i](const TensorShape& shape, const OrtMemoryInfo& location,
+                                            OrtValue& ort_value, bool& allocated) {
+          return AllocateScanOutput(i, shape, location, ort_value, allocated);
+        };
+      }
+    }
+  }
+}
+
+Status LoopImpl::AllocateLoopCarriedVar(int index, const TensorShape& shape, const OrtMemoryInfo& location,
+                                        OrtValue& ort_value, bool& allocated) {
+  // the last iteration writes directly to the Loop output if it's on the same device
+  if (iteration_ == trip_count_ - 1) {
+    Tensor* output = context_.Output(index, shape);
+    if (output->Location().device == location.device) {
+      ort_value = *context_.GetOutputMLValue(index);
+      allocated = true;
+    }
+
+    return Status::OK();
+  }
+
+  auto& buffer = loop_carried_buffers_[index][iteration_ % 2];
+
+  // the buffer may be the input of this iteration if the subgraph passed its input through as the output
+  if (buffer.IsAllocated() &&
+      std::find(feed_buffers_.cbegin(), feed_buffers_.cend(), buffer.Get<Tensor>().DataRaw()) != feed_buffers_.cend()) {
+    buffer = OrtValue();
+  }
+
+  if (!buffer.IsAllocated() || buffer.Get<Tensor>().Shape() != shape ||
+      buffer.Get<Tensor>().Location().device != location.device) {
+    auto allocator = session_state_.GetAllocator(location);
+    if (!allocator) {
+      // let the execution frame allocate it
+      return Status::OK();
+    }
+
+    auto tensor = onnxruntime::make_unique<Tensor>(loop_carried_types_[index], shape, allocator);
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    buffer.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  }
+
+  ort_value = buffer;
+  allocated = true;
+
+  return Status::OK();
+}
+
+Status LoopImpl::AllocateScanOutput(int output_index, const TensorShape& shape, const OrtMemoryInfo& location,
+                                    OrtValue& ort_value, bool& allocated) {
+  auto& output = scan_outputs_[output_index - info_.num_loop_carried_vars];
+  if (output == nullptr) {
+    std::vector<int64_t> dims;
+    dims.reserve(1 + shape.NumDimensions());
+    dims.push_back(trip_count_);
+    std::copy(shape.GetDims().cbegin(), shape.GetDims().cend(), std::back_inserter(dims));
+    output = context_.Output(output_index, TensorShape(dims));
+  }
+
+  // if the shape doesn't match SaveScanOutput will report the error
+  if (output->Location().device == location.device &&
+      output->Shape().Slice(1) == shape) {
+    ort_value = GetScanOutputSlice(output_index);
+    allocated = true;
+  }
+
+  return Status::OK();
+}
+
+Status LoopImpl::SaveScanOutput(int output_index, const OrtValue& value) {
+  const auto& data = value.Get<Tensor>();
+  auto& output = scan_outputs_[output_index - info_.num_loop_carried_vars];
+  if (output == nullptr) {
+    std::vector<int64_t> dims;
+    dims.reserve(1 + data.Shape().NumDimensions());
+    dims.push_back(trip_count_);
+    std::copy(data.Shape().GetDims().cbegin(), data.Shape().GetDims().cend(), std::back_inserter(dims));
+    output = context_.Output(output_index, TensorShape(dims));
+  }
+
+  if (output->Shape().Slice(1) != data.Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                           " Expected:", output->Shape().Slice(1), " Got:", data.Shape());
+  }
+
+  OrtValue slice = GetScanOutputSlice(output_index);
+  if (slice.Get<Tensor>().DataRaw() != data.DataRaw()) {
+    ORT_RETURN_IF_ERROR(session_state_.GetDataTransferMgr().CopyTensor(data, *slice.GetMutable<Tensor>()));
+  }
+
+  return Status::OK();
+}
+
+OrtValue LoopImpl::GetScanOutputSlice(int output_index) const {
+  Tensor& output = *scan_outputs_[output_index - info_.num_loop_carried_vars];
+  TensorShape slice_shape = output.Shape().Slice(1);
+  auto bytes_per_iteration = gsl::narrow<size_t>(slice_shape.Size()) * output.DataType()->Size();
+  auto* slice_data = static_cast<gsl::byte*>(output.MutableDataRaw()) + iteration_ * bytes_per_iteration;
+
+  auto tensor = onnxruntime::make_unique<Tensor>(output.DataType(), slice_shape, slice_data, output.Location());
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  return OrtValue{tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc()};
+}
+
+void LoopImpl::ReleaseAliasedBuffers(const OrtValue& value) {
+  const void* data = value.Get<Tensor>().DataRaw();
+  for (auto& buffers : loop_carried_buffers_) {
+    for (auto& buffer : buffers) {
+      if (buffer.IsAllocated() && buffer.Get<Tensor>().DataRaw() == data) {
+        // the saved value keeps the buffer alive
+        buffer = OrtValue();
+      }
+    }
   }
 }
 
@@ -467,18 +677,29 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
+  CreateFetchAllocators(fetch_allocators);
+  feed_buffers_.reserve(feeds.size());
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
-      SaveOutputsAndUpdateFeeds(fetches, feeds);
+      ORT_RETURN_IF_ERROR(SaveOutputsAndUpdateFeeds(fetches, feeds));
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    iteration_ = iter_num_value;
+    feed_buffers_.clear();
+    for (const auto& feed : feeds) {
+      if (feed.IsTensor()) {
+        feed_buffers_.push_back(feed.Get<Tensor>().DataRaw());
+      }
+    }
+
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
@@ -495,7 +716,10 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     if (type == DataTypeImpl::GetType<Tensor>()) {
       auto& data = input.Get<Tensor>();
       Tensor* output = context_.Output(output_idx, data.Shape());
-      session_state_.GetDataTransferMgr().CopyTensor(input.Get<Tensor>(), *output);
+      // the last iteration may have written directly to the output
+      if (output->DataRaw() != data.DataRaw()) {
+        session_state_.GetDataTransferMgr().CopyTensor(input.Get<Tensor>(), *output);
+      }
     } else if (type == DataTypeImpl::GetType<TensorSeq>()) {
       std::vector<Tensor> tensors;
 
@@ -526,6 +750,12 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     }
 
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+      if (trip_count_ >= 0) {
+        // the previous iterations were saved to the output already
+        ORT_RETURN_IF_ERROR(SaveScanOutput(i, fetches[i + 1]));  // skip cond
+        continue;
+      }
+
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[i - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[i + 1]);  // skip cond
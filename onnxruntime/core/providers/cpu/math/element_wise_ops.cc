@@ -18,6 +18,13 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
   float* output_ptr = output + first;
   MlasComputeExp(input + first, output_ptr, static_cast<size_t>(len));
 }
+
+template <>
+void Log<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeLog(input + first, output_ptr, static_cast<size_t>(len));
+}
 }  // namespace functors
 
 #define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
@@ -358,6 +365,43 @@ Status Div<T>::Compute(OpKernelContext* context) const {
 
 namespace pow_internal {
 
+template <typename T, typename E>
+void PowScalarExponent(gsl::span<const T> X, const E Y, gsl::span<T> output) {
+  // optimize for X^2 and X^3
+  if (Y == 2) {
+    std::transform(X.cbegin(), X.cend(), output.begin(),
+                   [](T x) {
+                     return static_cast<T>(x * x);
+                   });
+
+  } else if (Y == 3) {
+    std::transform(X.cbegin(), X.cend(), output.begin(),
+                   [](T x) {
+                     return static_cast<T>(x * x * x);
+                   });
+  } else {
+    std::transform(X.cbegin(), X.cend(), output.begin(),
+                   [Y](T x) {
+                     return static_cast<T>(std::pow(x, Y));
+                   });
+  }
+}
+
+// float base with an exponent that is exactly representable as a float uses the vectorized MLAS routine.
+template <typename E>
+void PowScalarExponent(gsl::span<const float> X, const E Y, gsl::span<float> output) {
+  const float exponent = static_cast<float>(Y);
+  if (static_cast<E>(exponent) != Y) {
+    std::transform(X.cbegin(), X.cend(), output.begin(),
+                   [Y](float x) {
+                     return static_cast<float>(std::pow(x, Y));
+                   });
+    return;
+  }
+
+  MlasComputePow(X.data(), output.data(), static_cast<size_t>(X.size()), exponent);
+}
+
 template <typename T, typename E>
 void PowImpl(OpKernelContext& context) {
   ProcessBroadcastSpanFuncs funcs{
@@ -372,28 +416,7 @@ void PowImpl(OpKernelContext& context) {
                        });
       },
       [](BroadcastHelper& per_iter_bh) {
-        auto X = per_iter_bh.SpanInput0<T>();
-        const E Y = per_iter_bh.ScalarInput1<E>();
-        auto output = per_iter_bh.OutputSpan<T>();
-
-        // optimize for X^2 and X^3
-        if (Y == 2) {
-          std::transform(X.cbegin(), X.cend(), output.begin(),
-                         [](T x) {
-                           return static_cast<T>(x * x);
-                         });
-
-        } else if (Y == 3) {
-          std::transform(X.cbegin(), X.cend(), output.begin(),
-                         [](T x) {
-                           return static_cast<T>(x * x * x);
-                         });
-        } else {
-          std::transform(X.cbegin(), X.cend(), output.begin(),
-                         [Y](T x) {
-                           return static_cast<T>(std::pow(x, Y));
-                         });
-        }
+        PowScalarExponent(per_iter_bh.SpanInput0<T>(), per_iter_bh.ScalarInput1<E>(), per_iter_bh.OutputSpan<T>());
       },
       [](BroadcastHelper& per_iter_bh) {
         auto X = per_iter_bh.SpanInput0<T>();
@@ -5,7 +5,6 @@
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/math.h"
-#include "core/providers/cpu/tensor/transpose.h"
 
 namespace onnxruntime {
 
@@ -23,103 +22,46 @@ Status Hardmax<float>::Compute(OpKernelContext* ctx) const {
   // handle negative and enforce axis is valid
   const size_t axis = static_cast<size_t>(HandleNegativeAxis(axis_, rank));
 
-  bool is_transpose_required = false;
-  Tensor transposed_input;
-  std::vector<int64_t> transposed_input_dims;
-  Tensor intermediate_output;  // output that the hardmax implementation will write into while using transposed input
-  std::vector<size_t> permutation(rank);
-
   // The "semantic" meaning of axis has changed in opset-13.
   // Please compare: https://github.com/onnx/onnx/blob/master/docs/Operators.md#Hardmax
   // with https://github.com/onnx/onnx/blob/master/docs/Changelog.md#Hardmax-11 for detailed explanations
-  // To account for the opset-13 behavior, our plan will be to transpose the "axis" dim to the innermost dim
-  // and perform softmax and then reverse the transpose. We can skip the transposing aspect if the axis is already
-  // the innermost dim
-  if (opset_ >= 13 && axis != (rank - 1)) {
-    is_transpose_required = true;
-  }
-
-  if (is_transpose_required) {
-    AllocatorPtr alloc;
-    auto status = ctx->GetTempSpaceAllocator(&alloc);
-    if (!status.IsOK())
-      return status;
-
-    std::iota(std::begin(permutation), std::end(permutation), 0);
-
-    // swap the innermost dim with the dim corresponding to axis
-    permutation[axis] = rank - 1;
-    permutation[rank - 1] = axis;
-
-    transposed_input_dims.reserve(rank);
-    for (auto e : permutation) {
-      transposed_input_dims.push_back(X_shape[e]);
-    }
-
-    // Allocate a temporary tensor to hold transposed input
-    Tensor temp_input(X->DataType(), TensorShape(transposed_input_dims), alloc);
-
-    // Perform the transpose
-    ORT_RETURN_IF_ERROR(TransposeBase::DoTranspose(permutation, *X, temp_input));
-    transposed_input = std::move(temp_input);
-
-    // Allocate memory for the intermediate output
-    Tensor temp_output(Y->DataType(), TensorShape(transposed_input_dims), alloc);
-    intermediate_output = std::move(temp_output);
-  }
+  // Treat the input as [N, D, S] where D is the extent of the hardmax. For opset-13 the hardmax is computed
+  // along the "axis" dim only, which is handled in place as a strided middle dim instead of transposing the
+  // "axis" dim to the innermost dim. For earlier opsets the input is coerced to 2-D, so S is 1.
+  const size_t N = X_shape.SizeToDimension(axis);
+  const size_t D = opset_ >= 13 ? static_cast<size_t>(X_shape[axis]) : X_shape.SizeFromDimension(axis);
+  const size_t S = opset_ >= 13 ? X_shape.SizeFromDimension(axis + 1) : 1;
 
-  size_t tmp_N = is_transpose_required ? TensorShape(transposed_input_dims).SizeToDimension(rank - 1) : X_shape.SizeToDimension(axis);
-  size_t tmp_D = is_transpose_required ? TensorShape(transposed_input_dims).SizeFromDimension(rank - 1) : X_shape.SizeFromDimension(axis);
+  const float* X_data = X->template Data<float>();
+  float* Y_data = Y->template MutableData<float>();
 
-  // Math::RowwiseMax expects int N and D.
-  if (tmp_N * tmp_D > INT32_MAX || tmp_N > INT32_MAX || tmp_D > INT32_MAX) {
-    std::ostringstream ss;
-    ss << "Hardmax inputs N, D and N * D must be < " << INT32_MAX << ". N=" << tmp_N << ", D=" << tmp_D;
-    std::string msg = ss.str();
-
-    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, msg);
-  }
-
-  const int N = gsl::narrow_cast<int>(tmp_N);
-  const int D = gsl::narrow_cast<int>(tmp_D);
-
-  std::vector<float> rowmax_(N);
-  float* rowmax_data = rowmax_.data();
-
-  const float* X_data = nullptr;
-  float* Y_data = nullptr;
-
-  if (is_transpose_required) {  // use intermediate buffers to compute the hardmax values
-    X_data = transposed_input.template Data<float>();
-    Y_data = intermediate_output.template MutableData<float>();
-  } else {  // use the node input/output directly
-    X_data = X->template Data<float>();
-    Y_data = Y->template MutableData<float>();
-  }
-
-  math::RowwiseMax<float, CPUMathUtil>(N, D, X_data, rowmax_data, nullptr);
-
-  // Even if we had to transpose the input, it is safe to go with X_shape.Size() which computes
-  // the size of the buffer from the original input's shape as even if we do transpose, the size
-  // of the transposed buffer will be the same as the original input's buffer
   math::Set<float, CPUMathUtil>(X_shape.Size(), 0.f, Y_data, &CPUMathUtil::Instance());
 
-  for (int i = 0; i < N; ++i) {
-    for (int j = 0; j < D; ++j) {
-      if (X_data[i * D + j] == rowmax_data[i]) {
-        Y_data[i * D + j] = 1;
-        break;
+  // Track the maximum and the index of its first occurrence for each of the S columns, scanning the D rows
+  // in order so that the inner loop runs over contiguous memory.
+  std::vector<float> colmax(S);
+  std::vector<size_t> colargmax(S);
+
+  for (size_t n = 0; n < N; ++n) {
+    const float* x = X_data + n * D * S;
+    float* y = Y_data + n * D * S;
+
+    std::copy_n(x, S, colmax.begin());
+    std::fill(colargmax.begin(), colargmax.end(), size_t{0});
+
+    for (size_t d = 1; d < D; ++d) {
+      const float* row = x + d * S;
+      for (size_t s = 0; s < S; ++s) {
+        if (row[s] > colmax[s]) {
+          colmax[s] = row[s];
+          colargmax[s] = d;
+        }
       }
     }
-  }
 
-  if (is_transpose_required) {
-    std::vector<size_t> reverse_permutation(rank);
-    for (size_t i = 0, end = permutation.size(); i < end; ++i) {
-      reverse_permutation[permutation[i]] = i;
+    for (size_t s = 0; s < S; ++s) {
+      y[colargmax[s] * S + s] = 1;
     }
-    // Perform the transpose to get the axes back to the original ordering
-    ORT_RETURN_IF_ERROR(TransposeBase::DoTranspose(reverse_permutation, intermediate_output, *Y));
   }
 
   return Status::OK();
@@ -2,9 +2,6 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/softmax.h"
-#include "core/providers/cpu/tensor/transpose.h"
-#include <vector>
-#include <numeric>
 
 namespace onnxruntime {
 
@@ -122,73 +119,20 @@ Status Softmax<T>::ComputeImpl(const Tensor& input, Tensor& output, size_t axis,
 // opset-13 and above
 template <typename T>
 Status Softmax<T>::ComputeImplOpset13(const Tensor& input, Tensor& output, size_t axis,
-                                      concurrency::ThreadPool* thread_pool, OpKernelContext* ctx) const {
+                                      concurrency::ThreadPool* thread_pool) const {
   const auto& X_shape = input.Shape();
-  size_t rank = X_shape.NumDimensions();
-
-  bool is_transpose_required = false;
-  Tensor transposed_input;
-  std::vector<int64_t> transposed_input_dims;
-  Tensor intermediate_output;  // output that the softmax implementation will write into while using transposed input
-  std::vector<size_t> permutation(rank);
 
   // The "semantic" meaning of axis has changed in opset-13.
   // Please compare: https://github.com/onnx/onnx/blob/master/docs/Operators.md#Softmax
   // with https://github.com/onnx/onnx/blob/master/docs/Changelog.md#Softmax-11 for detailed explanations
-  // To account for the opset-13 behavior, our plan will be to transpose the "axis" dim to the innermost dim
-  // and perform softmax and then reverse the transpose. We can skip the transposing aspect if the axis is already
-  // the innermost dim
-  if (axis != (rank - 1)) {
-    is_transpose_required = true;
-  }
-
-  if (is_transpose_required) {
-    AllocatorPtr alloc;
-    auto status = ctx->GetTempSpaceAllocator(&alloc);
-    if (!status.IsOK())
-      return status;
-
-    std::iota(std::begin(permutation), std::end(permutation), 0);
-
-    // swap the innermost dim with the dim corresponding to axis
-    permutation[axis] = rank - 1;
-    permutation[rank - 1] = axis;
-
-    transposed_input_dims.reserve(rank);
-    for (auto e : permutation) {
-      transposed_input_dims.push_back(X_shape[e]);
-    }
-
-    // Allocate a temporary tensor to hold transposed input
-    Tensor temp_input(input.DataType(), TensorShape(transposed_input_dims), alloc);
-
-    // Perform the transpose
-    ORT_RETURN_IF_ERROR(TransposeBase::DoTranspose(permutation, input, temp_input));
-    transposed_input = std::move(temp_input);
-
-    // Allocate memory for the intermediate output
-    Tensor temp_output(output.DataType(), TensorShape(transposed_input_dims), alloc);
-    intermediate_output = std::move(temp_output);
-  }
-
-  const size_t N = is_transpose_required ? TensorShape(transposed_input_dims).SizeToDimension(rank - 1) : X_shape.SizeToDimension(rank - 1);
-  const size_t D = is_transpose_required ? TensorShape(transposed_input_dims).SizeFromDimension(rank - 1) : X_shape.SizeFromDimension(rank - 1);
-
-  ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(N, D,
-                                    is_transpose_required ? transposed_input.template Data<T>() : input.template Data<T>(),
-                                    is_transpose_required ? intermediate_output.template MutableData<T>() : output.template MutableData<T>(),
-                                    log_softmax_, thread_pool));
-
-  if (is_transpose_required) {
-    std::vector<size_t> reverse_permutation(rank);
-    for (size_t i = 0, end = permutation.size(); i < end; ++i) {
-      reverse_permutation[permutation[i]] = i;
-    }
-    // Perform the transpose to get the axes back to the original ordering
-    ORT_RETURN_IF_ERROR(TransposeBase::DoTranspose(reverse_permutation, intermediate_output, output));
-  }
+  // The softmax is computed along the "axis" dim only. Treat the input as [N, D, S] and compute the softmax
+  // along the strided middle dim directly instead of transposing the "axis" dim to the innermost dim.
+  const size_t N = X_shape.SizeToDimension(axis);
+  const size_t D = static_cast<size_t>(X_shape[axis]);
+  const size_t S = X_shape.SizeFromDimension(axis + 1);
 
-  return Status::OK();
+  return SoftmaxCPU<T>(N, D, S, input.template Data<T>(), output.template MutableData<T>(), log_softmax_,
+                       thread_pool);
 }
 
 // compute method of Softmax
@@ -210,7 +154,7 @@ Status Softmax<T>::Compute(OpKernelContext* ctx) const {
   if (opset_ < 13) {
     return ComputeImpl(*X, *Y, axis, thread_pool);
   } else {
-    return ComputeImplOpset13(*X, *Y, axis, thread_pool, ctx);
+    return ComputeImplOpset13(*X, *Y, axis, thread_pool);
   }
 }
 
@@ -41,7 +41,7 @@ class Softmax final : public OpKernel {
                      concurrency::ThreadPool* thread_pool) const;
 
   Status ComputeImplOpset13(const Tensor& input, Tensor& output, size_t axis,
-                            concurrency::ThreadPool* thread_pool, OpKernelContext* ctx) const;
+                            concurrency::ThreadPool* thread_pool) const;
 
   int axis_;
   int opset_;
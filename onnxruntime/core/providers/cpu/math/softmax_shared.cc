@@ -100,4 +100,84 @@ common::Status SoftmaxCPU<float>(size_t N,
   return Status::OK();
 }
 
+template <typename T>
+common::Status SoftmaxCPU(size_t N,
+                          size_t D,
+                          size_t S,
+                          const T* Xdata,
+                          T* Ydata,
+                          bool logarithmic,
+                          onnxruntime::concurrency::ThreadPool* thread_pool) {
+  if (S == 1) {
+    return SoftmaxCPU<T>(N, D, Xdata, Ydata, logarithmic, thread_pool);
+  }
+
+  // The elements along the softmax axis are S elements apart, so process the S columns of each
+  // outer element together one row at a time. The inner loops run over contiguous memory.
+  std::vector<T> colmax(S);
+  std::vector<T> scale(S);
+
+  for (size_t n = 0; n < N; ++n) {
+    const T* x = Xdata + n * D * S;
+    T* y = Ydata + n * D * S;
+
+    std::copy_n(x, S, colmax.begin());
+    for (size_t d = 1; d < D; ++d) {
+      for (size_t s = 0; s < S; ++s) {
+        colmax[s] = std::max(colmax[s], x[d * S + s]);
+      }
+    }
+
+    std::fill(scale.begin(), scale.end(), T(0));
+    for (size_t d = 0; d < D; ++d) {
+      for (size_t s = 0; s < S; ++s) {
+        T e = std::exp(x[d * S + s] - colmax[s]);
+        scale[s] += e;
+        if (!logarithmic) {
+          y[d * S + s] = e;
+        }
+      }
+    }
+
+    if (!logarithmic) {
+      for (size_t d = 0; d < D; ++d) {
+        for (size_t s = 0; s < S; ++s) {
+          y[d * S + s] /= scale[s];
+        }
+      }
+    } else {
+      for (size_t s = 0; s < S; ++s) {
+        scale[s] = std::log(std::fmax(scale[s], 1e-20f));
+      }
+      for (size_t d = 0; d < D; ++d) {
+        for (size_t s = 0; s < S; ++s) {
+          y[d * S + s] = x[d * S + s] - colmax[s] - scale[s];
+        }
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+template common::Status SoftmaxCPU<double>(size_t N,
+                                           size_t D,
+                                           size_t S,
+                                           const double* Xdata,
+                                           double* Ydata,
+                                           bool logarithmic,
+                                           onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template <>
+common::Status SoftmaxCPU<float>(size_t N,
+                                 size_t D,
+                                 size_t S,
+                                 const float* Xdata,
+                                 float* Ydata,
+                                 bool logarithmic,
+                                 onnxruntime::concurrency::ThreadPool* thread_pool) {
+  MlasComputeSoftmaxStrided(Xdata, Ydata, N, D, S, logarithmic, thread_pool);
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -20,4 +20,17 @@ Calculate Softmax using CPU memory.
 template <typename T>
 common::Status SoftmaxCPU(size_t N, size_t D, const T* Xdata, T* Ydata,
                           bool logarithmic, concurrency::ThreadPool* thread_pool);
+
+/**
+Calculate Softmax along the middle dimension of a tensor with shape [N, D, S] using CPU memory.
+@param N Number of outer elements
+@param D Number of elements along the softmax axis
+@param S Number of elements between consecutive elements along the softmax axis
+@param Xdata Source data
+@param Ydata Output data
+@param logarithmic If true, compute LogSoftmax. If false compute Softmax.
+*/
+template <typename T>
+common::Status SoftmaxCPU(size_t N, size_t D, size_t S, const T* Xdata, T* Ydata,
+                          bool logarithmic, concurrency::ThreadPool* thread_pool);
 }  // namespace onnxruntime
@@ -117,6 +117,48 @@ static void HeapifyIthPosition(int64_t* heap, size_t i, size_t k, const HeapCmp&
   }
 }
 
+// Inserts the elements [begin, end) of a contiguous row into the heap of the top k indices.
+// Most elements of a long row do not replace the current k-th value at the top of the heap, so the elements are
+// first compared against it in fixed size blocks with a branch free loop that the compiler vectorizes, and only
+// the blocks containing a replacement are processed element by element.
+template <class Comparator>
+static void HeapInsertContiguous(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                                 int64_t begin, int64_t end, int64_t* heap, size_t k) {
+  constexpr int64_t kBlockSize = 32;
+
+  // save top so we only have one load in the CompareValueOnly call
+  auto top = input_data[heap[0]];
+
+  auto insert_range = [&](int64_t range_begin, int64_t range_end) {
+    for (int64_t l = range_begin; l < range_end; ++l) {
+      // we can compare value only. if the current value is equal to the top of the heap it won't
+      // replace it as the index will be higher.
+      if (comparer.CompareValueOnly(input_data[l], top)) {
+        heap[0] = l;
+        HeapifyIthPosition(heap, 0, k, comparer);
+        top = input_data[heap[0]];
+      }
+    }
+  };
+
+  int64_t block_start = begin;
+
+  for (; block_start + kBlockSize <= end; block_start += kBlockSize) {
+    const auto* block = input_data + block_start;
+
+    int replaces_top = 0;
+    for (int64_t l = 0; l < kBlockSize; ++l) {
+      replaces_top |= static_cast<int>(comparer.CompareValueOnly(block[l], top));
+    }
+
+    if (replaces_top != 0) {
+      insert_range(block_start, block_start + kBlockSize);
+    }
+  }
+
+  insert_range(block_start, end);
+}
+
 // Static helpers that implement the core logic for each of the 'TopK' operator flavor
 
 // Selects the top k elements (largest or smallest based on template parameter)
@@ -173,6 +215,49 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   int64_t threads_needed = static_cast<int64_t>(std::floor(input_shape.Size() * k / (128 * 1024)));
   num_threads = std::max(std::min(threads_needed, num_threads), static_cast<int64_t>(1));
 
+  // A few long rows along the innermost axis, such as the logits of a large vocabulary, cannot be split across the
+  // threads by rows. Instead split each row into chunks of columns, select the top k of each chunk in parallel,
+  // and then select the top k of the candidates of all the chunks. The comparer orders equal values by their
+  // index in the input, so the result is the same as selecting from the whole row.
+  if (block_slice == 1 && rows < tp_threads) {
+    constexpr int64_t kMinColumnsPerChunk = 8 * 1024;
+    const int64_t num_chunks = std::min(tp_threads, num_blocks / std::max(static_cast<int64_t>(4 * k),
+                                                                          kMinColumnsPerChunk));
+    if (num_chunks > 1) {
+      Comparator comparer(input_data);
+      std::vector<int64_t> candidates(num_chunks * k);
+
+      for (int64_t i = 0; i < rows; ++i) {
+        const auto row_offset = i * cols;
+
+        concurrency::ThreadPool::TrySimpleParallelFor(threadpool, num_chunks, [&](std::ptrdiff_t chunk) {
+          auto work = concurrency::ThreadPool::PartitionWork(chunk, num_chunks, num_blocks);
+          int64_t* heap = candidates.data() + chunk * k;
+
+          // add first k items starting from the bottom up, then insert the remainder of the chunk
+          for (unsigned l = 0; l < k; ++l) {
+            heap[k - l - 1] = row_offset + work.start + l;
+            HeapifyIthPosition(heap, k - l - 1, k, comparer);
+          }
+          HeapInsertContiguous(comparer, input_data, row_offset + work.start + k, row_offset + work.end, heap, k);
+        });
+
+        nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end(), comparer);
+        if (sorted) {
+          std::sort(candidates.begin(), candidates.begin() + k, comparer);
+        }
+
+        for (int64_t l = 0; l < k; ++l) {
+          int64_t idx = candidates[l];
+          values_map(i, l) = input_data[idx];
+          indices_map(i, l) = idx - row_offset;
+        }
+      }
+
+      return;
+    }
+  }
+
   // from testing various batch sizes relative to k, the following appears to work well as a selector.
   // tested with following combinations
   //   batch_size = [ 8, 16, 32, 64, 128, 256, 512, 1024, 2048 ]
@@ -242,18 +327,22 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
               }
 
               // insert remainder if the next value would replace the top of the heap (current worst top k value)
-              // save top so we only have one load in the CompareValueOnly call
-              auto top = input_data[indices[0]];
-              for (; l < num_blocks; ++l) {
-                // we can compare value only. if the current value is equal to the top of the heap it won't
-                // replace it as the index will be higher.
-                if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
-                  indices[0] = cur_idx;
-                  HeapifyIthPosition(indices, 0, k, comparer);
-                  top = input_data[indices[0]];
+              if (block_slice == 1) {
+                HeapInsertContiguous(comparer, input_data, cur_idx, row_offset + num_blocks, indices, k);
+              } else {
+                // save top so we only have one load in the CompareValueOnly call
+                auto top = input_data[indices[0]];
+                for (; l < num_blocks; ++l) {
+                  // we can compare value only. if the current value is equal to the top of the heap it won't
+                  // replace it as the index will be higher.
+                  if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
+                    indices[0] = cur_idx;
+                    HeapifyIthPosition(indices, 0, k, comparer);
+                    top = input_data[indices[0]];
+                  }
+
+                  cur_idx += block_slice;
                 }
-
-                cur_idx += block_slice;
               }
 
               if (sorted) {
@@ -32,35 +32,32 @@ Status LabelEncoder::Compute(OpKernelContext* context) const {
     if (!Y.IsDataType<int64_t>())
       return Status(ONNXRUNTIME, FAIL, "Input of tensor(string) must have output of tensor(int64)");
 
-    auto input = gsl::make_span(X.template Data<std::string>(), shape.Size());
     auto output = gsl::make_span(Y.template MutableData<int64_t>(), shape.Size());
     auto out = output.begin();
 
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
+    // map isn't going to change so get end() once instead of calling inside the loop
     const auto map_end = string_to_int_map_.end();
 
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const std::string& value) {
-                    auto map_to = string_to_int_map_.find(value);
-                    *out = map_to == map_end ? default_int_ : map_to->second;
-                    ++out;
-                  });
+    for (size_t i = 0, end = static_cast<size_t>(shape.Size()); i < end; ++i) {
+      auto map_to = string_to_int_map_.find(X.StringAt(i));
+      *out = map_to == map_end ? default_int_ : map_to->second;
+      ++out;
+    }
   } else {
     if (!Y.IsDataTypeString())
       return Status(ONNXRUNTIME, FAIL, "Input of tensor(int64) must have output of tensor(string)");
 
     auto input = gsl::make_span(X.template Data<int64_t>(), shape.Size());
-    auto output = gsl::make_span(Y.template MutableData<std::string>(), shape.Size());
-    auto out = output.begin();
+    StringTensorBuilder output(static_cast<size_t>(input.size()));
 
     const auto map_end = int_to_string_map_.end();
 
     std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const int64_t& value) {
+                  [&output, &map_end, this](const int64_t& value) {
                     auto map_to = int_to_string_map_.find(value);
-                    *out = map_to == map_end ? default_string_ : map_to->second;
-                    ++out;
+                    output.Append(map_to == map_end ? default_string_ : map_to->second);
                   });
+    output.Build(Y);
   }
 
   return Status::OK();
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "core/common/common.h"
+#include "core/common/string_view.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/string_tensor_builder.h"
 #include "core/providers/cpu/ml/ml_common.h"
 
 namespace onnxruntime {
@@ -13,20 +17,18 @@ namespace ml {
 class LabelEncoder final : public OpKernel {
  public:
   LabelEncoder(const OpKernelInfo& info) : OpKernel(info) {
-    std::vector<std::string> string_classes;
-
-    ORT_ENFORCE(info.GetAttrs<std::string>("classes_strings", string_classes).IsOK());
+    ORT_ENFORCE(info.GetAttrs<std::string>("classes_strings", string_classes_).IsOK());
 
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_classes.size();
+    auto num_entries = string_classes_.size();
 
     string_to_int_map_.reserve(num_entries);
     int_to_string_map_.reserve(num_entries);
 
     for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
+      const std::string& str = string_classes_[i];
 
       string_to_int_map_[str] = i;
       int_to_string_map_[i] = str;
@@ -36,13 +38,61 @@ class LabelEncoder final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
+  // the keys of string_to_int_map_ point into string_classes_, so the input strings are looked up without a copy
+  std::vector<std::string> string_classes_;
+  std::unordered_map<StringView, int64_t, StringViewHash> string_to_int_map_;
   std::unordered_map<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
   int64_t default_int_;
 };
 
+// Reads the elements of the input of LabelEncoder_2. Strings are read as views, so the std::string elements of an
+// input that stores its strings contiguously aren't created.
+template <typename T>
+class LabelEncoderInput {
+ public:
+  explicit LabelEncoderInput(const Tensor& X) : data_(X.Data<T>()) {}
+  T operator[](size_t i) const { return data_[i]; }
+
+ private:
+  const T* data_;
+};
+
+template <>
+class LabelEncoderInput<std::string> {
+ public:
+  explicit LabelEncoderInput(const Tensor& X) : X_(X) {}
+  StringView operator[](size_t i) const { return X_.StringAt(i); }
+
+ private:
+  const Tensor& X_;
+};
+
+// Writes the elements of the output of LabelEncoder_2. Strings are collected in one buffer.
+template <typename T>
+class LabelEncoderOutput {
+ public:
+  explicit LabelEncoderOutput(Tensor& Y) : data_(Y.MutableData<T>()) {}
+  void Append(const T& value) { *data_++ = value; }
+  void Finish() {}
+
+ private:
+  T* data_;
+};
+
+template <>
+class LabelEncoderOutput<std::string> {
+ public:
+  explicit LabelEncoderOutput(Tensor& Y) : Y_(Y), output_(static_cast<size_t>(Y.Shape().Size())) {}
+  void Append(const std::string& value) { output_.Append(value); }
+  void Finish() { output_.Build(Y_); }
+
+ private:
+  Tensor& Y_;
+  StringTensorBuilder output_;
+};
+
 template <typename TKey, typename TValue>
 class LabelEncoder_2 final : public OpKernel {
  public:
@@ -64,8 +114,9 @@ class LabelEncoder_2 final : public OpKernel {
                 "However, the number of key is ", num_keys, " and the number of ",
                 "values is ", num_values, ".");
 
+    _keys = std::move(keys);
     for (size_t i = 0; i < num_keys; ++i)
-      _map[keys[i]] = values[i];
+      _map[_keys[i]] = values[i];
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -75,16 +126,17 @@ class LabelEncoder_2 final : public OpKernel {
     const TensorShape& shape = X.Shape();
     Tensor& Y = *context->Output(0, shape);
 
-    auto input = X.template DataAsSpan<TKey>();
-    auto output = Y.template MutableDataAsSpan<TValue>();
+    LabelEncoderInput<TKey> input(X);
+    LabelEncoderOutput<TValue> output(Y);
 
     for (int64_t i = 0; i < shape.Size(); ++i) {
       const auto found = _map.find(input[i]);
       if (found == _map.end())
-        output[i] = _default_value;
+        output.Append(_default_value);
       else
-        output[i] = found->second;
+        output.Append(found->second);
     }
+    output.Finish();
 
     return Status::OK();
   }
@@ -95,10 +147,16 @@ class LabelEncoder_2 final : public OpKernel {
   // for other types can be found in ONNX spec.
   void InitializeSomeFields(const OpKernelInfo& info);
 
+  // String keys are looked up as views of the input, pointing into _keys.
+  using MapKey = typename std::conditional<std::is_same<TKey, std::string>::value, StringView, TKey>::type;
+  using MapHash = typename std::conditional<std::is_same<TKey, std::string>::value, StringViewHash,
+                                            std::hash<TKey>>::type;
+
+  std::vector<TKey> _keys;
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If _map doesn't contain "a_key", we use _default_value as its output.
-  std::unordered_map<TKey, TValue> _map;
+  std::unordered_map<MapKey, TValue, MapHash> _map;
   TValue _default_value;
   // ONNX attribute name to load keys.
   std::string _key_field_name;
@@ -18,6 +18,7 @@
 #include "core/providers/cpu/nn/conv.h"
 
 #include "core/common/safeint.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -151,7 +152,302 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // Only the channels last path consumes a reordered weight matrix.
+  if (!channels_last_ || input_idx != 1) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape().GetDims();
+  size_t rank = shape.size();
+  if (rank <= 2) {
+    return Status::OK();
+  }
+
+  // Note: The tensor has already been allocated with this tensor shape, so all
+  // shape indices are guaranteed to fit inside size_t.
+  const size_t output_channels = static_cast<size_t>(shape[0]);
+  const size_t group_input_channels = static_cast<size_t>(shape[1]);
+  const size_t kernel_size =
+      static_cast<size_t>(std::accumulate(shape.data() + 2, shape.data() + rank, 1LL, std::multiplies<int64_t>()));
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+
+  auto* reordered_W = static_cast<float*>(alloc->Alloc(SafeInt<size_t>(sizeof(float)) * output_channels * group_input_channels * kernel_size));
+  reordered_W_buffer_ = BufferUniquePtr(reordered_W, BufferDeleter(alloc));
+
+  ReorderFilter(tensor.Data<float>(), reordered_W, output_channels, group_input_channels, kernel_size);
+
+  W_shape_ = shape;
+  is_packed = true;
+  return Status::OK();
+}
+
+Status Conv<float>::ComputeChannelsLast(OpKernelContext* context) const {
+  size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const auto* X = context->Input<Tensor>(0);
+  const Tensor* W = reordered_W_buffer_ ? nullptr : context->Input<Tensor>(1);
+  const auto& W_shape = reordered_W_buffer_ ? W_shape_ : W->Shape();
+  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+  const int64_t N = X->Shape()[0];
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape, true));
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
+
+  const size_t kernel_rank = kernel_shape.size();
+
+  std::vector<int64_t> pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_rank * 2, 0);
+  }
+  std::vector<int64_t> dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_rank, 1);
+  }
+  std::vector<int64_t> strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_rank, 1);
+  }
+
+  const int64_t C = X->Shape()[1 + kernel_rank];
+
+  std::vector<int64_t> Y_dims({N});
+  TensorShape input_shape = X->Shape().Slice(1, 1 + kernel_rank);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
+  Y_dims.push_back(M);
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(1, 1 + kernel_rank);
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // Handle the case of a dynamic weight filter.
+  BufferUniquePtr reordered_W_buffer;
+  const float* reordered_W;
+  if (reordered_W_buffer_) {
+    reordered_W = static_cast<const float*>(reordered_W_buffer_.get());
+  } else {
+    // Weight tensor was not constant or prepacking is disabled.
+    auto* W_data = static_cast<float*>(alloc->Alloc(SafeInt<size_t>(sizeof(float)) * W_shape.Size()));
+    reordered_W_buffer = BufferUniquePtr(W_data, BufferDeleter(alloc));
+    ReorderFilter(W->Data<float>(),
+                  W_data,
+                  static_cast<size_t>(M),
+                  static_cast<size_t>(W_shape[1]),
+                  static_cast<size_t>(kernel_size));
+    reordered_W = W_data;
+  }
+
+  int64_t group_count = conv_attrs_.group;
+  int64_t group_input_channels = W_shape[1];
+  int64_t group_output_channels = M / group_count;
+
+  // Test for depthwise convolution.
+  const bool is_depthwise_conv = (group_input_channels == 1 && group_output_channels == 1);
+  if (is_depthwise_conv) {
+    // Update the input and output channels to the number of groups in order to
+    // reuse as much of the below standard convolution path.
+    group_input_channels = group_count;
+    group_output_channels = group_count;
+    group_count = 1;
+  }
+
+  const int64_t X_offset = C * input_image_size;
+  const int64_t Y_offset = M * output_image_size;
+  const int64_t kernel_dim = group_input_channels * kernel_size;
+  const int64_t col_buffer_size = kernel_dim * output_image_size;
+
+  const auto* Xdata = X->template Data<float>();
+  const auto* Bdata = B != nullptr ? B->template Data<float>() : nullptr;
+  auto* Ydata = Y->template MutableData<float>();
+
+  BufferUniquePtr col_buffer;
+
+  // Pointwise convolutions over a single group can use the original input
+  // tensor in place, otherwise a temporary buffer is required for the im2col
+  // transform.
+  if (kernel_size != 1 || group_count != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+    int64_t group_col_buffer_size = (kernel_rank > 2) ? group_count * col_buffer_size : col_buffer_size;
+    auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * group_col_buffer_size);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
+  }
+
+  // Follow the same heuristic as QLinearConv to control the number of worker
+  // threads used for the convolution.
+  constexpr int32_t maximum_thread_count = 16;
+  constexpr double thread_complexity = static_cast<double>(64 * 1024);
+
+  const double complexity = static_cast<double>(output_image_size) *
+                            static_cast<double>(group_output_channels) *
+                            static_cast<double>(kernel_dim);
+
+  int32_t thread_count = maximum_thread_count;
+  if (complexity < thread_complexity * maximum_thread_count) {
+    thread_count = static_cast<int32_t>(complexity / thread_complexity) + 1;
+  }
+  if (thread_count > output_image_size) {
+    // Ensure that every thread produces at least one output.
+    thread_count = static_cast<int32_t>(output_image_size);
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  thread_count = std::min(thread_count, concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    if (col_buffer && kernel_rank > 2) {
+      // Threaded implementation of ND convolution is not yet supported, so
+      // prepare all im2col transformations here.
+      for (int64_t group_id = 0; group_id < group_count; ++group_id) {
+        math::Im2col<float, StorageOrder::NHWC>()(
+            Xdata + group_id * group_input_channels,
+            group_input_channels,
+            C,
+            input_shape.GetDims().data(),
+            output_shape.GetDims().data(),
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int64_t>(kernel_rank),
+            static_cast<float*>(col_buffer.get()) + group_id * col_buffer_size);
+      }
+    }
+
+    auto conv_worker = [&](ptrdiff_t batch) {
+      auto work = concurrency::ThreadPool::PartitionWork(batch, thread_count, static_cast<ptrdiff_t>(output_image_size));
+      int64_t output_start = static_cast<int64_t>(work.start);
+      int64_t output_count = static_cast<int64_t>(work.end - work.start);
+
+      auto* worker_output = Ydata + output_start * M;
+
+      if (!is_depthwise_conv) {
+        // Seed the output with the bias so that the GEMM can accumulate into it.
+        for (int64_t i = 0; i < output_count; i++) {
+          if (Bdata != nullptr) {
+            std::copy_n(Bdata, static_cast<size_t>(M), worker_output + i * M);
+          } else {
+            std::fill_n(worker_output + i * M, static_cast<size_t>(M), 0.0f);
+          }
+        }
+      }
+
+      for (int64_t group_id = 0; group_id < group_count; ++group_id) {
+        // Prepare the im2col transformation or use the input buffer directly for
+        // pointwise convolutions.
+        const float* worker_gemm_input;
+        if (col_buffer) {
+          auto* worker_col_buffer = static_cast<float*>(col_buffer.get()) + output_start * kernel_dim;
+          if (kernel_rank == 2) {
+            math::Im2col<float, StorageOrder::NHWC>()(
+                Xdata + group_id * group_input_channels,
+                group_input_channels,
+                C,
+                input_shape[0],
+                input_shape[1],
+                kernel_shape[0],
+                kernel_shape[1],
+                dilations[0],
+                dilations[1],
+                pads[0],
+                pads[1],
+                strides[0],
+                strides[1],
+                output_shape[1],
+                output_start,
+                output_count,
+                worker_col_buffer);
+          } else if (kernel_rank == 1) {
+            math::Im2col<float, StorageOrder::NHWC>()(
+                Xdata + group_id * group_input_channels,
+                group_input_channels,
+                C,
+                1,
+                input_shape[0],
+                1,
+                kernel_shape[0],
+                1,
+                dilations[0],
+                0,
+                pads[0],
+                1,
+                strides[0],
+                output_shape[0],
+                output_start,
+                output_count,
+                worker_col_buffer);
+          } else {
+            // Use the im2col buffer prepared outside the thread, indexed by group.
+            worker_col_buffer += group_id * col_buffer_size;
+          }
+          worker_gemm_input = worker_col_buffer;
+        } else {
+          worker_gemm_input = Xdata + output_start * kernel_dim;
+        }
+
+        if (is_depthwise_conv) {
+          MlasConvDepthwise(worker_gemm_input,
+                            reordered_W,
+                            Bdata,
+                            worker_output,
+                            static_cast<size_t>(M),
+                            static_cast<size_t>(output_count),
+                            static_cast<size_t>(kernel_size),
+                            &activation_);
+        } else {
+          MlasGemm(CblasNoTrans,
+                   CblasNoTrans,
+                   static_cast<size_t>(output_count),
+                   static_cast<size_t>(group_output_channels),
+                   static_cast<size_t>(kernel_dim),
+                   1.0f,
+                   worker_gemm_input,
+                   static_cast<size_t>(kernel_dim),
+                   reordered_W + group_id * group_output_channels,
+                   static_cast<size_t>(M),
+                   1.0f,
+                   worker_output + group_id * group_output_channels,
+                   static_cast<size_t>(M),
+                   nullptr);
+        }
+      }
+
+      if (!is_depthwise_conv) {
+        MlasActivation(&activation_,
+                       worker_output,
+                       nullptr,
+                       static_cast<size_t>(output_count),
+                       static_cast<size_t>(M),
+                       static_cast<size_t>(M));
+      }
+    };
+
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, thread_count, conv_worker);
+
+    Xdata += X_offset;
+    Ydata += Y_offset;
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
+  if (channels_last_) {
+    return ComputeChannelsLast(context);
+  }
+
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const auto* X = context->Input<Tensor>(0);
   const auto* W = context->Input<Tensor>(1);
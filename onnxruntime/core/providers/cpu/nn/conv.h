@@ -26,14 +26,40 @@ class Conv<float> : public OpKernel {
  public:
   Conv<float>(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    channels_last_ = (info.GetAttrOrDefault<int64_t>("channels_last", static_cast<int64_t>(0)) != 0);
   }
 
   Status Compute(OpKernelContext* context) const override;
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  Status ComputeChannelsLast(OpKernelContext* context) const;
+
+  // Reorders the filter from OIHW to HWIO so that the kernel dimension of the
+  // channels last image expansion maps directly to rows of the filter matrix.
+  static void ReorderFilter(const float* input,
+                            float* output,
+                            size_t output_channels,
+                            size_t input_channels,
+                            size_t kernel_size) {
+    for (size_t k = 0; k < kernel_size; k++) {
+      for (size_t ic = 0; ic < input_channels; ic++) {
+        for (size_t oc = 0; oc < output_channels; oc++) {
+          size_t index = (oc * input_channels * kernel_size) + (ic * kernel_size) + k;
+          *output++ = input[index];
+        }
+      }
+    }
+  }
+
+  bool channels_last_;
+  TensorShape W_shape_;
+  BufferUniquePtr reordered_W_buffer_;
 };
 
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "string_normalizer.h"
 #include "core/common/common.h"
+#include "core/framework/string_tensor_builder.h"
 #include "core/framework/tensor.h"
 
 #ifdef _MSC_VER
@@ -11,8 +12,7 @@
 #elif defined(__APPLE__) or defined(__ANDROID__)
 #include <codecvt>
 #else
-#include <limits>
-#include <iconv.h>
+#include "core/common/utf8_util.h"
 #endif  // _MSC_VER
 
 #include <locale>
@@ -115,73 +115,76 @@ using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
 #else
 
 // All others (Linux)
+// wchar_t holds UTF-32 code points on these platforms, so UTF-8 is decoded and encoded directly without a
+// conversion descriptor or temporary buffer per string.
 class Utf8Converter {
  public:
   Utf8Converter(const std::string&, const std::wstring&) {}
 
-  std::wstring from_bytes(const std::string& s) const {
+  // the same signature as std::wstring_convert::from_bytes for a range of chars
+  std::wstring from_bytes(const char* first, const char* last) const {
     std::wstring result;
-    if (s.empty()) {
-      return result;
-    }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("WCHAR_T", "UTF-8");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return wconv_error;
-    }
+    result.reserve(last - first);
+
+    const auto* in = reinterpret_cast<const unsigned char*>(first);
+    const auto* const end = reinterpret_cast<const unsigned char*>(last);
+    while (in != end) {
+      // utf8_bytes treats every 0xF_ byte as a 4 byte lead, but leads past 0xF4 are not valid UTF-8
+      size_t bytes = 0;
+      if (*in > 0xF4 || !utf8_util::utf8_bytes(*in, bytes) || static_cast<size_t>(end - in) < bytes) {
+        return wconv_error;
+      }
 
-    char* iconv_in = const_cast<char*>(s.c_str());
-    size_t iconv_in_bytes = s.length();
-    // Temporary buffer assumes 1 byte to 1 wchar_t
-    // to make sure it is enough.
-    const size_t buffer_len = iconv_in_bytes * sizeof(wchar_t);
-    auto buffer = onnxruntime::make_unique<char[]>(buffer_len);
-    char* iconv_out = buffer.get();
-    size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
-    if (static_cast<size_t>(-1) == ret) {
-      result = wconv_error;
-    } else {
-      size_t converted_bytes = buffer_len - iconv_out_bytes;
-      assert((converted_bytes % sizeof(wchar_t)) == 0);
-      result.assign(reinterpret_cast<const wchar_t*>(buffer.get()), converted_bytes / sizeof(wchar_t));
+      // leading byte payload, then 6 bits from each continuation byte
+      static const unsigned char leading_masks[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+      static const uint32_t min_code_points[] = {0, 0, 0x80, 0x800, 0x10000};
+      uint32_t code_point = *in & leading_masks[bytes];
+      for (size_t i = 1; i < bytes; ++i) {
+        if ((in[i] & 0xC0) != 0x80) {
+          return wconv_error;
+        }
+        code_point = (code_point << 6) | (in[i] & 0x3F);
+      }
+
+      // reject overlong encodings, surrogates and values past the last code point
+      if (code_point < min_code_points[bytes] || (code_point >= 0xD800 && code_point <= 0xDFFF) ||
+          code_point > 0x10FFFF) {
+        return wconv_error;
+      }
+
+      result.push_back(static_cast<wchar_t>(code_point));
+      in += bytes;
     }
-    iconv_close(icvt);
     return result;
   }
 
   std::string to_bytes(const std::wstring& wstr) const {
     std::string result;
-    if (wstr.empty()) {
-      return result;
-    }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("UTF-8", "WCHAR_T");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return conv_error;
-    }
-
-    // I hope this does not modify the incoming buffer
-    wchar_t* non_const_in = const_cast<wchar_t*>(wstr.c_str());
-    char* iconv_in = reinterpret_cast<char*>(non_const_in);
-    size_t iconv_in_bytes = wstr.length() * sizeof(wchar_t);
-    // Temp buffer, assume every code point converts into 3 bytes, this should be enough
-    // We do not convert terminating zeros
-    const size_t buffer_len = wstr.length() * 3;
-    auto buffer = onnxruntime::make_unique<char[]>(buffer_len);
-
-    char* iconv_out = buffer.get();
-    size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
-    if (static_cast<size_t>(-1) == ret) {
-      result = conv_error;
-    } else {
-      size_t converted_len = buffer_len - iconv_out_bytes;
-      result.assign(buffer.get(), converted_len);
+    result.reserve(wstr.length());
+
+    for (wchar_t ch : wstr) {
+      auto code_point = static_cast<uint32_t>(ch);
+      if (code_point < 0x80) {
+        result.push_back(static_cast<char>(code_point));
+      } else if (code_point < 0x800) {
+        result.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else if (code_point < 0x10000) {
+        if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+          return conv_error;
+        }
+        result.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else if (code_point <= 0x10FFFF) {
+        result.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else {
+        return conv_error;
+      }
     }
-    iconv_close(icvt);
     return result;
   }
 };
@@ -192,6 +195,10 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS
 
 #endif  // MS_VER
 
+std::wstring FromBytes(Utf8Converter& converter, StringView s) {
+  return converter.from_bytes(s.data(), s.data() + s.size());
+}
+
 template <class ForwardIter>
 Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
                       const Locale& loc,
@@ -216,28 +223,25 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
 
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-  size_t output_idx = 0;
+  StringTensorBuilder output(C);
   while (first != end) {
-    auto& s = *first;
+    const StringView s = *first;
     if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
+      std::wstring wstr = FromBytes(converter, s);
       if (wstr == wconv_error) {
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
+                      "Input contains invalid utf8 chars at: " + s.ToString());
       }
       // In place transform
       loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
+      output.Append(converter.to_bytes(wstr));
     } else {
       assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+      output.Append(s);
     }
-    ++output_idx;
     ++first;
   }
+  output.Build(*output_tensor);
   return Status::OK();
 }
 }  // namespace string_normalizer
@@ -272,17 +276,19 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
   }
 
   locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  locale_ = onnxruntime::make_unique<Locale>(locale_name_);
+  const Locale& locale = *locale_;
   Utf8Converter converter(conv_error, wconv_error);
 
-  std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
-  for (const auto& sw : swords) {
+  // the views in stopwords_ point into swords_, which isn't modified after this
+  swords_ = info.GetAttrsOrDefault<std::string>("stopwords");
+  for (const auto& sw : swords_) {
     ORT_ENFORCE(!sw.empty(), "Empty stopwords not allowed");
     if (is_case_sensitive_) {
       auto p = stopwords_.insert(sw);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
+      std::wstring wstr = FromBytes(converter, sw);
       ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
       locale.ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(wstr);
@@ -291,6 +297,9 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
   }
 }
 
+// defined here where Locale is a complete type
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -319,67 +328,65 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   }
 
   Status status;
-  Locale locale(locale_name_);
+  const Locale& locale = *locale_;
   Utf8Converter converter(conv_error, wconv_error);
-  auto const input_data = X->template Data<std::string>();
-  using StrRef = std::reference_wrapper<const std::string>;
+  // views of the input strings, which may be stored contiguously
+  std::vector<StringView> input_data;
+  input_data.reserve(C);
+  for (size_t i = 0; i < C; ++i) {
+    input_data.push_back(X->StringAt(i));
+  }
   if (is_case_sensitive_) {
     if (!stopwords_.empty()) {
-      std::vector<StrRef> filtered_strings;
+      std::vector<StringView> filtered_strings;
       filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
+      for (const StringView s : input_data) {
         if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
+          filtered_strings.push_back(s);
         }
-        ++first;
       }
       status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
                               N, filtered_strings.size(), case_change_action_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data.cbegin(), input_data.cend(), ctx, locale, converter, N, C,
+                              case_change_action_);
     }
   } else {
     if (!wstopwords_.empty()) {
       // Filter input. When no case action is required
       // we simply store original string references.
       // Otherwise, we store converted strings.
-      std::vector<StrRef> filtered_orignal_strings;
+      std::vector<StringView> filtered_orignal_strings;
       std::vector<std::string> filtered_cased_strings;
       filtered_orignal_strings.reserve(C);
       filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
+      for (const StringView s : input_data) {
+        std::wstring wstr = FromBytes(converter, s);
         if (wstr == wconv_error) {
           return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
+                        "Input contains invalid utf8 chars at: " + s.ToString());
         }
         locale.ChangeCase(compare_caseaction_, wstr);
         if (0 == wstopwords_.count(wstr)) {
           if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
+            filtered_orignal_strings.push_back(s);
           } else {
             filtered_cased_strings.push_back(converter.to_bytes(wstr));
           }
         }
-        ++first;
       }
       if (case_change_action_ == NONE) {
         status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
                                 N, filtered_orignal_strings.size(), NONE);
       } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
+        status = CopyCaseAction(filtered_cased_strings.cbegin(), filtered_cased_strings.cend(), ctx, locale, converter,
                                 N, filtered_cased_strings.size(), NONE);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data.cbegin(), input_data.cend(), ctx, locale, converter, N, C,
+                              case_change_action_);
     }
   }
   return status;
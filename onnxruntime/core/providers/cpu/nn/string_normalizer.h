@@ -3,13 +3,19 @@
 
 #pragma once
 
+#include "core/common/string_view.h"
 #include "core/framework/op_kernel.h"
 
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace onnxruntime {
+namespace string_normalizer {
+class Locale;
+}  // namespace string_normalizer
 
 class StringNormalizer : public OpKernel {
  public:
@@ -20,7 +26,7 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() override = default;
+  ~StringNormalizer() override;
 
   Status Compute(OpKernelContext* ctx) const override;
 
@@ -29,8 +35,11 @@ class StringNormalizer : public OpKernel {
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
   std::string locale_name_;
+  // constructing a locale is expensive so it is created once and shared by all Compute calls
+  std::unique_ptr<string_normalizer::Locale> locale_;
+  std::vector<std::string> swords_;
   // Either if these are populated but not both
-  std::unordered_set<std::string> stopwords_;
+  std::unordered_set<StringView, StringViewHash> stopwords_;
   std::unordered_set<std::wstring> wstopwords_;
 };
 
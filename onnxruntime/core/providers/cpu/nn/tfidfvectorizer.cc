@@ -3,11 +3,12 @@
 
 #include "tfidfvectorizer.h"
 #include "core/common/common.h"
+#include "core/common/string_view.h"
 #include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
-#include <unordered_map>
 
 namespace onnxruntime {
 
@@ -23,61 +24,158 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
+// NgramIndex implements a Trie like structure over int64 tokens
+// stored in a single open addressing hash table.
+// Every trie node has a dense id, the root is 0, and an edge (parent, token)
+// maps to the child node.
+// for a unigram (1) it would insert the edge (root, 1) and give the child a valid output index.
+// for (1,2,3) node (1,2) would be created but have no output index
+// because (1,2) does not exists. Node (1,2,3) would have a valid one.
+// Lookups probe adjacent slots and nodes are never allocated individually.
+class NgramIndex {
+ public:
+  // The root is never a child, so it marks both an empty slot and a miss
+  static constexpr uint32_t kNoNode = 0;
+  static constexpr int64_t kNoOutput = -1;
+
+  // max_edges is the upper bound of Insert() calls, the table is not resized after this.
+  void Reserve(size_t max_edges) {
+    size_t capacity = 16;
+    while (capacity < max_edges * 2) {
+      capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot());
+    mask_ = capacity - 1;
+    outputs_.assign(1, int64_t{kNoOutput});
+  }
+
+  bool empty() const { return outputs_.size() <= 1; }
 
-template <>
-struct NgramPart<int64_t>;
+  uint32_t Find(uint32_t parent, int64_t token) const {
+    for (size_t i = Hash(parent, token) & mask_;; i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      if (slot.child == kNoNode) {
+        return kNoNode;
+      }
+      if (slot.token == token && slot.parent == parent) {
+        return slot.child;
+      }
+    }
+  }
 
-template <>
-struct NgramPart<std::string>;
+  // Returns the child of parent for token, creating it if it does not exist.
+  uint32_t Insert(uint32_t parent, int64_t token) {
+    size_t i = Hash(parent, token) & mask_;
+    for (; slots_[i].child != kNoNode; i = (i + 1) & mask_) {
+      if (slots_[i].token == token && slots_[i].parent == parent) {
+        return slots_[i].child;
+      }
+    }
+    ORT_ENFORCE(outputs_.size() * 2 <= slots_.size(), "n-gram index capacity exceeded");
+    Slot& slot = slots_[i];
+    slot.token = token;
+    slot.parent = parent;
+    slot.child = static_cast<uint32_t>(outputs_.size());
+    outputs_.push_back(int64_t{kNoOutput});
+    return slot.child;
+  }
 
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
+  // Index in the output row of the n-gram that ends at node, kNoOutput if it is only a prefix.
+  int64_t OutputIndex(uint32_t node) const { return outputs_[node]; }
+  int64_t& OutputIndex(uint32_t node) { return outputs_[node]; }
 
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = std::unordered_map<int64_t, std::unique_ptr<NgramPartInt>>;
+ private:
+  struct Slot {
+    int64_t token = 0;
+    uint32_t parent = 0;
+    uint32_t child = kNoNode;
+  };
 
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
+  static size_t Hash(uint32_t parent, int64_t token) {
+    uint64_t h = static_cast<uint64_t>(token) * 0x9E3779B97F4A7C15ULL + parent;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 32;
+    return static_cast<size_t>(h);
+  }
 
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  std::vector<int64_t> outputs_;
 };
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+// Maps pool_strings entries to dense token ids so that every input string
+// is hashed once and then matched against NgramIndex like an integer.
+// Input strings are looked up as views, so string tensors stored contiguously are read in place.
+class StringVocabulary {
+ public:
+  static constexpr int64_t kUnknown = -1;
+
+  void Reserve(size_t max_strings) {
+    size_t capacity = 16;
+    while (capacity < max_strings * 2) {
+      capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot());
+    mask_ = capacity - 1;
+    strings_.reserve(max_strings);
+  }
+
+  // The string must outlive this object, pool_strings attribute entries do.
+  int64_t Insert(StringView str) {
+    const size_t hash = hasher_(str);
+    size_t i = hash & mask_;
+    for (; slots_[i].token != kUnknown; i = (i + 1) & mask_) {
+      if (slots_[i].hash == hash && strings_[slots_[i].token] == str) {
+        return slots_[i].token;
+      }
+    }
+    ORT_ENFORCE((strings_.size() + 1) * 2 <= slots_.size(), "string vocabulary capacity exceeded");
+    slots_[i].hash = hash;
+    slots_[i].token = static_cast<int64_t>(strings_.size());
+    strings_.push_back(str);
+    return slots_[i].token;
+  }
+
+  int64_t Find(StringView str) const {
+    const size_t hash = hasher_(str);
+    for (size_t i = hash & mask_;; i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      if (slot.token == kUnknown) {
+        return kUnknown;
+      }
+      if (slot.hash == hash && strings_[slot.token] == str) {
+        return slot.token;
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    size_t hash = 0;
+    int64_t token = kUnknown;
+  };
+
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  std::vector<StringView> strings_;
+  StringViewHash hasher_;
 };
 
 // Returns next ngram_id
-template <class K, class ForwardIter, class Map>
+template <class ForwardIter, class ToToken>
 inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
+                            gsl::span<const int64_t> ngram_indexes, ToToken to_token, NgramIndex& index) {
   for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, onnxruntime::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
+    uint32_t node = 0;
+    for (size_t n = 0; n < ngram_size; ++n, ++first) {
+      node = index.Insert(node, to_token(*first));
     }
+    ORT_ENFORCE(ngram_id < ngram_indexes.size(), "ngram_indexes has no entry for ngram id: ", ngram_id);
+    ORT_ENFORCE(index.OutputIndex(node) == NgramIndex::kNoOutput,
+                "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+    index.OutputIndex(node) = ngram_indexes[ngram_id];
+    ++ngram_id;
   }
   return ngram_id;
 }
@@ -89,10 +187,6 @@ using namespace onnxruntime::ngram_details;
 
 namespace onnxruntime {
 
-inline const void* AdvanceElementPtr(const void* p, size_t elements, size_t element_size) {
-  return reinterpret_cast<const uint8_t*>(p) + elements * element_size;
-}
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -127,11 +221,11 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float>   weights_;
 
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // Trie of the n-grams of the loaded sizes, over pool_int64s values
+  // or over vocabulary_ ids of pool_strings
+  NgramIndex index_;
+  StringVocabulary vocabulary_;
+  bool pool_strings_ = false;
 
   size_t output_size_ = 0;
 
@@ -140,14 +234,24 @@ struct TfIdfVectorizer::Impl {
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
-  void IncrementCount(size_t ngram_id, size_t row_num,
-                      std::vector<uint32_t>& frequencies) const {
-    assert(ngram_id != 0);
-    --ngram_id;
-    assert(ngram_id < ngram_indexes_.size());
-    auto output_idx = row_num * output_size_ + ngram_indexes_[ngram_id];
-    assert(static_cast<size_t>(output_idx) < frequencies.size());
-    ++frequencies[output_idx];
+  // Returns the tokens of the row as int64. int64 input is used in place,
+  // other types are converted into buffer.
+  const int64_t* GetRowTokens(const Tensor& X, size_t row_num, size_t row_size,
+                              std::vector<int64_t>& buffer) const {
+    const size_t offset = row_num * row_size;
+    if (X.IsDataType<int64_t>()) {
+      return X.Data<int64_t>() + offset;
+    }
+    buffer.resize(row_size);
+    if (X.IsDataTypeString()) {
+      for (size_t i = 0; i < row_size; ++i) {
+        buffer[i] = vocabulary_.Find(X.StringAt(offset + i));
+      }
+    } else {
+      const int32_t* row = X.Data<int32_t>() + offset;
+      std::copy(row, row + row_size, buffer.begin());
+    }
+    return buffer.data();
   }
 };
 
@@ -219,7 +323,17 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
   const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
-  size_t ngram_id = 1;  // start with 1, 0 - means no n-gram
+  impl_->pool_strings_ = !pool_strings.empty();
+  // Every pool item adds at most one trie edge
+  impl_->index_.Reserve(total_items);
+  if (impl_->pool_strings_) {
+    impl_->vocabulary_.Reserve(total_items);
+  }
+  auto& vocabulary = impl_->vocabulary_;
+  auto string_token = [&vocabulary](const std::string& str) { return vocabulary.Insert(str); };
+  auto int64_token = [](int64_t val) { return val; };
+
+  size_t ngram_id = 0;
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = impl_->min_gram_length_;
   const size_t max_gram_length = impl_->max_gram_length_;
@@ -234,12 +348,14 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       ORT_ENFORCE((items % ngram_size == 0),
                   "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
       auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
+      // Skip loading into the index ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
+          ngram_id = PopulateGrams(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id,
+                                   impl_->ngram_indexes_, int64_token, impl_->index_);
         } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
+          ngram_id = PopulateGrams(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id,
+                                   impl_->ngram_indexes_, string_token, impl_->index_);
         }
       } else {
         ngram_id += ngrams;
@@ -310,68 +426,36 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
   }
 }
 
-void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
-                                  std::vector<uint32_t>& frequencies) const {
-  auto X = ctx->Input<Tensor>(0);
-  const auto elem_size = X->DataType()->Size();
-
-  const void* const row_begin = AdvanceElementPtr(X->DataRaw(), row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
-
+void TfIdfVectorizer::ComputeImpl(const int64_t* row, size_t row_size, uint32_t* frequencies) const {
   const auto& impl = *impl_;
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
+  const auto& index = impl.index_;
+  const size_t max_gram_length = impl.max_gram_length_;
+  const size_t max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
+  size_t start_ngram_size = impl.min_gram_length_;
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
-
-    while (ngram_start < ngram_row_end) {
+  for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+    for (size_t ngram_start = 0; ngram_start < row_size; ++ngram_start) {
       // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, skip_distance * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
+      if (ngram_start + skip_distance * (start_ngram_size - 1) >= row_size) {
         break;
       }
 
-      auto ngram_item = ngram_start;
-      if (X->IsDataTypeString()) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          str_map = &hit->second->leafs_;
+      uint32_t node = 0;
+      for (size_t ngram_size = 1, pos = ngram_start;
+           ngram_size <= max_gram_length && pos < row_size;
+           ++ngram_size, pos += skip_distance) {
+        node = index.Find(node, row[pos]);
+        if (node == NgramIndex::kNoNode) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (X->IsDataType<int32_t>()) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
+        if (ngram_size >= start_ngram_size) {
+          const int64_t output_idx = index.OutputIndex(node);
+          if (output_idx != NgramIndex::kNoOutput) {
+            assert(static_cast<size_t>(output_idx) < impl.output_size_);
+            ++frequencies[output_idx];
           }
-          int_map = &hit->second->leafs_;
         }
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -416,9 +500,7 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   std::vector<uint32_t> frequencies;
   frequencies.resize(num_rows * impl_->output_size_, 0);
 
-  if (total_items == 0 ||
-      (X->IsDataTypeString() && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+  if (total_items == 0 || impl_->index_.empty() || X->IsDataTypeString() != impl_->pool_strings_) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -428,11 +510,18 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  std::function<void(ptrdiff_t)> fn = [this, ctx, C, &frequencies](ptrdiff_t row_num) {
-    ComputeImpl(ctx, row_num, C, frequencies);
-  };
-
-  concurrency::ThreadPool::TryBatchParallelFor(ctx->GetOperatorThreadPool(), num_rows, std::move(fn), 0);
+  // Rows are independent and each one only updates its own slice of frequencies
+  const double cost = static_cast<double>(C) * static_cast<double>(impl_->max_skip_count_ + 1) *
+                      static_cast<double>(impl_->max_gram_length_);
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), num_rows, cost,
+      [this, X, C, &frequencies](ptrdiff_t first, ptrdiff_t last) {
+        std::vector<int64_t> buffer;
+        for (ptrdiff_t row_num = first; row_num < last; ++row_num) {
+          const int64_t* row = impl_->GetRowTokens(*X, row_num, C, buffer);
+          ComputeImpl(row, C, frequencies.data() + row_num * impl_->output_size_);
+        }
+      });
 
   OutputResult(ctx, B, frequencies);
 
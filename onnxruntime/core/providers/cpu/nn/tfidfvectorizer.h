@@ -20,8 +20,8 @@ class TfIdfVectorizer final : public OpKernel {
 
  private:
 
-  void ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
-                     std::vector<uint32_t>& frequencies) const;
+  // Counts the n-grams of one row of tokens into its frequencies
+  void ComputeImpl(const int64_t* row, size_t row_size, uint32_t* frequencies) const;
 
   // Apply weighing criteria and output
   void OutputResult(OpKernelContext* ctx, size_t b_dim, const std::vector<uint32_t>& frequences) const;
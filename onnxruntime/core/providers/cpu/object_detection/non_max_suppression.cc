@@ -13,8 +13,11 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <vector>
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -111,6 +114,91 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+// Box coordinates stored as a structure of arrays, so that the IOU of a candidate box against many other boxes
+// can be computed with a branch free loop that the compiler vectorizes.
+struct BoxArrays {
+  explicit BoxArrays(size_t capacity)
+      : y_min_(capacity), x_min_(capacity), y_max_(capacity), x_max_(capacity), area_(capacity) {}
+
+  void Set(size_t i, int64_t center_point_box, const float* box) {
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], x_min_[i], x_max_[i]);
+      MaxMin(box[0], box[2], y_min_[i], y_max_[i]);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      float box_width_half = box[2] / 2;
+      float box_height_half = box[3] / 2;
+      x_min_[i] = box[0] - box_width_half;
+      x_max_[i] = box[0] + box_width_half;
+      y_min_[i] = box[1] - box_height_half;
+      y_max_[i] = box[1] + box_height_half;
+    }
+    area_[i] = (y_max_[i] - y_min_[i]) * (x_max_[i] - x_min_[i]);
+  }
+
+  void Copy(size_t i, const BoxArrays& src, size_t src_i) {
+    y_min_[i] = src.y_min_[src_i];
+    x_min_[i] = src.x_min_[src_i];
+    y_max_[i] = src.y_max_[src_i];
+    x_max_[i] = src.x_max_[src_i];
+    area_[i] = src.area_[src_i];
+  }
+
+  std::vector<float> y_min_;
+  std::vector<float> x_min_;
+  std::vector<float> y_max_;
+  std::vector<float> x_max_;
+  std::vector<float> area_;
+};
+
+// Returns true if box 'i' of 'boxes' overlaps any of the first 'count' boxes of 'selected' by more than the
+// IOU threshold. The selected boxes are checked in blocks so that the search can stop early once a block
+// suppresses the box, while the loop inside each block has no branches.
+bool SuppressByIOU(const BoxArrays& boxes, size_t i, const BoxArrays& selected, size_t count, float iou_threshold) {
+  constexpr size_t kBlockSize = 16;
+
+  const float y_min = boxes.y_min_[i];
+  const float x_min = boxes.x_min_[i];
+  const float y_max = boxes.y_max_[i];
+  const float x_max = boxes.x_max_[i];
+  const float area = boxes.area_[i];
+
+  const float* selected_y_min = selected.y_min_.data();
+  const float* selected_x_min = selected.x_min_.data();
+  const float* selected_y_max = selected.y_max_.data();
+  const float* selected_x_max = selected.x_max_.data();
+  const float* selected_area = selected.area_.data();
+
+  for (size_t start = 0; start < count; start += kBlockSize) {
+    const size_t end = std::min(count, start + kBlockSize);
+    int suppressed = 0;
+
+    for (size_t j = start; j < end; ++j) {
+      const float intersection_x_min = std::max(x_min, selected_x_min[j]);
+      const float intersection_y_min = std::max(y_min, selected_y_min[j]);
+      const float intersection_x_max = std::min(x_max, selected_x_max[j]);
+      const float intersection_y_max = std::min(y_max, selected_y_max[j]);
+
+      const float intersection_area = std::max(intersection_x_max - intersection_x_min, .0f) *
+                                      std::max(intersection_y_max - intersection_y_min, .0f);
+      const float union_area = area + selected_area[j] - intersection_area;
+      suppressed |= static_cast<int>(intersection_area > .0f) &
+                    static_cast<int>(intersection_area / union_area > iou_threshold);
+    }
+
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   auto ret = PrepareCompute(ctx, pc);
@@ -131,108 +219,102 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
 
-  struct BoxInfo {
-    float score_{};
-    int64_t index_{};
-    float box_[4]{};
-    float area_{};
-
-    BoxInfo() = default;
-    explicit BoxInfo(float score, int64_t idx, int64_t center_point_box, const float* box) : score_(score), index_(idx) {
-      if (0 == center_point_box) {
-        // boxes data format [y1, x1, y2, x2],
-        MaxMin(box[1], box[3], box_[1], box_[3]);
-        MaxMin(box[0], box[2], box_[0], box_[2]);
-      } else {
-        // boxes data format [x_center, y_center, width, height]
-        float box_width_half = box[2] / 2;
-        float box_height_half = box[3] / 2;
-        box_[1] = box[0] - box_width_half;
-        box_[3] = box[0] + box_width_half;
-        box_[0] = box[1] - box_height_half;
-        box_[2] = box[1] + box_height_half;
-      }
-      area_ = (box_[2] - box_[0]) * (box_[3] - box_[1]);
-    }
-
-    inline bool operator<(const BoxInfo& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
-    }
-
-    inline bool SuppressByIOU(const BoxInfo& rhs, float iou_threshold) const {
-      const float intersection_x_min = std::max(box_[1], rhs.box_[1]);
-      const float intersection_y_min = std::max(box_[0], rhs.box_[0]);
-      const float intersection_x_max = std::min(box_[3], rhs.box_[3]);
-      const float intersection_y_max = std::min(box_[2], rhs.box_[2]);
+  const auto center_point_box = GetCenterPointBox();
+  const auto num_boxes = static_cast<size_t>(pc.num_boxes_);
+  const auto max_selected = static_cast<size_t>(std::min(max_output_boxes_per_class, pc.num_boxes_));
 
-      const float intersection_area = std::max(intersection_x_max - intersection_x_min, .0f) *
-                                      std::max(intersection_y_max - intersection_y_min, .0f);
-      if (intersection_area <= .0f) {
-        return false;
-      }
-      const float union_area = area_ + rhs.area_ - intersection_area;
-      const float intersection_over_union = intersection_area / union_area;
-      return intersection_over_union > iou_threshold;
+  // The boxes are shared by all the classes of a batch, so normalize their coordinates once per batch.
+  std::vector<BoxArrays> batch_boxes;
+  batch_boxes.reserve(static_cast<size_t>(pc.num_batches_));
+  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
+    batch_boxes.emplace_back(num_boxes);
+    const float* boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
+    for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+      batch_boxes.back().Set(box_index, center_point_box, boxes + (box_index * 4));
     }
-  };
+  }
 
-  const auto center_point_box = GetCenterPointBox();
+  // Each (batch, class) pair is independent, so run them in parallel and merge the selected box indices in
+  // (batch, class) order afterwards.
+  const auto num_tasks = static_cast<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<int64_t>> selected_per_task(static_cast<size_t>(num_tasks));
 
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfo> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min(max_output_boxes_per_class, pc.num_boxes_));
+  auto select_boxes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<std::pair<float, int64_t>> candidates;
+    candidates.reserve(num_boxes);
+    BoxArrays selected_boxes(max_selected);
 
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfo> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t batch_index = task / pc.num_classes_;
+      const auto& boxes = batch_boxes[static_cast<size_t>(batch_index)];
+      auto& selected_indices = selected_per_task[static_cast<size_t>(task)];
 
       // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
+      const auto* class_scores = scores_data + task * pc.num_boxes_;
+      candidates.clear();
       if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index, center_point_box, batch_boxes + (box_index * 4));
+        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+          if (class_scores[box_index] > score_threshold) {
+            candidates.emplace_back(class_scores[box_index], box_index);
           }
         }
       } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index, center_point_box, batch_boxes + (box_index * 4));
+        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+          candidates.emplace_back(class_scores[box_index], box_index);
         }
       }
-      std::priority_queue<BoxInfo, std::vector<BoxInfo>> sorted_boxes(std::less<BoxInfo>(), std::move(candidate_boxes));
 
-      selected_boxes_inside_class.clear();
+      // Order the candidates by descending score, breaking ties by ascending box index. Usually only a few of
+      // the candidates are visited before enough boxes are selected, so build a heap of the candidates in
+      // linear time and extract the boxes on demand instead of sorting all the candidates.
+      const auto lower_priority = [](const std::pair<float, int64_t>& lhs, const std::pair<float, int64_t>& rhs) {
+        return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second > rhs.second);
+      };
+      std::make_heap(candidates.begin(), candidates.end(), lower_priority);
+
       // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfo& next_top_score = sorted_boxes.top();
+      size_t num_selected = 0;
+      for (auto heap_end = candidates.end(); heap_end != candidates.begin() && num_selected < max_selected; --heap_end) {
+        std::pop_heap(candidates.begin(), heap_end, lower_priority);
+        const auto& candidate = *(heap_end - 1);
+
+        const auto box_index = static_cast<size_t>(candidate.second);
 
-        bool selected = true;
         // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (next_top_score.SuppressByIOU(selected_index, iou_threshold)) {
-            selected = false;
-            break;
-          }
+        if (!SuppressByIOU(boxes, box_index, selected_boxes, num_selected, iou_threshold)) {
+          selected_boxes.Copy(num_selected++, boxes, box_index);
+          selected_indices.push_back(candidate.second);
         }
+      }
+    }
+  };
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-        sorted_boxes.pop();
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+  // The cost of a task is dominated by the filtering and ordering of the candidate boxes.
+  const double cost_per_task = static_cast<double>(num_boxes) * (std::log2(static_cast<double>(num_boxes) + 1) + 8);
+  concurrency::ThreadPool::TryParallelFor(ctx->GetOperatorThreadPool(), num_tasks,
+                                          TensorOpCost{static_cast<double>(num_boxes * sizeof(float)),
+                                                       static_cast<double>(num_boxes * sizeof(int64_t)),
+                                                       cost_per_task},
+                                          select_boxes);
+
+  size_t num_selected = 0;
+  for (const auto& selected_indices : selected_per_task) {
+    num_selected += selected_indices.size();
+  }
 
   const auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+
+  for (std::ptrdiff_t task = 0; task < num_tasks; ++task) {
+    const int64_t batch_index = task / pc.num_classes_;
+    const int64_t class_index = task % pc.num_classes_;
+    for (const auto box_index : selected_per_task[static_cast<size_t>(task)]) {
+      *output_data++ = SelectedIndex(batch_index, class_index, box_index);
+    }
+  }
 
   return Status::OK();
 }
@@ -340,6 +340,95 @@ void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
   }
 }
 
+FastReduceKind OptimizeShapeForFastReduce(const std::vector<int64_t>& input_shape,
+                                          const std::vector<int64_t>& reduced_axes,
+                                          std::vector<int64_t>& fast_shape) {
+  fast_shape.clear();
+
+  std::vector<bool> reduced(input_shape.size(), false);
+  for (auto a : reduced_axes) {
+    reduced[a] = true;
+  }
+
+  // Merges the adjacent dimensions with the same status, starting with a kept segment so
+  // that fast_shape alternates between kept and reduced sizes.
+  std::vector<bool> segment_reduced;
+  for (size_t i = 0; i < input_shape.size(); ++i) {
+    if (input_shape[i] == 0) {
+      return FastReduceKind::kNone;
+    }
+    if (input_shape[i] == 1) {
+      continue;
+    }
+    if (!segment_reduced.empty() && segment_reduced.back() == reduced[i]) {
+      fast_shape.back() *= input_shape[i];
+    } else {
+      segment_reduced.push_back(reduced[i]);
+      fast_shape.push_back(input_shape[i]);
+    }
+  }
+
+  if (fast_shape.empty()) {
+    fast_shape.push_back(1);
+    return FastReduceKind::kK;
+  }
+
+  if (fast_shape.size() == 1) {
+    return segment_reduced[0] ? FastReduceKind::kR : FastReduceKind::kK;
+  }
+
+  if (fast_shape.size() == 2) {
+    return segment_reduced[0] ? FastReduceKind::kRK : FastReduceKind::kKR;
+  }
+
+  if (fast_shape.size() == 3 && !segment_reduced[0]) {
+    return FastReduceKind::kKRK;
+  }
+
+  return FastReduceKind::kNone;
+}
+
+// Reduces each of the K contiguous rows of R elements with the aggregator's whole row implementation.
+template <typename T, typename AGG>
+void FastReduceKR(const T* from_data, int64_t K, int64_t R, typename AGG::value_type* to_data,
+                  concurrency::ThreadPool* tp) {
+  auto fn = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t k = first; k < last; ++k) {
+      const T* row = from_data + k * R;
+      to_data[k] = AGG(R, row[0]).aggall(row);
+    }
+  };
+
+  auto cost = TensorOpCost{static_cast<double>(R * sizeof(T)),
+                           static_cast<double>(sizeof(typename AGG::value_type)),
+                           static_cast<double>(R * 2)};
+  concurrency::ThreadPool::TryParallelFor(tp, K, cost, fn);
+}
+
+// Reduces the middle axis of a [K0, R, K1] block. The K1 columns are split into blocks so that
+// each task reduces whole rows of a block, which keeps the accumulated outputs in the cache.
+template <typename T, typename AGG>
+void FastReduceKRK(const T* from_data, int64_t K0, int64_t R, int64_t K1, typename AGG::value_type* to_data,
+                   concurrency::ThreadPool* tp) {
+  constexpr int64_t block_size = 256;
+  const int64_t block_count = (K1 + block_size - 1) / block_size;
+
+  auto fn = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t index = first; index < last; ++index) {
+      const int64_t k0 = index / block_count;
+      const int64_t k1 = (index % block_count) * block_size;
+      const int64_t count = std::min(block_size, K1 - k1);
+      AGG::aggall_rk(from_data + k0 * R * K1 + k1, R, K1, count, to_data + k0 * K1 + k1);
+    }
+  };
+
+  const int64_t elements_per_task = R * std::min(block_size, K1);
+  auto cost = TensorOpCost{static_cast<double>(elements_per_task * sizeof(T)),
+                           static_cast<double>(std::min(block_size, K1) * sizeof(typename AGG::value_type)),
+                           static_cast<double>(elements_per_task * 2)};
+  concurrency::ThreadPool::TryParallelFor(tp, K0 * block_count, cost, fn);
+}
+
 template <typename T, typename AGG>
 void NoTransposeReduce(Tensor* output, const TensorShape& new_input_shape, const Tensor& input,
                        const std::vector<int64_t>& reduced_axes, concurrency::ThreadPool* tp,
@@ -356,6 +445,36 @@ void NoTransposeReduce(Tensor* output, const TensorShape& new_input_shape, const
     return;
   }
 
+  // Use the specialized implementations when the reduction can be expressed as one of the
+  // KR, RK, or KRK forms. The output shape is not needed, so the same implementation serves
+  // both keepdims settings.
+  std::vector<int64_t> fast_shape;
+  switch (OptimizeShapeForFastReduce(new_input_shape.GetDims(), reduced_axes, fast_shape)) {
+    case FastReduceKind::kK:
+      FastReduceKR<T, AGG>(from_data, count, 1, to_data, tp);
+      return;
+    case FastReduceKind::kR:
+      to_data[0] = AGG(fast_shape[0], from_data[0]).aggall(from_data);
+      return;
+    case FastReduceKind::kKR:
+      FastReduceKR<T, AGG>(from_data, fast_shape[0], fast_shape[1], to_data, tp);
+      return;
+    case FastReduceKind::kRK:
+      if (AGG::fast_rk()) {
+        FastReduceKRK<T, AGG>(from_data, 1, fast_shape[0], fast_shape[1], to_data, tp);
+        return;
+      }
+      break;
+    case FastReduceKind::kKRK:
+      if (AGG::fast_rk()) {
+        FastReduceKRK<T, AGG>(from_data, fast_shape[0], fast_shape[1], fast_shape[2], to_data, tp);
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+
   if (!last_results.equal(new_input_shape.GetDims(), reduced_axes)) {
     NoTransposePrepareForReduce(new_input_shape, reduced_axes, last_results);
     if (last_results.last_loop_red_size == 0 || last_results.last_loop_size == 0)
@@ -9,6 +9,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/containers.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include <cmath>
 
@@ -94,6 +95,80 @@ inline bool reduce_isnan<int32_t>(int32_t) { return false; }
 template <>
 inline bool reduce_isnan<int64_t>(int64_t) { return false; }
 
+// Returns the maximum of the finite values of a strided sequence, or zero if there are none. This is the
+// offset subtracted by the LogSumExp reduction before exponentiating the values.
+template <typename T>
+inline T reduce_finite_max(const T* from_data, int64_t N, int64_t inc) {
+  T max_value = 0;
+  bool found = false;
+  for (int64_t i = 0; i < N; ++i, from_data += inc) {
+    const T v = *from_data;
+    if (!reduce_isinf(v) && !reduce_isnan(v) && (!found || v > max_value)) {
+      max_value = v;
+      found = true;
+    }
+  }
+  return max_value;
+}
+
+// Adds exp(from_data[i] - max_values[i]) to to_data[i] for i in [0, N).
+template <typename T>
+inline void reduce_accumulate_exp(const T* from_data, const T* max_values, int64_t N, T* to_data) {
+  for (int64_t i = 0; i < N; ++i) {
+    to_data[i] += reduce_exp<T>(from_data[i] - max_values[i]);
+  }
+}
+
+// The float versions stage blocks of the shifted values through a local buffer to use the vectorized
+// MLAS exponential.
+constexpr int64_t kReduceExpBlockSize = 256;
+
+template <>
+inline void reduce_accumulate_exp<float>(const float* from_data, const float* max_values, int64_t N, float* to_data) {
+  float buffer[kReduceExpBlockSize];
+  for (int64_t i = 0; i < N; i += kReduceExpBlockSize) {
+    const int64_t count = std::min(kReduceExpBlockSize, N - i);
+    EigenVectorArrayMap<float>(buffer, count) =
+        ConstEigenVectorArrayMap<float>(from_data + i, count) - ConstEigenVectorArrayMap<float>(max_values + i, count);
+    MlasComputeExp(buffer, buffer, static_cast<size_t>(count));
+    EigenVectorArrayMap<float>(to_data + i, count) += ConstEigenVectorArrayMap<float>(buffer, count);
+  }
+}
+
+template <>
+inline void reduce_accumulate_exp<double>(const double* from_data, const double* max_values, int64_t N, double* to_data) {
+  EigenVectorArrayMap<double>(to_data, N) +=
+      (ConstEigenVectorArrayMap<double>(from_data, N) - ConstEigenVectorArrayMap<double>(max_values, N)).exp();
+}
+
+// Returns the sum of exp(from_data[i] - max_value) for i in [0, N).
+template <typename T>
+inline T reduce_sum_exp(const T* from_data, int64_t N, T max_value) {
+  T sum = 0;
+  for (int64_t i = 0; i < N; ++i) {
+    sum += reduce_exp<T>(from_data[i] - max_value);
+  }
+  return sum;
+}
+
+template <>
+inline float reduce_sum_exp<float>(const float* from_data, int64_t N, float max_value) {
+  float buffer[kReduceExpBlockSize];
+  float sum = 0;
+  for (int64_t i = 0; i < N; i += kReduceExpBlockSize) {
+    const int64_t count = std::min(kReduceExpBlockSize, N - i);
+    EigenVectorArrayMap<float>(buffer, count) = ConstEigenVectorArrayMap<float>(from_data + i, count) - max_value;
+    MlasComputeExp(buffer, buffer, static_cast<size_t>(count));
+    sum += ConstEigenVectorArrayMap<float>(buffer, count).sum();
+  }
+  return sum;
+}
+
+template <>
+inline double reduce_sum_exp<double>(const double* from_data, int64_t N, double max_value) {
+  return (ConstEigenVectorArrayMap<double>(from_data, N) - max_value).exp().sum();
+}
+
 template <typename T, typename TVAL = T>
 class ReduceAggregator {
  public:
@@ -114,6 +189,11 @@ class ReduceAggregator {
   inline TVAL get_value() { return accumulator_; }
   inline void enforce(const ResultsNoTransposePrepareForReduce&) {}
   static inline bool two_loops() { return false; }
+
+  // Aggregators returning true reduce the leading axis of a [R, K] block with whole row operations,
+  // see aggall_rk. The rows are separated by ld elements.
+  static inline bool fast_rk() { return false; }
+  static inline void aggall_rk(const T*, int64_t, int64_t, int64_t, TVAL*) { ORT_ENFORCE(false, "must be overloaded."); }
 };
 
 template <typename T, typename TVAL = T>
@@ -124,6 +204,14 @@ class ReduceAggregatorSum : public ReduceAggregator<T, TVAL> {
   inline TVAL aggall(const T* from_data) {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).sum();
   }
+  static inline bool fast_rk() { return true; }
+  static inline void aggall_rk(const T* from_data, int64_t R, int64_t ld, int64_t K, TVAL* to_data) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out += ConstEigenVectorArrayMap<T>(from_data + r * ld, K);
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -144,6 +232,10 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).mean();
   }
   inline T get_value() { return this->accumulator_ / static_cast<T>(this->N_); }
+  static inline void aggall_rk(const T* from_data, int64_t R, int64_t ld, int64_t K, TVAL* to_data) {
+    ReduceAggregatorSum<T, TVAL>::aggall_rk(from_data, R, ld, K, to_data);
+    EigenVectorArrayMap<TVAL>(to_data, K) /= static_cast<T>(R);
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -154,6 +246,14 @@ class ReduceAggregatorMax : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).maxCoeff();
   }
   inline void update(const T& v) { this->accumulator_ = v > this->accumulator_ ? v : this->accumulator_; }
+  static inline bool fast_rk() { return true; }
+  static inline void aggall_rk(const T* from_data, int64_t R, int64_t ld, int64_t K, TVAL* to_data) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out = out.max(ConstEigenVectorArrayMap<T>(from_data + r * ld, K));
+    }
+  }
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -253,6 +353,14 @@ class ReduceAggregatorMin : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).minCoeff();
   }
   inline void update(const T& v) { this->accumulator_ = v < this->accumulator_ ? v : this->accumulator_; }
+  static inline bool fast_rk() { return true; }
+  static inline void aggall_rk(const T* from_data, int64_t R, int64_t ld, int64_t K, TVAL* to_data) {
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out = ConstEigenVectorArrayMap<T>(from_data, K);
+    for (int64_t r = 1; r < R; ++r) {
+      out = out.min(ConstEigenVectorArrayMap<T>(from_data + r * ld, K));
+    }
+  }
 };
 
 template <typename T, typename TVAL = T>
@@ -308,9 +416,10 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, TVAL> {
   }
   inline TVAL aggall(const T* from_data) {
     max_ = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, this->N_).maxCoeff();
-    for (int64_t i = 0; i < this->N_; ++i) {
-      update(from_data[i]);
+    if (reduce_isinf(max_) || reduce_isnan(max_)) {
+      max_ = reduce_finite_max(from_data, this->N_, 1);
     }
+    this->accumulator_ = reduce_sum_exp(from_data, this->N_, max_);
     return get_value();
   }
   inline void update0(const T& v) {
@@ -319,6 +428,27 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, TVAL> {
   inline void update(const T& v) { this->accumulator_ += reduce_exp(v - max_); }
   inline TVAL get_value() { return reduce_log<T>(this->accumulator_) + max_; }
   static inline bool two_loops() { return true; }
+  static inline bool fast_rk() { return true; }
+  static inline void aggall_rk(const T* from_data, int64_t R, int64_t ld, int64_t K, TVAL* to_data) {
+    std::vector<T> max_values(from_data, from_data + K);
+    EigenVectorArrayMap<T> max_map(max_values.data(), K);
+    for (int64_t r = 1; r < R; ++r) {
+      max_map = max_map.max(ConstEigenVectorArrayMap<T>(from_data + r * ld, K));
+    }
+    for (int64_t k = 0; k < K; ++k) {
+      if (reduce_isinf(max_values[k]) || reduce_isnan(max_values[k])) {
+        max_values[k] = reduce_finite_max(from_data + k, R, ld);
+      }
+    }
+    EigenVectorArrayMap<TVAL> out(to_data, K);
+    out.setZero();
+    for (int64_t r = 0; r < R; ++r) {
+      reduce_accumulate_exp(from_data + r * ld, max_values.data(), K, to_data);
+    }
+    for (int64_t k = 0; k < K; ++k) {
+      to_data[k] = reduce_log<T>(to_data[k]) + max_values[k];
+    }
+  }
 };
 
 bool SetupForReduce(const Tensor* input_tensor_ptr,
@@ -329,6 +459,22 @@ bool SetupForReduce(const Tensor* input_tensor_ptr,
                     bool& empty_reduce,
                     const TensorShape* input_shape_override);
 
+// Classification of a reduction once the dimensions of size one are dropped and the adjacent dimensions that
+// are all kept (K) or all reduced (R) are merged. For example, ReduceMean over the last axis of a [B, S, H]
+// tensor is a KR reduction with fast_shape [B * S, H].
+enum class FastReduceKind {
+  kNone,  // no fast implementation, use the generic index based implementation
+  kK,     // only dimensions of size one are reduced
+  kR,     // all elements are reduced into one value
+  kKR,    // the reduced elements of each output are contiguous
+  kRK,    // the leading dimensions are reduced, each output is reduced over a column
+  kKRK,   // an RK reduction repeated for each of the leading kept elements
+};
+
+FastReduceKind OptimizeShapeForFastReduce(const std::vector<int64_t>& input_shape,
+                                          const std::vector<int64_t>& reduced_axes,
+                                          std::vector<int64_t>& fast_shape);
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  const std::vector<int64_t>& reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results);
@@ -161,8 +161,8 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
-               gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weightsZR,
+               const GemmWeights<T>& recurrent_weightsH, gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
 
@@ -223,7 +223,13 @@ class UniDirectionalGru {
   deepcpu::ActivationFuncPtr update_gate_{};
   deepcpu::GruOutputGateFuncPtr output_gate_{};
 
+  // batch rows are processed in parallel through all the steps if batch_parallel_ is set,
+  // otherwise the GEMMs of each step use the thread pool
+  bool batch_parallel_{};
+  int hidden_num_threads_ = -1;
+
   void AllocateBuffers();
+  void SetNumThreads();
 
   onnxruntime::concurrency::ThreadPool* ttp_;
 };
@@ -236,6 +242,79 @@ class UniDirectionalGru {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+Status DeepCpuGruOp::TryPackInputWeights(const Tensor& weights, bool& is_packed) {
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3) {
+    return Status::OK();
+  }
+
+  // weights: [num_directions, 3*hidden_size, input_size]
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+
+  if ((shape[0] != num_directions_) || (N != static_cast<size_t>(hidden_size_ * 3))) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  if (!PackWeights(alloc, weights.Data<float>(), num_directions_, N * K, N, K, packed_W_)) {
+    return Status::OK();
+  }
+
+  packed_W_.shape_ = shape;
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status DeepCpuGruOp::TryPackRecurrentWeights(const Tensor& weights, bool& is_packed) {
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3) {
+    return Status::OK();
+  }
+
+  // recurrence weights: [num_directions, 3*hidden_size, hidden_size]
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+
+  if ((shape[0] != num_directions_) || (N != static_cast<size_t>(hidden_size_ * 3)) ||
+      (K != static_cast<size_t>(hidden_size_))) {
+    return Status::OK();
+  }
+
+  // R[zr] is applied to Ht-1 and R[h] is applied to rt (.) Ht-1, so pack the two separately
+  const auto* weights_data = weights.Data<float>();
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  if (!PackWeights(alloc, weights_data, num_directions_, N * K, 2 * hidden_size, K, packed_R_zr_) ||
+      !PackWeights(alloc, weights_data + 2 * hidden_size * K, num_directions_, N * K, hidden_size, K,
+                   packed_R_h_)) {
+    packed_R_zr_.buffer_ = nullptr;
+    packed_R_h_.buffer_ = nullptr;
+    return Status::OK();
+  }
+
+  packed_R_zr_.shape_ = shape;
+  packed_R_h_.shape_ = shape;
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status DeepCpuGruOp::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (tensor.IsDataType<float>()) {
+    if (input_idx == 1) {
+      return TryPackInputWeights(tensor, is_packed);
+    } else if (input_idx == 2) {
+      return TryPackRecurrentWeights(tensor, is_packed);
+    }
+  }
+
+  return Status::OK();
+}
+
 Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
 
@@ -258,8 +337,10 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
-  const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
-  const Tensor& R = *context.Input<Tensor>(2);  // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
+  const Tensor* W = packed_W_.buffer_ ? nullptr : context.Input<Tensor>(1);
+                                                // weights. [num_directions, 3*hidden_size, input_size]
+  const Tensor* R = packed_R_zr_.buffer_ ? nullptr : context.Input<Tensor>(2);
+                                                // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
 
   // optional
   const auto* B = context.Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
@@ -272,7 +353,10 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   int batch_size = gsl::narrow<int>(X_shape[1]);
   int input_size = gsl::narrow<int>(X_shape[2]);
 
-  auto status = ValidateCommonRnnInputs(X, W.Shape(), R.Shape(), B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
+  const auto& W_shape = (W != nullptr) ? W->Shape() : packed_W_.shape_;
+  const auto& R_shape = (R != nullptr) ? R->Shape() : packed_R_zr_.shape_;
+
+  auto status = ValidateCommonRnnInputs(X, W_shape, R_shape, B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
   ORT_RETURN_IF_ERROR(status);
 
   // GRU outputs are optional but must be in the same order
@@ -295,8 +379,10 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   AllocatorPtr alloc;
   status = context.GetTempSpaceAllocator(&alloc);
   ORT_RETURN_IF_ERROR(status);
-  gsl::span<const T> input_weights = W.DataAsSpan<T>();
-  gsl::span<const T> recurrent_weights = R.DataAsSpan<T>();
+  const auto* input_weights = (W != nullptr) ? W->Data<T>() : nullptr;
+  const auto* recurrent_weights = (R != nullptr) ? R->Data<T>() : nullptr;
+  // R[h] follows R[zr] in the recurrence weights of each direction
+  const auto* recurrent_weights_h = (R != nullptr) ? recurrent_weights + 2 * hidden_size_ * hidden_size_ : nullptr;
   gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
@@ -304,8 +390,9 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
+  GemmWeights<T> input_weights_1(0, input_weights, input_weights_size_per_direction, packed_W_);
+  GemmWeights<T> recurrent_weights_zr_1(0, recurrent_weights, recurrent_weights_size_per_direction, packed_R_zr_);
+  GemmWeights<T> recurrent_weights_h_1(0, recurrent_weights_h, recurrent_weights_size_per_direction, packed_R_h_);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -340,10 +427,9 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
+    GemmWeights<T> input_weights_2(1, input_weights, input_weights_size_per_direction, packed_W_);
+    GemmWeights<T> recurrent_weights_zr_2(1, recurrent_weights, recurrent_weights_size_per_direction, packed_R_zr_);
+    GemmWeights<T> recurrent_weights_h_2(1, recurrent_weights_h, recurrent_weights_size_per_direction, packed_R_h_);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -362,24 +448,24 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+               recurrent_weights_h_1, output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_zr_2,
+               recurrent_weights_h_2, output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+                  recurrent_weights_h_1, output_1, hidden_output_1);
   }
 
   if (!output.empty())
@@ -429,6 +515,7 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
   h_alpha_ = activation_func_g.alpha;
   h_beta_ = activation_func_g.beta;
 
+  SetNumThreads();
   AllocateBuffers();
 
   if (use_bias_) {
@@ -478,8 +565,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights<T>& input_weights,
+                                   const GemmWeights<T>& recurrent_weightsZR,
+                                   const GemmWeights<T>& recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -496,11 +584,6 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -530,9 +613,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   // apply weights to all the inputs
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
-              input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, 0.f,
+              input_weights, 0.f,
               outputZRH_.begin(), outputZRH_.end(),
               hidden_size_x3, ttp_);
 
@@ -552,13 +633,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   span_T_const_iter batched_bias_WRz_local_end = batched_bias_WRz_.cend();
   span_T_const_iter batched_bias_WRr_local_end = batched_bias_WRr_.cend();
   span_T_const_iter batched_bias_Wh_local_end = batched_bias_Wh_.cend();
-  span_T_const_iter batched_bias_Rh_local_end = batched_bias_Rh_.cend();
   span_T_const_iter batched_bias_WRh_local_end = batched_bias_WRh_.cend();
 
-  size_t out_added_offset;
-
-  span_T_const_iter prev_Ht = batched_hidden0_.cbegin();  // Ht-1
-  span_T_const_iter prev_Ht_end = batched_hidden0_.cend();
   span_T_iter cur_h_local = cur_h_.begin();
   span_T_iter cur_h_local_end = cur_h_.end();
 
@@ -566,7 +642,6 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   span_T_const_iter batched_bias_WRr_local{};
   span_T_const_iter batched_bias_WRh_local{};
   span_T_const_iter batched_bias_Wh_local{};
-  span_T_const_iter batched_bias_Rh_local{};
 
   if (use_bias_) {
     batched_bias_WRz_local = batched_bias_WRz_.cbegin();
@@ -574,212 +649,253 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 
     if (linear_before_reset_) {
       batched_bias_Wh_local = batched_bias_Wh_.cbegin();
-      batched_bias_Rh_local = batched_bias_Rh_.cbegin();
     } else {
       batched_bias_WRh_local = batched_bias_WRh_.cbegin();
     }
   }
 
-  {
-    // Enter a parallel section encompassing the kernels invoked
-    // below.  This lets the runtime system amortize loop entry/exit
-    // costs over a series of short kernels, and promotes cache
-    // affinity between iterations of successive loops.
-    onnxruntime::concurrency::ThreadPool::ParallelSection ps(ttp_);
-
-    // for each item in sequence run all calculations
-    for (int step = 0; step < max_sequence_length; step++) {
+  // run all calculations for one step on the num_rows batch rows starting at row.
+  // rows are independent apart from sharing the GEMMs, so the rows can be split across threads
+  // with each set of rows run through all the steps.
+  auto compute_step = [&](int step, int row, int num_rows, onnxruntime::concurrency::ThreadPool* thread_pool) {
 #if defined(DUMP_MATRIXES)
-      const std::string seqno_str = " [seqno=" + std::to_string(step) + "]";
+    const std::string seqno_str = " [row=" + std::to_string(row) + ",seqno=" + std::to_string(step) + "]";
 #endif
-      DumpMatrix("Ht-1" + seqno_str, &*prev_Ht, batch_size_, hidden_size_);
 
-      out_added_offset = (step * batch_size_) * hidden_size_x3;
+    // Ht-1 is the initial hidden state for the first step, and the output of the previous step after that
+    span_T_const_iter prev_Ht = batched_hidden0_.cbegin();
+    span_T_const_iter prev_Ht_end = batched_hidden0_.cend();
+    if (step > 0) {
+      if (output_sequence) {
+        prev_Ht = outputs.begin() + (step - 1) * output_step_length;
+        prev_Ht_end = outputs.end();
+      } else {
+        prev_Ht = final_hidden_state.begin();
+        prev_Ht_end = final_hidden_state.end();
+      }
+    }
+
+    span_T_const_iter prev_Ht_rows = prev_Ht + row * hidden_size_;
 
-      // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
-      // Ht-1 * R[zr] + Xt*(W[zr]^T)
-      ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
-                  prev_Ht, prev_Ht_end,
-                  hidden_size_,
-                  recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                  hidden_size_, 1.f,  // beta == 1 so we add existing values in outputZRH_
-                  outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                  hidden_size_x3, ttp_);
+    DumpMatrix("Ht-1" + seqno_str, &*prev_Ht_rows, num_rows, hidden_size_);
 
-      DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
-                 outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
+    const size_t out_added_offset = (step * batch_size_ + row) * hidden_size_x3;
 
-      if (linear_before_reset_) {
-        // copy Rbh to linear output
-        if (use_bias_) {
-          gsl::copy(batched_bias_Rh_.subspan(batched_bias_Rh_local - batched_bias_Rh_.begin(),
-                                             batched_bias_Rh_local_end - batched_bias_Rh_local),
-                    linear_output_);
-        }
+    // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
+    // Ht-1 * R[zr] + Xt*(W[zr]^T)
+    ComputeGemm(num_rows, hidden_size_x2, hidden_size_, alpha,
+                prev_Ht_rows, prev_Ht_end,
+                recurrent_weightsZR,
+                1.f,  // beta == 1 so we add existing values in outputZRH_
+                outputZRH_.begin() + out_added_offset, outputZRH_.end(),
+                hidden_size_x3, thread_pool);
+
+    DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
+               outputZRH_.data() + out_added_offset, num_rows, hidden_size_x2, 0, hidden_size_x3);
 
-        // compute Ht-1 * (Rh^T) + Rbh
-        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                    prev_Ht, prev_Ht_end,  // Ht-1
-                    hidden_size_,
-                    recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                    hidden_size_,
-                    use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-                    linear_output_.begin(),
-                    linear_output_.end(),  // pre: Rbh if use_bias_, post:output
-                    hidden_size_, ttp_);
-
-        DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
+    if (linear_before_reset_) {
+      // copy Rbh to linear output
+      if (use_bias_) {
+        gsl::copy(batched_bias_Rh_.subspan(row * hidden_size_, num_rows * hidden_size_),
+                  linear_output_.subspan(row * hidden_size_, num_rows * hidden_size_));
       }
 
-      // 1st Set Of Activations
-      for (int r = 0; r < batch_size_; r++) {
-        const T* p_bias_r = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRr_local + r * hidden_size_,
-                                                               batched_bias_WRr_local_end, hidden_size_)
-          : nullptr;
+      // compute Ht-1 * (Rh^T) + Rbh
+      ComputeGemm(num_rows, hidden_size_, hidden_size_, alpha,
+                  prev_Ht_rows, prev_Ht_end,  // Ht-1
+                  recurrent_weightsH,         // Rh^T
+                  use_bias_ ? 1.f : 0.f,      // don't add values in linear_output_ if no bias input
+                  linear_output_.begin() + row * hidden_size_,
+                  linear_output_.end(),  // pre: Rbh if use_bias_, post:output
+                  hidden_size_, thread_pool);
+
+      DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data() + row * hidden_size_,
+                 num_rows, hidden_size_);
+    }
 
-        // initialize p_rt with input to calculate rt. outputZRH_ has Xt*(Wr^T) + Ht-1*(Rr^T).
-        T* p_rt = SafeRawPointer(outputZRH_, out_added_offset + r * hidden_size_x3 + hidden_size_, hidden_size_);
+    // 1st Set Of Activations
+    for (int r = row; r < row + num_rows; r++) {
+      const T* p_bias_r = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRr_local + r * hidden_size_,
+                                                             batched_bias_WRr_local_end, hidden_size_)
+                                    : nullptr;
 
-        // add the bias and clip. post: p_rt == Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr
-        clip_with_bias_ptr_(clip_, p_bias_r, p_rt, hidden_size_);
+      // initialize p_rt with input to calculate rt. outputZRH_ has Xt*(Wr^T) + Ht-1*(Rr^T).
+      T* p_rt = SafeRawPointer(outputZRH_, out_added_offset + (r - row) * hidden_size_x3 + hidden_size_,
+                               hidden_size_);
 
-        if (linear_before_reset_) {
-          // p_linear_output = Ht-1 * (Rh^T) + Rbh
-          T* p_linear_output = SafeRawPointer<T>(linear_output_, r * hidden_size_, hidden_size_);
-          T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
+      // add the bias and clip. post: p_rt == Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr
+      clip_with_bias_ptr_(clip_, p_bias_r, p_rt, hidden_size_);
 
-          // calculate rt in-place [p_rt = f(p_rt)]
-          // calculate rt (.) (Ht-1 * (Rh^T) + Rbh) using p_linear_output. write to p_cur_h
-          reset_gate_(p_linear_output, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
+      if (linear_before_reset_) {
+        // p_linear_output = Ht-1 * (Rh^T) + Rbh
+        T* p_linear_output = SafeRawPointer<T>(linear_output_, r * hidden_size_, hidden_size_);
+        T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
 
-        } else {
-          const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
-          T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
+        // calculate rt in-place [p_rt = f(p_rt)]
+        // calculate rt (.) (Ht-1 * (Rh^T) + Rbh) using p_linear_output. write to p_cur_h
+        reset_gate_(p_linear_output, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
 
-          // calculate rt in-place [p_rt = f(p_rt)]
-          // calculate rt (.) Ht-1 using p_prev_Ht, and write to p_cur_h
-          reset_gate_(p_prev_Ht, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
-        }
+      } else {
+        const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
+        T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
+
+        // calculate rt in-place [p_rt = f(p_rt)]
+        // calculate rt (.) Ht-1 using p_prev_Ht, and write to p_cur_h
+        reset_gate_(p_prev_Ht, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
       }
+    }
 
 #if defined(DUMP_MATRIXES)
-      std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
+    std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
 #endif
-      DumpMatrix(label + seqno_str, &*cur_h_local, batch_size_, hidden_size_);
+    DumpMatrix(label + seqno_str, &*cur_h_local + row * hidden_size_, num_rows, hidden_size_);
 
-      if (linear_before_reset_) {
-        // input contains rt (.) (Ht-1*(Rh^T) + Rbh)
-        auto input = cur_h_local;
-        // out_H currently contains Xt*(W[zrh]^T).
-        auto out_H = outputZRH_.begin() + out_added_offset;
-
-        for (int r = 0; r < batch_size_; r++) {
-          // skip over the inputs with Z and R weights
-          out_H += hidden_size_x2;
-          for (int h = 0; h < hidden_size_; ++h) {
-            *out_H += *input;
-            ++out_H;
-            ++input;
-          }
+    if (linear_before_reset_) {
+      // input contains rt (.) (Ht-1*(Rh^T) + Rbh)
+      auto input = cur_h_local + row * hidden_size_;
+      // out_H currently contains Xt*(W[zrh]^T).
+      auto out_H = outputZRH_.begin() + out_added_offset;
+
+      for (int r = 0; r < num_rows; r++) {
+        // skip over the inputs with Z and R weights
+        out_H += hidden_size_x2;
+        for (int h = 0; h < hidden_size_; ++h) {
+          *out_H += *input;
+          ++out_H;
+          ++input;
         }
-      } else {
+      }
+    } else {
 #if defined(DUMP_MATRIXES)
-        label += " * Rh^T";
+      label += " * Rh^T";
 #endif
 
-        // out_H currently contains Xt*(Wh^T).
-        auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
-
-        // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
-        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                    cur_h_local, cur_h_local_end,  // rt (.) Ht-1
-                    hidden_size_,
-                    recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                    hidden_size_, 1.f,                                       // beta == 1 to add Xt*(Wh^T) from out_H
-                    out_H, outputZRH_.end(),
-                    hidden_size_x3, ttp_);
-      }
+      // out_H currently contains Xt*(Wh^T).
+      auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
 
-      DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
-                 batch_size_, hidden_size_, hidden_size_x2, hidden_size_x3);
+      // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
+      ComputeGemm(num_rows, hidden_size_, hidden_size_, alpha,
+                  cur_h_local + row * hidden_size_, cur_h_local_end,  // rt (.) Ht-1
+                  recurrent_weightsH,                                 // Rh^T
+                  1.f,                                                // beta == 1 to add Xt*(Wh^T) from out_H
+                  out_H, outputZRH_.end(),
+                  hidden_size_x3, thread_pool);
+    }
 
-      //2nd Set of Activations
-      span_T_iter output;
-      span_T_iter output_end;
-      if (output_sequence) {
-        output = outputs.begin() + step * output_step_length;
-        output_end = outputs.end();
+    DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
+               num_rows, hidden_size_, hidden_size_x2, hidden_size_x3);
 
-      } else {
-        output = final_hidden_state.begin();
-        output_end = final_hidden_state.end();
-      }
+    //2nd Set of Activations
+    span_T_iter output;
+    span_T_iter output_end;
+    if (output_sequence) {
+      output = outputs.begin() + step * output_step_length;
+      output_end = outputs.end();
 
-      for (int r = 0; r < batch_size_; r++) {
-        if (step >= min_sequence_length && step >= sequence_lengths[r]) {
-          // if we need output for every step,
-          // or we need to set prev_Ht for an empty sequence to avoid warnings about using uninitialized values
-          if (output_sequence || (step == 0 && sequence_lengths[r] == 0)) {
-            auto fill_output = output + r * hidden_size_;
-            std::fill_n(&*fill_output, hidden_size_, T{});
-          }
+    } else {
+      output = final_hidden_state.begin();
+      output_end = final_hidden_state.end();
+    }
 
-          continue;
+    for (int r = row; r < row + num_rows; r++) {
+      if (step >= min_sequence_length && step >= sequence_lengths[r]) {
+        // if we need output for every step,
+        // or we need to set prev_Ht for an empty sequence to avoid warnings about using uninitialized values
+        if (output_sequence || (step == 0 && sequence_lengths[r] == 0)) {
+          auto fill_output = output + r * hidden_size_;
+          std::fill_n(&*fill_output, hidden_size_, T{});
         }
 
-        const T* p_bias_z = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRz_local,
-                                                               batched_bias_WRz_local_end, hidden_size_)
-          : nullptr;
+        continue;
+      }
 
-        // initialize p_zt with Xt*(Wz^T) + Ht-1*(Rz^T), which is most of the input to calculate zt:
-        T* p_zt = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3, hidden_size_);
+      const T* p_bias_z = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRz_local + r * hidden_size_,
+                                                             batched_bias_WRz_local_end, hidden_size_)
+                                    : nullptr;
 
-        // using p_zt, add bias and clip in-place
-        clip_with_bias_ptr_(clip_, p_bias_z, p_zt, hidden_size_);
+      // initialize p_zt with Xt*(Wz^T) + Ht-1*(Rz^T), which is most of the input to calculate zt:
+      T* p_zt = SafeRawPointer<T>(outputZRH_, out_added_offset + (r - row) * hidden_size_x3, hidden_size_);
 
-        // calculate zt in-place. p_zt = f(p_zt)
-        update_gate_(p_zt, hidden_size_, zr_alpha_, zr_beta_);
+      // using p_zt, add bias and clip in-place
+      clip_with_bias_ptr_(clip_, p_bias_z, p_zt, hidden_size_);
 
-        DumpMatrix("zt[" + std::to_string(r) + "]" + seqno_str, p_zt, 1, hidden_size_);
+      // calculate zt in-place. p_zt = f(p_zt)
+      update_gate_(p_zt, hidden_size_, zr_alpha_, zr_beta_);
 
-        const T* p_bias_h = nullptr;
-        if (use_bias_) {
-          if (linear_before_reset_) {
-            // Wbh
-            p_bias_h = SafeRawConstPointer<T>(batched_bias_Wh_local + r * hidden_size_,
-                                              batched_bias_Wh_local_end, hidden_size_);
+      DumpMatrix("zt[" + std::to_string(r) + "]" + seqno_str, p_zt, 1, hidden_size_);
 
-          } else {
-            // Wbh + Wrh
-            p_bias_h = SafeRawConstPointer<T>(batched_bias_WRh_local + r * hidden_size_,
-                                              batched_bias_WRh_local_end, hidden_size_);
-          }
+      const T* p_bias_h = nullptr;
+      if (use_bias_) {
+        if (linear_before_reset_) {
+          // Wbh
+          p_bias_h = SafeRawConstPointer<T>(batched_bias_Wh_local + r * hidden_size_,
+                                            batched_bias_Wh_local_end, hidden_size_);
+
+        } else {
+          // Wbh + Wrh
+          p_bias_h = SafeRawConstPointer<T>(batched_bias_WRh_local + r * hidden_size_,
+                                            batched_bias_WRh_local_end, hidden_size_);
         }
+      }
 
-        // setup p_ht with input to calculate ht
-        // p_ht = Xt*(Wh^T) + (rt (.) Ht-1 * Rh^T)          #  linear_before_reset_ == false
-        //      = Xt*(Wh^T) + (rt (.) (Ht-1*(Rh^T) + Rbh))  #  linear_before_reset_ == true
-        T* p_ht = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3 + hidden_size_x2, hidden_size_);
+      // setup p_ht with input to calculate ht
+      // p_ht = Xt*(Wh^T) + (rt (.) Ht-1 * Rh^T)          #  linear_before_reset_ == false
+      //      = Xt*(Wh^T) + (rt (.) (Ht-1*(Rh^T) + Rbh))  #  linear_before_reset_ == true
+      T* p_ht = SafeRawPointer<T>(outputZRH_, out_added_offset + (r - row) * hidden_size_x3 + hidden_size_x2,
+                                  hidden_size_);
 
-        // add Wbh [and Wrh] and clip
-        clip_with_bias_ptr_(clip_, p_bias_h, p_ht, hidden_size_);  // post: p_ht == input to g() for calculating ht
+      // add Wbh [and Wrh] and clip
+      clip_with_bias_ptr_(clip_, p_bias_h, p_ht, hidden_size_);  // post: p_ht == input to g() for calculating ht
 
-        DumpMatrix("ht input [" + std::to_string(r) + "]" + seqno_str, p_ht, 1, hidden_size_);
+      DumpMatrix("ht input [" + std::to_string(r) + "]" + seqno_str, p_ht, 1, hidden_size_);
 
-        const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
-        T* p_Ht = SafeRawPointer<T>(output + r * hidden_size_, output_end, hidden_size_);
+      const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
+      T* p_Ht = SafeRawPointer<T>(output + r * hidden_size_, output_end, hidden_size_);
+
+      // calculate ht = g(p_ht) and write in-place to p_ht
+      // calculate Ht = (1 - zt) (.) ht + zt (.) Ht-1 and write to p_Ht
+      output_gate_(p_ht, p_zt, p_prev_Ht, p_Ht, hidden_size_, h_alpha_, h_beta_);  // calculate ht and Ht
+    }
 
-        // calculate ht = g(p_ht) and write in-place to p_ht
-        // calculate Ht = (1 - zt) (.) ht + zt (.) Ht-1 and write to p_Ht
-        output_gate_(p_ht, p_zt, p_prev_Ht, p_Ht, hidden_size_, h_alpha_, h_beta_);  // calculate ht and Ht
+    DumpMatrix("output" + seqno_str, &*output + row * hidden_size_, num_rows, hidden_size_);
+  };
+
+  if (batch_parallel_) {
+    int fused_hidden_rows = batch_size_ / hidden_num_threads_;
+    if (batch_size_ % hidden_num_threads_ != 0)
+      fused_hidden_rows++;
+
+    // lambda to run all the steps on fused_hidden_rows rows
+    auto hidden_gemm_and_activations = [&](int row) {
+      // handling boundaries
+      int local_fused_hidden_rows = fused_hidden_rows;
+      if ((row + fused_hidden_rows) > batch_size_)
+        local_fused_hidden_rows = batch_size_ - row;
+
+      // run through steps sequentially
+      // do the GEMMs sequentially to avoid nested parallelism
+      for (int step = 0; step < max_sequence_length; step++) {
+        compute_step(step, row, local_fused_hidden_rows, nullptr);
       }
+    };
+
+    // Approximate worst case cost of hidden_gemm_and_activations.
+    double gemm_cost = fused_hidden_rows * hidden_size_x3 * hidden_size_;
+    double cost = max_sequence_length * (gemm_cost + fused_hidden_rows);
+    ExecuteLambdaInParallel(hidden_gemm_and_activations, batch_size_, fused_hidden_rows, cost, ttp_);
 
-      DumpMatrix("output" + seqno_str, &*output, batch_size_, hidden_size_);
+  } else {
+    // Enter a parallel section encompassing the kernels invoked
+    // below.  This lets the runtime system amortize loop entry/exit
+    // costs over a series of short kernels, and promotes cache
+    // affinity between iterations of successive loops.
+    onnxruntime::concurrency::ThreadPool::ParallelSection ps(ttp_);
 
-      prev_Ht = output;
-      prev_Ht_end = output_end;
+    // for each item in sequence run all calculations
+    for (int step = 0; step < max_sequence_length; step++) {
+      compute_step(step, 0, batch_size_, ttp_);
     }
-  } // End parallel section
+  }  // End parallel section
 
   // copy last output to final_hidden_state
   for (int i = 0; i < batch_size_; i++) {
@@ -849,5 +965,25 @@ void UniDirectionalGru<T>::AllocateBuffers() {
   }
 }
 
+template <typename T>
+void UniDirectionalGru<T>::SetNumThreads() {
+  int threads = concurrency::ThreadPool::DegreeOfParallelism(ttp_);
+
+  if (threads < 1)
+    threads = 1;
+
+  hidden_num_threads_ = threads;
+  batch_parallel_ = false;
+
+  // for readability of the below logic
+  const auto num_rows = batch_size_;
+  const auto num_columns = hidden_size_;
+
+  // parallelize by partitioning the batch rows. use the same thresholds as the LSTM.
+  if (threads > 1 && (num_rows > 4 || (num_rows >= 2 && num_columns <= 256))) {
+    batch_parallel_ = true;
+  }
+}
+
 }  // namespace detail
 }  // namespace onnxruntime
@@ -51,11 +51,15 @@ class DeepCpuGruOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
 
  private:
+  Status TryPackInputWeights(const Tensor& weights, bool& is_packed);
+  Status TryPackRecurrentWeights(const Tensor& weights, bool& is_packed);
+
   rnn::detail::Direction direction_;
   int num_directions_;
 
@@ -63,6 +67,11 @@ class DeepCpuGruOp final : public OpKernel {
   float clip_;
   int linear_before_reset_ {};
 
+  // W[zrh] are packed together. R[zr] and R[h] are packed separately as they are applied by different GEMMs.
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_zr_;
+  rnn::detail::PackedWeights packed_R_h_;
+
   rnn::detail::ActivationFuncs activation_funcs_;
 
   template <typename T>
@@ -155,27 +155,6 @@ Equations (Default: f=Sigmoid, g=Tanh, h=Tanh):
 
 namespace onnxruntime {
 
-template <typename TLambda>
-static inline void ExecuteLambdaInParallel(TLambda lambda, int max, int step, double cost,
-                                           onnxruntime::concurrency::ThreadPool* ttp) {
-  // #define NOTHREADS to execute the lambdas directly and in order if you need to do that to debug
-
-#ifdef NOTHREADS
-  ORT_UNUSED_PARAMETER(ttp);
-
-  for (int i = 0; i < max; i += step) {
-    std::bind(lambda, i)();
-  }
-#else
-  const int total_tasks = max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
-  concurrency::ThreadPool::TryParallelFor(ttp, total_tasks, cost, [&lambda, step](ptrdiff_t first, ptrdiff_t last) {
-    for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
-      lambda(i * step);
-    }
-  });
-#endif
-}
-
 /* LSTM operator */
 ONNX_CPU_OPERATOR_KERNEL(LSTM, 7,
                          KernelDefBuilder()
@@ -305,24 +284,13 @@ Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, PackedWeights& packe
     return Status::OK();
   }
 
-  const size_t packed_weights_size = MlasGemmPackBSize(N, K);
-  if (packed_weights_size == 0) {
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  if (!PackWeights(alloc, weights.Data<float>(), num_directions_, N * K, N, K, packed_weights)) {
     return Status::OK();
   }
 
-  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
-  auto* packed_weights_data = alloc->Alloc(SafeInt<size_t>(packed_weights_size) * num_directions_);
-  packed_weights.buffer_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
-  packed_weights.weights_size_ = packed_weights_size;
   packed_weights.shape_ = shape;
 
-  const auto* weights_data = weights.Data<float>();
-  for (int i = 0; i < num_directions_; i++) {
-    MlasGemmPackB(CblasTrans, N, K, weights_data, K, packed_weights_data);
-    packed_weights_data = static_cast<uint8_t*>(packed_weights_data) + packed_weights_size;
-    weights_data += N * K;
-  }
-
   is_packed = true;
   return Status::OK();
 }
@@ -95,6 +95,73 @@ void ClearMissingFrames(T* Y_buffer_data, const Tensor* sequence_lens,
   }
 }
 
+// Tanh and Sigmoid are applied to each batch row in a single pass using the MLAS kernels
+static void ApplyMlasActivationToBatches(const Tensor* sequence_lens, const float* h_prev,
+                                         float* Y_buffer_data_current_frame,
+                                         int64_t time_step, int64_t batch_size, int64_t hidden_size,
+                                         float clip, bool is_sigmoid) {
+  const int* seq_len_data = sequence_lens ? sequence_lens->template Data<int>() : nullptr;
+
+  for (int batch = 0; batch < batch_size; batch++) {
+    float* y = Y_buffer_data_current_frame + batch * hidden_size;
+
+    if (nullptr != seq_len_data && time_step >= seq_len_data[batch]) {
+      // copy from previous time_step if available
+      if (h_prev) {
+        std::copy_n(h_prev + batch * hidden_size, hidden_size, y);
+      } else {
+        std::fill_n(y, hidden_size, 0.f);
+      }
+      continue;
+    }
+
+    if (clip >= 0) {
+      for (int64_t feature = 0; feature < hidden_size; ++feature) {
+        y[feature] = Clip(y[feature], clip);
+      }
+    }
+
+    if (is_sigmoid) {
+      MlasComputeLogistic(y, y, static_cast<size_t>(hidden_size));
+    } else {
+      MlasComputeTanh(y, y, static_cast<size_t>(hidden_size));
+    }
+  }
+}
+
+template <>
+Status RNN<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  if (input_idx != 1 && input_idx != 2) {
+    return Status::OK();
+  }
+
+  // weights: [num_directions, hidden_size, input_size]
+  // recurrence weights: [num_directions, hidden_size, hidden_size]
+  const auto& shape = tensor.Shape();
+  const int64_t num_directions = direction_ == "bidirectional" ? 2 : 1;
+  if (!tensor.IsDataType<float>() || shape.NumDimensions() != 3 ||
+      shape[0] != num_directions || shape[1] != hidden_size_) {
+    return Status::OK();
+  }
+
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+  auto& packed_weights = input_idx == 1 ? packed_W_ : packed_R_;
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  if (!rnn::detail::PackWeights(alloc, tensor.Data<float>(), static_cast<int>(num_directions), N * K, N, K,
+                                packed_weights)) {
+    return Status::OK();
+  }
+
+  packed_weights.shape_ = shape;
+
+  is_packed = true;
+  return Status::OK();
+}
+
 template <typename T>
 using EigenMatrixMapRowMajor = Eigen::Map<
     Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
@@ -106,8 +173,8 @@ Status RNN<float>::Compute(OpKernelContext* ctx) const {
 
   // inputs
   const Tensor& X = *ctx->Input<Tensor>(0);
-  const Tensor& W = *ctx->Input<Tensor>(1);
-  const Tensor& R = *ctx->Input<Tensor>(2);
+  const Tensor* W = packed_W_.buffer_ ? nullptr : ctx->Input<Tensor>(1);
+  const Tensor* R = packed_R_.buffer_ ? nullptr : ctx->Input<Tensor>(2);
 
   // optional inputs
   const auto* B = ctx->Input<Tensor>(3);
@@ -119,7 +186,10 @@ Status RNN<float>::Compute(OpKernelContext* ctx) const {
   int64_t batch_size = X.Shape()[1];
   int64_t input_size = X.Shape()[2];
 
-  auto status = rnn::detail::ValidateCommonRnnInputs(X, W.Shape(), R.Shape(), B, 1, sequence_lens, initial_h,
+  const auto& W_shape = (W != nullptr) ? W->Shape() : packed_W_.shape_;
+  const auto& R_shape = (R != nullptr) ? R->Shape() : packed_R_.shape_;
+
+  auto status = rnn::detail::ValidateCommonRnnInputs(X, W_shape, R_shape, B, 1, sequence_lens, initial_h,
                                                      num_directions, hidden_size_);
   ORT_RETURN_IF_ERROR(status);
 
@@ -151,10 +221,18 @@ Status RNN<float>::Compute(OpKernelContext* ctx) const {
 
   int64_t Y_frame_size = batch_size * hidden_size_;
 
+  const float* input_weights = (W != nullptr) ? W->template Data<float>() : nullptr;
+  const float* recurrent_weights = (R != nullptr) ? R->template Data<float>() : nullptr;
+  const float* X_data = X.template Data<float>();
+
   for (int direction = 0; direction < num_directions; direction++) {
     auto activation_func = GetFuncByName<float>(activations_[direction], "Tanh");
+    const bool use_mlas_activation = activations_[direction] == "Tanh" || activations_[direction] == "Sigmoid";
     bool isReverse = direction_ == "reverse" || direction == 1;
 
+    GemmWeights<float> input_weights_dir(direction, input_weights, hidden_size_ * input_size, packed_W_);
+    GemmWeights<float> recurrent_weights_dir(direction, recurrent_weights, hidden_size_ * hidden_size_, packed_R_);
+
     if (B != nullptr) {
       EigenMatrixMapRowMajor<float>(x_matmul_w_buffer_data, seq_length * batch_size, hidden_size_).rowwise() =
           ConstEigenVectorMap<float>(B->template Data<float>() + direction * 2 * hidden_size_, hidden_size_).transpose() +
@@ -164,18 +242,16 @@ Status RNN<float>::Compute(OpKernelContext* ctx) const {
     }
 
     // X * W[direction]^t + B
-    math::Gemm<float>(
-        CblasNoTrans,
-        CblasTrans,
-        static_cast<int>(seq_length * batch_size),
-        static_cast<int>(hidden_size_),
-        static_cast<int>(input_size),
-        1,
-        X.template Data<float>(),
-        W.template Data<float>() + direction * hidden_size_ * input_size,
-        1,
-        x_matmul_w_buffer_data,
-        tp);
+    ComputeGemm(static_cast<int>(seq_length * batch_size),
+                static_cast<int>(hidden_size_),
+                static_cast<int>(input_size),
+                1.f,
+                X_data, X_data + seq_length * batch_size * input_size,
+                input_weights_dir,
+                1.f,
+                x_matmul_w_buffer_data, x_matmul_w_buffer_data + seq_length * Y_frame_size,
+                static_cast<int>(hidden_size_),
+                tp);
 
     for (int64_t t = 0; t < seq_length; t++) {
       int64_t time_step = isReverse ? (seq_length - t - 1) : t;
@@ -200,18 +276,16 @@ Status RNN<float>::Compute(OpKernelContext* ctx) const {
 
       if (h_prev != nullptr) {
         // H_t_1 * R[direction]^t
-        math::Gemm<float>(
-            CblasNoTrans,
-            CblasTrans,
-            static_cast<int>(batch_size),
-            static_cast<int>(hidden_size_),
-            static_cast<int>(hidden_size_),
-            1,
-            h_prev,
-            R.template Data<float>() + direction * hidden_size_ * hidden_size_,
-            0,
-            Y_buffer_data_current_frame,
-            tp);
+        ComputeGemm(static_cast<int>(batch_size),
+                    static_cast<int>(hidden_size_),
+                    static_cast<int>(hidden_size_),
+                    1.f,
+                    h_prev, h_prev + Y_frame_size,
+                    recurrent_weights_dir,
+                    0.f,
+                    Y_buffer_data_current_frame, Y_buffer_data_current_frame + Y_frame_size,
+                    static_cast<int>(hidden_size_),
+                    tp);
       } else {
         math::Set<float, CPUMathUtil>(batch_size * hidden_size_, 0, Y_buffer_data_current_frame, &CPUMathUtil::Instance());
       }
@@ -220,9 +294,16 @@ Status RNN<float>::Compute(OpKernelContext* ctx) const {
       y_frame_mat += EigenMatrixMapRowMajor<float>(&x_matmul_w_buffer_data[time_step * Y_frame_size], batch_size, hidden_size_);
 
       // apply activation
-      ApplyActivationToBatches<float>(sequence_lens, h_prev, Y_buffer_data_current_frame,
-                                      time_step, batch_size, hidden_size_,
-                                      activation_alpha_[direction], activation_beta_[direction], clip_, activation_func);
+      if (use_mlas_activation) {
+        ApplyMlasActivationToBatches(sequence_lens, h_prev, Y_buffer_data_current_frame,
+                                     time_step, batch_size, hidden_size_,
+                                     clip_, activations_[direction] == "Sigmoid");
+      } else {
+        ApplyActivationToBatches<float>(sequence_lens, h_prev, Y_buffer_data_current_frame,
+                                        time_step, batch_size, hidden_size_,
+                                        activation_alpha_[direction], activation_beta_[direction], clip_,
+                                        activation_func);
+      }
     }  // close sequence loop
 
     if (Y_h)
@@ -8,6 +8,7 @@
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/rnn/rnn_helpers.h"
 
 namespace onnxruntime {
 template <typename T>
@@ -41,6 +42,7 @@ class RNN : public OpKernel {
     }
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
   Status Compute(OpKernelContext* context) const override;
 
  private:
@@ -62,6 +64,9 @@ class RNN : public OpKernel {
   // required
   int64_t hidden_size_;
 
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_;
+
   // const std::string default_activation = "Tanh";
 };
 
@@ -119,6 +119,26 @@ static std::unordered_map<std::string, std::pair<float, float>>
                          {"hardsigmoid", {0.2f, 0.5f}},
                          {"elu", {1.0f, 0.f}}};
 
+bool PackWeights(const AllocatorPtr& alloc, const float* weights_data, int num_directions, size_t direction_stride,
+                 size_t N, size_t K, PackedWeights& packed_weights) {
+  const size_t packed_weights_size = MlasGemmPackBSize(N, K);
+  if (packed_weights_size == 0) {
+    return false;
+  }
+
+  auto* packed_weights_data = alloc->Alloc(SafeInt<size_t>(packed_weights_size) * num_directions);
+  packed_weights.buffer_ = BufferUniquePtr(packed_weights_data, BufferDeleter(alloc));
+  packed_weights.weights_size_ = packed_weights_size;
+
+  for (int i = 0; i < num_directions; i++) {
+    MlasGemmPackB(CblasTrans, N, K, weights_data, K, packed_weights_data);
+    packed_weights_data = static_cast<uint8_t*>(packed_weights_data) + packed_weights_size;
+    weights_data += direction_stride;
+  }
+
+  return true;
+}
+
 std::string NormalizeActivationArgumentAndGetAlphaBetaCount(const std::string& activation,
                                                             std::vector<float>::const_iterator& cur_alpha,
                                                             const std::vector<float>::const_iterator& end_alpha,
@@ -169,6 +169,11 @@ struct PackedWeights {
   TensorShape shape_;
 };
 
+// Pack the weights of each direction for use with MlasGemm. The weights of a direction are the N x K matrix
+// starting at weights_data + direction * direction_stride. Returns false if the weights could not be packed.
+bool PackWeights(const AllocatorPtr& alloc, const float* weights_data, int num_directions, size_t direction_stride,
+                 size_t N, size_t K, PackedWeights& packed_weights);
+
 template <typename T>
 struct GemmWeights {
   GemmWeights(int idx, const T* weights_data, size_t weights_size, const PackedWeights& packed_weights) {
@@ -220,6 +225,28 @@ void ComputeGemm(const int M,
   }
 }
 
+// Run lambda(i) for i in [0, max) in increments of step using the thread pool.
+template <typename TLambda>
+inline void ExecuteLambdaInParallel(TLambda lambda, int max, int step, double cost,
+                                    onnxruntime::concurrency::ThreadPool* ttp) {
+  // #define NOTHREADS to execute the lambdas directly and in order if you need to do that to debug
+
+#ifdef NOTHREADS
+  ORT_UNUSED_PARAMETER(ttp);
+
+  for (int i = 0; i < max; i += step) {
+    std::bind(lambda, i)();
+  }
+#else
+  const int total_tasks = max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
+  concurrency::ThreadPool::TryParallelFor(ttp, total_tasks, cost, [&lambda, step](ptrdiff_t first, ptrdiff_t last) {
+    for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
+      lambda(i * step);
+    }
+  });
+#endif
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
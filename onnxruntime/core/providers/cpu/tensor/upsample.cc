@@ -297,11 +297,189 @@ Status UpsampleLinear(const T* input,
   return Status::OK();
 }
 
+// Input indices and interpolation weights of one axis of a bilinear resize, computed once per shape.
+// The value at output index 'o' is interpolated from the input indices 'in1[o]' and 'in2[o]' with the
+// weights 'd2[o]' and 'd1[o]' respectively. 'outside[o]' is set when the original coordinate falls outside
+// of the input range, in which case the extrapolation value is used if extrapolation is enabled.
+struct BilinearAxisParams {
+  std::vector<int64_t> in1;
+  std::vector<int64_t> in2;
+  std::vector<float> d1;
+  std::vector<float> d2;
+  std::vector<uint8_t> outside;
+};
+
+static BilinearAxisParams SetupBilinearAxis(int64_t input_size,
+                                            int64_t output_size,
+                                            float scale,
+                                            float roi_start,
+                                            float roi_end,
+                                            const GetOriginalCoordinateFunc& get_original_coordinate) {
+  BilinearAxisParams p;
+  p.in1.resize(output_size);
+  p.in2.resize(output_size);
+  p.d1.resize(output_size);
+  p.d2.resize(output_size);
+  p.outside.resize(output_size);
+
+  for (int64_t o = 0; o < output_size; ++o) {
+    float in = scale == 1 ? static_cast<float>(o)
+                          : get_original_coordinate(static_cast<float>(o), scale,
+                                                    static_cast<float>(output_size),
+                                                    static_cast<float>(input_size),
+                                                    roi_start, roi_end);
+    p.outside[o] = in < 0 || in > static_cast<float>(input_size - 1);
+    in = std::max(0.0f, std::min(in, static_cast<float>(input_size - 1)));
+
+    p.in1[o] = std::min(static_cast<int64_t>(in), input_size - 1);
+    p.in2[o] = std::min(p.in1[o] + 1, input_size - 1);
+    p.d1[o] = std::fabs(in - p.in1[o]);
+    p.d2[o] = std::fabs(in - p.in2[o]);
+
+    if (p.in1[o] == p.in2[o]) {
+      p.d1[o] = 0.5f;
+      p.d2[o] = 0.5f;
+    }
+  }
+
+  return p;
+}
+
+// Computes the rows [first_row, last_row) of a bilinear resize, where the rows of all the planes of the
+// input are numbered consecutively. Each output element is interpolated from its 4 input neighbors.
+template <typename T>
+static void BilinearResizeRows(const T* XdataBase,
+                               T* YdataBase,
+                               int64_t input_height,
+                               int64_t input_width,
+                               int64_t output_height,
+                               int64_t output_width,
+                               const BilinearAxisParams& p_y,
+                               const BilinearAxisParams& p_x,
+                               bool use_extrapolation,
+                               float extrapolation_value,
+                               std::ptrdiff_t first_row,
+                               std::ptrdiff_t last_row) {
+  for (std::ptrdiff_t row = first_row; row < last_row; ++row) {
+    const int64_t plane = row / output_height;
+    const int64_t y = row % output_height;
+    const T* Xdata = XdataBase + plane * (input_height * input_width);
+    T* Ydata = YdataBase + row * output_width;
+
+    // when use_extrapolation is set and original index of x or y is out of the dim range
+    // then use extrapolation_value as the output value.
+    if (use_extrapolation && p_y.outside[y]) {
+      std::fill_n(Ydata, output_width, static_cast<T>(extrapolation_value));
+      continue;
+    }
+
+    const T* Xrow1 = Xdata + input_width * p_y.in1[y];
+    const T* Xrow2 = Xdata + input_width * p_y.in2[y];
+    const float dy1 = p_y.d1[y];
+    const float dy2 = p_y.d2[y];
+
+    for (int64_t x = 0; x < output_width; ++x) {
+      if (use_extrapolation && p_x.outside[x]) {
+        Ydata[x] = static_cast<T>(extrapolation_value);
+        continue;
+      }
+
+      T X11 = Xrow1[p_x.in1[x]];
+      T X21 = Xrow1[p_x.in2[x]];
+      T X12 = Xrow2[p_x.in1[x]];
+      T X22 = Xrow2[p_x.in2[x]];
+
+      Ydata[x] = static_cast<T>(p_x.d2[x] * dy2 * X11 +
+                                p_x.d1[x] * dy2 * X21 +
+                                p_x.d2[x] * dy1 * X12 +
+                                p_x.d1[x] * dy1 * X22);
+    }
+  }
+}
+
+// The float version is separable: the two input rows of an output row are first interpolated along the
+// width, and the results are then blended along the height with a loop over contiguous memory that the
+// compiler vectorizes. The two most recent horizontally interpolated rows are kept, so each input row is
+// interpolated along the width only once for consecutive output rows when upsampling.
+template <>
+void BilinearResizeRows<float>(const float* XdataBase,
+                               float* YdataBase,
+                               int64_t input_height,
+                               int64_t input_width,
+                               int64_t output_height,
+                               int64_t output_width,
+                               const BilinearAxisParams& p_y,
+                               const BilinearAxisParams& p_x,
+                               bool use_extrapolation,
+                               float extrapolation_value,
+                               std::ptrdiff_t first_row,
+                               std::ptrdiff_t last_row) {
+  std::vector<float> horizontal(2 * output_width);
+  int64_t cached_rows[2] = {-1, -1};
+
+  const int64_t* in_x1 = p_x.in1.data();
+  const int64_t* in_x2 = p_x.in2.data();
+  const float* dx1 = p_x.d1.data();
+  const float* dx2 = p_x.d2.data();
+
+  // Returns the input row 'input_row' (numbered across all the planes) interpolated along the width,
+  // without evicting the row 'keep_row' from the cache.
+  auto get_horizontal_row = [&](int64_t input_row, int64_t keep_row) -> const float* {
+    for (int slot = 0; slot < 2; ++slot) {
+      if (cached_rows[slot] == input_row) {
+        return horizontal.data() + slot * output_width;
+      }
+    }
+
+    const int slot = cached_rows[0] == keep_row ? 1 : 0;
+    cached_rows[slot] = input_row;
+
+    const float* Xrow = XdataBase + input_row * input_width;
+    float* h = horizontal.data() + slot * output_width;
+    for (int64_t x = 0; x < output_width; ++x) {
+      h[x] = dx2[x] * Xrow[in_x1[x]] + dx1[x] * Xrow[in_x2[x]];
+    }
+    return h;
+  };
+
+  for (std::ptrdiff_t row = first_row; row < last_row; ++row) {
+    const int64_t plane = row / output_height;
+    const int64_t y = row % output_height;
+    float* Ydata = YdataBase + row * output_width;
+
+    if (use_extrapolation && p_y.outside[y]) {
+      std::fill_n(Ydata, output_width, extrapolation_value);
+      continue;
+    }
+
+    const int64_t input_row1 = plane * input_height + p_y.in1[y];
+    const int64_t input_row2 = plane * input_height + p_y.in2[y];
+    const float* h1 = get_horizontal_row(input_row1, input_row2);
+    const float* h2 = get_horizontal_row(input_row2, input_row1);
+    const float dy1 = p_y.d1[y];
+    const float dy2 = p_y.d2[y];
+
+    for (int64_t x = 0; x < output_width; ++x) {
+      Ydata[x] = dy2 * h1[x] + dy1 * h2[x];
+    }
+
+    if (use_extrapolation) {
+      for (int64_t x = 0; x < output_width; ++x) {
+        if (p_x.outside[x]) {
+          Ydata[x] = extrapolation_value;
+        }
+      }
+    }
+  }
+}
+
 // The following method supports a 4-D input in 'Linear mode'
 // that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
 // the scale values for the outermost 2 dimensions are 1.
 // This is the common use-case where the 4-D input (batched multi-channel images)
 // is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
+// The index and weight tables are computed once per axis and the output rows of all the
+// planes are distributed across the thread pool.
 template <typename T>
 void UpsampleBilinear(int64_t batch_size,
                       int64_t num_channels,
@@ -311,134 +489,104 @@ void UpsampleBilinear(int64_t batch_size,
                       int64_t output_width,
                       float height_scale,
                       float width_scale,
-                      const std::vector<float>& roi,
+                      float roi_height_start,
+                      float roi_height_end,
+                      float roi_width_start,
+                      float roi_width_end,
                       bool use_extrapolation,
                       float extrapolation_value,
                       const T* XdataBase,
                       T* YdataBase,
-                      AllocatorPtr& alloc,
-                      GetOriginalCoordinateFunc get_original_coordinate,
+                      const GetOriginalCoordinateFunc& get_original_coordinate,
                       concurrency::ThreadPool* tp) {
-  std::vector<float> y_original;
-  y_original.reserve(output_height);
-
-  std::vector<float> x_original;
-  x_original.reserve(output_width);
-
-  // For each index in the output height and output width, cache its corresponding indices in the input
-  // while multiplying it with the input stride for that dimension (cache because we don't have to re-compute
-  // each time we come across the output width/ output height value while iterating the output image tensor
-  SafeInt<size_t> idx_buffer_size = SafeInt<size_t>(2) * sizeof(int64_t) * (output_height + output_width);
-
-  // For each index in the output height and output width, cache its corresponding "weights/scales" for its
-  // corresponding indices in the input which proportionately indicates how much they will influence the final
-  // pixel value in the output
-  // (cache because we don't have to re-compute each time we come across the output width/ output height value while iterating the output image tensor
-  SafeInt<size_t> scale_buffer_size = SafeInt<size_t>(2) * sizeof(float_t) * (output_height + output_width);
-
-  // Limit number of allocations to just 1
-  auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
-  BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
-
-  // Get pointers to appropriate memory locations in the scratch buffer
-  auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
-
-  // input_width is the stride for the height dimension
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = input_width_mul_y1 + output_height;
-
-  // stride for width is 1 (no multiplication needed)
-  int64_t* in_x1 = input_width_mul_y1 + 2 * output_height;
-  int64_t* in_x2 = in_x1 + output_width;
-
-  auto* scale_data = reinterpret_cast<float*>(in_x2 + output_width);
-
-  float* dy1 = scale_data;
-  float* dy2 = dy1 + output_height;
-
-  float* dx1 = dy1 + 2 * output_height;
-  float* dx2 = dx1 + output_width;
-
-  // Start processing
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    in_y = std::max(0.0f, std::min(in_y, static_cast<float>(input_height - 1)));
-
-    const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
-    const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
-
-    if (in_y1 == in_y2) {
-      dy1[y] = 0.5f;
-      dy2[y] = 0.5f;
-    }
+  const BilinearAxisParams p_y = SetupBilinearAxis(input_height, output_height, height_scale,
+                                                   roi_height_start, roi_height_end, get_original_coordinate);
+  const BilinearAxisParams p_x = SetupBilinearAxis(input_width, output_width, width_scale,
+                                                   roi_width_start, roi_width_end, get_original_coordinate);
+
+  const std::ptrdiff_t num_rows = static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height);
+  const TensorOpCost cost{static_cast<double>(2 * output_width * sizeof(T)),
+                          static_cast<double>(output_width * sizeof(T)),
+                          static_cast<double>(output_width * 8)};
+
+  concurrency::ThreadPool::TryParallelFor(tp, num_rows, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    BilinearResizeRows<T>(XdataBase, YdataBase, input_height, input_width, output_height, output_width,
+                          p_y, p_x, use_extrapolation, extrapolation_value, first, last);
+  });
+}
 
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
-  }
+// The following method supports a 4-D input of shape [N, H, W, C] in 'Linear mode' with the scales
+// [1.0, height_scale, width_scale, 1.0], which is the common layout of images in preprocessing graphs.
+// The channels of a pixel are contiguous, so each output pixel blends 4 input pixels with a loop over
+// the channels using the same weights, and the output rows are distributed across the thread pool.
+template <typename T>
+void UpsampleBilinearNhwc(int64_t batch_size,
+                          int64_t num_channels,
+                          int64_t input_height,
+                          int64_t input_width,
+                          int64_t output_height,
+                          int64_t output_width,
+                          float height_scale,
+                          float width_scale,
+                          float roi_height_start,
+                          float roi_height_end,
+                          float roi_width_start,
+                          float roi_width_end,
+                          bool use_extrapolation,
+                          float extrapolation_value,
+                          const T* XdataBase,
+                          T* YdataBase,
+                          const GetOriginalCoordinateFunc& get_original_coordinate,
+                          concurrency::ThreadPool* tp) {
+  const BilinearAxisParams p_y = SetupBilinearAxis(input_height, output_height, height_scale,
+                                                   roi_height_start, roi_height_end, get_original_coordinate);
+  const BilinearAxisParams p_x = SetupBilinearAxis(input_width, output_width, width_scale,
+                                                   roi_width_start, roi_width_end, get_original_coordinate);
+
+  const std::ptrdiff_t num_rows = static_cast<std::ptrdiff_t>(batch_size * output_height);
+  const int64_t output_row_size = output_width * num_channels;
+  const TensorOpCost cost{static_cast<double>(2 * output_row_size * sizeof(T)),
+                          static_cast<double>(output_row_size * sizeof(T)),
+                          static_cast<double>(output_row_size * 8)};
+
+  concurrency::ThreadPool::TryParallelFor(tp, num_rows, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t n = row / output_height;
+      const int64_t y = row % output_height;
+      T* Ydata = YdataBase + row * output_row_size;
+
+      if (use_extrapolation && p_y.outside[y]) {
+        std::fill_n(Ydata, output_row_size, static_cast<T>(extrapolation_value));
+        continue;
+      }
 
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    in_x = std::max(0.0f, std::min(in_x, static_cast<float>(input_width - 1)));
+      const T* Xdata = XdataBase + n * (input_height * input_width * num_channels);
+      const T* Xrow1 = Xdata + p_y.in1[y] * input_width * num_channels;
+      const T* Xrow2 = Xdata + p_y.in2[y] * input_width * num_channels;
+      const float dy1 = p_y.d1[y];
+      const float dy2 = p_y.d2[y];
 
-    in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
-    in_x2[x] = std::min(in_x1[x] + 1, input_width - 1);
+      for (int64_t x = 0; x < output_width; ++x, Ydata += num_channels) {
+        if (use_extrapolation && p_x.outside[x]) {
+          std::fill_n(Ydata, num_channels, static_cast<T>(extrapolation_value));
+          continue;
+        }
 
-    dx1[x] = std::fabs(in_x - in_x1[x]);
-    dx2[x] = std::fabs(in_x - in_x2[x]);
-    if (in_x1[x] == in_x2[x]) {
-      dx1[x] = 0.5f;
-      dx2[x] = 0.5f;
+        const T* X11 = Xrow1 + p_x.in1[x] * num_channels;
+        const T* X21 = Xrow1 + p_x.in2[x] * num_channels;
+        const T* X12 = Xrow2 + p_x.in1[x] * num_channels;
+        const T* X22 = Xrow2 + p_x.in2[x] * num_channels;
+        const float w11 = p_x.d2[x] * dy2;
+        const float w21 = p_x.d1[x] * dy2;
+        const float w12 = p_x.d2[x] * dy1;
+        const float w22 = p_x.d1[x] * dy1;
+
+        for (int64_t c = 0; c < num_channels; ++c) {
+          Ydata[c] = static_cast<T>(w11 * X11[c] + w21 * X21[c] + w12 * X12[c] + w22 * X22[c]);
+        }
+      }
     }
-  }
-  
- for (int64_t n = 0; n < batch_size; ++n) {
-    concurrency::ThreadPool::TrySimpleParallelFor(tp, num_channels,
-                                                  [&](std::ptrdiff_t c) {
-                                                    const T* Xdata = XdataBase + (n * num_channels + c) * (input_height * input_width);
-                                                    T* Ydata = YdataBase + (n * num_channels + c) * (output_height * output_width);
-                                                    for (int64_t y = 0; y < output_height; ++y) {
-                                                      for (int64_t x = 0; x < output_width; ++x) {
-                                                        // when use_extrapolation is set and original index of x or y is out of the dim range
-                                                        // then use extrapolation_value as the output value.
-                                                        if (use_extrapolation &&
-                                                            ((y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1)) ||
-                                                             (x_original[x] < 0 || x_original[x] > static_cast<float>(input_width - 1)))) {
-                                                          Ydata[output_width * y + x] = static_cast<T>(extrapolation_value);
-                                                          continue;
-                                                        }
-
-                                                        T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-                                                        T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-                                                        T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-                                                        T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
-
-                                                        Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                                                                     dx1[x] * dy2[y] * X21 +
-                                                                                                     dx2[x] * dy1[y] * X12 +
-                                                                                                     dx1[x] * dy1[y] * X22);
-                                                      }
-                                                    }
-                                                    Xdata += input_height * input_width;
-                                                    Ydata += output_width * output_height;
-                                                  });
-  }
+  });
 }
 
 // The following method supports a 5-D input in 'Linear mode'
@@ -649,49 +797,64 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
-
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+// Input indices and interpolation weights of one axis of a bicubic resize, computed once per shape.
+// The value at output index 'o' is interpolated from the 4 input indices starting at 'index[4 * o]'
+// with the weights starting at 'weight[4 * o]'. The indices are clamped to the input range and the
+// weights are already normalized when exclude_outside is set.
+struct CubicAxisParams {
+  std::vector<int64_t> index;
+  std::vector<float> weight;
+  std::vector<uint8_t> outside;
+};
+
+static CubicAxisParams SetupCubicAxis(int64_t input_size,
+                                      int64_t output_size,
+                                      float scale,
+                                      float roi_start,
+                                      float roi_end,
+                                      float cubic_coeff_a,
+                                      bool exclude_outside,
+                                      const GetOriginalCoordinateFunc& get_original_coordinate) {
+  CubicAxisParams p;
+  p.index.resize(CubicModeGridLength * output_size);
+  p.weight.resize(CubicModeGridLength * output_size);
+  p.outside.resize(output_size);
+
+  for (int64_t o = 0; o < output_size; ++o) {
+    float in = scale == 1 ? static_cast<float>(o)
+                          : get_original_coordinate(static_cast<float>(o), scale,
+                                                    static_cast<float>(output_size),
+                                                    static_cast<float>(input_size),
+                                                    roi_start, roi_end);
+    p.outside[o] = in < 0 || in > static_cast<float>(input_size - 1);
+
+    auto in_int = static_cast<int64_t>(std::floor(in));
+    auto coeffs = GetCubicCoeffs(in - in_int, cubic_coeff_a);
+    float coeff_sum = 1;
+
+    if (exclude_outside) {
+      // When true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      coeff_sum = 0;
+      for (int64_t i = 0, val = in_int - 1; val <= in_int + 2; val++, i++) {
+        coeffs[i] = (val < 0 || val >= input_size) ? 0.0f : coeffs[i];
+        coeff_sum += coeffs[i];
+      }
+    }
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[i] / coeff_sum * orig_data;
+    for (int64_t i = 0, val = in_int - 1; val <= in_int + 2; val++, i++) {
+      p.index[CubicModeGridLength * o + i] = std::max(static_cast<int64_t>(0), std::min(val, input_size - 1));
+      p.weight[CubicModeGridLength * o + i] = coeffs[i] / coeff_sum;
+    }
   }
-  cache[grid_start_pos] = result;
 
-  return result;
+  return p;
 }
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
+
+// The bicubic resize is separable: the input rows are first interpolated along the width, and the
+// results are then combined along the height with a loop over contiguous memory that the compiler
+// vectorizes. The index and weight tables are computed once per axis and the planes are distributed
+// across the thread pool.
 template <typename T>
 void ResizeBiCubic(
     int64_t batch_size,
@@ -706,141 +869,88 @@ void ResizeBiCubic(
     bool use_extrapolation,
     float extrapolation_value,
     bool exclude_outside,
-    const std::vector<float>& roi,
-    const T* Xdata,
-    T* Ydata,
-    GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
-  y_original.reserve(output_height);
-
-  std::vector<float> x_original;
-  x_original.reserve(output_width);
-
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
-
-  // generate coefficients in y direction
+    float roi_height_start,
+    float roi_height_end,
+    float roi_width_start,
+    float roi_width_end,
+    const T* XdataBase,
+    T* YdataBase,
+    const GetOriginalCoordinateFunc& get_original_coordinate,
+    concurrency::ThreadPool* tp) {
+  const CubicAxisParams p_y = SetupCubicAxis(input_height, output_height, height_scale, roi_height_start,
+                                             roi_height_end, cubic_coeff_a, exclude_outside, get_original_coordinate);
+  const CubicAxisParams p_x = SetupCubicAxis(input_width, output_width, width_scale, roi_width_start,
+                                             roi_width_end, cubic_coeff_a, exclude_outside, get_original_coordinate);
+
+  // Only interpolate the input rows along the width that contribute to an output row.
+  std::vector<uint8_t> row_used(input_height, 0);
   for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[y] - std::floor(y_original[y]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
+    if (use_extrapolation && p_y.outside[y]) {
+      continue;
     }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[x] - std::floor(x_original[x]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
+    for (size_t i = 0; i < CubicModeGridLength; ++i) {
+      row_used[p_y.index[CubicModeGridLength * y + i]] = 1;
     }
   }
 
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
+  const std::ptrdiff_t num_planes = static_cast<std::ptrdiff_t>(batch_size * num_channels);
+  const TensorOpCost cost{static_cast<double>(input_height * input_width * sizeof(T)),
+                          static_cast<double>(output_height * output_width * sizeof(T)),
+                          static_cast<double>((input_height + output_height) * output_width * 8)};
 
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[y];
+  concurrency::ThreadPool::TryParallelFor(tp, num_planes, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<float> horizontal(input_height * output_width);
+
+    const int64_t* in_x = p_x.index.data();
+    const float* w_x = p_x.weight.data();
+
+    for (std::ptrdiff_t plane = first; plane < last; ++plane) {
+      const T* Xdata = XdataBase + plane * (input_height * input_width);
+      T* Ydata = YdataBase + plane * (output_height * output_width);
 
+      for (int64_t y = 0; y < input_height; ++y) {
+        if (!row_used[y]) {
+          continue;
+        }
+        const T* Xrow = Xdata + y * input_width;
+        float* h = horizontal.data() + y * output_width;
+        for (int64_t x = 0; x < output_width; ++x) {
+          const int64_t* ix = in_x + CubicModeGridLength * x;
+          const float* wx = w_x + CubicModeGridLength * x;
+          h[x] = wx[0] * Xrow[ix[0]] + wx[1] * Xrow[ix[1]] + wx[2] * Xrow[ix[2]] + wx[3] * Xrow[ix[3]];
+        }
+      }
+
+      for (int64_t y = 0; y < output_height; ++y, Ydata += output_width) {
         // when use_extrapolation is set and original index is out of the dim range
         // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
+        if (use_extrapolation && p_y.outside[y]) {
+          std::fill_n(Ydata, output_width, static_cast<T>(extrapolation_value));
           continue;
         }
 
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[i] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[i];
-            y_coeff_sum += y_coeff_holder[i];
-          }
-        }
+        const int64_t* iy = p_y.index.data() + CubicModeGridLength * y;
+        const float* wy = p_y.weight.data() + CubicModeGridLength * y;
+        const float* h0 = horizontal.data() + iy[0] * output_width;
+        const float* h1 = horizontal.data() + iy[1] * output_width;
+        const float* h2 = horizontal.data() + iy[2] * output_width;
+        const float* h3 = horizontal.data() + iy[3] * output_width;
 
         for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[x];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
-          }
+          Ydata[x] = static_cast<T>(h0[x] * wy[0] + h1[x] * wy[1] + h2[x] * wy[2] + h3[x] * wy[3]);
+        }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[i] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[i];
-              x_coeff_sum += x_coeff_holder[i];
+        if (use_extrapolation) {
+          for (int64_t x = 0; x < output_width; ++x) {
+            if (p_x.outside[x]) {
+              Ydata[x] = static_cast<T>(extrapolation_value);
             }
           }
-
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[i] / y_coeff_sum;
-          }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
       }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
     }
-  }
+  });
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -887,8 +997,9 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       // Supports 'bilinear' and 'trilinear' sampling only
 
       //'bilinear' == 2-D input or 4-D input with outermost 2 scales as 1
-      if (dims.size() == 2 || dims.size() == 4) {
+      if (dims.size() == 2 || (dims.size() == 4 && scales[0] == 1 && scales[1] == 1)) {
         bool is_2D = dims.size() == 2;
+        const size_t rank = dims.size();
 
         const int64_t batch_size = is_2D ? 1 : dims[0];
         const int64_t num_channels = is_2D ? 1 : dims[1];
@@ -898,13 +1009,29 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
         const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
 
-        AllocatorPtr alloc;
-        ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
         UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                         is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], roi,
+                         scales[rank - 2], scales[rank - 1],
+                         roi[rank - 2], roi[2 * rank - 2], roi[rank - 1], roi[2 * rank - 1],
                          use_extrapolation_, extrapolation_value_, X->template Data<T>(),
-                         Y->template MutableData<T>(), alloc, get_original_coordinate_, 
-                         output_height*output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                         Y->template MutableData<T>(), get_original_coordinate_,
+                         output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+        return Status::OK();
+      } else if (dims.size() == 4) {
+        //'bilinear' of a 4-D input of shape [N, H, W, C] with the outermost and innermost scales as 1
+        const int64_t batch_size = dims[0];
+        const int64_t input_height = dims[1];
+        const int64_t input_width = dims[2];
+        const int64_t num_channels = dims[3];
+
+        const int64_t output_height = output_dims[1];
+        const int64_t output_width = output_dims[2];
+
+        UpsampleBilinearNhwc(batch_size, num_channels, input_height, input_width, output_height, output_width,
+                             scales[1], scales[2], roi[1], roi[5], roi[2], roi[6],
+                             use_extrapolation_, extrapolation_value_, X->template Data<T>(),
+                             Y->template MutableData<T>(), get_original_coordinate_,
+                             output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool()
+                                                                              : nullptr);
         return Status::OK();
       } else if (dims.size() == 3 || dims.size() == 5) {
         //'trilinear' == 3-D input or 5-D input with outermost 2 scales as 1
@@ -958,10 +1085,14 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
       const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
 
+      const size_t rank = dims.size();
+
       ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                    is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], cubic_coeff_a_, use_extrapolation_,
-                    extrapolation_value_, exclude_outside_, roi, X->template Data<float>(), Y->template MutableData<float>(),
-                    get_original_coordinate_);
+                    scales[rank - 2], scales[rank - 1], cubic_coeff_a_, use_extrapolation_,
+                    extrapolation_value_, exclude_outside_,
+                    roi[rank - 2], roi[2 * rank - 2], roi[rank - 1], roi[2 * rank - 1],
+                    X->template Data<float>(), Y->template MutableData<float>(), get_original_coordinate_,
+                    output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
       return Status::OK();
     }
     default:
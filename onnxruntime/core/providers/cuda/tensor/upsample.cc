@@ -56,6 +56,9 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
   if (roi.size() != 2 * X->Shape().GetDims().size())
     return Status(ONNXRUNTIME, INVALID_ARGUMENT,
                   "Resize: size of roi array should be 2 * N where N is the rank of input tensor X.");
+  if (mode_ == UpsampleMode::LINEAR && rank == 4 && (scales[0] != 1 || scales[1] != 1))
+    return Status(ONNXRUNTIME, NOT_IMPLEMENTED,
+                  "'Linear' mode of a 4-D input is only supported with the outermost 2 scale values being 1.");
 
   Tensor* Y = context->Output(0, output_dims);
 
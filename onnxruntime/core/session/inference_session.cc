@@ -4,9 +4,12 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <cstdlib>
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
+#include <limits>
 #include <list>
 #include <string>
 #include <thread>
@@ -14,6 +17,7 @@
 #include "core/common/denormal.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/arena.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -37,6 +41,7 @@
 #include "core/platform/Barrier.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
+#include "core/platform/tracing.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
@@ -94,6 +99,133 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// Parse an integer session config entry, throwing if it is not a number in [min_value, max_value].
+long GetIntegerConfig(const SessionOptions& session_options, const char* config_key, const char* default_value,
+                      long min_value, long max_value) {
+  const auto config = session_options.GetConfigOrDefault(config_key, default_value);
+  char* end = nullptr;
+  const long value = std::strtol(config.c_str(), &end, 10);
+  ORT_ENFORCE(end != config.c_str() && *end == '\0' && value >= min_value && value <= max_value,
+              "Invalid value for ", config_key, ": ", config);
+  return value;
+}
+
+// Record an event per thread of the pool, on the thread's track, with the change of its counters since the
+// snapshot taken at start_time, and an event with the parallel loops run in the meantime.
+void RecordThreadPoolEvents(profiling::Profiler& profiler, const std::string& pool_name,
+                            const concurrency::ThreadPool* tp, const concurrency::ThreadPoolStats& before,
+                            const TimePoint& start_time) {
+  concurrency::ThreadPoolStats after;
+  if (!concurrency::ThreadPool::GetStats(tp, after) || after.workers.size() != before.workers.size()) {
+    return;
+  }
+
+  for (size_t i = 0; i < after.workers.size(); ++i) {
+    const auto& b = before.workers[i];
+    const auto& a = after.workers[i];
+    profiler.EndTimeAndRecordEvent(profiling::THREAD_POOL_EVENT, pool_name + "_thread_" + std::to_string(i),
+                                   start_time, a.os_thread_id,
+                                   {{"tasks", std::to_string(a.tasks - b.tasks)},
+                                    {"steals", std::to_string(a.steals - b.steals)},
+                                    {"spin_us", std::to_string(a.spin_us - b.spin_us)},
+                                    {"blocked_us", std::to_string(a.blocked_us - b.blocked_us)},
+                                    {"section_joins", std::to_string(a.section_joins - b.section_joins)},
+                                    {"section_entry_us", std::to_string(a.section_entry_us - b.section_entry_us)}});
+  }
+
+  const uint64_t loops = after.loops - before.loops;
+  if (loops > 0) {
+    const double mean_imbalance =
+        (after.total_loop_imbalance - before.total_loop_imbalance) / static_cast<double>(loops);
+    profiler.EndTimeAndRecordEvent(profiling::THREAD_POOL_EVENT, pool_name + "_loops", start_time,
+                                   {{"loops", std::to_string(loops)},
+                                    {"mean_imbalance", std::to_string(mean_imbalance)}});
+  }
+}
+
+void WriteThreadPoolStats(std::ostream& out, const concurrency::ThreadPoolStats& stats) {
+  const double mean_loop_imbalance =
+      stats.loops > 0 ? stats.total_loop_imbalance / static_cast<double>(stats.loops) : 0.0;
+  out << "{\"loops\": " << stats.loops
+      << ", \"mean_loop_imbalance\": " << mean_loop_imbalance
+      << ", \"max_loop_imbalance\": " << stats.max_loop_imbalance
+      << ", \"threads\": [";
+  for (size_t i = 0; i < stats.workers.size(); ++i) {
+    const auto& w = stats.workers[i];
+    out << (i == 0 ? "" : ", ")
+        << "{\"tid\": " << w.os_thread_id
+        << ", \"tasks\": " << w.tasks
+        << ", \"steals\": " << w.steals
+        << ", \"spin_us\": " << w.spin_us
+        << ", \"blocked_us\": " << w.blocked_us
+        << ", \"section_joins\": " << w.section_joins
+        << ", \"section_entry_us\": " << w.section_entry_us << "}";
+  }
+  out << "]}";
+}
+
+void WriteThreadPoolLoad(std::ostream& out, const concurrency::ThreadPoolLoad& load) {
+  out << "{\"queued_tasks\": " << load.queued_tasks
+      << ", \"active_loops\": " << load.active_loops
+      << ", \"active_shares\": " << load.active_shares
+      << ", \"shared_loops\": " << load.shared_loops
+      << ", \"throttled_loops\": " << load.throttled_loops << "}";
+}
+
+void WriteJsonString(std::ostream& out, const std::string& str) {
+  out << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+// Write the statistics of the nodes of the graph that ran, and those of its subgraphs with the names prefixed by
+// the name of their node and attribute.
+void WriteNodeStats(std::ostream& out, const SessionState& session_state, const std::string& prefix,
+                    bool& is_first) {
+  const NodeStats* node_stats = session_state.GetNodeStats();
+  if (node_stats != nullptr) {
+    NodeStats::NodeCounters counters;
+    for (const auto& node : session_state.GetGraphViewer().Nodes()) {
+      node_stats->GetNodeCounters(node.Index(), counters);
+      if (counters.calls == 0) {
+        continue;
+      }
+      out << (is_first ? "" : ", ") << "{\"name\": ";
+      WriteJsonString(out, prefix + (node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name()));
+      out << ", \"op_type\": ";
+      WriteJsonString(out, node.OpType());
+      out << ", \"calls\": " << counters.calls
+          << ", \"total_ns\": " << static_cast<uint64_t>(counters.total_ns)
+          << ", \"max_ns\": " << static_cast<uint64_t>(counters.max_ns)
+          << ", \"output_bytes\": " << counters.output_bytes
+          << ", \"histogram\": [";
+      for (size_t i = 0; i < counters.histogram.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << "{\"le_ns\": " << static_cast<uint64_t>(counters.histogram[i].first)
+            << ", \"calls\": " << counters.histogram[i].second << "}";
+      }
+      out << "]}";
+      is_first = false;
+    }
+  }
+
+  session_state.VisitSubgraphSessionStates(
+      [&](NodeIndex node_index, const std::string& attribute_name, const SessionState& subgraph_session_state) {
+        const auto* node = session_state.GetGraphViewer().GetNode(node_index);
+        const std::string node_name = node == nullptr || node->Name().empty()
+                                          ? MakeString(node == nullptr ? "" : node->OpType(), "_", node_index)
+                                          : node->Name();
+        WriteNodeStats(out, subgraph_session_state, prefix + node_name + "/" + attribute_name + "/", is_first);
+      });
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -228,12 +360,28 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 
   if (use_per_session_threads_) {
     LOGS(*session_logger_, INFO) << "Creating and using per session threadpools since use_per_session_threads_ is true";
+    const bool collect_stats = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigThreadPoolStats, "0") == "1";
+    const long numa_node = GetIntegerConfig(session_options_, kOrtSessionOptionsConfigNumaNode, "-1", -1,
+                                            std::numeric_limits<int>::max());
     {
       OrtThreadPoolParams to = session_options_.intra_op_param;
       if (to.name == nullptr) {
         to.name = ORT_TSTR("intra-op");
       }
       to.set_denormal_as_zero = set_denormal_as_zero;
+      to.collect_stats = collect_stats;
+      to.numa_node = static_cast<int>(numa_node);
+      loop_costs_file_ = session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpLoopCostsFile, "");
+      to.adaptive_loop_costs =
+          !loop_costs_file_.empty() ||
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveLoopCosts, "0") == "1";
+      const auto cpu_sets_config =
+          session_options_.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpThreadAffinities, "");
+      if (!cpu_sets_config.empty()) {
+        status = concurrency::ParseCpuSets(cpu_sets_config, to.cpu_sets);
+        ORT_ENFORCE(status.IsOK(), "Invalid value for ", kOrtSessionOptionsConfigIntraOpThreadAffinities, ": ",
+                    status.ErrorMessage());
+      }
       // If the thread pool can use all the processors, then
       // we set affinity of each thread to each processor.
       to.auto_set_affinity = to.thread_pool_size == 0 &&
@@ -241,6 +389,16 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                              to.affinity_vec_len == 0;
       thread_pool_ =
           concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+      if (thread_pool_ && !loop_costs_file_.empty()) {
+        std::ifstream loop_costs(loop_costs_file_);
+        if (loop_costs) {
+          status = concurrency::ThreadPool::LoadLoopCosts(thread_pool_.get(), loop_costs);
+          if (!status.IsOK()) {
+            LOGS(*session_logger_, WARNING) << "Ignoring the loop costs in " << loop_costs_file_ << ": "
+                                            << status.ErrorMessage();
+          }
+        }
+      }
     }
     if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
       OrtThreadPoolParams to = session_options_.inter_op_param;
@@ -251,6 +409,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
       if (to.name == nullptr)
         to.name = ORT_TSTR("intra-op");
       to.set_denormal_as_zero = set_denormal_as_zero;
+      to.collect_stats = collect_stats;
+      to.numa_node = static_cast<int>(numa_node);
       inter_op_thread_pool_ =
           concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
       if (inter_op_thread_pool_ == nullptr) {
@@ -265,6 +425,22 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
+    // Sessions with a share of the global intra-op pool run their loops on a pool of their own that shares its threads.
+    std::string config_value;
+    const bool has_share = session_options_.TryGetConfigEntry(kOrtSessionOptionsConfigThreadPoolShare, config_value);
+    const bool has_max_parallelism =
+        session_options_.TryGetConfigEntry(kOrtSessionOptionsConfigThreadPoolMaxParallelism, config_value);
+    if (intra_op_thread_pool_from_env_ && (has_share || has_max_parallelism)) {
+      concurrency::ThreadPoolShareOptions share_options;
+      share_options.share = static_cast<unsigned>(
+          GetIntegerConfig(session_options_, kOrtSessionOptionsConfigThreadPoolShare, "1", 1,
+                           std::numeric_limits<int>::max()));
+      share_options.max_degree_of_parallelism = static_cast<int>(
+          GetIntegerConfig(session_options_, kOrtSessionOptionsConfigThreadPoolMaxParallelism, "0", 0,
+                           std::numeric_limits<int>::max()));
+      shared_intra_op_thread_pool_ =
+          onnxruntime::make_unique<concurrency::ThreadPool>(intra_op_thread_pool_from_env_, share_options);
+    }
   }
 
   session_profiler_.Initialize(session_logger_);
@@ -371,6 +547,15 @@ InferenceSession::~InferenceSession() {
     }
   }
 
+  if (thread_pool_ && !loop_costs_file_.empty()) {
+    std::ofstream loop_costs(loop_costs_file_);
+    auto status = concurrency::ThreadPool::SaveLoopCosts(thread_pool_.get(), loop_costs);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, ERROR) << "Failed to save the loop costs to " << loop_costs_file_ << ": "
+                                    << status.ErrorMessage();
+    }
+  }
+
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   if (session_activity_started_)
     TraceLoggingWriteStop(session_activity, "OrtInferenceSessionActivity");
@@ -1466,8 +1651,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
   TimePoint tp;
+  concurrency::ThreadPoolStats intra_op_stats;
+  concurrency::ThreadPoolStats inter_op_stats;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.StartTime();
+    concurrency::ThreadPool::GetStats(GetIntraOpThreadPoolToUse(), intra_op_stats);
+    concurrency::ThreadPool::GetStats(GetInterOpThreadPoolToUse(), inter_op_stats);
   }
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
@@ -1511,6 +1700,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
     }
 
     ++current_num_runs_;
+    ORT_TRACE_PROBE2(run_begin, session_id_, run_options.run_tag.c_str());
 
     // TODO should we add this exec to the list of executors? i guess its not needed now?
 
@@ -1561,6 +1751,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
   }
 
   --current_num_runs_;
+  ORT_TRACE_PROBE2(run_end, session_id_, static_cast<int>(retval.Code()));
 
   // keep track of telemetry
   ++telemetry_.total_runs_since_last_;
@@ -1582,6 +1773,8 @@ Status InferenceSession::Run(const RunOptions& run_options,
 
   // send out profiling events (optional)
   if (session_profiler_.IsEnabled()) {
+    RecordThreadPoolEvents(session_profiler_, "intra_op", GetIntraOpThreadPoolToUse(), intra_op_stats, tp);
+    RecordThreadPoolEvents(session_profiler_, "inter_op", GetInterOpThreadPoolToUse(), inter_op_stats, tp);
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
   }
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
@@ -1688,6 +1881,262 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::AddStatefulInputOutput(const std::string& input_name,
+                                                        const std::string& output_name) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session must be initialized before adding stateful inputs.");
+    }
+  }
+
+  auto input_entry = input_def_map_.find(input_name);
+  if (input_entry == input_def_map_.end()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid stateful input name: ", input_name);
+  }
+
+  auto output_entry = std::find_if(output_def_list_.cbegin(), output_def_list_.cend(),
+                                   [&output_name](const NodeArg* def) { return def->Name() == output_name; });
+  if (output_entry == output_def_list_.cend()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid stateful output name: ", output_name);
+  }
+
+  if (!input_entry->second.ml_data_type->IsTensorType()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stateful input ", input_name, " must be a tensor.");
+  }
+
+  if (utils::GetMLDataType(**output_entry) != input_entry->second.ml_data_type) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stateful input ", input_name, " and output ",
+                           output_name, " have different types.");
+  }
+
+  std::lock_guard<onnxruntime::OrtMutex> l(stream_states_mutex_);
+  if (!stream_states_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Stateful inputs must be added before any stream is run.");
+  }
+
+  for (const auto& entry : stateful_inputs_outputs_) {
+    if (entry.input_name == input_name || entry.output_name == output_name) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stateful input ", input_name, " or output ",
+                             output_name, " was already added.");
+    }
+  }
+
+  stateful_inputs_outputs_.push_back({input_name, output_name});
+  return Status::OK();
+}
+
+common::Status InferenceSession::AllocateStateValue(const OrtValue& like, OrtValue& dst) const {
+  const Tensor& tensor = like.Get<Tensor>();
+  AllocatorPtr allocator = session_state_->GetAllocator(tensor.Location());
+  if (allocator == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "No allocator for the stream state location ", tensor.Location());
+  }
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(tensor.DataType(), tensor.Shape(), allocator);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  dst.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
+common::Status InferenceSession::CopyStateValue(const OrtValue& src, OrtValue& dst) const {
+  if (!src.IsTensor()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stream state values must be tensors.");
+  }
+
+  const Tensor& src_tensor = src.Get<Tensor>();
+  if (!dst.IsAllocated() ||
+      dst.Get<Tensor>().DataType() != src_tensor.DataType() ||
+      dst.Get<Tensor>().Shape() != src_tensor.Shape() ||
+      dst.Get<Tensor>().Location().device != src_tensor.Location().device) {
+    ORT_RETURN_IF_ERROR(AllocateStateValue(src, dst));
+  }
+
+  return data_transfer_mgr_.CopyTensor(src_tensor, *dst.GetMutable<Tensor>());
+}
+
+common::Status InferenceSession::CreateInitialStateValue(const std::string& input_name, OrtValue& dst) const {
+  const auto& input_def = input_def_map_.at(input_name);
+  const TensorShape& shape = input_def.tensor_shape;
+
+  if (shape.NumDimensions() == 0 && input_def.node_arg->Shape() == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stateful input ", input_name,
+                           " has no shape and must be bound on the first Run call of a stream.");
+  }
+
+  for (size_t i = 0; i < shape.NumDimensions(); ++i) {
+    if (shape[i] < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stateful input ", input_name,
+                             " has a symbolic shape and must be bound on the first Run call of a stream.");
+    }
+  }
+
+  AllocatorPtr allocator = session_state_->GetAllocator(execution_providers_.GetDefaultCpuMemoryInfo());
+  MLDataType element_type = input_def.ml_data_type->AsTensorType()->GetElementType();
+
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, allocator);
+  // string elements are already constructed empty by the Tensor constructor
+  if (!p_tensor->IsDataTypeString()) {
+    memset(p_tensor->MutableDataRaw(), 0, p_tensor->SizeInBytes());
+  }
+
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  dst.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, const std::string& stream_id,
+                                     IOBinding& io_binding) {
+  if (stateful_inputs_outputs_.empty()) {
+    return Run(run_options, io_binding);
+  }
+
+  StreamState* stream = nullptr;
+  {
+    // elements of the map are not moved by later insertions, so the stream can be used without the lock
+    std::lock_guard<onnxruntime::OrtMutex> l(stream_states_mutex_);
+    stream = &stream_states_[stream_id];
+    if (stream->in_use) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Stream ", stream_id, " is already running.");
+    }
+    stream->in_use = true;
+  }
+
+  auto release_stream = gsl::finally([this, stream]() {
+    std::lock_guard<onnxruntime::OrtMutex> l(stream_states_mutex_);
+    stream->in_use = false;
+  });
+
+  const size_t num_states = stateful_inputs_outputs_.size();
+  stream->current.resize(num_states);
+  stream->next.resize(num_states);
+
+  const auto& bound_input_names = io_binding.GetInputNames();
+  const auto& bound_inputs = io_binding.GetInputs();
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  feed_names.reserve(bound_input_names.size() + num_states);
+  feeds.reserve(bound_input_names.size() + num_states);
+
+  // a state input bound by the caller replaces the current state of the stream
+  for (size_t i = 0, end = bound_input_names.size(); i < end; ++i) {
+    auto state_entry = std::find_if(stateful_inputs_outputs_.cbegin(), stateful_inputs_outputs_.cend(),
+                                    [&bound_input_names, i](const StatefulInputOutput& entry) {
+                                      return entry.input_name == bound_input_names[i];
+                                    });
+    if (state_entry != stateful_inputs_outputs_.cend()) {
+      size_t state_idx = static_cast<size_t>(state_entry - stateful_inputs_outputs_.cbegin());
+      ORT_RETURN_IF_ERROR(CopyStateValue(bound_inputs[i], stream->current[state_idx]));
+    } else {
+      feed_names.push_back(bound_input_names[i]);
+      feeds.push_back(bound_inputs[i]);
+    }
+  }
+
+  const size_t num_outputs = io_binding.GetOutputNames().size();
+  std::vector<std::string> output_names(io_binding.GetOutputNames());
+  std::vector<OrtValue> fetches(io_binding.GetOutputs());
+  std::vector<OrtDevice> fetches_device_info(io_binding.GetOutputsDeviceInfo());
+  output_names.reserve(num_outputs + num_states);
+  fetches.resize(num_outputs);
+  fetches.reserve(num_outputs + num_states);
+  fetches_device_info.resize(num_outputs);
+  fetches_device_info.reserve(num_outputs + num_states);
+
+  for (size_t i = 0; i < num_states; ++i) {
+    OrtValue& current = stream->current[i];
+    if (!current.IsAllocated()) {
+      ORT_RETURN_IF_ERROR(CreateInitialStateValue(stateful_inputs_outputs_[i].input_name, current));
+    }
+
+    feed_names.push_back(stateful_inputs_outputs_[i].input_name);
+    feeds.push_back(current);
+
+    // the buffer of the state from two Run calls ago receives the new state if its shape still matches,
+    // otherwise the output is allocated by the session and adopted below
+    const Tensor& current_tensor = current.Get<Tensor>();
+    OrtValue& next = stream->next[i];
+    if (next.IsAllocated() && next.Get<Tensor>().Shape() != current_tensor.Shape()) {
+      next = OrtValue();
+    }
+
+    output_names.push_back(stateful_inputs_outputs_[i].output_name);
+    fetches.push_back(next);
+    fetches_device_info.push_back(current_tensor.Location().device);
+  }
+
+  ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, &fetches, &fetches_device_info));
+
+  for (size_t i = 0; i < num_states; ++i) {
+    stream->next[i] = std::move(fetches[num_outputs + i]);
+    std::swap(stream->current[i], stream->next[i]);
+  }
+
+  fetches.resize(num_outputs);
+  io_binding.GetOutputs() = std::move(fetches);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ResetStreamState(const std::string& stream_id) {
+  std::lock_guard<onnxruntime::OrtMutex> l(stream_states_mutex_);
+  auto entry = stream_states_.find(stream_id);
+  if (entry == stream_states_.end()) {
+    return Status::OK();
+  }
+
+  if (entry->second.in_use) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Stream ", stream_id, " is running and can not be reset.");
+  }
+
+  stream_states_.erase(entry);
+  return Status::OK();
+}
+
+common::Status InferenceSession::SnapshotStreamState(const std::string& stream_id,
+                                                     std::vector<OrtValue>& state_values) {
+  std::lock_guard<onnxruntime::OrtMutex> l(stream_states_mutex_);
+  auto entry = stream_states_.find(stream_id);
+  if (entry == stream_states_.end() || entry->second.current.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Stream ", stream_id, " has no state.");
+  }
+
+  if (entry->second.in_use) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Stream ", stream_id, " is running and can not be snapshotted.");
+  }
+
+  const auto& current = entry->second.current;
+  state_values.clear();
+  state_values.resize(current.size());
+  for (size_t i = 0; i < current.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyStateValue(current[i], state_values[i]));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::RestoreStreamState(const std::string& stream_id,
+                                                    const std::vector<OrtValue>& state_values) {
+  if (state_values.size() != stateful_inputs_outputs_.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", stateful_inputs_outputs_.size(),
+                           " stream state values but got ", state_values.size());
+  }
+
+  std::lock_guard<onnxruntime::OrtMutex> l(stream_states_mutex_);
+  auto& stream = stream_states_[stream_id];
+  if (stream.in_use) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Stream ", stream_id, " is running and can not be restored.");
+  }
+
+  stream.current.resize(state_values.size());
+  stream.next.resize(state_values.size());
+  for (size_t i = 0; i < state_values.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyStateValue(state_values[i], stream.current[i]));
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -1726,6 +2175,113 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+std::string InferenceSession::GetThreadPoolStats() const {
+  std::ostringstream ss;
+  ss << "{";
+  concurrency::ThreadPoolStats stats;
+  concurrency::ThreadPoolLoad load;
+  bool is_first = true;
+  if (concurrency::ThreadPool::GetLoad(GetIntraOpThreadPoolToUse(), load)) {
+    ss << "\"intra_op_load\": ";
+    WriteThreadPoolLoad(ss, load);
+    is_first = false;
+  }
+  if (concurrency::ThreadPool::GetLoad(GetInterOpThreadPoolToUse(), load)) {
+    ss << (is_first ? "" : ", ") << "\"inter_op_load\": ";
+    WriteThreadPoolLoad(ss, load);
+    is_first = false;
+  }
+  if (concurrency::ThreadPool::GetStats(GetIntraOpThreadPoolToUse(), stats)) {
+    ss << (is_first ? "" : ", ") << "\"intra_op\": ";
+    WriteThreadPoolStats(ss, stats);
+    is_first = false;
+  }
+  if (concurrency::ThreadPool::GetStats(GetInterOpThreadPoolToUse(), stats)) {
+    ss << (is_first ? "" : ", ") << "\"inter_op\": ";
+    WriteThreadPoolStats(ss, stats);
+  }
+  ss << "}";
+  return ss.str();
+}
+
+std::string InferenceSession::GetNodeStats() const {
+  std::ostringstream ss;
+  ss << "{\"nodes\": [";
+  if (is_inited_) {
+    bool is_first = true;
+    WriteNodeStats(ss, *session_state_, "", is_first);
+  }
+  ss << "]}";
+  return ss.str();
+}
+
+std::string InferenceSession::GetMemoryStats() const {
+  std::ostringstream ss;
+  ss << "{\"arenas\": [";
+  std::unordered_set<const IAllocator*> seen;
+  bool is_first = true;
+  for (const auto& provider : execution_providers_) {
+    for (const auto& allocator : provider->GetAllocators()) {
+      if (allocator->Info().alloc_type != OrtArenaAllocator || !seen.insert(allocator.get()).second) {
+        continue;
+      }
+
+      AllocatorStats stats;
+      static_cast<IArenaAllocator*>(allocator.get())->GetStats(&stats);
+      // Share of the free bytes of the arena that can't be used for an allocation of the largest free block.
+      const int64_t free_bytes = stats.total_allocated_bytes - stats.bytes_in_use;
+      const double fragmentation =
+          free_bytes > 0 ? 1.0 - static_cast<double>(stats.largest_free_block_bytes) / free_bytes : 0.0;
+      ss << (is_first ? "" : ", ") << "{\"name\": ";
+      WriteJsonString(ss, allocator->Info().name);
+      ss << ", \"device_id\": " << allocator->Info().id
+         << ", \"mem_type\": " << allocator->Info().mem_type
+         << ", \"in_use_bytes\": " << stats.bytes_in_use
+         << ", \"peak_in_use_bytes\": " << stats.max_bytes_in_use
+         << ", \"allocated_bytes\": " << stats.total_allocated_bytes
+         << ", \"limit_bytes\": " << stats.bytes_limit
+         << ", \"num_allocs\": " << stats.num_allocs
+         << ", \"max_alloc_bytes\": " << stats.max_alloc_size
+         << ", \"num_extensions\": " << stats.num_arena_extensions
+         << ", \"largest_free_block_bytes\": " << stats.largest_free_block_bytes
+         << ", \"fragmentation\": " << fragmentation << "}";
+      is_first = false;
+    }
+  }
+  ss << "]";
+
+  const MemoryProfiler* memory_profiler = is_inited_ ? session_state_->GetMemoryProfiler() : nullptr;
+  if (memory_profiler) {
+    std::vector<MemoryProfiler::Peak> peaks;
+    size_t num_runs;
+    memory_profiler->GetPeaks(peaks, num_runs);
+    ss << ", \"runs\": " << num_runs << ", \"peaks\": [";
+    for (size_t i = 0; i < peaks.size(); ++i) {
+      const auto& peak = peaks[i];
+      ss << (i == 0 ? "" : ", ") << "{\"location\": ";
+      WriteJsonString(ss, peak.location);
+      ss << ", \"bytes\": " << peak.bytes
+         << ", \"planned_bytes\": " << peak.planned_bytes
+         << ", \"tensors\": [";
+      for (size_t j = 0; j < peak.contributors.size(); ++j) {
+        const auto& contributor = peak.contributors[j];
+        ss << (j == 0 ? "" : ", ") << "{\"name\": ";
+        WriteJsonString(ss, contributor.value_name);
+        ss << ", \"node\": ";
+        WriteJsonString(ss, contributor.node_name);
+        ss << ", \"op_type\": ";
+        WriteJsonString(ss, contributor.op_type);
+        ss << ", \"bytes\": " << contributor.bytes
+           << ", \"planned\": " << (contributor.planned ? "true" : "false") << "}";
+      }
+      ss << "]}";
+    }
+    ss << "]";
+  }
+  ss << "}";
+  return ss.str();
+}
+
 AllocatorPtr InferenceSession::GetAllocator(const OrtMemoryInfo& mem_info) const {
   return session_state_->GetAllocator(mem_info);
 }
@@ -293,6 +293,46 @@ class InferenceSession {
   virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding) ORT_MUST_USE_RESULT;
   common::Status Run(IOBinding& io_binding) ORT_MUST_USE_RESULT;
 
+  /**
+    * Designates a graph input and a graph output as a state pair for stateful streaming.
+    * The value produced for the output by a Run call for a stream is fed to the input by the next Run call
+    * for the same stream. The state values are held in session owned buffers that persist across Run calls,
+    * so they are not copied in and out of the session for every call.
+    * Must be called after Initialize and before any Run call that uses a stream id.
+    * @param input_name name of a graph input.
+    * @param output_name name of a graph output with the same type and shape as the input.
+    */
+  common::Status AddStatefulInputOutput(const std::string& input_name,
+                                        const std::string& output_name) ORT_MUST_USE_RESULT;
+
+  /**
+    * Runs the model for the stream identified by stream_id.
+    * The state inputs are fed from the state buffers of the stream and the state outputs are written to them,
+    * so io_binding only needs to contain the remaining inputs and outputs. A state input bound in io_binding
+    * replaces the current state of the stream. On the first Run call for a stream a state input that is not
+    * bound is initialized with zeros, which requires the input to have a static shape.
+    * Run calls for different streams may be made concurrently. Run calls for the same stream must not.
+    */
+  common::Status Run(const RunOptions& run_options, const std::string& stream_id,
+                     IOBinding& io_binding) ORT_MUST_USE_RESULT;
+
+  /**
+    * Releases the state buffers of a stream. The next Run call for the stream initializes its state again.
+    */
+  common::Status ResetStreamState(const std::string& stream_id) ORT_MUST_USE_RESULT;
+
+  /**
+    * Copies the current state values of a stream, in the order the state pairs were added.
+    */
+  common::Status SnapshotStreamState(const std::string& stream_id,
+                                     std::vector<OrtValue>& state_values) ORT_MUST_USE_RESULT;
+
+  /**
+    * Replaces the state of a stream with values previously returned by SnapshotStreamState.
+    */
+  common::Status RestoreStreamState(const std::string& stream_id,
+                                    const std::vector<OrtValue>& state_values) ORT_MUST_USE_RESULT;
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -376,6 +416,29 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Get the load of the thread pools and the utilization counters of those that collect them,
+    * see kOrtSessionOptionsConfigThreadPoolStats.
+    @return a JSON object with an "intra_op_load" and an "inter_op_load" member for each pool, and an "intra_op" and
+    an "inter_op" member for each pool with counters.
+    */
+  std::string GetThreadPoolStats() const;
+
+  /**
+    * Get the latency statistics of the nodes, see kOrtSessionOptionsConfigNodeStats.
+    @return a JSON object with a "nodes" array with the statistics of each node that ran, including the nodes of
+    subgraphs. Empty if the statistics are not enabled or the session is not initialized.
+    */
+  std::string GetNodeStats() const;
+
+  /**
+    * Get the usage of the arenas of the execution providers, and the memory peaks of the runs if
+    * kOrtSessionOptionsConfigMemoryProfile is enabled.
+    @return a JSON object with an "arenas" array with the statistics of each arena, and if the memory profile is
+    enabled the number of "runs" and a "peaks" array with the highest peak of each location and its largest tensors.
+    */
+  std::string GetMemoryStats() const;
+
   /**
     * Search registered execution providers for an allocator that has characteristics
     * specified within mem_info
@@ -420,7 +483,10 @@ class InferenceSession {
   // specific flags in session options
   // These methods assume that session options have been finalized before the call.
   onnxruntime::concurrency::ThreadPool* GetIntraOpThreadPoolToUse() const {
-    return session_options_.use_per_session_threads ? thread_pool_.get() : intra_op_thread_pool_from_env_;
+    if (session_options_.use_per_session_threads) {
+      return thread_pool_.get();
+    }
+    return shared_intra_op_thread_pool_ ? shared_intra_op_thread_pool_.get() : intra_op_thread_pool_from_env_;
   }
 
   onnxruntime::concurrency::ThreadPool* GetInterOpThreadPoolToUse() const {
@@ -567,11 +633,18 @@ class InferenceSession {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // File the loop costs of thread_pool_ are loaded from and saved to, see kOrtSessionOptionsConfigIntraOpLoopCostsFile.
+  std::string loop_costs_file_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
   onnxruntime::concurrency::ThreadPool* inter_op_thread_pool_from_env_{};
 
+  // Pool sharing the threads of the global intra-op pool, created when the session is given a share of it.
+  // See kOrtSessionOptionsConfigThreadPoolShare.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> shared_intra_op_thread_pool_;
+
   // initialized from session options
   // Determines which threadpools will be intialized and used for the duration of this session.
   // If true, use the per session ones, or else the global threadpools.
@@ -605,6 +678,28 @@ class InferenceSession {
   // Data transfer manager.
   DataTransferManager data_transfer_mgr_;
 
+  struct StatefulInputOutput {
+    std::string input_name;
+    std::string output_name;
+  };
+
+  std::vector<StatefulInputOutput> stateful_inputs_outputs_;
+
+  // State buffers of a stream. current holds the values fed to the state inputs by the next Run call. The state
+  // outputs are written to next, which is then swapped with current, so the values are never copied.
+  struct StreamState {
+    std::vector<OrtValue> current;
+    std::vector<OrtValue> next;
+    bool in_use = false;
+  };
+
+  common::Status CopyStateValue(const OrtValue& src, OrtValue& dst) const;
+  common::Status AllocateStateValue(const OrtValue& like, OrtValue& dst) const;
+  common::Status CreateInitialStateValue(const std::string& input_name, OrtValue& dst) const;
+
+  std::unordered_map<std::string, StreamState> stream_states_;  // GUARDED_BY(stream_states_mutex_)
+  mutable onnxruntime::OrtMutex stream_states_mutex_;
+
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
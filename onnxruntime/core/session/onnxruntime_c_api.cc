@@ -9,10 +9,12 @@
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/utils.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <functional>
 #include <sstream>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -789,6 +791,26 @@ ORT_API_STATUS_IMPL(OrtApis::FillStringTensor, _Inout_ OrtValue* value, _In_ con
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::FillStringTensorContent, _Inout_ OrtValue* value, _In_reads_(s_len) const char* s,
+                    size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len) {
+  TENSOR_READWRITE_API_BEGIN
+  auto len = static_cast<size_t>(tensor->Shape().Size());
+  if (offsets_len != len) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "offsets buffer is not equal to tensor size");
+  }
+
+  std::vector<size_t> string_offsets(offsets, offsets + offsets_len);
+  string_offsets.push_back(s_len);
+  if ((len > 0 && string_offsets[0] != 0) || !std::is_sorted(string_offsets.cbegin(), string_offsets.cend())) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "offsets must start at 0, not decrease and not exceed the data length");
+  }
+
+  tensor->SetStrings(gsl::make_span(s, s_len), string_offsets);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::FillStringTensorElement, _Inout_ OrtValue* value, _In_ const char* s, size_t index) {
   TENSOR_READWRITE_API_BEGIN
   auto* dst = tensor->MutableData<std::string>();
@@ -803,14 +825,25 @@ ORT_API_STATUS_IMPL(OrtApis::FillStringTensorElement, _Inout_ OrtValue* value, _
   API_IMPL_END
 }
 
+// The string readers below use Tensor::StringAt, so they don't create the std::string elements of a tensor
+// whose strings are stored contiguously.
+#define STRING_TENSOR_READ_API_BEGIN                                                            \
+  TENSOR_READ_API_BEGIN                                                                         \
+  if (!tensor.IsDataTypeString()) {                                                             \
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "this API requires a string tensor");    \
+  }
+
 ORT_API_STATUS_IMPL(OrtApis::GetStringTensorDataLength, _In_ const OrtValue* value, _Out_ size_t* out) {
-  TENSOR_READ_API_BEGIN
-  const auto* src = tensor.Data<std::string>();
+  STRING_TENSOR_READ_API_BEGIN
   int64_t len = tensor.Shape().Size();
   if (len >= 0) {
+    if (tensor.HasContiguousStrings()) {
+      *out = tensor.ContiguousStringOffsets()[len];
+      return nullptr;
+    }
     size_t ret = 0;
     for (int64_t i = 0; i != len; ++i) {
-      ret += src[i].size();
+      ret += tensor.StringAt(static_cast<size_t>(i)).size();
     }
     *out = ret;
   } else
@@ -820,11 +853,10 @@ ORT_API_STATUS_IMPL(OrtApis::GetStringTensorDataLength, _In_ const OrtValue* val
 }
 
 ORT_API_STATUS_IMPL(OrtApis::GetStringTensorElementLength, _In_ const OrtValue* value, size_t index, _Out_ size_t* out) {
-  TENSOR_READ_API_BEGIN
-  const auto* src = tensor.Data<std::string>();
+  STRING_TENSOR_READ_API_BEGIN
   auto len = static_cast<size_t>(tensor.Shape().Size());
   if (index < len) {
-    *out = src[index].size();
+    *out = tensor.StringAt(index).size();
   } else
     return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "shape is invalid");
   return nullptr;
@@ -833,16 +865,28 @@ ORT_API_STATUS_IMPL(OrtApis::GetStringTensorElementLength, _In_ const OrtValue*
 
 ORT_API_STATUS_IMPL(OrtApis::GetStringTensorContent, _In_ const OrtValue* value, _Out_writes_bytes_all_(s_len) void* s,
                     size_t s_len, _Out_writes_all_(offsets_len) size_t* offsets, size_t offsets_len) {
-  TENSOR_READ_API_BEGIN
-  const auto* input = tensor.Data<std::string>();
+  STRING_TENSOR_READ_API_BEGIN
   auto len = static_cast<size_t>(tensor.Shape().Size());
   if (offsets_len != len) {
     return OrtApis::CreateStatus(ORT_FAIL, "offsets buffer is not equal to tensor size");
   }
+
+  if (tensor.HasContiguousStrings()) {
+    const size_t* input_offsets = tensor.ContiguousStringOffsets();
+    if (s_len < input_offsets[len]) {
+      return OrtApis::CreateStatus(ORT_FAIL, "output buffer is too small");
+    }
+    if (input_offsets[len] > 0) {
+      memcpy(s, tensor.ContiguousStringChars(), input_offsets[len]);
+    }
+    std::copy(input_offsets, input_offsets + len, offsets);
+    return nullptr;
+  }
+
   {
     size_t ret = 0;
     for (size_t i = 0; i != len; ++i) {
-      ret += input[i].size();
+      ret += tensor.StringAt(i).size();
     }
     if (s_len < ret) {
       return OrtApis::CreateStatus(ORT_FAIL, "output buffer is too small");
@@ -851,30 +895,43 @@ ORT_API_STATUS_IMPL(OrtApis::GetStringTensorContent, _In_ const OrtValue* value,
   size_t f = 0;
   char* p = static_cast<char*>(s);
   for (size_t i = 0; i != len; ++i, ++offsets) {
-    memcpy(p, input[i].data(), input[i].size());
-    p += input[i].size();
+    const auto input = tensor.StringAt(i);
+    memcpy(p, input.data(), input.size());
+    p += input.size();
     *offsets = f;
-    f += input[i].size();
+    f += input.size();
   }
   return nullptr;
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::GetStringTensorContentView, _In_ const OrtValue* value, _Outptr_ const char** s,
+                    _Outptr_ const size_t** offsets) {
+  STRING_TENSOR_READ_API_BEGIN
+  if (!tensor.HasContiguousStrings()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "the strings of this tensor are not stored contiguously, use GetStringTensorContent");
+  }
+  *s = tensor.ContiguousStringChars();
+  *offsets = tensor.ContiguousStringOffsets();
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::GetStringTensorElement, _In_ const OrtValue* value, size_t s_len, size_t index, _Out_writes_bytes_all_(s_len) void* s) {
-  TENSOR_READ_API_BEGIN
-  const auto* input = tensor.Data<std::string>();
+  STRING_TENSOR_READ_API_BEGIN
   auto len = static_cast<size_t>(tensor.Shape().Size());
 
   if (index >= len) {
     return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "element index is out of bounds");
   }
 
-  size_t ret = input[index].size();
-  if (s_len < ret) {
+  const auto input = tensor.StringAt(index);
+  if (s_len < input.size()) {
     return OrtApis::CreateStatus(ORT_FAIL, "buffer size is too small for string");
   }
 
-  memcpy(s, input[index].data(), input[index].size());
+  memcpy(s, input.data(), input.size());
 
   return nullptr;
   API_IMPL_END
@@ -978,6 +1035,33 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetThreadPoolStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetThreadPoolStats(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetNodeStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetNodeStats(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMemoryStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetMemoryStats(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -2043,6 +2127,11 @@ static constexpr OrtApi ort_api_1_to_6 = {
     &OrtApis::CreateEnvWithCustomLoggerAndGlobalThreadPools,
     &OrtApis::OrtSessionOptionsAppendExecutionProvider_CUDA,
     &OrtApis::SetGlobalDenormalAsZero,
+    &OrtApis::SessionGetThreadPoolStats,
+    &OrtApis::SessionGetNodeStats,
+    &OrtApis::SessionGetMemoryStats,
+    &OrtApis::FillStringTensorContent,
+    &OrtApis::GetStringTensorContentView,
 };
 
 // Assert to do a limited check to ensure Version 1 of OrtApi never changes (will detect an addition or deletion but not if they cancel out each other)
@@ -247,4 +247,14 @@ ORT_API_STATUS_IMPL(AddInitializer, _Inout_ OrtSessionOptions* options, _In_ con
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA,
                     _In_ OrtSessionOptions* options, _In_ OrtCUDAProviderOptions* cuda_options);
 ORT_API_STATUS_IMPL(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* options);
+ORT_API_STATUS_IMPL(SessionGetThreadPoolStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetNodeStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(SessionGetMemoryStats, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+ORT_API_STATUS_IMPL(FillStringTensorContent, _Inout_ OrtValue* value, _In_reads_(s_len) const char* s,
+                    size_t s_len, _In_reads_(offsets_len) const size_t* offsets, size_t offsets_len);
+ORT_API_STATUS_IMPL(GetStringTensorContentView, _In_ const OrtValue* value, _Outptr_ const char** s,
+                    _Outptr_ const size_t** offsets);
 }  // namespace OrtApis
@@ -534,6 +534,7 @@ void Im2col<T, StorageOrder::NHWC>::operator()(
   } while (NextPosition(rank, output_shape, d_output.data()));
 }
 
+template struct Im2col<float, StorageOrder::NHWC>;
 template struct Im2col<uint8_t, StorageOrder::NHWC>;
 
 template <>
@@ -1,5 +1,7 @@
 #include "thread_utils.h"
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
 #include <core/common/make_unique.h>
 #ifdef _WIN32
@@ -19,6 +21,12 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   if (options.affinity_vec_len != 0) {
     to.affinity.assign(options.affinity_vec, options.affinity_vec + options.affinity_vec_len);
   }
+  if (options.numa_node >= 0) {
+    ORT_THROW_IF_ERROR(ApplyNumaNode(env->GetNumaNodeCpus(), options));
+    if (options.thread_pool_size == 1)
+      return nullptr;
+  }
+  to.cpu_sets = options.cpu_sets;
   if (options.thread_pool_size <= 0) {  // default
     cpu_list = Env::Default().GetThreadAffinityMasks();
     if (cpu_list.empty() || cpu_list.size() == 1)
@@ -28,6 +36,8 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
       to.affinity = cpu_list;
   }
   to.set_denormal_as_zero = options.set_denormal_as_zero;
+  to.collect_stats = options.collect_stats;
+  to.adaptive_loop_costs = options.adaptive_loop_costs;
 
   return onnxruntime::make_unique<ThreadPool>(env, to, options.name, options.thread_pool_size,
                                               options.allow_spinning);
@@ -52,6 +62,63 @@ CreateThreadPool(Env* env, OrtThreadPoolParams options, ThreadPoolType tpool_typ
 #endif
 }
 
+Status ApplyNumaNode(const std::vector<std::vector<size_t>>& node_cpus, OrtThreadPoolParams& options) {
+  ORT_RETURN_IF_NOT(static_cast<size_t>(options.numa_node) < node_cpus.size() &&
+                        !node_cpus[options.numa_node].empty(),
+                    "NUMA node ", options.numa_node, " has no processors. Number of NUMA nodes: ", node_cpus.size());
+  const auto& cpus = node_cpus[options.numa_node];
+  if (options.thread_pool_size <= 0) {
+    options.thread_pool_size = static_cast<int>(cpus.size());
+  }
+  // Let the threads move between the processors of the node, so no processor is pinned more than once.
+  if (options.cpu_sets.empty()) {
+    options.cpu_sets.push_back(cpus);
+  }
+  return Status::OK();
+}
+
+// Larger processor IDs are rejected rather than expanding a mistyped range into billions of entries.
+static constexpr unsigned long kMaxCpuId = 65535;
+
+Status ParseCpuSets(const std::string& value, std::vector<std::vector<size_t>>& cpu_sets) {
+  cpu_sets.clear();
+  const char* p = value.c_str();
+  while (*p != '\0') {
+    std::vector<size_t> cpus;
+    while (*p != '\0' && *p != ';') {
+      // strtoul also accepts white space and signs, which aren't valid here
+      char* end = nullptr;
+      ORT_RETURN_IF_NOT(std::isdigit(static_cast<unsigned char>(*p)), "Invalid CPU sets: ", value);
+      const unsigned long first = std::strtoul(p, &end, 10);
+      unsigned long last = first;
+      p = end;
+      if (*p == '-') {
+        ++p;
+        ORT_RETURN_IF_NOT(std::isdigit(static_cast<unsigned char>(*p)), "Invalid CPU range in CPU sets: ", value);
+        last = std::strtoul(p, &end, 10);
+        ORT_RETURN_IF_NOT(last >= first, "Invalid CPU range in CPU sets: ", value);
+        p = end;
+      }
+      ORT_RETURN_IF_NOT(last <= kMaxCpuId, "Processor ID out of range in CPU sets: ", value);
+      for (unsigned long cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(static_cast<size_t>(cpu));
+      }
+      if (*p == ',') {
+        ++p;
+        ORT_RETURN_IF_NOT(std::isdigit(static_cast<unsigned char>(*p)), "Invalid CPU sets: ", value);
+      } else {
+        ORT_RETURN_IF_NOT(*p == '\0' || *p == ';', "Invalid CPU sets: ", value);
+      }
+    }
+    ORT_RETURN_IF_NOT(!cpus.empty(), "Empty CPU set in: ", value);
+    cpu_sets.push_back(std::move(cpus));
+    if (*p == ';') {
+      ++p;
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace concurrency
 }  // namespace onnxruntime
 namespace OrtApis {
@@ -6,6 +6,7 @@
 #include "core/session/onnxruntime_c_api.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 struct OrtThreadPoolParams {
   //0: Use default setting. (All the physical cores or half of the logical cores)
@@ -24,10 +25,22 @@ struct OrtThreadPoolParams {
   //If the vector is empty, no explict affinity binding
   size_t* affinity_vec = nullptr;
   size_t affinity_vec_len = 0;
+  //Index is thread id, value is the set of processor IDs the thread can run on. Sets are reused modulo the number
+  //of sets and take precedence over affinity_vec.
+  std::vector<std::vector<size_t>> cpu_sets;
+  //If it is not negative, the threads only run on the processors of this NUMA node (unless cpu_sets is given), and
+  //thread_pool_size = 0 uses all the processors of the node.
+  int numa_node = -1;
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
+
+  // Collect utilization counters of the threads, see ThreadPool::GetStats
+  bool collect_stats = false;
+
+  // Measure the cost of parallel loops instead of trusting the estimates of the callers, see ThreadPool::LoadLoopCosts
+  bool adaptive_loop_costs = false;
 };
 
 struct OrtThreadingOptions {
@@ -47,5 +60,15 @@ enum class ThreadPoolType : uint8_t {
 };
 std::unique_ptr<ThreadPool> CreateThreadPool(Env* env, OrtThreadPoolParams options,
                                              ThreadPoolType tpool_type);
+
+// Restricts the threads of a pool to options.numa_node, given the processors of every NUMA node as returned by
+// Env::GetNumaNodeCpus. A thread_pool_size of 0 becomes the number of processors of the node, and unless cpu_sets is
+// given every thread can run on all of them. Fails if the node doesn't exist or has no processors.
+common::Status ApplyNumaNode(const std::vector<std::vector<size_t>>& node_cpus, OrtThreadPoolParams& options);
+
+// Parses the CPU sets of the threads of a pool, e.g. "0-3,8;4-7,9". Sets are separated by ';' and each is a ','
+// separated list of processor IDs or ranges of them. An empty value gives no sets, empty sets and processor IDs above
+// 65535 are rejected.
+common::Status ParseCpuSets(const std::string& value, std::vector<std::vector<size_t>>& cpu_sets);
 }  // namespace concurrency
 }  // namespace onnxruntime
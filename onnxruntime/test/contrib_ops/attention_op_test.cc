@@ -1359,5 +1359,96 @@ TEST(AttentionTest, AttentionPastState_dynamic) {
   test.Run();
 }
 
+TEST(AttentionTest, PackedAttentionBatch2PartialSequence) {
+  // The first sequence has 2 tokens and the second one 1 token, so the outputs match the real tokens of
+  // AttentionBatch2 and AttentionMaskPartialSequence.
+  int hidden_size = 4;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f,
+      0.8f, -0.5f, 0.0f, 1.f};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  std::vector<int32_t> cumulative_sequence_length_data = {0, 2, 3};
+
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      8.6899995803833008f, -0.13000002503395081f, 4.25f, 5.6499996185302734f};
+
+  for (bool is_weights_constant : {false, true}) {
+    OpTester tester("PackedAttention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+    tester.AddInput<float>("input", {1, 3, hidden_size}, input_data);
+    tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data, is_weights_constant);
+    tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+    tester.AddInput<int32_t>("cumulative_sequence_length", {3}, cumulative_sequence_length_data);
+    tester.AddOutput<float>("output", {1, 3, hidden_size}, output_data);
+    tester.Run();
+  }
+}
+
+TEST(AttentionTest, RemoveAndRestorePadding) {
+  std::vector<float> input_data = {
+      1.f, 2.f, 3.f, 4.f, 5.f, 6.f,
+      7.f, 8.f, 9.f, 10.f, 11.f, 12.f,
+      13.f, 14.f, 15.f, 16.f, 17.f, 18.f};
+
+  // The token counts are clamped to the sequence length.
+  std::vector<int32_t> mask_index = {2, 0, 5};
+
+  std::vector<float> packed_data = {
+      1.f, 2.f, 3.f, 4.f,
+      13.f, 14.f, 15.f, 16.f, 17.f, 18.f};
+  std::vector<int32_t> token_offset_data = {0, 1, -1, -1, -1, -1, 2, 3, 4};
+
+  OpTester remove_padding("RemovePadding", 1, onnxruntime::kMSDomain);
+  remove_padding.AddInput<float>("input", {3, 3, 2}, input_data);
+  remove_padding.AddInput<int32_t>("mask_index", {3}, mask_index);
+  remove_padding.AddOutput<float>("output", {1, 5, 2}, packed_data);
+  remove_padding.AddOutput<int32_t>("token_offset", {3, 3}, token_offset_data);
+  remove_padding.AddOutput<int32_t>("cumulative_sequence_length", {4}, {0, 2, 2, 5});
+  remove_padding.Run();
+
+  std::vector<float> restored_data = {
+      1.f, 2.f, 3.f, 4.f, 0.f, 0.f,
+      0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+      13.f, 14.f, 15.f, 16.f, 17.f, 18.f};
+
+  OpTester restore_padding("RestorePadding", 1, onnxruntime::kMSDomain);
+  restore_padding.AddInput<float>("input", {1, 5, 2}, packed_data);
+  restore_padding.AddInput<int32_t>("token_offset", {3, 3}, token_offset_data);
+  restore_padding.AddOutput<float>("output", {3, 3, 2}, restored_data);
+  restore_padding.Run();
+}
+
+TEST(AttentionTest, RemovePaddingRawMask) {
+  std::vector<float> input_data = {
+      1.f, 2.f, 3.f, 4.f, 5.f, 6.f,
+      7.f, 8.f, 9.f, 10.f, 11.f, 12.f};
+
+  // Any token with a non-zero mask value is kept, including for left-side padding.
+  std::vector<int32_t> mask_data = {0, 1, 1,
+                                    1, 0, 2};
+
+  OpTester tester("RemovePadding", 1, onnxruntime::kMSDomain);
+  tester.AddInput<float>("input", {2, 3, 2}, input_data);
+  tester.AddInput<int32_t>("mask_index", {2, 3}, mask_data);
+  tester.AddOutput<float>("output", {1, 4, 2}, {3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 11.f, 12.f});
+  tester.AddOutput<int32_t>("token_offset", {2, 3}, {-1, 0, 1, 2, -1, 3});
+  tester.AddOutput<int32_t>("cumulative_sequence_length", {3}, {0, 2, 4});
+  tester.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
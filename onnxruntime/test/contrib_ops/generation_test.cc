@@ -0,0 +1,389 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/framework/test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+static const int kVocabSize = 5;
+static const int32_t kPadTokenId = 0;
+static const int32_t kEosTokenId = 4;
+
+static void AddDecoderInputs(Graph& graph, std::vector<NodeArg*>& inputs) {
+  TypeProto int32_tensor;
+  int32_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  int32_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  int32_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+
+  inputs.push_back(&graph.GetOrCreateNodeArg("input_ids", &int32_tensor));
+  inputs.push_back(&graph.GetOrCreateNodeArg("position_ids", &int32_tensor));
+  inputs.push_back(&graph.GetOrCreateNodeArg("attention_mask", &int32_tensor));
+}
+
+// Adds the initializer W with the log probabilities of the next tokens, one row per value that the decoder looks up
+// in it. Tokens that are not listed for a row have a very low logit.
+static NodeArg& AddLogProbabilities(Graph& graph, int64_t rows, int64_t vocab_size,
+                                    const std::vector<std::tuple<int, int, float>>& probabilities) {
+  const float kNever = -1e4f;
+  std::vector<float> w(static_cast<size_t>(rows * vocab_size), kNever);
+  for (const auto& entry : probabilities) {
+    w[std::get<0>(entry) * vocab_size + std::get<1>(entry)] = std::log(std::get<2>(entry));
+  }
+
+  TensorProto weight_tensor;
+  weight_tensor.set_name("W");
+  weight_tensor.add_dims(rows);
+  weight_tensor.add_dims(vocab_size);
+  weight_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  for (float value : w) {
+    weight_tensor.add_float_data(value);
+  }
+  graph.AddInitializedTensor(weight_tensor);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  return graph.GetOrCreateNodeArg("W", &float_tensor);
+}
+
+static NodeArg& CreateLogitsArg(Graph& graph) {
+  TypeProto logits_tensor;
+  logits_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int i = 0; i < 3; i++) {
+    logits_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  }
+  return graph.GetOrCreateNodeArg("logits", &logits_tensor);
+}
+
+// Creates a decoder subgraph without past state, whose logits for the next token only depend on the last token:
+// logits = Gather(W, input_ids).
+static const ONNX_NAMESPACE::GraphProto CreateGatherDecoderSubgraph(
+    int64_t vocab_size, const std::vector<std::tuple<int, int, float>>& probabilities) {
+  Model model("decoder subgraph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{"", 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  std::vector<NodeArg*> inputs;
+  AddDecoderInputs(graph, inputs);
+  auto& weight = AddLogProbabilities(graph, vocab_size, vocab_size, probabilities);
+  auto& logits = CreateLogitsArg(graph);
+
+  graph.AddNode("gather", "Gather", "Logits of the next token", {&weight, inputs[0]}, {&logits});
+
+  graph.SetInputs(inputs);
+  graph.SetOutputs({&logits});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+// Each row of W holds the log probabilities of the tokens that follow a token:
+//   1 -> 2 (0.6) or 3 (0.4)
+//   2 -> eos
+//   3 -> eos (0.9) or 2 (0.1)
+static const ONNX_NAMESPACE::GraphProto CreateDecoderSubgraph() {
+  std::vector<std::tuple<int, int, float>> probabilities{
+      {1, 2, 0.6f}, {1, 3, 0.4f}, {2, kEosTokenId, 1.0f}, {3, kEosTokenId, 0.9f}, {3, 2, 0.1f}};
+  for (int v = 0; v < kVocabSize; v++) {
+    probabilities.emplace_back(0, v, 1.0f / kVocabSize);
+    probabilities.emplace_back(kEosTokenId, v, 1.0f / kVocabSize);
+  }
+  return CreateGatherDecoderSubgraph(kVocabSize, probabilities);
+}
+
+// Number of rows of W of the sum decoder, more than the sum of any sequence of the tests.
+static const int kMaxSum = 32;
+
+// Creates a decoder subgraph whose logits for the next token depend on the sum of all the tokens of the sequence:
+// logits = Gather(W, sum). With past state, the subgraph only sees the new tokens, and the sum is taken over the
+// present state, which is the past state with the new tokens appended as keys and values:
+//   present = Concat(past, [tokens, tokens], axis=3)
+//   sum = ReduceSum(present) / 2
+// so the next tokens are only right if the present state of each step is fed back as the past state of the next
+// step, and follows the beam that it belongs to. Each row of W holds the log probabilities of the tokens that follow
+// a sum:
+//   1 -> 2 (0.6) or 3 (0.4)
+//   3 -> 1 (0.5), 2 (0.3) or 3 (0.2)
+//   4 -> 1 (0.9) or 3 (0.1)
+//   5, 6, 7 and 10 -> eos
+//   8 -> 3 (0.7) or 2 (0.3)
+// and the other sums are followed by any token with the same probability.
+static const ONNX_NAMESPACE::GraphProto CreateSumDecoderSubgraph(bool with_past) {
+  Model model("sum decoder subgraph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{"", 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  std::vector<NodeArg*> inputs;
+  AddDecoderInputs(graph, inputs);
+
+  std::vector<std::tuple<int, int, float>> probabilities{
+      {1, 2, 0.6f}, {1, 3, 0.4f}, {3, 1, 0.5f}, {3, 2, 0.3f}, {3, 3, 0.2f}, {4, 1, 0.9f}, {4, 3, 0.1f},
+      {5, kEosTokenId, 1.0f}, {6, kEosTokenId, 1.0f}, {7, kEosTokenId, 1.0f}, {8, 3, 0.7f}, {8, 2, 0.3f},
+      {10, kEosTokenId, 1.0f}};
+  for (int sum = 0; sum < kMaxSum; sum++) {
+    if (std::none_of(probabilities.cbegin(), probabilities.cend(),
+                     [sum](const std::tuple<int, int, float>& entry) { return std::get<0>(entry) == sum; })) {
+      for (int v = 0; v < kVocabSize; v++) {
+        probabilities.emplace_back(sum, v, 1.0f / kVocabSize);
+      }
+    }
+  }
+  auto& weight = AddLogProbabilities(graph, kMaxSum, kVocabSize, probabilities);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto int32_tensor;
+  int32_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+
+  auto& tokens = graph.GetOrCreateNodeArg("tokens", &float_tensor);
+  auto& sum = graph.GetOrCreateNodeArg("sum", &float_tensor);
+  auto& sum_index = graph.GetOrCreateNodeArg("sum_index", &int32_tensor);
+  auto& next_logits = graph.GetOrCreateNodeArg("next_logits", &float_tensor);
+  auto& logits = CreateLogitsArg(graph);
+
+  graph.AddNode("cast_tokens", "Cast", "", {inputs[0]}, {&tokens})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+
+  std::vector<NodeArg*> outputs{&logits};
+  if (with_past) {
+    // past and present have shape (2, batch_size, num_heads = 1, sequence_length, head_size = 1).
+    TypeProto past_tensor{float_tensor};
+    auto* past_shape = past_tensor.mutable_tensor_type()->mutable_shape();
+    past_shape->add_dim()->set_dim_value(2);
+    past_shape->add_dim();
+    past_shape->add_dim()->set_dim_value(1);
+    past_shape->add_dim();
+    past_shape->add_dim()->set_dim_value(1);
+
+    auto& past = graph.GetOrCreateNodeArg("past_0", &past_tensor);
+    auto& present = graph.GetOrCreateNodeArg("present_0", &past_tensor);
+    auto& token_values = graph.GetOrCreateNodeArg("token_values", &float_tensor);
+    auto& new_state = graph.GetOrCreateNodeArg("new_state", &float_tensor);
+    auto& state_sum = graph.GetOrCreateNodeArg("state_sum", &float_tensor);
+    inputs.push_back(&past);
+    outputs.push_back(&present);
+
+    TensorProto half;
+    half.set_name("half");
+    half.set_data_type(TensorProto_DataType_FLOAT);
+    half.add_float_data(0.5f);
+    graph.AddInitializedTensor(half);
+    auto& half_arg = graph.GetOrCreateNodeArg("half", &float_tensor);
+
+    graph.AddNode("unsqueeze_tokens", "Unsqueeze", "", {&tokens}, {&token_values})
+        .AddAttribute("axes", std::vector<int64_t>{0, 2, 4});
+    graph.AddNode("concat_keys_values", "Concat", "", {&token_values, &token_values}, {&new_state})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    graph.AddNode("concat_past", "Concat", "", {&past, &new_state}, {&present})
+        .AddAttribute("axis", static_cast<int64_t>(3));
+    auto& reduce = graph.AddNode("sum_state", "ReduceSum", "", {&present}, {&state_sum});
+    reduce.AddAttribute("axes", std::vector<int64_t>{0, 2, 3, 4});
+    reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+    graph.AddNode("halve_sum", "Mul", "", {&state_sum, &half_arg}, {&sum});
+  } else {
+    auto& reduce = graph.AddNode("sum_tokens", "ReduceSum", "", {&tokens}, {&sum});
+    reduce.AddAttribute("axes", std::vector<int64_t>{1});
+    reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+  }
+
+  graph.AddNode("cast_sum", "Cast", "", {&sum}, {&sum_index})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+  graph.AddNode("gather", "Gather", "Logits of the next token", {&weight, &sum_index}, {&next_logits});
+  graph.AddNode("unsqueeze_logits", "Unsqueeze", "", {&next_logits}, {&logits})
+      .AddAttribute("axes", std::vector<int64_t>{1});
+
+  graph.SetInputs(inputs);
+  graph.SetOutputs(outputs);
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+TEST(GenerationTest, GreedySearch) {
+  OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+  test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+  test.AddAttribute("decoder", CreateDecoderSubgraph());
+
+  test.AddInput<int32_t>("input_ids", {2, 1}, {1, 3});
+  test.AddInput<int32_t>("max_length", {}, {5});
+
+  // The sequences are padded after eos.
+  test.AddOutput<int32_t>("sequences", {2, 5},
+                          {1, 2, 4, 0, 0,
+                           3, 4, 0, 0, 0});
+  test.Run();
+}
+
+TEST(GenerationTest, GreedySearchInvalidMaxLength) {
+  OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+  test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+  test.AddAttribute("decoder", CreateDecoderSubgraph());
+
+  test.AddInput<int32_t>("input_ids", {1, 2}, {1, 2});
+  test.AddInput<int32_t>("max_length", {}, {2});
+  test.AddOutput<int32_t>("sequences", {1, 2}, {1, 2});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "max_length should be larger than the sequence length");
+}
+
+TEST(GenerationTest, BeamSearch) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+  test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+  test.AddAttribute("decoder", CreateDecoderSubgraph());
+
+  test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+  test.AddInput<int32_t>("max_length", {}, {4});
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddInput<int32_t>("num_beams", {}, {2});
+  test.AddInput<int32_t>("num_return_sequences", {}, {2});
+
+  // 1 2 eos has probability 0.6 and 1 3 eos has probability 0.36. The scores are divided by the length without eos.
+  test.AddOutput<int32_t>("sequences", {1, 2, 4},
+                          {1, 2, 4, 0,
+                           1, 3, 4, 0});
+  test.AddOutput<float>("sequences_scores", {1, 2}, {std::log(0.6f) / 2, std::log(0.36f) / 2});
+  test.Run();
+}
+
+TEST(GenerationTest, GreedySearchWithPastState) {
+  // Only the new tokens are run after the prompt, so the sums are only right if the present state is fed back.
+  // The first prompt is padded on the left.
+  for (bool with_past : {false, true}) {
+    OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+    test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+    test.AddAttribute("decoder", CreateSumDecoderSubgraph(with_past));
+
+    test.AddInput<int32_t>("input_ids", {2, 2}, {0, 1, 1, 2});
+    test.AddInput<int32_t>("max_length", {}, {6});
+
+    test.AddOutput<int32_t>("sequences", {2, 6},
+                            {0, 1, 2, 1, 1, 4,
+                             1, 2, 1, 1, 4, 0});
+    test.Run();
+  }
+}
+
+TEST(GenerationTest, GreedySearchRepetitionPenalty) {
+  // Once 1 and 2 are in the sequence, their log probabilities after 1 2 become -0.69 * 3 and -1.2 * 3, lower than
+  // the -1.6 of 3.
+  OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+  test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+  test.AddAttribute("decoder", CreateSumDecoderSubgraph(true));
+
+  test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+  test.AddInput<int32_t>("max_length", {}, {5});
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddInput<float>("repetition_penalty", {}, {3.0f});
+
+  test.AddOutput<int32_t>("sequences", {1, 5}, {1, 2, 3, 4, 0});
+  test.Run();
+}
+
+TEST(GenerationTest, GreedySearchNoRepeatNgram) {
+  // 3 would repeat the bigram 1 3, so the less likely 2 follows.
+  OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+  test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+  test.AddAttribute<int64_t>("no_repeat_ngram_size", 2);
+  test.AddAttribute("decoder", CreateSumDecoderSubgraph(true));
+
+  test.AddInput<int32_t>("input_ids", {1, 4}, {3, 1, 3, 1});
+  test.AddInput<int32_t>("max_length", {}, {6});
+
+  test.AddOutput<int32_t>("sequences", {1, 6}, {3, 1, 3, 1, 2, 4});
+  test.Run();
+}
+
+TEST(GenerationTest, GreedySearchSampling) {
+  // Only the most likely token is left by top_k = 1, and by a top_p below its probability, so sampling gives the
+  // same sequence as the greedy search.
+  for (bool use_top_k : {true, false}) {
+    OpTester test("GreedySearch", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+    test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+    test.AddAttribute<int64_t>("do_sample", 1);
+    test.AddAttribute<float>("seed", 42.0f);
+    test.AddAttribute("decoder", CreateSumDecoderSubgraph(true));
+
+    test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+    test.AddInput<int32_t>("max_length", {}, {6});
+    test.AddMissingOptionalInput<int32_t>();
+    test.AddMissingOptionalInput<float>();
+    test.AddMissingOptionalInput<float>();
+    if (use_top_k) {
+      test.AddInput<int32_t>("top_k", {}, {1});
+      test.AddMissingOptionalInput<float>();
+    } else {
+      test.AddMissingOptionalInput<int32_t>();
+      test.AddInput<float>("top_p", {}, {0.45f});
+    }
+
+    test.AddOutput<int32_t>("sequences", {1, 6}, {1, 2, 1, 1, 4, 0});
+    test.Run();
+  }
+}
+
+TEST(GenerationTest, BeamSearchReordersBeams) {
+  // After 1 2 (0.6) and 1 3 (0.4), the two best continuations 1 3 1 (0.36) and 1 2 1 (0.3) swap the beams, and
+  // 1 2 1 1 (0.27) and 1 2 1 3 (0.03) then both continue the second beam while 1 3 1 ends. The past state of each
+  // beam has to be gathered from the beam it continues for the sums to be right.
+  for (bool with_past : {false, true}) {
+    OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<int64_t>("eos_token_id", kEosTokenId);
+    test.AddAttribute<int64_t>("pad_token_id", kPadTokenId);
+    test.AddAttribute("decoder", CreateSumDecoderSubgraph(with_past));
+
+    test.AddInput<int32_t>("input_ids", {1, 1}, {1});
+    test.AddInput<int32_t>("max_length", {}, {5});
+    test.AddMissingOptionalInput<int32_t>();
+    test.AddInput<int32_t>("num_beams", {}, {2});
+    test.AddInput<int32_t>("num_return_sequences", {}, {2});
+
+    test.AddOutput<int32_t>("sequences", {1, 2, 5},
+                            {1, 2, 1, 1, 4,
+                             1, 3, 1, 4, 0});
+    test.AddOutput<float>("sequences_scores", {1, 2}, {std::log(0.27f) / 4, std::log(0.36f) / 3});
+    test.Run();
+  }
+}
+
+TEST(GenerationTest, BeamSearchSingleTokenVocabulary) {
+  // The only token is eos, so no beam continues and the rows of the beams are filled with beams that can't be
+  // chosen. Both sequences end after the prompt, the second one from the inactive beam.
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", 0);
+  test.AddAttribute<int64_t>("pad_token_id", 1);
+  test.AddAttribute("decoder", CreateGatherDecoderSubgraph(1, {}));
+
+  test.AddInput<int32_t>("input_ids", {1, 1}, {0});
+  test.AddInput<int32_t>("max_length", {}, {2});
+  test.AddMissingOptionalInput<int32_t>();
+  test.AddInput<int32_t>("num_beams", {}, {2});
+  test.AddInput<int32_t>("num_return_sequences", {}, {2});
+
+  test.AddOutput<int32_t>("sequences", {1, 2, 2},
+                          {0, 0,
+                           0, 0});
+  test.AddOutput<float>("sequences_scores", {1, 2}, {0.0f, -1e9f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -43,5 +43,22 @@ TEST(LayerNormTest, BERTLayerNorm) {
   tester.Run();
 }
 
+TEST(LayerNormTest, LayerNorm_Float16) {
+  OpTester tester("LayerNormalization", 1 /*opset_version*/);
+  tester.AddAttribute<int64_t>("axis", -1);
+  tester.AddAttribute<float>("epsilon", 1e-05f);
+
+  std::vector<int64_t> dims{2, 4};
+  tester.AddInput<MLFloat16>("X", dims, ToFloat16({0.8f, -0.5f, 0.0f, 1.0f,
+                                                   0.5f, 0.2f, 0.3f, -0.6f}));
+  tester.AddInput<MLFloat16>("Scale", {4}, ToFloat16({0.3f, 0.2f, 4.0f, 2.2f}));
+  tester.AddInput<MLFloat16>("B", {4}, ToFloat16({0.2f, 0.1f, 0.4f, 1.6f}));
+  tester.AddOutput<MLFloat16>("Y", dims, ToFloat16({0.4352610f, -0.1724074f, -1.7462404f, 4.0516670f,
+                                                    0.4868467f, 0.1478078f, 2.3123111f, -2.0811989f}));
+  tester.SetOutputAbsErr("Y", 0.005f);
+
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
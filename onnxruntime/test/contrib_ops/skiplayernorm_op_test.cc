@@ -48,7 +48,7 @@ static void RunTest(
 
     test.AddOutput<float>("output", output_dims, output_data);
     test.Run();
-  } else if (HasCudaEnvironment(530 /*min_cuda_architecture*/)) {
+  } else {
     OpTester test("SkipLayerNormalization", 1, onnxruntime::kMSDomain);
     test.AddInput<MLFloat16>("input", input_dims, ToFloat16(input_data));
     test.AddInput<MLFloat16>("skip", skip_dims, ToFloat16(skip_data));
@@ -61,8 +61,14 @@ static void RunTest(
 
     test.AddOutput<MLFloat16>("output", output_dims, ToFloat16(output_data));
 
+    // The float16 rounding of the inputs shifts the larger outputs by about one ulp.
+    test.SetOutputAbsErr("output", 0.005f);
+
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
+    if (HasCudaEnvironment(530 /*min_cuda_architecture*/)) {
+      execution_providers.push_back(DefaultCudaExecutionProvider());
+    }
+    execution_providers.push_back(DefaultCpuExecutionProvider());
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
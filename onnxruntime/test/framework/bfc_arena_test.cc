@@ -284,5 +284,26 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, TestExtensionsAndLargestFreeBlock) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+
+  // The first allocation extends the arena by the 1MiB initial chunk, the second one by another 2MiB region
+  // that it uses entirely.
+  void* first_ptr = a.Alloc(1024);
+  void* second_ptr = a.Alloc(2 * 1048576);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+  EXPECT_EQ(stats.total_allocated_bytes, 3 * 1048576);
+  EXPECT_EQ(stats.largest_free_block_bytes, 1048576 - 1024);
+
+  a.Free(first_ptr);
+  a.Free(second_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+  EXPECT_EQ(stats.largest_free_block_bytes, 2 * 1048576);
+}
 }  // namespace test
 }  // namespace onnxruntime
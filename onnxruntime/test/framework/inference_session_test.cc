@@ -661,6 +661,275 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+#ifndef _OPENMP
+TEST(InferenceSessionTests, CheckRunProfilerWithThreadPoolStats) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfiler";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_thread_pool_stats_test");
+  so.intra_op_param.thread_pool_size = 2;
+  so.AddConfigEntry(kOrtSessionOptionsConfigThreadPoolStats, "1");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  const std::string stats = session_object.GetThreadPoolStats();
+  ASSERT_TRUE(stats.find("\"intra_op\"") != string::npos);
+  ASSERT_TRUE(stats.find("\"threads\"") != string::npos);
+
+  std::string profile_file = session_object.EndProfiling();
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::stringstream content;
+  content << profile.rdbuf();
+
+  // The single intra-op thread has an event with its counters on its own track.
+  ASSERT_TRUE(content.str().find("\"ThreadPool\"") != string::npos);
+  ASSERT_TRUE(content.str().find("intra_op_thread_0") != string::npos);
+  ASSERT_TRUE(content.str().find("blocked_us") != string::npos);
+}
+#endif
+
+TEST(InferenceSessionTests, CheckNodeStats) {
+  SessionOptions so;
+
+  so.session_logid = "CheckNodeStats";
+  so.AddConfigEntry(kOrtSessionOptionsConfigNodeStats, "1");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_EQ(session_object.GetNodeStats(), "{\"nodes\": []}");
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  // The single Mul node has been called twice and output a 3x2 float tensor each time.
+  const std::string stats = session_object.GetNodeStats();
+  ASSERT_TRUE(stats.find("\"name\": \"mul_1\"") != string::npos);
+  ASSERT_TRUE(stats.find("\"op_type\": \"Mul\"") != string::npos);
+  ASSERT_TRUE(stats.find("\"calls\": 2,") != string::npos);
+  ASSERT_TRUE(stats.find("\"output_bytes\": 48") != string::npos);
+  ASSERT_TRUE(stats.find("\"le_ns\"") != string::npos);
+}
+
+TEST(InferenceSessionTests, CheckMemoryStats) {
+  SessionOptions so;
+
+  so.session_logid = "CheckMemoryStats";
+  so.AddConfigEntry(kOrtSessionOptionsConfigMemoryProfile, "1");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  // The CPU arena is listed, and the peak of both runs is the output of the Mul node.
+  const std::string stats = session_object.GetMemoryStats();
+  ASSERT_TRUE(stats.find("{\"name\": \"Cpu\", \"device_id\": 0") != string::npos);
+  ASSERT_TRUE(stats.find("\"fragmentation\"") != string::npos);
+  ASSERT_TRUE(stats.find("\"runs\": 2,") != string::npos);
+  ASSERT_TRUE(stats.find("{\"name\": \"Y\", \"node\": \"mul_1\", \"op_type\": \"Mul\"") != string::npos);
+}
+
+TEST(InferenceSessionTests, CheckKernelReplay) {
+  SessionOptions so;
+
+  so.session_logid = "CheckKernelReplay";
+  so.AddConfigEntry(kOrtSessionOptionsConfigKernelReplay, "1");
+
+  InferenceSessionWrapper session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  const KernelReplay* kernel_replay = session_object.GetSessionState().GetKernelReplay();
+  ASSERT_NE(kernel_replay, nullptr);
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  auto run = [&](const std::vector<float>& values_mul_x, std::vector<OrtValue>& fetches) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, {"Y"}, &fetches));
+  };
+
+  // the first run creates the memory pattern and is executed normally, the next ones are replayed.
+  std::vector<OrtValue> fetches_1;
+  std::vector<OrtValue> fetches_2;
+  std::vector<OrtValue> fetches_3;
+  run({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, fetches_1);
+  ASSERT_EQ(kernel_replay->NumReplays(), 0u);
+  run({6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f}, fetches_2);
+  run({1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f}, fetches_3);
+  ASSERT_EQ(kernel_replay->NumReplays(), 2u);
+
+  // every run returned its own output
+  VerifyOutputs(fetches_1, dims_mul_x, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+  VerifyOutputs(fetches_2, dims_mul_x, {6.0f, 10.0f, 12.0f, 12.0f, 10.0f, 6.0f});
+  VerifyOutputs(fetches_3, dims_mul_x, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+
+  // a pre-allocated output is written by the replay
+  RunOptions run_options;
+  RunModel(session_object, run_options, true);
+  ASSERT_EQ(kernel_replay->NumReplays(), 3u);
+}
+
+// Model with Y = Reshape(X, {3, 2}) * W + B. The Reshape output is created on the buffer of the feed X, and W is an
+// initializer that is also a graph input so it can be overridden by a feed.
+static void CreateReshapeMulAddModel(std::unique_ptr<onnxruntime::Model>& p_model) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 12;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  p_model = onnxruntime::make_unique<Model>("test", true, ModelMetaData(), PathString(),
+                                            IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                            model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = p_model->MainGraph();
+
+  TypeProto tensor_float_2x3;
+  tensor_float_2x3.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float_2x3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_float_2x3.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto tensor_float_3x2;
+  tensor_float_3x2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float_3x2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  tensor_float_3x2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  TypeProto tensor_int64_2;
+  tensor_int64_2.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  tensor_int64_2.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg_x = graph.GetOrCreateNodeArg("X", &tensor_float_2x3);
+  auto& input_arg_w = graph.GetOrCreateNodeArg("W", &tensor_float_3x2);
+  auto& arg_shape = graph.GetOrCreateNodeArg("shape", &tensor_int64_2);
+  auto& arg_b = graph.GetOrCreateNodeArg("B", &tensor_float_3x2);
+  auto& arg_r = graph.GetOrCreateNodeArg("R", &tensor_float_3x2);
+  auto& arg_m = graph.GetOrCreateNodeArg("M", &tensor_float_3x2);
+  auto& output_arg_y = graph.GetOrCreateNodeArg("Y", &tensor_float_3x2);
+
+  graph.AddNode("reshape", "Reshape", "Reshape", {&input_arg_x, &arg_shape}, {&arg_r});
+  graph.AddNode("mul", "Mul", "Mul", {&arg_r, &input_arg_w}, {&arg_m});
+  graph.AddNode("add", "Add", "Add", {&arg_m, &arg_b}, {&output_arg_y});
+
+  TensorProto w;
+  w.set_name("W");
+  w.set_data_type(TensorProto_DataType_FLOAT);
+  w.add_dims(3);
+  w.add_dims(2);
+  for (int i = 1; i <= 6; ++i) w.add_float_data(static_cast<float>(i));
+  graph.AddInitializedTensor(w);
+
+  TensorProto shape;
+  shape.set_name("shape");
+  shape.set_data_type(TensorProto_DataType_INT64);
+  shape.add_dims(2);
+  shape.add_int64_data(3);
+  shape.add_int64_data(2);
+  graph.AddInitializedTensor(shape);
+
+  TensorProto b;
+  b.set_name("B");
+  b.set_data_type(TensorProto_DataType_FLOAT);
+  b.add_dims(3);
+  b.add_dims(2);
+  for (int i = 0; i < 6; ++i) b.add_float_data(10.0f);
+  graph.AddInitializedTensor(b);
+
+  graph.SetInputs({&input_arg_x, &input_arg_w});
+  graph.SetOutputs({&output_arg_y});
+
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(InferenceSessionTests, CheckKernelReplayMultipleNodes) {
+  std::unique_ptr<Model> p_model;
+  CreateReshapeMulAddModel(p_model);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "CheckKernelReplayMultipleNodes";
+  so.graph_optimization_level = TransformerLevel::Default;
+  so.AddConfigEntry(kOrtSessionOptionsConfigKernelReplay, "1");
+
+  std::vector<int64_t> dims_x = {2, 3};
+  std::vector<int64_t> dims_y = {3, 2};
+  auto run = [&](InferenceSession& session, const std::vector<float>& values_x, const std::vector<float>* values_w,
+                 std::vector<OrtValue>& fetches) {
+    auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+    NameMLValMap feeds;
+    OrtValue x;
+    CreateMLValue<float>(allocator, dims_x, values_x, &x);
+    feeds.insert(std::make_pair("X", x));
+    if (values_w) {
+      OrtValue w;
+      CreateMLValue<float>(allocator, dims_y, *values_w, &w);
+      feeds.insert(std::make_pair("W", w));
+    }
+    ASSERT_STATUS_OK(session.Run(RunOptions(), feeds, {"Y"}, &fetches));
+  };
+
+  {
+    InferenceSessionWrapper session_object(so, GetEnvironment());
+    std::stringstream sstr(model_str);
+    ASSERT_STATUS_OK(session_object.Load(sstr));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    const KernelReplay* kernel_replay = session_object.GetSessionState().GetKernelReplay();
+    ASSERT_NE(kernel_replay, nullptr);
+
+    // the Reshape output has to be recreated on the feed of every replay, and the Mul output is kept between them
+    std::vector<OrtValue> fetches_1;
+    std::vector<OrtValue> fetches_2;
+    std::vector<OrtValue> fetches_3;
+    run(session_object, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, nullptr, fetches_1);
+    run(session_object, {6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f}, nullptr, fetches_2);
+    run(session_object, {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f}, nullptr, fetches_3);
+    ASSERT_EQ(kernel_replay->NumReplays(), 2u);
+    VerifyOutputs(fetches_1, dims_y, {11.0f, 14.0f, 19.0f, 26.0f, 35.0f, 46.0f});
+    VerifyOutputs(fetches_2, dims_y, {16.0f, 20.0f, 22.0f, 22.0f, 20.0f, 16.0f});
+    VerifyOutputs(fetches_3, dims_y, {12.0f, 14.0f, 16.0f, 18.0f, 20.0f, 22.0f});
+
+    // feeding W doesn't match the captured feeds, so the run is executed normally
+    std::vector<float> values_w = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    std::vector<OrtValue> fetches_4;
+    run(session_object, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &values_w, fetches_4);
+    ASSERT_EQ(kernel_replay->NumReplays(), 2u);
+    VerifyOutputs(fetches_4, dims_y, {11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f});
+
+    // the captured feeds are still replayed afterwards
+    std::vector<OrtValue> fetches_5;
+    run(session_object, {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f}, nullptr, fetches_5);
+    ASSERT_EQ(kernel_replay->NumReplays(), 3u);
+    VerifyOutputs(fetches_5, dims_y, {11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f});
+  }
+
+  {
+    // a feed that overrides an initializer is released after every replay, so runs that feed W are never captured
+    InferenceSessionWrapper session_object(so, GetEnvironment());
+    std::stringstream sstr(model_str);
+    ASSERT_STATUS_OK(session_object.Load(sstr));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    const KernelReplay* kernel_replay = session_object.GetSessionState().GetKernelReplay();
+
+    std::vector<float> values_w = {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f};
+    for (int i = 0; i < 3; ++i) {
+      std::vector<OrtValue> fetches;
+      run(session_object, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &values_w, fetches);
+      VerifyOutputs(fetches, dims_y, {12.0f, 14.0f, 16.0f, 18.0f, 20.0f, 22.0f});
+    }
+    ASSERT_EQ(kernel_replay->NumReplays(), 0u);
+  }
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerStartTime) {
   // Test whether the InferenceSession can access the profiler's start time
   SessionOptions so;
@@ -897,6 +1166,90 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+// Model that accumulates X into the state S: S_out = X + S, Y = S_out * X
+static void CreateAccumulatorModel(std::unique_ptr<onnxruntime::Model>& p_model) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  p_model = onnxruntime::make_unique<Model>("test", true, ModelMetaData(), PathString(),
+                                            IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                            model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = p_model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg_x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& input_arg_s = graph.GetOrCreateNodeArg("S", &tensor_float);
+  auto& output_arg_s = graph.GetOrCreateNodeArg("S_out", &tensor_float);
+  auto& output_arg_y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+
+  graph.AddNode("add", "Add", "Add", {&input_arg_x, &input_arg_s}, {&output_arg_s});
+  graph.AddNode("mul", "Mul", "Mul", {&output_arg_s, &input_arg_x}, {&output_arg_y});
+  graph.SetOutputs({&output_arg_s, &output_arg_y});
+
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(InferenceSessionTests, TestStreamState) {
+  SessionOptions so;
+  InferenceSession session_object(so, GetEnvironment());
+  std::unique_ptr<Model> p_model;
+  CreateAccumulatorModel(p_model);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  ASSERT_FALSE(session_object.AddStatefulInputOutput("S", "Z").IsOK());
+  ASSERT_FALSE(session_object.AddStatefulInputOutput("Z", "S_out").IsOK());
+  ASSERT_STATUS_OK(session_object.AddStatefulInputOutput("S", "S_out"));
+
+  RunOptions run_options;
+  auto run_stream = [&](const std::string& stream_id, float x, float expected_state) {
+    unique_ptr<IOBinding> io_binding;
+    ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+
+    OrtValue input;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2}, {x, x}, &input);
+    ASSERT_STATUS_OK(io_binding->BindInput("X", input));
+    ASSERT_STATUS_OK(io_binding->BindOutput("Y"));
+
+    ASSERT_STATUS_OK(session_object.Run(run_options, stream_id, *io_binding));
+    ASSERT_EQ(io_binding->GetOutputs().size(), 1u);
+    VerifyOutputs(io_binding->GetOutputs()[0].Get<Tensor>(), {2},
+                  {expected_state * x, expected_state * x});
+  };
+
+  // the state starts at zero and accumulates X independently for each stream
+  run_stream("a", 1.f, 1.f);
+  run_stream("a", 2.f, 3.f);
+  run_stream("b", 1.f, 1.f);
+  run_stream("a", 1.f, 4.f);
+
+  std::vector<OrtValue> snapshot;
+  ASSERT_STATUS_OK(session_object.SnapshotStreamState("a", snapshot));
+  ASSERT_EQ(snapshot.size(), 1u);
+  VerifyOutputs(snapshot[0].Get<Tensor>(), {2}, {4.f, 4.f});
+
+  run_stream("a", 1.f, 5.f);
+  ASSERT_STATUS_OK(session_object.RestoreStreamState("a", snapshot));
+  run_stream("a", 1.f, 5.f);
+
+  // the snapshot is a copy and is not updated by later Run calls
+  VerifyOutputs(snapshot[0].Get<Tensor>(), {2}, {4.f, 4.f});
+
+  ASSERT_STATUS_OK(session_object.ResetStreamState("a"));
+  run_stream("a", 1.f, 1.f);
+  run_stream("b", 1.f, 2.f);
+
+  ASSERT_FALSE(session_object.SnapshotStreamState("c", snapshot).IsOK());
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -2296,6 +2649,46 @@ TEST(InferenceSessionTests, CheckIfPerSessionThreadPoolsAreBeingUsed2) {
   RunModel(session_object, run_options);
 }
 
+// Sessions given a share of the global intra-op tp run their loops on their own pool using the global threads
+TEST(InferenceSessionTests, CheckIfSharedGlobalThreadPoolIsBeingUsed) {
+  SessionOptions so;
+  so.use_per_session_threads = false;
+  so.session_logid = "CheckIfSharedGlobalThreadPoolIsBeingUsed";
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigThreadPoolShare, "4"));
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigThreadPoolMaxParallelism, "2"));
+  auto logging_manager = onnxruntime::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  OrtThreadingOptions tp_options;
+  tp_options.intra_op_thread_pool_params.thread_pool_size = 4;
+  auto st = Environment::Create(std::move(logging_manager), env, &tp_options, true /*create_global_thread_pools*/);
+  ASSERT_TRUE(st.IsOK());
+
+  InferenceSessionTestGlobalThreadPools session_object{so, *env.get()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto intra_tp_from_session = session_object.GetIntraOpThreadPoolToUse();
+  auto intra_tp_from_env = env->GetIntraOpThreadPool();
+  ASSERT_TRUE(intra_tp_from_session == session_object.GetSessionState().GetThreadPool());
+  ASSERT_TRUE(session_object.GetInterOpThreadPoolToUse() == env->GetInterOpThreadPool());
+#ifndef _OPENMP
+  ASSERT_TRUE(intra_tp_from_env != nullptr);
+  ASSERT_FALSE(intra_tp_from_session == intra_tp_from_env);
+  ASSERT_EQ(concurrency::ThreadPool::DegreeOfParallelism(intra_tp_from_session), 2);
+#endif
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+#ifndef _OPENMP
+  const std::string stats = session_object.GetThreadPoolStats();
+  ASSERT_TRUE(stats.find("\"intra_op_load\"") != string::npos);
+#endif
+}
+
 // Test 4: env created WITHOUT global tp / DONT use per session tp --> this should throw an exception
 TEST(InferenceSessionTests, InvalidSessionEnvCombination) {
   SessionOptions so;
@@ -3,9 +3,11 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "gtest/gtest.h"
 
@@ -145,5 +147,133 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                         testing::Values(1, 0));
+
+// Creates a graph with branches of different lengths that are summed. The branches finish in any order,
+// and the sum must only run once all of them are done.
+static std::string CreateMultiBranchModel() {
+  Model model("multi_branch", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  const std::vector<std::vector<std::string>> branches{{"Neg"},
+                                                       {"Neg", "Neg", "Neg", "Neg"},
+                                                       {"Abs", "Neg"},
+                                                       {"Neg", "Abs", "Neg", "Neg", "Abs", "Neg"}};
+  std::vector<NodeArg*> branch_outputs;
+  for (size_t b = 0; b < branches.size(); ++b) {
+    NodeArg* prev = &input;
+    for (size_t n = 0; n < branches[b].size(); ++n) {
+      const std::string name = "branch" + std::to_string(b) + "_" + std::to_string(n);
+      auto& output = graph.GetOrCreateNodeArg(name, &float_tensor);
+      graph.AddNode(name, branches[b][n], "", {prev}, {&output});
+      prev = &output;
+    }
+    branch_outputs.push_back(prev);
+  }
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum", "Sum", "", branch_outputs, {&output});
+  EXPECT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+static void RunMultiBranchModel(InferenceSession& session) {
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3}, {1.f, -2.f, 3.f}, &x);
+  NameMLValMap feeds{{"X", x}};
+
+  // -x + x - |x| - |x|
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(feeds, {"Y"}, &fetches));
+    const auto& y = fetches[0].Get<Tensor>();
+    EXPECT_THAT(std::vector<float>(y.Data<float>(), y.Data<float>() + 3),
+                testing::ElementsAre(-2.f, -4.f, -6.f));
+  }
+}
+
+TEST(ParallelExecutor, TestMultiBranchGraph) {
+  const std::string model_data = CreateMultiBranchModel();
+
+  SessionOptions so;
+  so.session_logid = "TestMultiBranchGraph";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+  ASSERT_EQ(session.GetSessionState().GetStreamExecutionPlan(), nullptr);
+
+  // the paths are computed once by the session state, and count the nodes of a branch and the sum
+  const auto& session_state = session.GetSessionState();
+  const auto& critical_path_lengths = session_state.GetCriticalPathLengths();
+  ASSERT_EQ(critical_path_lengths.size(), session_state.GetGraphViewer().MaxNodeIndex());
+  std::unordered_map<std::string, size_t> lengths_by_name;
+  for (const auto& node : session_state.GetGraphViewer().Nodes()) {
+    lengths_by_name[node.Name()] = critical_path_lengths[node.Index()];
+  }
+  EXPECT_EQ(lengths_by_name["branch0_0"], 2u);
+  EXPECT_EQ(lengths_by_name["branch1_0"], 5u);
+  EXPECT_EQ(lengths_by_name["branch3_0"], 7u);
+  EXPECT_EQ(lengths_by_name["branch3_5"], 2u);
+  EXPECT_EQ(lengths_by_name["sum"], 1u);
+
+  RunMultiBranchModel(session);
+}
+
+TEST(StreamExecutor, TestMultiBranchGraph) {
+  const std::string model_data = CreateMultiBranchModel();
+
+  SessionOptions so;
+  so.session_logid = "TestMultiBranchGraphStreams";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigInterOpNumStreams, "3"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  // the branches are spread over the streams, and every node is in exactly one of them
+  const auto* plan = session.GetSessionState().GetStreamExecutionPlan();
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(plan->streams.size(), 3u);
+  size_t num_nodes = 0;
+  for (const auto& stream : plan->streams) {
+    num_nodes += stream.size();
+  }
+  EXPECT_EQ(num_nodes, static_cast<size_t>(session.GetSessionState().GetGraphViewer().NumberOfNodes()));
+
+  RunMultiBranchModel(session);
+}
+
+TEST(StreamExecutor, TestStatusPropagation) {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  Status status;
+  ASSERT_TRUE((status = registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11)).IsOK()) << status;
+  KernelCreateFn kernel_create_fn = [](const OpKernelInfo& info) { return new typename TestOp::OpKernelImpl(info); };
+  auto kernel_def = TestOp::KernelDef();
+  ASSERT_TRUE((status = registry->RegisterCustomKernel(kernel_def, kernel_create_fn)).IsOK()) << status;
+
+  OpTester tester{"TestOp", 10, TestOp::OpDomain};
+  tester.AddCustomOpRegistry(registry);
+
+  tester.AddInput<int64_t>("action", {1}, {/*failure*/ 1});
+  tester.AddOutput<int64_t>("action_out", {1}, {0});
+  onnxruntime::SessionOptions so;
+  so.session_logid = "TestOp";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.AddConfigEntry(kOrtSessionOptionsConfigInterOpNumStreams, "2"));
+  tester.Run(so, OpTester::ExpectResult::kExpectFailure, "Action was 1", {kTensorrtExecutionProvider}, nullptr,
+             nullptr);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
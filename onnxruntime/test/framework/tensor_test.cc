@@ -178,6 +178,48 @@ TEST(TensorTest, StringTensorTest) {
   }
 }
 
+TEST(TensorTest, ContiguousStringTensorTest) {
+  TensorShape shape({3});
+  auto alloc = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  Tensor t(DataTypeImpl::GetType<std::string>(), shape, alloc);
+
+  const std::string chars = "abcde";
+  const std::vector<size_t> offsets = {0, 2, 2, 5};
+  t.SetStrings(chars, offsets);
+  ASSERT_TRUE(t.HasContiguousStrings());
+  EXPECT_EQ(t.StringAt(0), "ab");
+  EXPECT_TRUE(t.StringAt(1).empty());
+  EXPECT_EQ(t.StringAt(2), "cde");
+  EXPECT_EQ(std::string(t.ContiguousStringChars(), 5), chars);
+  EXPECT_EQ(t.ContiguousStringOffsets()[3], 5u);
+
+  // the std::string elements are created on access and the contiguous strings are kept
+  const std::string* data = t.Data<std::string>();
+  EXPECT_EQ(data[0], "ab");
+  EXPECT_EQ(data[1], "");
+  EXPECT_EQ(data[2], "cde");
+  EXPECT_TRUE(t.HasContiguousStrings());
+
+  Tensor moved(std::move(t));
+  ASSERT_TRUE(moved.HasContiguousStrings());
+  EXPECT_EQ(moved.StringAt(2), "cde");
+
+  // modifying the elements releases the contiguous strings
+  std::string* mutable_data = moved.MutableData<std::string>();
+  EXPECT_FALSE(moved.HasContiguousStrings());
+  mutable_data[0] = "xyz";
+  EXPECT_EQ(moved.StringAt(0), "xyz");
+  EXPECT_EQ(moved.StringAt(2), "cde");
+
+  // the offsets must cover the elements and the chars
+  EXPECT_THROW(moved.SetStrings(chars, std::vector<size_t>{0, 2, 5}), OnnxRuntimeException);
+  EXPECT_THROW(moved.SetStrings(chars, std::vector<size_t>{0, 3, 2, 5}), OnnxRuntimeException);
+  EXPECT_THROW(moved.SetStrings(chars, std::vector<size_t>{0, 2, 2, 4}), OnnxRuntimeException);
+
+  Tensor floats(DataTypeImpl::GetType<float>(), shape, alloc);
+  EXPECT_THROW(floats.SetStrings(chars, offsets), OnnxRuntimeException);
+}
+
 TEST(TensorTest, ConvertToString) {
   TensorShape shape({2, 3, 4});
 
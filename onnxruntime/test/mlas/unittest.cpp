@@ -1236,6 +1236,10 @@ public:
             Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 16, 1, i, i, 1, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
+            Test(1, 16, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(2, 32, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 2, 2, 1, 1);
         }
     }
 
@@ -1257,6 +1261,13 @@ public:
             Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
         }
 
+        // Depthwise convolutions with a channel multiplier.
+        for (unsigned i = 1; i <= 4; i++) {
+            Test(1, 13, 1, 17, 23, i, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 13, 1, 17, 23, i, 3, 3, 0, 1, 1, 0, 1, 1, 2, 2);
+            Test(3, 7, 1, 9, 31, i, 3, 5, 2, 2, 2, 2, 2, 2, 1, 2);
+        }
+
         for (unsigned ic = 0; ic < _countof(cs); ic++) {
             for (unsigned ih = 0; ih < _countof(is); ih++) {
                 for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -1514,6 +1525,64 @@ public:
 
 };
 
+class MlasConvDepthwiseTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferFilter;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+    void
+    Test(
+        size_t Channels,
+        size_t OutputCount,
+        size_t KernelSize,
+        bool UseBias
+        )
+    {
+        const float* Input = BufferInput.GetBuffer(OutputCount * KernelSize * Channels);
+        const float* Filter = BufferFilter.GetBuffer(KernelSize * Channels);
+        const float* Bias = UseBias ? BufferBias.GetBuffer(Channels) : nullptr;
+        float* Output = BufferOutput.GetBuffer(OutputCount * Channels);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputCount * Channels);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasReluActivation;
+
+        MlasConvDepthwise(Input, Filter, Bias, Output, Channels, OutputCount, KernelSize, &Activation);
+
+        for (size_t n = 0; n < OutputCount; n++) {
+            for (size_t c = 0; c < Channels; c++) {
+                float Accumulator = (Bias != nullptr) ? Bias[c] : 0.0f;
+                for (size_t k = 0; k < KernelSize; k++) {
+                    Accumulator += Input[(n * KernelSize + k) * Channels + c] * Filter[k * Channels + c];
+                }
+                OutputReference[n * Channels + c] = std::max(Accumulator, 0.0f);
+            }
+        }
+
+        if (memcmp(Output, OutputReference, OutputCount * Channels * sizeof(float)) != 0) {
+            printf("mismatch ConvDepthwise: Channels=%zd, OutputCount=%zd, KernelSize=%zd, Bias=%d\n",
+                Channels, OutputCount, KernelSize, int(UseBias));
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t c = 1; c < 64; c++) {
+            Test(c, 1, 1, false);
+            Test(c, 7, 9, true);
+            Test(c, 12, 25, false);
+        }
+    }
+};
+
 class MlasPool2DTest : public MlasTestBase
 {
 protected:
@@ -2405,22 +2474,25 @@ private:
         size_t N,
         size_t D,
         float MinimumValue,
-        float MaximumValue
+        float MaximumValue,
+        size_t Stride = 1
         )
     {
-        float* Input = BufferInput.GetBuffer(N * D);
-        float* Output = BufferOutput.GetBuffer(N * D);
-        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+        const size_t ElementCount = N * D * Stride;
 
-        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        float* Input = BufferInput.GetBuffer(ElementCount);
+        float* Output = BufferOutput.GetBuffer(ElementCount);
+        float* OutputReference = BufferOutputReference.GetBuffer(ElementCount);
+
+        std::default_random_engine generator(static_cast<unsigned>(ElementCount));
         std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
 
-        for (size_t nd = 0; nd < N * D; nd++) {
+        for (size_t nd = 0; nd < ElementCount; nd++) {
             Input[nd] = distribution(generator);
         }
 
-        Test(Input, Output, OutputReference, N, D, false);
-        Test(Input, Output, OutputReference, N, D, true);
+        Test(Input, Output, OutputReference, N, D, Stride, false);
+        Test(Input, Output, OutputReference, N, D, Stride, true);
     }
 
     void
@@ -2430,19 +2502,24 @@ private:
         float* OutputReference,
         size_t N,
         size_t D,
+        size_t Stride,
         bool LogSoftmax
         )
     {
-        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
-        ReferenceSoftmax(Input, OutputReference, N, D, LogSoftmax);
+        if (Stride == 1) {
+            MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
+        } else {
+            MlasComputeSoftmaxStrided(Input, Output, N, D, Stride, LogSoftmax, threadpool);
+        }
+        ReferenceSoftmax(Input, OutputReference, N, D, Stride, LogSoftmax);
 
         constexpr float AbsoluteTolerance = 1e-6f;
         constexpr float RelativeTolerance = 1e-6f;
 
-        for (size_t nd = 0; nd < N * D; nd++) {
+        for (size_t nd = 0; nd < N * D * Stride; nd++) {
             float diff = std::fabs(Output[nd] - OutputReference[nd]);
             if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[nd]) * RelativeTolerance) {
-                printf("softmax(%d) difference: %u/%u %.8f %.8f\n", int32_t(LogSoftmax), unsigned(N), unsigned(D), Output[nd], OutputReference[nd]);
+                printf("softmax(%d) difference: %u/%u/%u %.8f %.8f\n", int32_t(LogSoftmax), unsigned(N), unsigned(D), unsigned(Stride), Output[nd], OutputReference[nd]);
             }
         }
     }
@@ -2453,23 +2530,27 @@ private:
         float* Output,
         size_t N,
         size_t D,
+        size_t Stride,
         bool LogSoftmax
         )
     {
-        for (size_t n = 0; n < N; n++) {
+        for (size_t n = 0; n < N * Stride; n++) {
+
+            const float* input = Input + (n / Stride) * D * Stride + (n % Stride);
+            float* output = Output + (n / Stride) * D * Stride + (n % Stride);
 
             float MaximumValue = std::numeric_limits<float>::lowest();
 
             for (size_t d = 0; d < D; d++) {
-                MaximumValue = (std::max)(MaximumValue, Input[d]);
+                MaximumValue = (std::max)(MaximumValue, input[d * Stride]);
             }
 
             double Sum = 0.0;
 
             for (size_t d = 0; d < D; d++) {
-                double e = std::exp(double(Input[d]) - double(MaximumValue));
+                double e = std::exp(double(input[d * Stride]) - double(MaximumValue));
                 Sum += e;
-                Output[d] = float(e);
+                output[d * Stride] = float(e);
             }
 
             if (LogSoftmax) {
@@ -2477,7 +2558,7 @@ private:
                 float Scale = float(std::log(Sum));
 
                 for (size_t d = 0; d < D; d++) {
-                    Output[d] = Input[d] - MaximumValue - Scale;
+                    output[d * Stride] = input[d * Stride] - MaximumValue - Scale;
                 }
 
             } else {
@@ -2485,12 +2566,9 @@ private:
                 float Scale = float(Sum);
 
                 for (size_t d = 0; d < D; d++) {
-                    Output[d] /= Scale;
+                    output[d * Stride] /= Scale;
                 }
             }
-
-            Input += D;
-            Output += D;
         }
     }
 
@@ -2507,6 +2585,184 @@ public:
         Test(3, 128, 20.f, 30.f);
         Test(63, 95, -150.f, 190.f);
         Test(16, 211, 20.f, 30.f);
+
+        for (size_t s = 2; s < 20; s++) {
+            Test(3, 7, -10.f, 10.f, s);
+        }
+
+        Test(1, 1, -10.f, 10.f, 37);
+        Test(2, 21, -150.f, 190.f, 128);
+        Test(5, 19, 20.f, 30.f, 301);
+        Test(1, 150, -10.f, 10.f, 1024);
+    }
+};
+
+class MlasLayerNormTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferSkip;
+    MatrixGuardBuffer<float> BufferSkipBias;
+    MatrixGuardBuffer<float> BufferScale;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferMean;
+    MatrixGuardBuffer<float> BufferInverseStdDev;
+
+    void
+    Test(
+        size_t N,
+        size_t D,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Skip = BufferSkip.GetBuffer(N * D);
+        float* SkipBias = BufferSkipBias.GetBuffer(D);
+        float* Scale = BufferScale.GetBuffer(D);
+        float* Bias = BufferBias.GetBuffer(D);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = distribution(generator);
+            Skip[nd] = distribution(generator);
+        }
+
+        for (size_t d = 0; d < D; d++) {
+            SkipBias[d] = distribution(generator);
+            Scale[d] = distribution(generator);
+            Bias[d] = distribution(generator);
+        }
+
+        Test(Input, nullptr, nullptr, Scale, Bias, N, D, false);
+        Test(Input, nullptr, nullptr, Scale, Bias, N, D, true);
+        Test(Input, Skip, nullptr, Scale, Bias, N, D, false);
+        Test(Input, Skip, SkipBias, Scale, Bias, N, D, false);
+    }
+
+    void
+    Test(
+        const float* Input,
+        const float* Skip,
+        const float* SkipBias,
+        const float* Scale,
+        const float* Bias,
+        size_t N,
+        size_t D,
+        bool Simplified
+        )
+    {
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+        float* Mean = BufferMean.GetBuffer(N);
+        float* InverseStdDev = BufferInverseStdDev.GetBuffer(N);
+
+        constexpr float Epsilon = 1e-5f;
+
+        MlasComputeLayerNormalization(Input, Skip, SkipBias, Scale, Bias, Output, Mean,
+            InverseStdDev, N, D, Epsilon, Simplified, threadpool);
+
+        constexpr float AbsoluteTolerance = 1e-4f;
+        constexpr float RelativeTolerance = 1e-4f;
+
+        for (size_t n = 0; n < N; n++) {
+
+            double ReferenceMean;
+            double ReferenceInverseStdDev;
+
+            ReferenceLayerNorm(Input + n * D, (Skip != nullptr) ? Skip + n * D : nullptr, SkipBias,
+                Scale, Bias, OutputReference + n * D, D, Epsilon, Simplified, &ReferenceMean,
+                &ReferenceInverseStdDev);
+
+            if (std::fabs(InverseStdDev[n] - ReferenceInverseStdDev) > std::fabs(ReferenceInverseStdDev) * RelativeTolerance) {
+                printf("layernorm(%d) inverse stddev difference: %u/%u %.8f %.8f\n", int32_t(Simplified),
+                    unsigned(N), unsigned(D), InverseStdDev[n], float(ReferenceInverseStdDev));
+            }
+
+            if (!Simplified && std::fabs(Mean[n] - ReferenceMean) > AbsoluteTolerance) {
+                printf("layernorm(%d) mean difference: %u/%u %.8f %.8f\n", int32_t(Simplified),
+                    unsigned(N), unsigned(D), Mean[n], float(ReferenceMean));
+            }
+        }
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            float diff = std::fabs(Output[nd] - OutputReference[nd]);
+            if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[nd]) * RelativeTolerance) {
+                printf("layernorm(%d) difference: %u/%u %.8f %.8f\n", int32_t(Simplified),
+                    unsigned(N), unsigned(D), Output[nd], OutputReference[nd]);
+            }
+        }
+    }
+
+    void
+    ReferenceLayerNorm(
+        const float* Input,
+        const float* Skip,
+        const float* SkipBias,
+        const float* Scale,
+        const float* Bias,
+        float* Output,
+        size_t D,
+        float Epsilon,
+        bool Simplified,
+        double* Mean,
+        double* InverseStdDev
+        )
+    {
+        std::vector<double> Values(D);
+
+        double Sum = 0.0;
+
+        for (size_t d = 0; d < D; d++) {
+            double Value = Input[d];
+            if (Skip != nullptr) {
+                Value += Skip[d];
+                if (SkipBias != nullptr) {
+                    Value += SkipBias[d];
+                }
+            }
+            Values[d] = Value;
+            Sum += Value;
+        }
+
+        *Mean = Simplified ? 0.0 : Sum / D;
+
+        double Variance = 0.0;
+
+        for (size_t d = 0; d < D; d++) {
+            double Centered = Values[d] - *Mean;
+            Variance += Centered * Centered;
+        }
+
+        *InverseStdDev = 1.0 / std::sqrt(Variance / D + Epsilon);
+
+        for (size_t d = 0; d < D; d++) {
+            double Value = (Values[d] - *Mean) * *InverseStdDev * Scale[d];
+            if (!Simplified) {
+                Value += Bias[d];
+            }
+            Output[d] = float(Value);
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 80; d++) {
+            Test(1, d, -10.f, 10.f);
+        }
+
+        Test(3, 128, 20.f, 30.f);
+        Test(63, 95, -5.f, 5.f);
+        Test(16, 768, -1.f, 1.f);
+        Test(7, 1024, -3.f, 7.f);
     }
 };
 
@@ -2564,6 +2820,279 @@ public:
     }
 };
 
+class MlasTranscendentalTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+    static
+    double
+    GeluReference(
+        double x
+        )
+    {
+        return 0.5 * x * (1.0 + std::erf(x * M_SQRT1_2));
+    }
+
+    static
+    double
+    FastGeluReference(
+        double x
+        )
+    {
+        return 0.5 * x * (1.0 + std::tanh(0.7978845608028654 * (x + 0.044715 * x * x * x)));
+    }
+
+    static
+    double
+    SoftplusReference(
+        double x
+        )
+    {
+        return std::max(x, 0.0) + std::log1p(std::exp(-std::fabs(x)));
+    }
+
+    void
+    Check(
+        const char* Name,
+        size_t N,
+        const float* Input,
+        const float* Output,
+        const float* OutputReference,
+        float AbsoluteTolerance,
+        float RelativeTolerance
+        )
+    {
+        for (size_t n = 0; n < N; n++) {
+            if (std::isnan(OutputReference[n])) {
+                if (!std::isnan(Output[n])) {
+                    printf("%s difference: %u %.8g %.8g %.8g\n", Name, unsigned(N), Input[n], Output[n], OutputReference[n]);
+                }
+                continue;
+            }
+            if (std::isinf(OutputReference[n])) {
+                if (Output[n] != OutputReference[n]) {
+                    printf("%s difference: %u %.8g %.8g %.8g\n", Name, unsigned(N), Input[n], Output[n], OutputReference[n]);
+                }
+                continue;
+            }
+            float diff = std::fabs(Output[n] - OutputReference[n]);
+            if (!(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[n]) * RelativeTolerance)) {
+                printf("%s difference: %u %.8g %.8g %.8g\n", Name, unsigned(N), Input[n], Output[n], OutputReference[n]);
+            }
+        }
+    }
+
+    void
+    Test(
+        size_t N,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Bias = BufferBias.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+        float* OutputReference = BufferOutputReference.GetBuffer(N);
+
+        std::default_random_engine generator(static_cast<unsigned>(N));
+        std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = distribution(generator);
+            Bias[n] = distribution(generator);
+        }
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(std::log(std::fabs(double(Input[n]))));
+            Output[n] = std::fabs(Input[n]);
+        }
+        MlasComputeLog(Output, Output, N);
+        Check("log", N, Input, Output, OutputReference, 1e-6f, 1e-6f);
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(1.0 / std::sqrt(std::fabs(double(Input[n]))));
+            Output[n] = std::fabs(Input[n]);
+        }
+        MlasComputeReciprocalSqrt(Output, Output, N, MlasComputeModeAccurate);
+        Check("rsqrt", N, Input, Output, OutputReference, 0.0f, 1e-6f);
+        for (size_t n = 0; n < N; n++) {
+            Output[n] = std::fabs(Input[n]);
+        }
+        MlasComputeReciprocalSqrt(Output, Output, N, MlasComputeModeFast);
+        Check("rsqrt fast", N, Input, Output, OutputReference, 0.0f, 1e-5f);
+
+        static const float Exponents[] = { 0.0f, 1.0f, 2.0f, 3.0f, -1.0f, 0.5f, -2.0f, 5.0f, 1.7f, -0.3f };
+
+        for (float Exponent : Exponents) {
+            for (size_t n = 0; n < N; n++) {
+                OutputReference[n] = float(std::pow(double(Input[n]), double(Exponent)));
+            }
+            MlasComputePow(Input, Output, N, Exponent);
+            Check("pow", N, Input, Output, OutputReference, 1e-6f, 1e-5f);
+        }
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(GeluReference(Input[n]));
+        }
+        MlasComputeGelu(Input, nullptr, Output, N, MlasComputeModeAccurate);
+        Check("gelu", N, Input, Output, OutputReference, 1e-6f, 1e-5f);
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(GeluReference(double(Input[n] + Bias[n])));
+        }
+        MlasComputeGelu(Input, Bias, Output, N, MlasComputeModeAccurate);
+        Check("gelu bias", N, Input, Output, OutputReference, 1e-6f, 1e-5f);
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(FastGeluReference(double(Input[n] + Bias[n])));
+        }
+        MlasComputeGelu(Input, Bias, Output, N, MlasComputeModeFast);
+        Check("fast gelu bias", N, Input, Output, OutputReference, 1e-5f, 1e-5f);
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(double(Input[n]) / (1.0 + std::exp(-1.5 * double(Input[n]))));
+        }
+        MlasComputeSwish(Input, Output, N, 1.5f);
+        Check("swish", N, Input, Output, OutputReference, 1e-6f, 1e-5f);
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(SoftplusReference(Input[n]));
+        }
+        MlasComputeSoftplus(Input, Output, N);
+        Check("softplus", N, Input, Output, OutputReference, 1e-6f, 1e-5f);
+    }
+
+    void
+    TestSpecialValues(
+        void
+        )
+    {
+        const float Infinity = std::numeric_limits<float>::infinity();
+        const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+        const float Input[] = {
+            0.0f, -0.0f, 1.0f, -1.0f, Infinity, -Infinity, NaN,
+            std::numeric_limits<float>::denorm_min(), 1e-40f, std::numeric_limits<float>::min(),
+            std::numeric_limits<float>::max(), -2.0f, -0.5f, 100.0f, -100.0f,
+        };
+        constexpr size_t N = _countof(Input);
+
+        float Output[N];
+        float OutputReference[N];
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(std::log(double(Input[n])));
+        }
+        MlasComputeLog(Input, Output, N);
+        Check("log special", N, Input, Output, OutputReference, 0.0f, 1e-6f);
+
+        static const float Exponents[] = { 2.0f, 3.0f, -1.0f, 0.5f, -2.0f, 5.0f, -0.3f, Infinity, NaN };
+
+        for (float Exponent : Exponents) {
+            for (size_t n = 0; n < N; n++) {
+                OutputReference[n] = float(std::pow(double(Input[n]), double(Exponent)));
+            }
+            MlasComputePow(Input, Output, N, Exponent);
+            Check("pow special", N, Input, Output, OutputReference, 0.0f, 1e-5f);
+        }
+
+        for (size_t n = 0; n < N; n++) {
+            OutputReference[n] = float(SoftplusReference(Input[n]));
+        }
+        MlasComputeSoftplus(Input, Output, N);
+        Check("softplus special", N, Input, Output, OutputReference, 1e-6f, 1e-5f);
+    }
+
+    void
+    TestActivation(
+        MLAS_ACTIVATION_KIND ActivationKind,
+        size_t M,
+        size_t N,
+        size_t ldc
+        )
+    {
+        float* Input = BufferInput.GetBuffer(M * ldc);
+        float* Bias = BufferBias.GetBuffer(M);
+        float* Output = BufferOutput.GetBuffer(M * ldc);
+        float* OutputReference = BufferOutputReference.GetBuffer(M * ldc);
+
+        std::default_random_engine generator(static_cast<unsigned>(M * ldc));
+        std::uniform_real_distribution<float> distribution(-5.0f, 5.0f);
+
+        for (size_t n = 0; n < M * ldc; n++) {
+            Input[n] = distribution(generator);
+        }
+
+        for (size_t m = 0; m < M; m++) {
+            Bias[m] = distribution(generator);
+        }
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = ActivationKind;
+        Activation.Parameters.Swish.alpha = 1.0f;
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < ldc; n++) {
+                double x = double(Input[m * ldc + n]);
+                if (n < N) {
+                    x += double(Bias[m]);
+                    switch (ActivationKind) {
+                        case MlasGeluActivation:
+                            x = GeluReference(x);
+                            break;
+                        case MlasFastGeluActivation:
+                            x = FastGeluReference(x);
+                            break;
+                        case MlasSwishActivation:
+                            x = x / (1.0 + std::exp(-x));
+                            break;
+                        default:
+                            x = SoftplusReference(x);
+                            break;
+                    }
+                } else {
+                    x = double(Input[m * ldc + n]);
+                }
+                OutputReference[m * ldc + n] = float(x);
+            }
+        }
+
+        std::copy_n(Input, M * ldc, Output);
+        MlasActivation(&Activation, Output, Bias, M, N, ldc);
+
+        Check("activation", M * ldc, Input, Output, OutputReference, 1e-5f, 1e-5f);
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 1; n < 128; n++) {
+            Test(n, -10.f, 10.f);
+        }
+
+        Test(1000, -100.f, 100.f);
+        Test(1000, -1e-3f, 1e-3f);
+
+        TestSpecialValues();
+
+        static const MLAS_ACTIVATION_KIND ActivationKinds[] = {
+            MlasGeluActivation, MlasFastGeluActivation, MlasSwishActivation, MlasSoftplusActivation
+        };
+
+        for (MLAS_ACTIVATION_KIND ActivationKind : ActivationKinds) {
+            TestActivation(ActivationKind, 7, 33, 33);
+            TestActivation(ActivationKind, 7, 33, 40);
+        }
+    }
+};
+
 class MlasQLinearBinaryOpTest : public MlasTestBase
 {
 public:
@@ -2911,6 +3440,9 @@ RunThreadedTests(
 
     printf("Softmax tests.\n");
     onnxruntime::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+    printf("LayerNorm tests.\n");
+    onnxruntime::make_unique<MlasLayerNormTest>()->ExecuteShort();
 }
 
 int
@@ -2949,8 +3481,12 @@ main(
     printf("Activation tests.\n");
     onnxruntime::make_unique<MlasActivationTest>()->ExecuteShort();
 
+    printf("ConvDepthwise tests.\n");
+    onnxruntime::make_unique<MlasConvDepthwiseTest>()->ExecuteShort();
+
     printf("Transcendental tests.\n");
     onnxruntime::make_unique<MlasComputeExpTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasTranscendentalTest>()->ExecuteShort();
 
     printf("MinMaxElements tests.\n");
     onnxruntime::make_unique<MlasFindMinMaxElementsTest>()->ExecuteShort();
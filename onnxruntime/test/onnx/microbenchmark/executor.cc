@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/ort_env.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+using namespace onnxruntime;
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+    }                                                           \
+  } while (0);
+
+// Builds a model with 'towers' independent chains of 'depth' small element-wise nodes whose outputs are summed,
+// the shape of multi-branch models (Inception blocks, multi-tower rankers) where the executor overhead matters.
+static std::string CreateMultiTowerModel(int64_t towers, int64_t depth, int64_t width) {
+  auto logger = env->GetLoggingManager()->CreateLogger("test");
+  Model model("multi_tower", false, *logger);
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(width);
+
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> tower_outputs;
+  for (int64_t t = 0; t < towers; ++t) {
+    NodeArg* prev = &input;
+    for (int64_t d = 0; d < depth; ++d) {
+      const std::string name = "tower" + std::to_string(t) + "_" + std::to_string(d);
+      auto& output = graph.GetOrCreateNodeArg(name, &float_tensor);
+      graph.AddNode(name, (d % 2 == 0) ? "Sigmoid" : "Relu", "", {prev}, {&output});
+      prev = &output;
+    }
+    tower_outputs.push_back(prev);
+  }
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum", "Sum", "", tower_outputs, {&output});
+
+  auto status = graph.Resolve();
+  if (!status.IsOK()) {
+    std::cerr << "Resolve graph failed: " << status.ErrorMessage() << std::endl;
+    abort();
+  }
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+// Arguments: number of towers, and 0 for ORT_SEQUENTIAL or 1 for ORT_PARALLEL.
+static void BM_MultiTowerExecution(benchmark::State& state) {
+  const int64_t towers = state.range(0);
+  const ExecutionMode execution_mode = state.range(1) ? ORT_PARALLEL : ORT_SEQUENTIAL;
+  const int64_t depth = 16;
+  const int64_t width = 64;
+  const std::string model_data = CreateMultiTowerModel(towers, depth, width);
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->SetSessionExecutionMode(session_options, execution_mode));
+  ORT_BREAK_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, 1));
+  ORT_BREAK_ON_ERROR(g_ort->SetInterOpNumThreads(session_options, 4));
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_data.data(), model_data.size(), session_options,
+                                                   &session));
+
+  std::vector<float> input_data(static_cast<size_t>(width), 0.5f);
+  const int64_t input_shape[] = {1, width};
+  OrtMemoryInfo* memory_info;
+  ORT_BREAK_ON_ERROR(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info));
+  OrtValue* input_tensor = nullptr;
+  ORT_BREAK_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, input_data.data(),
+                                                           input_data.size() * sizeof(float), input_shape, 2,
+                                                           ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &input_tensor));
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  for (auto _ : state) {
+    OrtValue* output_tensor = nullptr;
+    ORT_BREAK_ON_ERROR(g_ort->Run(session, nullptr, input_names, &input_tensor, 1, output_names, 1, &output_tensor));
+    g_ort->ReleaseValue(output_tensor);
+  }
+
+  g_ort->ReleaseValue(input_tensor);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+BENCHMARK(BM_MultiTowerExecution)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({2, 0})
+    ->Args({2, 1})
+    ->Args({8, 0})
+    ->Args({8, 1})
+    ->Args({32, 0})
+    ->Args({32, 1});
@@ -0,0 +1,115 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "core/mlas/inc/mlas.h"
+
+// vanilla implementation of LayerNormalization along the last dimension
+static void BM_LayerNormPlainLoop(benchmark::State& state) {
+  const size_t batch_size = static_cast<size_t>(state.range(0));
+  const size_t hidden_size = static_cast<size_t>(state.range(1));
+  float* data = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+  float* scale = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* bias = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+
+  for (auto _ : state) {
+    for (size_t n = 0; n != batch_size; ++n) {
+      const float* p_input = data + n * hidden_size;
+      float* p_output = output + n * hidden_size;
+
+      float mean = 0;
+      float mean_square = 0;
+      for (size_t h = 0; h != hidden_size; ++h) {
+        mean += p_input[h];
+        mean_square += p_input[h] * p_input[h];
+      }
+
+      mean = mean / hidden_size;
+      mean_square = std::sqrt(mean_square / hidden_size - mean * mean + 1e-5f);
+
+      for (size_t h = 0; h != hidden_size; ++h) {
+        p_output[h] = (p_input[h] - mean) / mean_square * scale[h] + bias[h];
+      }
+    }
+    benchmark::DoNotOptimize(output);
+  }
+
+  aligned_free(data);
+  aligned_free(scale);
+  aligned_free(bias);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_LayerNormPlainLoop)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 768})
+    ->Args({128, 768})
+    ->Args({128, 1024})
+    ->Args({512, 1024})
+    ->Args({64, 4096});
+
+// MLAS implementation
+static void BM_LayerNormMlas(benchmark::State& state) {
+  const size_t batch_size = static_cast<size_t>(state.range(0));
+  const size_t hidden_size = static_cast<size_t>(state.range(1));
+  float* data = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+  float* scale = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* bias = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+
+  for (auto _ : state) {
+    MlasComputeLayerNormalization(data, nullptr, nullptr, scale, bias, output, nullptr, nullptr,
+                                  batch_size, hidden_size, 1e-5f, false, nullptr);
+    benchmark::DoNotOptimize(output);
+  }
+
+  aligned_free(data);
+  aligned_free(scale);
+  aligned_free(bias);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_LayerNormMlas)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 768})
+    ->Args({128, 768})
+    ->Args({128, 1024})
+    ->Args({512, 1024})
+    ->Args({64, 4096});
+
+// MLAS implementation with the skip and bias addition of SkipLayerNormalization fused
+static void BM_SkipLayerNormMlas(benchmark::State& state) {
+  const size_t batch_size = static_cast<size_t>(state.range(0));
+  const size_t hidden_size = static_cast<size_t>(state.range(1));
+  float* data = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+  float* skip = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+  float* skip_bias = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* scale = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* bias = GenerateArrayWithRandomValue<float>(hidden_size, -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(batch_size * hidden_size, -1, 1);
+
+  for (auto _ : state) {
+    MlasComputeLayerNormalization(data, skip, skip_bias, scale, bias, output, nullptr, nullptr,
+                                  batch_size, hidden_size, 1e-5f, false, nullptr);
+    benchmark::DoNotOptimize(output);
+  }
+
+  aligned_free(data);
+  aligned_free(skip);
+  aligned_free(skip_bias);
+  aligned_free(scale);
+  aligned_free(bias);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_SkipLayerNormMlas)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 768})
+    ->Args({128, 768})
+    ->Args({128, 1024})
+    ->Args({512, 1024})
+    ->Args({64, 4096});
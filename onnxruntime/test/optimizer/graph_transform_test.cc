@@ -40,6 +40,7 @@
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/packed_attention_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
@@ -2796,6 +2797,37 @@ TEST_F(GraphTransformationTests, EmbedLayerNormFusionFormat3NoCast) {
   EXPECT_EQ(op_to_count["com.microsoft.EmbedLayerNormalization"], 1);
 }
 
+TEST_F(GraphTransformationTests, PackedAttentionFusionFormat3) {
+  auto model_uri = MODEL_FOLDER "fusion/embed_layer_norm_format3.onnx";
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, p_model, nullptr, *logger_));
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<EmbedLayerNormFusion>(), TransformerLevel::Level2);
+  graph_transformation_mgr.Register(onnxruntime::make_unique<PackedAttentionFusion>(), TransformerLevel::Level2);
+  auto ret = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_);
+  ASSERT_TRUE(ret.IsOK());
+
+  // The attention, the dense layer and the residual connection run on the packed sequence, and only the graph
+  // output is restored to the padded layout.
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["ReduceSum"], 1);
+  EXPECT_EQ(op_to_count["MatMul"], 1);
+  EXPECT_EQ(op_to_count["Add"], 2);
+  EXPECT_EQ(op_to_count["com.microsoft.Attention"], 0);
+  EXPECT_EQ(op_to_count["com.microsoft.PackedAttention"], 1);
+  EXPECT_EQ(op_to_count["com.microsoft.RemovePadding"], 1);
+  EXPECT_EQ(op_to_count["com.microsoft.RestorePadding"], 1);
+  EXPECT_EQ(op_to_count["com.microsoft.EmbedLayerNormalization"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "RestorePadding") {
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "add2_out");
+    }
+  }
+}
+
 TEST_F(GraphTransformationTests, EmbedLayerNormFusionFormat4) {
   auto model_uri = MODEL_FOLDER "fusion/embed_layer_norm_format4.onnx";
   std::shared_ptr<Model> p_model;
@@ -484,6 +484,48 @@ TEST(NhwcTransformerTests, ConvMixTensorRanks) {
   NhwcTransformerTester(build_test_case, check_nhwc_graph);
 }
 
+TEST(NhwcTransformerTests, ConvDepthwiseFloat) {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      const int64_t channels = weights_shape[0];
+      auto* input_arg = helper.MakeInput<float>(input_shape);
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* relu_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      // Depthwise convolution followed by a pointwise convolution.
+      auto* weights1_arg = helper.MakeInitializer<float>(weights_shape, -7, 7);
+      auto* bias1_arg = helper.MakeInitializer<float>({channels}, -7, 7);
+      Node& conv1_node = helper.AddNode("Conv", {input_arg, weights1_arg, bias1_arg}, {conv1_output_arg});
+      conv1_node.AddAttribute("group", channels);
+      conv1_node.AddAttribute("pads", std::vector<int64_t>(2 * (weights_shape.size() - 2), 1));
+      helper.AddNode("Relu", {conv1_output_arg}, {relu_output_arg});
+
+      std::vector<int64_t> weights2_shape(weights_shape.size(), 1);
+      weights2_shape[0] = 19;
+      weights2_shape[1] = channels;
+      auto* weights2_arg = helper.MakeInitializer<float>(weights2_shape, -7, 7);
+      helper.AddNode("Conv", {relu_output_arg, weights2_arg}, {conv2_output_arg});
+      helper.AddNode("Sigmoid", {conv2_output_arg}, {output_arg});
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.FusedConv"], 2);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    NhwcTransformerTester(build_test_case, check_nhwc_graph);
+  };
+
+  // Use channel counts that are not a multiple of the NCHWc block size so that
+  // the NCHWc transformer leaves the convolutions alone.
+  test_case({1, 13, 37}, {13, 1, 5});
+  test_case({1, 13, 15, 17}, {13, 1, 3, 3});
+  test_case({2, 13, 11, 9, 7}, {13, 1, 3, 3, 3});
+}
+
 #endif
 
 #endif // DISABLE_CONTRIB_OPS
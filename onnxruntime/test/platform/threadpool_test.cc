@@ -4,17 +4,24 @@
 #include "core/platform/threadpool.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
+#include "core/util/thread_utils.h"
 
 #include <core/common/make_unique.h>
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <sstream>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
 #endif
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sched.h>
+#endif
 
 using namespace onnxruntime::concurrency;
 
@@ -381,6 +388,219 @@ TEST(ThreadPoolTest, TestMultiLoopSections_4Thread_100Loop) {
   TestMultiLoopSections("TestMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+#ifndef _OPENMP
+TEST(ThreadPoolTest, TestStats) {
+  ThreadOptions to;
+  to.collect_stats = true;
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 4, true);
+
+  constexpr int num_loops = 10;
+  for (int i = 0; i < num_loops; i++) {
+    auto test_data = CreateTestData(1000);
+    ThreadPool::TryParallelFor(tp.get(), 1000, 1000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t idx = first; idx < last; idx++) {
+        IncrementElement(*test_data, idx);
+      }
+    });
+    ValidateTestData(*test_data);
+  }
+
+  ThreadPoolStats stats;
+  ASSERT_TRUE(ThreadPool::GetStats(tp.get(), stats));
+  ASSERT_EQ(stats.workers.size(), 3u);
+  ASSERT_EQ(stats.loops, static_cast<uint64_t>(num_loops));
+  ASSERT_GE(stats.total_loop_imbalance, static_cast<double>(num_loops));
+  ASSERT_GE(stats.max_loop_imbalance, 1.0);
+  ASSERT_LE(stats.max_loop_imbalance, 4.0);
+  for (const auto& worker : stats.workers) {
+    ASSERT_LE(worker.steals, worker.tasks);
+    ASSERT_LE(worker.section_joins, worker.tasks);
+  }
+
+  // Pools that don't collect statistics don't report them.
+  auto tp_without_stats = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), ThreadOptions(), nullptr,
+                                                               2, true);
+  ASSERT_FALSE(ThreadPool::GetStats(tp_without_stats.get(), stats));
+  ASSERT_FALSE(ThreadPool::GetStats(nullptr, stats));
+}
+#endif
+
+#ifndef _OPENMP
+using ProcessElementFunc = void (*)(std::ptrdiff_t);
+
+static void CheapElement(std::ptrdiff_t) {
+}
+
+static void ExpensiveElement(std::ptrdiff_t) {
+  const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+// A helper shared by several operators, with a single loop body for all of them like the element-wise broadcasting.
+static void ParallelizeElements(ThreadPool* tp, std::ptrdiff_t total, ProcessElementFunc func) {
+  ThreadPool::TryParallelFor(tp, total, 10.0, [func](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t idx = first; idx < last; idx++) {
+      func(idx);
+    }
+  });
+}
+
+TEST(ThreadPoolTest, TestAdaptiveLoopCostsPerOperator) {
+  ThreadOptions to;
+  to.adaptive_loop_costs = true;
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 2, true);
+
+  const std::string add = "Add";
+  const std::string mul = "Mul";
+  const std::string add_node = "add_node";
+  const std::string mul_node = "mul_node";
+  for (int i = 0; i < 4; i++) {
+    {
+      ThreadPool::LoopScope scope(add, add_node);
+      ParallelizeElements(tp.get(), 100, CheapElement);
+    }
+    {
+      ThreadPool::LoopScope scope(mul, mul_node);
+      ParallelizeElements(tp.get(), 100, ExpensiveElement);
+    }
+  }
+
+  std::stringstream saved;
+  ASSERT_TRUE(ThreadPool::SaveLoopCosts(tp.get(), saved).IsOK());
+  double add_cost = 0;
+  double mul_cost = 0;
+  std::string line;
+  while (std::getline(saved, line)) {
+    std::istringstream fields(line);
+    double ns_per_iteration = 0;
+    std::string name;
+    fields >> ns_per_iteration >> name;
+    if (name == "Add(add_node)") {
+      add_cost = ns_per_iteration;
+    } else if (name == "Mul(mul_node)") {
+      mul_cost = ns_per_iteration;
+    }
+  }
+
+  // the loop of the helper has a cost for each operator rather than the average of both
+  ASSERT_GT(add_cost, 0.0);
+  ASSERT_GE(mul_cost, 20000.0);
+  ASSERT_LT(add_cost * 10, mul_cost);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveLoopCosts) {
+  ThreadOptions to;
+  to.adaptive_loop_costs = true;
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 4, true);
+
+  // The estimate is far too high for the loop, which should run on the calling thread once it has been measured.
+  bool ran_on_other_threads = false;
+  for (int i = 0; i < 10; i++) {
+    auto test_data = CreateTestData(1000);
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> other_threads{false};
+    ThreadPool::TryParallelFor(
+        tp.get(), 1000, 1000000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          if (std::this_thread::get_id() != caller) {
+            other_threads = true;
+          }
+          for (std::ptrdiff_t idx = first; idx < last; idx++) {
+            IncrementElement(*test_data, idx);
+          }
+        },
+        "test_loop");
+    ValidateTestData(*test_data);
+    ran_on_other_threads = other_threads;
+  }
+  ASSERT_FALSE(ran_on_other_threads);
+
+  std::stringstream saved;
+  ASSERT_TRUE(ThreadPool::SaveLoopCosts(tp.get(), saved).IsOK());
+  double ns_per_iteration = 0;
+  std::string name;
+  saved >> ns_per_iteration >> name;
+  ASSERT_GT(ns_per_iteration, 0.0);
+  ASSERT_LT(ns_per_iteration, 1000000.0);
+  ASSERT_EQ(name, "test_loop");
+
+  // Loaded costs replace the measured ones and are saved again.
+  std::stringstream loaded("1234.5 test_loop\n\n42 other loop\n");
+  ASSERT_TRUE(ThreadPool::LoadLoopCosts(tp.get(), loaded).IsOK());
+  std::stringstream resaved;
+  ASSERT_TRUE(ThreadPool::SaveLoopCosts(tp.get(), resaved).IsOK());
+  const std::string costs = resaved.str();
+  ASSERT_NE(costs.find("1234.5 test_loop\n"), std::string::npos);
+  ASSERT_NE(costs.find("42 other loop\n"), std::string::npos);
+
+  std::stringstream invalid("fast test_loop\n");
+  ASSERT_FALSE(ThreadPool::LoadLoopCosts(tp.get(), invalid).IsOK());
+
+  // Pools without adaptive loop costs have nothing to save or load.
+  auto tp_without_costs = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), ThreadOptions(), nullptr,
+                                                               2, true);
+  ASSERT_FALSE(ThreadPool::SaveLoopCosts(tp_without_costs.get(), saved).IsOK());
+  ASSERT_FALSE(ThreadPool::LoadLoopCosts(nullptr, loaded).IsOK());
+}
+#endif
+
+#ifndef _OPENMP
+TEST(ThreadPoolTest, TestSharedThreads) {
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), ThreadOptions(), nullptr, 4, true);
+  ThreadPoolShareOptions latency_options;
+  latency_options.share = 3;
+  ThreadPool latency_tp(tp.get(), latency_options);
+  ThreadPoolShareOptions batch_options;
+  batch_options.max_degree_of_parallelism = 2;
+  ThreadPool batch_tp(tp.get(), batch_options);
+
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&latency_tp), 4);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&batch_tp), 2);
+
+  // Hold a loop of the batch pool open while the latency pool runs a loop.
+  std::atomic<bool> batch_started{false};
+  std::atomic<bool> batch_release{false};
+  std::thread batch_thread([&]() {
+    ThreadPool::TrySimpleParallelFor(&batch_tp, 2, [&](std::ptrdiff_t i) {
+      if (i == 0) {
+        batch_started = true;
+        while (!batch_release) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  });
+  while (!batch_started) {
+    std::this_thread::yield();
+  }
+
+  ThreadPoolLoad load;
+  ASSERT_TRUE(ThreadPool::GetLoad(tp.get(), load));
+  ASSERT_EQ(load.active_loops, 1u);
+  ASSERT_EQ(load.active_shares, 1u);
+
+  auto test_data = CreateTestData(100);
+  ThreadPool::TrySimpleParallelFor(&latency_tp, 100, [&](std::ptrdiff_t i) {
+    IncrementElement(*test_data, i);
+  });
+  ValidateTestData(*test_data);
+
+  batch_release = true;
+  batch_thread.join();
+
+  // The latency pool got 3 of the 4 threads because of the batch loop.
+  ASSERT_TRUE(ThreadPool::GetLoad(&latency_tp, load));
+  ASSERT_EQ(load.active_loops, 0u);
+  ASSERT_EQ(load.active_shares, 0u);
+  ASSERT_EQ(load.shared_loops, 1u);
+  ASSERT_EQ(load.throttled_loops, 1u);
+  ASSERT_TRUE(ThreadPool::GetLoad(&batch_tp, load));
+  ASSERT_EQ(load.shared_loops, 1u);
+  ASSERT_EQ(load.throttled_loops, 0u);
+  ASSERT_FALSE(ThreadPool::GetLoad(nullptr, load));
+}
+#endif
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestStackSize) {
   ThreadOptions to;
@@ -410,4 +630,171 @@ TEST(ThreadPoolTest, TestStackSize) {
 }
 #endif
 
+TEST(ThreadPoolTest, TestParseCpuSets) {
+  std::vector<std::vector<size_t>> cpu_sets;
+  ASSERT_TRUE(ParseCpuSets("0-3,8;4-7,9", cpu_sets).IsOK());
+  ASSERT_EQ(cpu_sets, (std::vector<std::vector<size_t>>{{0, 1, 2, 3, 8}, {4, 5, 6, 7, 9}}));
+
+  ASSERT_TRUE(ParseCpuSets("5", cpu_sets).IsOK());
+  ASSERT_EQ(cpu_sets, (std::vector<std::vector<size_t>>{{5}}));
+
+  // a trailing separator doesn't add a set
+  ASSERT_TRUE(ParseCpuSets("1;2-2;", cpu_sets).IsOK());
+  ASSERT_EQ(cpu_sets, (std::vector<std::vector<size_t>>{{1}, {2}}));
+
+  ASSERT_TRUE(ParseCpuSets("", cpu_sets).IsOK());
+  ASSERT_TRUE(cpu_sets.empty());
+
+  for (const char* invalid : {"a", "1-", "3-1", "1,,2", "1,", ";1", "1;;2", "1 2", " 1", "-1", "+1", "1-+2",
+                              "0-99999999999", "70000"}) {
+    ASSERT_FALSE(ParseCpuSets(invalid, cpu_sets).IsOK()) << invalid;
+  }
+}
+
+TEST(ThreadPoolTest, TestApplyNumaNode) {
+  const std::vector<std::vector<size_t>> node_cpus = {{0, 1, 2, 3}, {4, 5, 6, 7}, {}};
+
+  // the default size is the number of processors of the node, and the threads can move between them
+  OrtThreadPoolParams options;
+  options.numa_node = 1;
+  ASSERT_TRUE(ApplyNumaNode(node_cpus, options).IsOK());
+  ASSERT_EQ(options.thread_pool_size, 4);
+  ASSERT_EQ(options.cpu_sets, (std::vector<std::vector<size_t>>{{4, 5, 6, 7}}));
+
+  // an explicit size and explicit CPU sets are kept
+  OrtThreadPoolParams explicit_options;
+  explicit_options.numa_node = 0;
+  explicit_options.thread_pool_size = 2;
+  explicit_options.cpu_sets = {{1}, {2}};
+  ASSERT_TRUE(ApplyNumaNode(node_cpus, explicit_options).IsOK());
+  ASSERT_EQ(explicit_options.thread_pool_size, 2);
+  ASSERT_EQ(explicit_options.cpu_sets, (std::vector<std::vector<size_t>>{{1}, {2}}));
+
+  // missing nodes and nodes without processors
+  OrtThreadPoolParams invalid_options;
+  invalid_options.numa_node = 2;
+  ASSERT_FALSE(ApplyNumaNode(node_cpus, invalid_options).IsOK());
+  invalid_options.numa_node = 3;
+  ASSERT_FALSE(ApplyNumaNode(node_cpus, invalid_options).IsOK());
+  ASSERT_FALSE(ApplyNumaNode({}, invalid_options).IsOK());
+}
+
+TEST(ThreadPoolTest, TestHomeShard) {
+  // the home shard only depends on the position, so a thread starts from the same shard in every loop
+  for (unsigned num_positions : {1u, 3u, 4u, 8u, 13u}) {
+    for (unsigned num_shards : {1u, 2u, 4u, 8u, 64u}) {
+      unsigned previous = 0;
+      std::vector<bool> is_home(num_shards, false);
+      for (unsigned position = 0; position < num_positions; ++position) {
+        const unsigned shard = ThreadPool::GetHomeShard(position, num_positions, num_shards);
+        ASSERT_EQ(shard, ThreadPool::GetHomeShard(position, num_positions, num_shards));
+        ASSERT_LT(shard, num_shards);
+        // neighboring threads get neighboring shards
+        ASSERT_GE(shard, previous);
+        previous = shard;
+        is_home[shard] = true;
+      }
+      ASSERT_EQ(ThreadPool::GetHomeShard(0, num_positions, num_shards), 0u);
+      if (num_positions >= num_shards) {
+        // every shard is the home of a thread
+        ASSERT_TRUE(std::all_of(is_home.begin(), is_home.end(), [](bool b) { return b; }));
+      }
+      if (num_positions == num_shards) {
+        for (unsigned position = 0; position < num_positions; ++position) {
+          ASSERT_EQ(ThreadPool::GetHomeShard(position, num_positions, num_shards), position);
+        }
+      }
+    }
+  }
+}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+static std::vector<size_t> GetAllowedCpus() {
+  std::vector<size_t> cpus;
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed))
+        cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// Run a task on the worker of a pool with a single worker and return the processors it may run on.
+static void GetWorkerAffinity(ThreadPool* tp, cpu_set_t& worker) {
+  Notification n;
+  int ret = -1;
+  ThreadPool::Schedule(tp, [&]() {
+    ret = sched_getaffinity(0, sizeof(worker), &worker);
+    n.Notify();
+  });
+  n.Wait();
+  ASSERT_EQ(ret, 0);
+}
+
+TEST(ThreadPoolTest, TestMoreCpuSetsThanThreads) {
+  const std::vector<size_t> cpus = GetAllowedCpus();
+  ASSERT_FALSE(cpus.empty());
+
+  // the single worker takes the first set, the others are unused
+  ThreadOptions to;
+  to.cpu_sets = {{cpus.back()}, {cpus.front()}, {cpus.front(), cpus.back()}};
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 2, true);
+
+  cpu_set_t worker;
+  GetWorkerAffinity(tp.get(), worker);
+  ASSERT_EQ(CPU_COUNT(&worker), 1);
+  ASSERT_TRUE(CPU_ISSET(cpus.back(), &worker));
+}
+
+TEST(ThreadPoolTest, TestCpuSetWithoutAllowedCpus) {
+  const std::vector<size_t> cpus = GetAllowedCpus();
+  ASSERT_FALSE(cpus.empty());
+  if (cpus.back() + 1 >= CPU_SETSIZE) {
+    return;
+  }
+
+  // binding to a processor the process can't run on fails, and the worker keeps running unbound
+  ThreadOptions to;
+  to.cpu_sets = {{static_cast<size_t>(CPU_SETSIZE - 1)}};
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 2, true);
+
+  cpu_set_t worker;
+  GetWorkerAffinity(tp.get(), worker);
+  ASSERT_EQ(static_cast<size_t>(CPU_COUNT(&worker)), cpus.size());
+}
+
+TEST(ThreadPoolTest, TestCpuSets) {
+  cpu_set_t allowed;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  std::vector<size_t> cpus;
+  for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed))
+      cpus.push_back(cpu);
+  }
+  ASSERT_FALSE(cpus.empty());
+
+  // Bind the worker to the last two processors the process can run on.
+  ThreadOptions to;
+  to.cpu_sets.push_back({cpus[cpus.size() > 1 ? cpus.size() - 2 : 0], cpus.back()});
+  auto tp = onnxruntime::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 2, true);
+
+  Notification n;
+  cpu_set_t worker;
+  int ret = -1;
+  ThreadPool::Schedule(tp.get(), [&]() {
+    ret = sched_getaffinity(0, sizeof(worker), &worker);
+    n.Notify();
+  });
+  n.Wait();
+  ASSERT_EQ(ret, 0);
+  cpu_set_t expected;
+  CPU_ZERO(&expected);
+  for (size_t cpu : to.cpu_sets[0])
+    CPU_SET(cpu, &expected);
+  ASSERT_TRUE(CPU_EQUAL(&worker, &expected));
+}
+#endif
+
 }  // namespace onnxruntime
@@ -1038,6 +1038,94 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// Test a loop with a known trip count, where the loop carried vars are double buffered and the scan output is
+// written directly to the Loop output. loop_var_1 is passed through to check it isn't overwritten while being read.
+TEST(Loop, KnownTripCountReusesBuffers) {
+  auto create_subgraph = []() {
+    Model model("Known trip count subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    /* Inputs: iter_num, cond_in, loop_var_0_in, loop_var_1_in
+
+         cond_in    loop_var_0_in  [Constant 1]   loop_var_1_in
+            |              \        /               |
+        [Identity]          [Add]                [Identity]
+            |                 |    [Constant 2]      |
+         cond_out      loop_var_0_out    /      loop_var_1_out
+                              |         /
+                              [Mul]----/
+                                |
+                           loop_out_0
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_0_in = graph.GetOrCreateNodeArg("loop_var_0_in", &float_tensor);
+    auto& loop_var_1_in = graph.GetOrCreateNodeArg("loop_var_1_in", &float_tensor);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+    auto& loop_var_1_out = graph.GetOrCreateNodeArg("loop_var_1_out", &float_tensor);
+    auto& loop_out_0 = graph.GetOrCreateNodeArg("loop_out_0", &float_tensor);
+
+    auto add_constant = [&graph, &float_tensor](const std::string& name, float value) -> NodeArg& {
+      auto& constant_out = graph.GetOrCreateNodeArg(name, &float_tensor);
+      auto& constant = graph.AddNode(name + "_node", "Constant", "Constant " + name, {}, {&constant_out});
+
+      TensorProto value_tensor;
+      value_tensor.add_dims(1);
+      value_tensor.add_float_data(value);
+      value_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      constant.AddAttribute("value", value_tensor);
+
+      return constant_out;
+    };
+
+    auto& one = add_constant("one", 1.f);
+    auto& two = add_constant("two", 2.f);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add", "Add", "Increment loop_var_0", {&loop_var_0_in, &one}, {&loop_var_0_out});
+    graph.AddNode("mul", "Mul", "Scale loop_var_0 for the scan output", {&loop_var_0_out, &two}, {&loop_out_0});
+    graph.AddNode("loop_var_1_identity", "Identity", "Forward loop_var_1", {&loop_var_1_in}, {&loop_var_1_out});
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_0_in, &loop_var_1_in});
+    graph.SetOutputs({&cond_out, &loop_var_0_out, &loop_var_1_out, &loop_out_0});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {4});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var_0_orig", {2}, {0.f, 10.f});
+  test.AddInput<float>("loop_var_1_orig", {1}, {5.f});
+
+  test.AddOutput<float>("loop_var_0_final", {2}, {4.f, 14.f});
+  test.AddOutput<float>("loop_var_1_final", {1}, {5.f});
+  test.AddOutput<float>("loop_out_0_final", {4, 2}, {2.f, 22.f, 4.f, 24.f, 6.f, 26.f, 8.f, 28.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
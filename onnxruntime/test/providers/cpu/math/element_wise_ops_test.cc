@@ -695,6 +695,28 @@ TEST(MathOpTest, Pow_Broadcast_Scalar1_12) {
   test.Run();
 }
 
+TEST(MathOpTest, Pow_Broadcast_Scalar1_Fractional) {
+  OpTester test("Pow", 12);
+
+  std::vector<int64_t> dims{6};
+  test.AddInput<float>("X", dims, {0.0f, 0.25f, 1.0f, 2.0f, 9.0f, 100.0f});
+  test.AddInput<float>("Y", {}, {-1.5f});
+  test.AddOutput<float>("Z", dims,
+                        {std::numeric_limits<float>::infinity(), std::pow(0.25f, -1.5f), 1.0f,
+                         std::pow(2.0f, -1.5f), std::pow(9.0f, -1.5f), std::pow(100.0f, -1.5f)});
+  test.Run();
+}
+
+TEST(MathOpTest, Pow_Broadcast_Scalar1_NegativeBase) {
+  OpTester test("Pow", 12);
+
+  std::vector<int64_t> dims{4};
+  test.AddInput<float>("X", dims, {-2.0f, -0.5f, 3.0f, -3.0f});
+  test.AddInput<int64_t>("Y", {}, {5});
+  test.AddOutput<float>("Z", dims, {-32.0f, -0.03125f, 243.0f, -243.0f});
+  test.Run();
+}
+
 TEST(MathOpTest, Pow_float_int64) {
   OpTester test("Pow", 12);
   std::vector<int64_t> dims{3};
@@ -817,6 +839,18 @@ TEST(MathOpTest, Log) {
   test.Run();
 }
 
+TEST(MathOpTest, Log_SpecialValues) {
+  OpTester test("Log");
+  std::vector<int64_t> dims{6};
+  test.AddInput<float>("X", dims,
+                       {0.0f, 1e-30f, 0.5f, 3.0e10f,
+                        std::numeric_limits<float>::infinity(), -1.0f});
+  test.AddOutput<float>("Y", dims,
+                        {-std::numeric_limits<float>::infinity(), std::log(1e-30f), std::log(0.5f), std::log(3.0e10f),
+                         std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()});
+  test.Run();
+}
+
 TEST(MathOpTest, Sum_6) {
   OpTester test("Sum", 6);
   std::vector<int64_t> dims{3, 3};
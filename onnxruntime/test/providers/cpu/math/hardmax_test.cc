@@ -226,5 +226,31 @@ TEST(HardmaxOperator, ThreeDimsNegAxis2) {
   RunTest(x_vals_3dims, expected_vals, three_dimensions, /*opset*/ 7, /*axis*/ -1);
 }
 
+TEST(HardmaxOperator, ThreeDimsAxis0Ties_opset13) {
+  // The hardmax is computed along a non-innermost axis. For ties, the first occurrence of the max is selected.
+  std::vector<int64_t> dimensions = {3, 2, 2};
+  std::vector<float> x_vals = {
+      1.0f, 5.0f,
+      2.0f, -1.0f,
+
+      1.0f, 6.0f,
+      3.0f, -1.0f,
+
+      0.0f, 6.0f,
+      3.0f, -1.0f};
+
+  std::vector<float> expected_vals = {
+      1.0f, 0.0f,
+      0.0f, 1.0f,
+
+      0.0f, 1.0f,
+      1.0f, 0.0f,
+
+      0.0f, 0.0f,
+      0.0f, 0.0f};
+
+  RunTest(x_vals, expected_vals, dimensions, /*opset*/ 13, /*axis*/ 0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
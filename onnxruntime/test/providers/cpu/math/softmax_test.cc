@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -277,6 +280,40 @@ TEST(SoftmaxOperator, InvalidAxis_opset13) {
           // is that it breaks and this is the right behavior
           "[ShapeInferenceError] axis must be in [-rank, rank-1]. input rank was 2");
 }
+TEST(SoftmaxOperator, ChannelAxis_opset13) {
+  // NCHW input with the softmax over the channels, so the elements along the axis are H * W apart.
+  // Use enough spatial elements to span multiple column blocks of the strided implementation.
+  const int64_t N = 2, C = 5, HW = 300;
+  std::vector<int64_t> dimensions = {N, C, HW};
+
+  std::vector<float> x_vals(N * C * HW);
+  for (size_t i = 0; i < x_vals.size(); ++i) {
+    x_vals[i] = static_cast<float>((i * 37) % 101) / 10.f - 5.f;
+  }
+
+  std::vector<float> expected_vals(x_vals.size());
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t s = 0; s < HW; ++s) {
+      const int64_t offset = n * C * HW + s;
+      float max_value = x_vals[offset];
+      for (int64_t c = 1; c < C; ++c) {
+        max_value = std::max(max_value, x_vals[offset + c * HW]);
+      }
+      double sum = 0.0;
+      for (int64_t c = 0; c < C; ++c) {
+        sum += std::exp(static_cast<double>(x_vals[offset + c * HW] - max_value));
+      }
+      for (int64_t c = 0; c < C; ++c) {
+        expected_vals[offset + c * HW] =
+            static_cast<float>(std::exp(static_cast<double>(x_vals[offset + c * HW] - max_value)) / sum);
+      }
+    }
+  }
+
+  RunTest(x_vals, expected_vals, dimensions, /*opset*/ 13, /*axis*/ 1,
+          {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});  // OpenVINO doesn't support opset-13 yet
+}
+
 TEST(SoftmaxOperator, DimWithZero) {
   std::vector<float> x_vals = {};
   std::vector<float> expected_vals = {};
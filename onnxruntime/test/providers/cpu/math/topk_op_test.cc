@@ -556,5 +556,38 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded(k, n, batch_size);
 }
 
+// a single long row is split into column chunks when the thread pool has more threads than there are rows.
+// the values repeat so the merge of the chunks must preserve the order of equal values by index.
+TEST(TopKOperator, SingleLongRowWithTies) {
+  const int64_t k = 10;
+  const int64_t cols = 100000;
+  const int64_t period = 1000;
+
+  std::vector<float> input_vals(cols);
+  for (int64_t i = 0; i < cols; ++i) {
+    input_vals[i] = static_cast<float>(i % period);
+  }
+
+  std::vector<int64_t> input_dimensions = {1, cols};
+  std::vector<int64_t> expected_dimensions = {1, k};
+
+  std::vector<float> expected_vals(k, static_cast<float>(period - 1));
+  std::vector<int64_t> expected_indices(k);
+  for (int64_t i = 0; i < k; ++i) {
+    expected_indices[i] = i * period + period - 1;
+  }
+
+  RunTest(11, k, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false);
+
+  // smallest
+  std::fill(expected_vals.begin(), expected_vals.end(), 0.0f);
+  for (int64_t i = 0; i < k; ++i) {
+    expected_indices[i] = i * period;
+  }
+
+  RunTest(11, k, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false,
+          -1, 0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -200,5 +200,44 @@ TEST(ContribOpTest, StringNormalizerTest) {
   }
 }
 
+TEST(ContribOpTest, StringNormalizerUtf8Test) {
+  // - multi-byte characters survive the case change
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "UPPER", true, {}, test_locale);
+    std::vector<int64_t> dims{2};
+    std::vector<std::string> input = {std::string("caf\xc3\xa9"), std::string("\xe2\x82\xac 1")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string("CAF\xc3\x89"), std::string("\xe2\x82\xac 1")};
+    test.AddOutput<std::string>("Y", dims, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  // - a truncated sequence is rejected
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", true, {}, test_locale);
+    std::vector<int64_t> dims{1};
+    std::vector<std::string> input = {std::string("abc\xc3")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string("abc")};
+    test.AddOutput<std::string>("Y", dims, output);
+    test.Run(OpTester::ExpectResult::kExpectFailure, "Input contains invalid utf8 chars");
+  }
+  // - lead bytes past 0xF4 are rejected rather than decoded as 4 byte sequences
+  for (int lead = 0xF5; lead <= 0xFF; ++lead) {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", true, {}, test_locale);
+    std::vector<int64_t> dims{1};
+    std::vector<std::string> input = {std::string(1, static_cast<char>(lead)) + "\x90\x80\x80"};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string()};
+    test.AddOutput<std::string>("Y", dims, output);
+    test.Run(OpTester::ExpectResult::kExpectFailure, "Input contains invalid utf8 chars");
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
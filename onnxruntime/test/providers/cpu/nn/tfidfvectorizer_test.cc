@@ -433,6 +433,34 @@ TEST(TfIdfVectorizerTest, Int32_TF_BatchUniAndBigrams_Skip5) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(TfIdfVectorizerTest, Int64_TF_BatchUniAndBigrams_Skip5) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=5, Min=1, Max=2, weights empty, int64 with values that do not fit into int32
+  const int64_t big = int64_t{1} << 40;
+  InitTestAttr(test, "TF", 1, 2, 5,
+               {0, 4},
+               {0, 1, 2, 3, 4, 5, 6},  //7 output indexes
+               {},
+               {2, 3, 5, 4,               //1-grams
+                5, 6, 7, 8 + big, 6, 7},  //bi-grams
+               {});
+
+  std::vector<int64_t> dims{3, 6};
+  std::vector<int64_t> input = {1, 1, 3, 3, 3, 7,
+                                8 + big, 6, 7, 5, 6, 8 + big,
+                                8, 6, 7, 5, 6, 8};
+  test.AddInput<int64_t>("T", dims, input);
+
+  std::vector<int64_t> out_dims{3, 7};
+  // 8 and 8 + big are different tokens
+  std::vector<float> output = {0, 3, 0, 0, 0, 0, 0,
+                               0, 0, 1, 0, 1, 1, 1,
+                               0, 0, 1, 0, 1, 0, 1};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 TEST(TfIdfVectorizerTest, String_TF_UniAndBigrams_Skip5) {
   OpTester test("TfIdfVectorizer", opset_ver);
   // s=5, Min=1, Max=2, weights empty, string
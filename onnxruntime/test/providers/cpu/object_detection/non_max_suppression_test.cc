@@ -288,6 +288,42 @@ TEST(NonMaxSuppressionOpTest, SelectFromIdenticalBoxes) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManySelectedBoxes_TwoClasses) {
+  // 20 disjoint boxes, each followed by a slightly shifted duplicate with a lower score. The duplicates are
+  // suppressed by the original boxes, which requires checking against more than one block of selected boxes.
+  constexpr int64_t num_unique_boxes = 20;
+  std::vector<float> boxes;
+  std::vector<float> scores(2 * 2 * num_unique_boxes);
+  for (int64_t i = 0; i < num_unique_boxes; ++i) {
+    const float x = 2.0f * i;
+    boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    boxes.insert(boxes.end(), {0.0f, x + 0.05f, 1.0f, x + 1.05f});
+
+    // class 0 prefers the boxes on the left, class 1 prefers the boxes on the right
+    scores[2 * i] = 1.0f - 0.01f * i;
+    scores[2 * i + 1] = scores[2 * i] - 0.005f;
+    scores[2 * num_unique_boxes + 2 * i] = 0.01f + 0.01f * i;
+    scores[2 * num_unique_boxes + 2 * i + 1] = scores[2 * num_unique_boxes + 2 * i] - 0.005f;
+  }
+
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < num_unique_boxes; ++i) {
+    expected.insert(expected.end(), {0L, 0L, 2 * i});
+  }
+  for (int64_t i = num_unique_boxes - 1; i >= 0; --i) {
+    expected.insert(expected.end(), {0L, 1L, 2 * i});
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, 2 * num_unique_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {1, 2, 2 * num_unique_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {100L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {2 * num_unique_boxes, 3}, expected);
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 6, 4},
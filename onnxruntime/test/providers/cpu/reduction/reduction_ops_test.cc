@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <functional>
+#include <numeric>
 #include <random>
 #include <cmath>
 #include <type_traits>
@@ -2080,5 +2082,102 @@ TEST(ReductionOpTest, ReduceInfLogSumExp) {
   test.Run();
 }
 
+// Compares the reductions of a [4, 37, 300] tensor against a reference computed in double. The axes select
+// the contiguous (KR), leading (RK), and middle (KRK) reduction forms along with a non-contiguous case.
+static void TestReduceForms(const std::string& op,
+                            const std::function<double(const std::vector<double>&)>& reference) {
+  const std::vector<int64_t> input_dims{4, 37, 300};
+  std::vector<float> input_data(4 * 37 * 300);
+  std::default_random_engine generator(1234);
+  std::uniform_real_distribution<float> distribution(-5.0f, 5.0f);
+  for (auto& v : input_data) {
+    v = distribution(generator);
+  }
+
+  const std::vector<std::vector<int64_t>> axes_list{{2}, {1, 2}, {0}, {0, 1}, {1}, {0, 2}};
+
+  for (const auto& axes : axes_list) {
+    std::vector<int64_t> output_dims = input_dims;
+    for (auto a : axes) {
+      output_dims[a] = 1;
+    }
+
+    std::vector<float> expected_data;
+    for (int64_t i = 0; i < output_dims[0]; ++i) {
+      for (int64_t j = 0; j < output_dims[1]; ++j) {
+        for (int64_t k = 0; k < output_dims[2]; ++k) {
+          std::vector<double> values;
+          for (int64_t a = 0; a < input_dims[0]; ++a) {
+            for (int64_t b = 0; b < input_dims[1]; ++b) {
+              for (int64_t c = 0; c < input_dims[2]; ++c) {
+                if ((output_dims[0] == 1 || a == i) && (output_dims[1] == 1 || b == j) &&
+                    (output_dims[2] == 1 || c == k)) {
+                  values.push_back(input_data[(a * input_dims[1] + b) * input_dims[2] + c]);
+                }
+              }
+            }
+          }
+          expected_data.push_back(static_cast<float>(reference(values)));
+        }
+      }
+    }
+
+    for (int64_t keepdims : {0, 1}) {
+      std::vector<int64_t> expected_dims;
+      for (size_t d = 0; d < input_dims.size(); ++d) {
+        if (keepdims || std::find(axes.begin(), axes.end(), static_cast<int64_t>(d)) == axes.end()) {
+          expected_dims.push_back(output_dims[d]);
+        }
+      }
+
+      OpTester test(op.c_str());
+      test.AddAttribute("axes", axes);
+      test.AddAttribute("keepdims", keepdims);
+      test.AddInput<float>("data", input_dims, input_data);
+      test.AddOutput<float>("reduced", expected_dims, expected_data);
+      test.SetOutputRelErr("reduced", 1e-4f);
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+    }
+  }
+}
+
+TEST(ReductionOpTest, ReduceSum_Forms) {
+  TestReduceForms("ReduceSum", [](const std::vector<double>& values) {
+    return std::accumulate(values.begin(), values.end(), 0.0);
+  });
+}
+
+TEST(ReductionOpTest, ReduceMean_Forms) {
+  TestReduceForms("ReduceMean", [](const std::vector<double>& values) {
+    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  });
+}
+
+TEST(ReductionOpTest, ReduceMax_Forms) {
+  TestReduceForms("ReduceMax", [](const std::vector<double>& values) {
+    return *std::max_element(values.begin(), values.end());
+  });
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_Forms) {
+  TestReduceForms("ReduceLogSumExp", [](const std::vector<double>& values) {
+    double max_value = *std::max_element(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values) {
+      sum += std::exp(v - max_value);
+    }
+    return std::log(sum) + max_value;
+  });
+}
+
+TEST(ReductionOpTest, ReduceInfLogSumExp_Leading) {
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {2, 3}, {1.0f, FLOAT_NINF, FLOAT_INF, FLOAT_NINF, 1.0f, 2.0f});
+  test.AddOutput<float>("reduced", {3}, {1.0f, 1.0f, FLOAT_INF});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider, kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -34,71 +34,74 @@ static void RunGruTest(const std::vector<float>& X_data,
                        std::vector<string> activations = default_activations,
                        std::vector<float> activation_alphas = {},
                        std::vector<float> activation_betas = {}) {
-  OpTester test("GRU");
+  // run with the weights as initializers so they are prepacked, and as regular inputs
+  for (bool is_initializer : std::initializer_list<bool>{false, true}) {
+    OpTester test("GRU");
 
-  test.AddShapeToTensorData();
+    test.AddShapeToTensorData();
 
-  int num_directions = (direction == "bidirectional") ? 2 : 1;
+    int num_directions = (direction == "bidirectional") ? 2 : 1;
 
-  if (num_directions == 2 && activations.size() == 2) {
-    activations.reserve(4);  // need to avoid reallocation when inserting
-    // default to copying the activations so the same are used for forward and backwards
-    std::copy(activations.cbegin(), activations.cend(), std::back_inserter(activations));
-  }
+    if (num_directions == 2 && activations.size() == 2) {
+      activations.reserve(4);  // need to avoid reallocation when inserting
+      // default to copying the activations so the same are used for forward and backwards
+      std::copy(activations.cbegin(), activations.cend(), std::back_inserter(activations));
+    }
 
-  test.AddAttribute<std::vector<string>>("activations", activations);
-  if (!activation_alphas.empty())
-    test.AddAttribute<std::vector<float>>("activation_alpha", activation_alphas);
-  if (!activation_betas.empty())
-    test.AddAttribute<std::vector<float>>("activation_beta", activation_betas);
-
-  test.AddAttribute("direction", direction);
-  test.AddAttribute("hidden_size", hidden_size);
-  // test.AddAttribute<int64_t>("output_sequence", output_sequence);
-  test.AddAttribute<int64_t>("linear_before_reset", linear_before_reset);
-  // if clip is a very big number (usually it is default value), don't set the clip
-  if (clip < 999.f)
-    test.AddAttribute<float>("clip", clip);
-
-  std::vector<int64_t> X_dims = {seq_length, batch_size, input_size};
-  std::vector<int64_t> W_dims = {num_directions, 3 * hidden_size, input_size};
-  std::vector<int64_t> R_dims = {num_directions, 3 * hidden_size, hidden_size};
-
-  test.AddInput<float>("X", X_dims, X_data);
-  test.AddInput<float>("W", W_dims, W_data, true);
-  test.AddInput<float>("R", R_dims, R_data, true);
-
-  if (B_data) {
-    std::vector<int64_t> B_dims = {num_directions, 6 * hidden_size};
-    test.AddInput<float>("B", B_dims, *B_data, true);
-  }
+    test.AddAttribute<std::vector<string>>("activations", activations);
+    if (!activation_alphas.empty())
+      test.AddAttribute<std::vector<float>>("activation_alpha", activation_alphas);
+    if (!activation_betas.empty())
+      test.AddAttribute<std::vector<float>>("activation_beta", activation_betas);
+
+    test.AddAttribute("direction", direction);
+    test.AddAttribute("hidden_size", hidden_size);
+    // test.AddAttribute<int64_t>("output_sequence", output_sequence);
+    test.AddAttribute<int64_t>("linear_before_reset", linear_before_reset);
+    // if clip is a very big number (usually it is default value), don't set the clip
+    if (clip < 999.f)
+      test.AddAttribute<float>("clip", clip);
+
+    std::vector<int64_t> X_dims = {seq_length, batch_size, input_size};
+    std::vector<int64_t> W_dims = {num_directions, 3 * hidden_size, input_size};
+    std::vector<int64_t> R_dims = {num_directions, 3 * hidden_size, hidden_size};
+
+    test.AddInput<float>("X", X_dims, X_data);
+    test.AddInput<float>("W", W_dims, W_data, is_initializer);
+    test.AddInput<float>("R", R_dims, R_data, is_initializer);
+
+    if (B_data) {
+      std::vector<int64_t> B_dims = {num_directions, 6 * hidden_size};
+      test.AddInput<float>("B", B_dims, *B_data, true);
+    }
 
-  if (sequence_lengths) {
-    std::vector<int64_t> sequence_lens_dims{batch_size};
-    test.AddInput<int>("sequence_lens", sequence_lens_dims, *sequence_lengths);
-  }
+    if (sequence_lengths) {
+      std::vector<int64_t> sequence_lens_dims{batch_size};
+      test.AddInput<int>("sequence_lens", sequence_lens_dims, *sequence_lengths);
+    }
 
-  if (initial_h_data) {
-    std::vector<int64_t> initial_h_dims = {num_directions, batch_size, hidden_size};
-    test.AddInput<float>("initial_h", initial_h_dims, *initial_h_data);
-  }
+    if (initial_h_data) {
+      std::vector<int64_t> initial_h_dims = {num_directions, batch_size, hidden_size};
+      test.AddInput<float>("initial_h", initial_h_dims, *initial_h_data);
+    }
 
-  if (output_sequence != 0) {
-    std::vector<int64_t> Y_dims = {seq_length, num_directions, batch_size, hidden_size};
-    test.AddOutput<float>("Y", Y_dims, Y_data);
-  } else {
-    test.AddMissingOptionalOutput<float>();
-  }
+    if (output_sequence != 0) {
+      std::vector<int64_t> Y_dims = {seq_length, num_directions, batch_size, hidden_size};
+      test.AddOutput<float>("Y", Y_dims, Y_data);
+    } else {
+      test.AddMissingOptionalOutput<float>();
+    }
 
-  if (!Y_h_data.empty()) {
-    std::vector<int64_t> Y_h_dims{num_directions, batch_size, hidden_size};
-    test.AddOutput<float>("Y_h", Y_h_dims, Y_h_data);
-  } else {
-    test.AddMissingOptionalOutput<float>();
-  }
+    if (!Y_h_data.empty()) {
+      std::vector<int64_t> Y_h_dims{num_directions, batch_size, hidden_size};
+      test.AddOutput<float>("Y_h", Y_h_dims, Y_h_data);
+    } else {
+      test.AddMissingOptionalOutput<float>();
+    }
 
-  // TensorRT failed on GRU tests
-  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+    // TensorRT failed on GRU tests
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
 }
 
 void DefaultActivationsSimpleWeightsNoBias(std::string direction,
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/providers/cpu/tensor/resize.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -254,6 +256,66 @@ TEST(ResizeOpTest, ResizeOpLinearUpSampleTest_4DBilinear_asymmetric) {
   run_test(true);
 }
 
+TEST(ResizeOpTest, ResizeOpLinearUpSampleTest_4DBilinear_asymmetric_Nhwc) {
+  // Same data as ResizeOpLinearUpSampleTest_4DBilinear_asymmetric with the 2 images stored as the
+  // channels of an NHWC tensor, and the height and width scales in the middle.
+  const int64_t N = 1, H = 2, W = 2, C = 2;
+  std::vector<float> scales{1.0f, 2.0f, 4.0f, 1.0f};
+  std::vector<float> X = {1.0f, 6.0f, 3.0f, 2.0f,
+                          4.0f, 7.0f, 8.0f, 11.0f};
+
+  std::vector<float> Y_nchw = {
+      1.0f, 1.5f, 2.0f, 2.5f, 3.0f, 3.0f, 3.0f, 3.0f,
+      2.5f, 3.25f, 4.0f, 4.75f, 5.5f, 5.5f, 5.5f, 5.5f,
+      4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 8.0f, 8.0f, 8.0f,
+      4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 8.0f, 8.0f, 8.0f,
+
+      6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 2.0f, 2.0f, 2.0f,
+      6.5f, 6.5f, 6.5f, 6.5f, 6.5f, 6.5f, 6.5f, 6.5f,
+      7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 11.0f, 11.0f, 11.0f,
+      7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 11.0f, 11.0f, 11.0f};
+
+  const int64_t output_size = static_cast<int64_t>(H * scales[1] * W * scales[2]);
+  std::vector<float> Y(Y_nchw.size());
+  for (int64_t i = 0; i < output_size; ++i) {
+    for (int64_t c = 0; c < C; ++c) {
+      Y[i * C + c] = Y_nchw[c * output_size + i];
+    }
+  }
+
+  const std::vector<int64_t> output_dims{N, static_cast<int64_t>(H * scales[1]), static_cast<int64_t>(W * scales[2]), C};
+
+  {
+    OpTester test("Resize", 13);
+    test.AddAttribute("mode", "linear");
+    test.AddAttribute("coordinate_transformation_mode", "asymmetric");
+    test.AddInput<float>("X", {N, H, W, C}, X);
+    test.AddInput<float>("roi", {0}, {});
+    test.AddInput<float>("scales", {4}, scales);
+    test.AddOutput<float>("Y", output_dims, Y);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "",
+             {kCudaExecutionProvider, kTensorrtExecutionProvider, kNnapiExecutionProvider});
+  }
+
+  // The uint8 version truncates the interpolated values.
+  std::vector<uint8_t> X_uint8(X.size());
+  std::transform(X.begin(), X.end(), X_uint8.begin(), [](float v) { return static_cast<uint8_t>(v); });
+  std::vector<uint8_t> Y_uint8(Y.size());
+  std::transform(Y.begin(), Y.end(), Y_uint8.begin(), [](float v) { return static_cast<uint8_t>(v); });
+
+  {
+    OpTester test("Resize", 13);
+    test.AddAttribute("mode", "linear");
+    test.AddAttribute("coordinate_transformation_mode", "asymmetric");
+    test.AddInput<uint8_t>("X", {N, H, W, C}, X_uint8);
+    test.AddInput<float>("roi", {0}, {});
+    test.AddInput<float>("scales", {4}, scales);
+    test.AddOutput<uint8_t>("Y", output_dims, Y_uint8);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "",
+             {kCudaExecutionProvider, kTensorrtExecutionProvider, kNnapiExecutionProvider});
+  }
+}
+
 TEST(ResizeOpTest, ResizeOpLinearUpSampleTest_2DBilinear_align_corners) {
   OpTester test("Resize", 13);
   std::vector<float> roi{};
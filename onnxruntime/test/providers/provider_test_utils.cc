@@ -203,6 +203,9 @@ void Check<MLFloat16>(const OpTester::Data& expected_data,
 #if defined(USE_TENSORRT) || defined(ENABLE_TRAINING) || defined(USE_CUDA)
   threshold = 0.005f;
 #endif
+  if (expected_data.absolute_error_.has_value()) {
+    threshold = expected_data.absolute_error_.value();
+  }
   for (int i = 0; i < size; ++i) {
     if (std::isinf(f_expected[i]))  // Test infinity for equality
       EXPECT_EQ(f_expected[i], f_output[i]) << "i:" << i;
@@ -770,6 +770,41 @@ TEST(CApiTest, get_string_tensor_element) {
   ASSERT_EQ(expected_string_len, string_len);
 }
 
+TEST(CApiTest, fill_string_tensor_content) {
+  const std::string s = "abcdefg";
+  const std::vector<size_t> fill_offsets = {0, 3, 3};
+  int64_t expected_len = 3;
+  auto default_allocator = onnxruntime::make_unique<MockedOrtAllocator>();
+
+  Ort::Value tensor = Ort::Value::CreateTensor(default_allocator.get(), &expected_len, 1, ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+  tensor.FillStringTensorContent(s.data(), s.size(), fill_offsets.data(), fill_offsets.size());
+
+  ASSERT_EQ(tensor.GetStringTensorDataLength(), s.size());
+  ASSERT_EQ(tensor.GetStringTensorElementLength(1), 0u);
+  ASSERT_EQ(tensor.GetStringTensorElementLength(2), 4u);
+
+  // the strings are read without a copy
+  const char* chars = nullptr;
+  const size_t* offsets = nullptr;
+  tensor.GetStringTensorContentView(&chars, &offsets);
+  ASSERT_EQ(std::string(chars, offsets[3]), s);
+  ASSERT_EQ(std::vector<size_t>(offsets, offsets + 4), (std::vector<size_t>{0, 3, 3, 7}));
+
+  std::string result(s.size(), '\0');
+  std::vector<size_t> result_offsets(expected_len);
+  tensor.GetStringTensorContent((void*)result.data(), result.size(), result_offsets.data(), result_offsets.size());
+  ASSERT_EQ(result, s);
+  ASSERT_EQ(result_offsets, fill_offsets);
+
+  // filling an element stores the strings one by one, which has no view
+  tensor.FillStringTensorElement("xy", 1);
+  ASSERT_EQ(tensor.GetStringTensorDataLength(), s.size() + 2);
+  ASSERT_THROW(tensor.GetStringTensorContentView(&chars, &offsets), Ort::Exception);
+
+  const size_t bad_offsets[] = {0, 5, 3};
+  ASSERT_THROW(tensor.FillStringTensorContent(s.data(), s.size(), bad_offsets, 3), Ort::Exception);
+}
+
 TEST(CApiTest, create_tensor_with_data) {
   float values[] = {3.0f, 1.0f, 2.f, 0.f};
   constexpr size_t values_length = sizeof(values) / sizeof(values[0]);
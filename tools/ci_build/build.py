@@ -396,6 +396,9 @@ def parse_arguments():
     parser.add_argument(
         "--use_telemetry", action='store_true',
         help="Only official builds can set this flag to enable telemetry.")
+    parser.add_argument(
+        "--enable_usdt", action='store_true',
+        help="Enable USDT tracepoints for system profilers such as bpftrace and perf on Linux.")
     parser.add_argument(
         "--enable_wcos", action='store_true',
         help="Build for Windows Core OS.")
@@ -733,6 +736,7 @@ def generate_build_tree(cmake_path, source_dir, build_dir, cuda_home, cudnn_home
         "-Donnxruntime_USE_WINML=" + ("ON" if args.use_winml else "OFF"),
         "-Donnxruntime_USE_TELEMETRY=" + (
             "ON" if args.use_telemetry else "OFF"),
+        "-Donnxruntime_ENABLE_USDT=" + ("ON" if args.enable_usdt else "OFF"),
         "-Donnxruntime_ENABLE_LTO=" + ("ON" if args.enable_lto else "OFF"),
         "-Donnxruntime_USE_ACL=" + ("ON" if args.use_acl else "OFF"),
         "-Donnxruntime_USE_ACL_1902=" + (